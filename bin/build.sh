@@ -55,7 +55,7 @@ popd > /dev/null
 
 function usage
 {
-    echo "usage: $0 [-h] [-c] [-w] [-t/r/i/g] [build_path]"
+    echo "usage: $0 [-h] [-c] [-w] [-f] [-t/r/i/g] [build_path]"
     echo ""
     echo "positional arguments:"
     echo "  build_path            Path to build (relative to src, e.g. 'BasicApp' or"
@@ -65,6 +65,8 @@ function usage
     echo "  -h       Show this help message and exit"
     echo "  -c       Run 'make clean' before make/make install on non-library sources"
     echo "  -w       Show compiler warnings when building"
+    echo "  -f       Build the single precision (float) flavor into <build dir>_float."
+    echo "           Requires BULLET_SINGLE_PRECISION=\"ON\" in conf/bullet.conf."
     echo "  -t       Build test/ rather than src/" 
     echo "  -r       Build test/ rather than src/ *and* run all tests after compilation."
     echo "  -i       Build test_integration/ rather than src/" 
@@ -80,6 +82,7 @@ function cmake_cross_platform()
         -DCMAKE_INSTALL_NAME_DIR="$BASE_DIR/env" \
         -DCMAKE_CXX_FLAGS="$cmake_cxx_flags" \
         -DCMAKE_CXX_COMPILER="$ENV_BIN_DIR/g++" \
+        -DUSE_DOUBLE_PRECISION="$use_double_precision" \
         -DCMAKE_C_FLAGS="-fPIC" \
         -DCMAKE_CXX_FLAGS="-fPIC" \
         -DCMAKE_EXE_LINKER_FLAGS="-fPIC" \
@@ -96,8 +99,9 @@ MAKE_CLEAN_FLAG=false
 CMAKE_COMPILER_WARNINGS_FLAG=false
 RUN_ALL_TESTS=false
 RUN_INTEGRATION_TESTS=false
+use_double_precision="ON"
 
-while getopts ":hcwtrig" opt; do
+while getopts ":hcwftrig" opt; do
     case $opt in
         h)
             usage;
@@ -109,6 +113,9 @@ while getopts ":hcwtrig" opt; do
         w)
             CMAKE_COMPILER_WARNINGS_FLAG=true
             ;;
+        f)
+            use_double_precision="OFF"
+            ;;
         t)
             build_target=$BUILD_TEST_DIR 
             build_src=$TEST_DIR
@@ -138,6 +145,13 @@ while getopts ":hcwtrig" opt; do
     esac
 done
 
+# The single precision flavor gets its own build trees so both can coexist
+if [ "$use_double_precision" == "OFF" ]; then
+    build_target="${build_target}_float"
+    BUILD_TEST_DIR="${BUILD_TEST_DIR}_float"
+    BUILD_INTEGRATION_TEST_DIR="${BUILD_INTEGRATION_TEST_DIR}_float"
+fi
+
 
 # Make sure the build directory exists
 create_directory_if_noexist $build_target
@@ -56,10 +56,16 @@ source_conf "bullet.conf"
 
 # Variables
 bullet_pkg=`echo $BULLET_URL|awk -F/ '{print $NF}'`  # get the package name from the url
+bullet_double_precision="ON"  # overridden while building the single precision copy
 
 # Check to see if bullet has been built already
 function check_bullet_built()
 {
+    # A build from before profiling was turned off has to be redone
+    if ! check_bullet_no_profile; then
+        return $FALSE
+    fi
+
     # Check for a library that's created when bullet is built   
     fname=$(find "$BULLET_BUILD_DIR" -iname libBulletCollision.* 2>/dev/null)
     if [ -f "$fname" ]; then
@@ -68,6 +74,13 @@ function check_bullet_built()
     return $FALSE
 }
 
+# Check that bullet was configured with BT_NO_PROFILE. inc.CMakeBullet.txt
+# reads the same cache to decide whether NTRT may step on several threads.
+function check_bullet_no_profile()
+{
+    grep -q "^CMAKE_CXX_FLAGS:STRING=.*-DBT_NO_PROFILE" "$BULLET_BUILD_DIR/CMakeCache.txt" 2>/dev/null
+}
+
 function ensure_bullet_openglsupport()
 {
     result=$(count_files "$BULLET_BUILD_DIR/Demos/OpenGL/libOpenGLSupport.*")
@@ -158,18 +171,20 @@ function build_bullet()
 
     # Perform the build
     # If you turn double precision on, turn it on in inc.CMakeBullet.txt as well for the NTRT build
+    # BT_NO_PROFILE removes Bullet's global profiler, which is not thread
+    # safe, so independent worlds can be stepped on separate threads
     "$ENV_DIR/bin/cmake" . -G "Unix Makefiles" \
         -DBUILD_SHARED_LIBS=OFF \
         -DBUILD_EXTRAS=ON \
         -DCMAKE_INSTALL_PREFIX="$BULLET_INSTALL_PREFIX" \
-        -DCMAKE_C_FLAGS="-fPIC" \
-        -DCMAKE_CXX_FLAGS="-fPIC" \
+        -DCMAKE_C_FLAGS="-fPIC -DBT_NO_PROFILE" \
+        -DCMAKE_CXX_FLAGS="-fPIC -DBT_NO_PROFILE" \
         -DCMAKE_C_COMPILER="gcc" \
         -DCMAKE_CXX_COMPILER="g++" \
         -DCMAKE_EXE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_MODULE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_SHARED_LINKER_FLAGS="-fPIC" \
-        -DUSE_DOUBLE_PRECISION=ON \
+        -DUSE_DOUBLE_PRECISION=$bullet_double_precision \
         -DCMAKE_INSTALL_NAME_DIR="$BULLET_INSTALL_PREFIX" || { echo "- ERROR: CMake for Bullet Physics failed."; exit 1; }
     #If you turn this on, turn it on in inc.CMakeBullet.txt as well for the NTRT build
     # Additional bullet options: 
@@ -232,16 +247,52 @@ function env_link_bullet()
 
 }
 
+# Build a second, single precision copy of Bullet if requested in bullet.conf.
+# It is never installed; inc.CMakeBullet.txt links it from env/build/bullet_float.
+function setup_bullet_single_precision()
+{
+    if [ "${BULLET_SINGLE_PRECISION:-OFF}" != "ON" ]; then
+        return
+    fi
+
+    # The regular build functions work on BULLET_BUILD_DIR, so point it
+    # at the single precision tree for the duration of this subshell
+    (
+        BULLET_BUILD_DIR="$BULLET_SINGLE_PRECISION_BUILD_DIR"
+        bullet_double_precision="OFF"
+
+        if check_bullet_built; then
+            echo "- Single precision Bullet Physics is already built under $BULLET_BUILD_DIR -- skipping."
+        else
+            # Both skip work that has already been done
+            download_bullet
+            unpack_bullet
+            if ! check_directory_exists "$BULLET_BUILD_DIR/Demos/OpenGL_FreeGlut/"; then
+                patch_bullet
+            fi
+            build_bullet
+        fi
+
+        pushd "$ENV_DIR/build" > /dev/null
+        rm bullet_float 2>/dev/null
+        create_exist_symlink "$BULLET_BUILD_DIR" bullet_float
+        popd > /dev/null
+    )
+}
+
 function main()
 {
 
     ensure_install_prefix_writable $BULLET_INSTALL_PREFIX
 
     if check_package_installed "$BULLET_INSTALL_PREFIX/lib/libBulletDynamics*"; then
-        echo "- Bullet Physics is installed under prefix $BULLET_INSTALL_PREFIX -- skipping."
-        ensure_bullet_openglsupport
-        env_link_bullet
-        return
+        if check_bullet_no_profile || ! check_directory_exists "$BULLET_BUILD_DIR"; then
+            echo "- Bullet Physics is installed under prefix $BULLET_INSTALL_PREFIX -- skipping."
+            ensure_bullet_openglsupport
+            env_link_bullet
+            return
+        fi
+        echo "- Bullet Physics under $BULLET_BUILD_DIR was built with profiling -- rebuilding without it."
     fi
 
     if check_bullet_built; then
@@ -293,3 +344,4 @@ function main()
 
 
 main
+setup_bullet_single_precision
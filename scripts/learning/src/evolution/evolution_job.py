@@ -43,23 +43,71 @@ class EvolutionJob(NTRTJob):
             logPath = self.args['resourcePrefix'] + self.args['path'] + self.args['filename'] + '_log.txt'
             logFile = open(logPath, 'wb')
 
-            # A set of jobs. Currently [0 0] is flat ground, [1 0] is a block field, [0 1] is hilly terrain, and [1 1] is both
-            # This will expand in the future.
-            terrainMatrix = self.args['terrain']
-            # Update this if the subprocess call gets changed
-            if len(terrainMatrix[0]) < 4: 
-                raise NTRTMasterError("Not enough terrain args!")
-            
-            # Run through a set of binary job options. Currently handles terrain switches
-            for run in terrainMatrix:
-                if (len(run)) >= 5:
-                    trialLength = run[4]
-                else:
-                    trialLength = self.args['length']
+            for run, trialLength in self.__terrainRuns():
                 #TODO improve error handling here
                 subprocess.check_call([self.args['executable'], "-l", self.args['filename'], "-P", self.args['path'], "-s", str(trialLength), "-b", str(run[0]), "-H", str(run[1]), "-a", str(run[2]), "-B", str(run[3])], stdout=logFile)
             sys.exit()
 
+    def workerRequests(self):
+        """
+        The same runs as startJob, as requests for an app running in worker
+        mode (see WorkerScheduler). The parameters travel in the request;
+        the scheduler hands the scores back to recordScores.
+        """
+        params = self.__readTrialFile()
+        params.pop('scores', None)
+        requests = []
+        for run, trialLength in self.__terrainRuns():
+            requests.append({'filename' : self.args['filename'],
+                             'path'     : self.args['path'],
+                             'params'   : params,
+                             'steps'    : int(trialLength),
+                             'blocks'   : bool(run[0]),
+                             'hills'    : bool(run[1])})
+        return requests
+
+    def recordScores(self, scores):
+        """
+        Appends the scores of one worker run to the trial file, as the app
+        does when it runs the trial itself, so processJobOutput works for
+        both.
+        """
+        obj = self.__readTrialFile()
+        obj.setdefault('scores', []).append(scores)
+        fout = open(self.__trialPath(), 'w')
+        json.dump(obj, fout, indent=4)
+        fout.close()
+
+    def __trialPath(self):
+        return self.args['resourcePrefix'] + self.args['path'] + self.args['filename']
+
+    def __readTrialFile(self):
+        fin = open(self.__trialPath(), 'r')
+        obj = json.load(fin)
+        fin.close()
+        return obj
+
+    def __terrainRuns(self):
+        """
+        Returns (run, trialLength) for each run in the terrain matrix
+        """
+        # A set of jobs. Currently [0 0] is flat ground, [1 0] is a block field, [0 1] is hilly terrain, and [1 1] is both
+        # This will expand in the future.
+        terrainMatrix = self.args['terrain']
+        # Update this if the subprocess call gets changed
+        if len(terrainMatrix[0]) < 4: 
+            raise NTRTMasterError("Not enough terrain args!")
+        
+        # Run through a set of binary job options. Currently handles terrain switches
+        runs = []
+        for run in terrainMatrix:
+            if (len(run)) >= 5:
+                trialLength = run[4]
+            else:
+                trialLength = self.args['length']
+            runs.append((run, trialLength))
+        return runs
+
     def processJobOutput(self):
         scoresPath = self.args['resourcePrefix'] + self.args['path'] + self.args['filename']
 
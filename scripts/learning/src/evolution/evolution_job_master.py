@@ -4,6 +4,8 @@ import random
 import collections
 from interfaces import NTRTJobMaster, NTRTMasterError
 from concurrent_scheduler import ConcurrentScheduler
+from worker_scheduler import WorkerScheduler
+from score_cache import ScoreCache
 import collections
 #TODO: This is hackety, fix it.
 from evolution_job import EvolutionJob
@@ -480,6 +482,27 @@ class EvolutionJobMaster(NTRTJobMaster):
 
         return self.jConf['filePrefix'] + "_" + str(jobNum) + self.jConf['fileSuffix']
     
+    def __trialParams(self, fileName):
+        """
+        The parameters of every prefix in a trial file, for the score cache
+        """
+        fin = open(self.path + fileName, 'r')
+        obj = json.load(fin)
+        fin.close()
+        return [obj[p + "Vals"]['params'] for p in self.prefixes]
+
+    def __writeCachedScores(self, fileName, scores):
+        """
+        Put cached scores into a trial file, as if the app had run it
+        """
+        fin = open(self.path + fileName, 'r')
+        obj = json.load(fin)
+        fin.close()
+        obj['scores'] = scores
+        fout = open(self.path + fileName, 'w')
+        json.dump(obj, fout, indent=4)
+        fout.close()
+
     def getJobNum(self, paramNum, paramName):
 
         for i in range(0, len(self.currentGeneration[paramName])):
@@ -518,6 +541,20 @@ class EvolutionJobMaster(NTRTJobMaster):
         for p in self.prefixes:
             self.currentGeneration[p] = {}
 
+        # Optional: keep a pool of app processes in worker mode for the
+        # whole run instead of starting one process per trial
+        workerSched = None
+        if self.jConf.get('useWorkers', False):
+            workerSched = WorkerScheduler(self.jConf['executable'], self.numProcesses, self.path + '/logs')
+
+        # Optional: skip trials that were already simulated. Results are
+        # matched on the trial's parameters, terrain and learningParams' seed
+        cacheConf = self.jConf.get('scoreCache', {})
+        scoreCache = ScoreCache(self.path + cacheConf.get('file', 'scoreCache.json'),
+                                cacheConf.get('policy', 'off'),
+                                cacheConf.get('samples', 1),
+                                cacheConf.get('deterministic', False))
+
         logFile = open('evoLog.txt', 'w') #Clear logfile
         logFile.close()
 
@@ -534,12 +571,26 @@ class EvolutionJobMaster(NTRTJobMaster):
             else:
                 startTrial = 0
 
+            # Trials answered by the score cache, and the cache keys of the others
+            cachedJobs = []
+            trialKeys = {}
+
             # We want to write all of the trials for post processing
             for i in range(0, numTrials) :
 
                 # MonteCarlo solution. This function could be overridden with something that
                 # provides a filename for a pre-existing file
                 fileName = self.getNewFile(i)
+
+                cachedScores = None
+                if (n == 0 or i >= startTrial):
+                    trialKey = scoreCache.makeKey(self.__trialParams(fileName), self.jConf['terrain'],
+                                                  self.jConf['learningParams'].get('seed', 0))
+                    cachedScores = scoreCache.lookup(trialKey)
+                    if cachedScores is not None:
+                        self.__writeCachedScores(fileName, cachedScores)
+                    else:
+                        trialKeys[fileName] = trialKey
                 
                 for j in self.jConf['terrain']:
                     # All args to be passed to subprocess must be strings
@@ -551,11 +602,19 @@ class EvolutionJobMaster(NTRTJobMaster):
                             'length'   : self.jConf['learningParams']['trialLength'],
                             'terrain'  : j}
                     if (n == 0 or i >= startTrial):
-                        jobList.append(EvolutionJob(args))
+                        if cachedScores is not None:
+                            cachedJobs.append(EvolutionJob(args))
+                        else:
+                            jobList.append(EvolutionJob(args))
 
             # Run the jobs
-            conSched = ConcurrentScheduler(jobList, self.numProcesses)
-            completedJobs = conSched.processJobs()
+            if workerSched is not None:
+                completedJobs = workerSched.processJobs(jobList)
+                jobList = []
+            else:
+                conSched = ConcurrentScheduler(jobList, self.numProcesses)
+                completedJobs = conSched.processJobs()
+            completedJobs += cachedJobs
 
             # Read scores from files, write to logs
             totalScore = 0
@@ -565,6 +624,10 @@ class EvolutionJobMaster(NTRTJobMaster):
                 jobVals = job.obj
 
                 scores = jobVals['scores']
+
+                # Several terrain jobs can share a file; record it once
+                if job.args['filename'] in trialKeys:
+                    scoreCache.record(trialKeys.pop(job.args['filename']), scores)
                 
                              
 
@@ -586,3 +649,7 @@ class EvolutionJobMaster(NTRTJobMaster):
             logFile.write(str((n+1) * numTrials) + ',' + str(maxScore) + ',' + str(avgScore) +'\n')
             logFile.close()
 
+            scoreCache.save()
+
+        if workerSched is not None:
+            workerSched.close()
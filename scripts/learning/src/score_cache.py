@@ -0,0 +1,98 @@
+import hashlib
+import json
+import logging
+import os
+
+class ScoreCache:
+    """
+    Scores of trials that were already simulated, keyed by a hash of the
+    trial's parameters, seed and terrain. EvolutionJobMaster asks the cache before
+    scheduling a trial file and skips the simulation when the policy allows
+    reusing what is there. Mirrors ScoreCache in src/learning/AnnealEvolution.
+
+    Policies:
+        off           - always simulate, nothing is recorded
+        always        - reuse any recorded result
+        resample      - simulate until there are 'samples' results, then
+                        reuse their mean
+        deterministic - reuse only if the learning spec declares the trials
+                        deterministic (off by default)
+    """
+
+    POLICIES = ("off", "always", "resample", "deterministic")
+
+    def __init__(self, filename, policy="off", samples=1, deterministic=False):
+        if policy not in self.POLICIES:
+            raise ValueError("Unknown score cache policy %s" % policy)
+        if samples < 1:
+            raise ValueError("Score cache needs at least one sample")
+        self.filename = filename
+        self.policy = policy
+        self.samples = samples
+        self.deterministic = deterministic
+        # key : list of samples, each the list of score dicts one trial file got
+        self.entries = {}
+
+        if self.policy != "off" and os.path.isfile(filename):
+            fin = open(filename, 'r')
+            self.entries = json.load(fin)
+            fin.close()
+            logging.info("Loaded %d cached trials from %s" % (len(self.entries), filename))
+
+    def makeKey(self, params, terrain, seed=0):
+        """
+        Hash of the parameters (anything JSON serializable), the terrain
+        runs and the random seed of a trial, so results are only reused
+        under the same conditions
+        """
+        text = json.dumps([params, terrain, seed], sort_keys=True)
+        return hashlib.sha1(text.encode()).hexdigest()
+
+    def lookup(self, key):
+        """
+        Returns the scores to reuse for this key, or None if the trial must
+        be simulated
+        """
+        if self.policy == "off" or (self.policy == "deterministic" and not self.deterministic):
+            return None
+
+        samples = self.entries.get(key)
+        if not samples:
+            return None
+        if self.policy == "resample":
+            if len(samples) < self.samples:
+                return None
+            return self.__mean(samples)
+        return samples[-1]
+
+    def record(self, key, scores):
+        """ Add the scores a simulated trial produced """
+        if self.policy == "off" or len(scores) == 0:
+            return
+        self.entries.setdefault(key, []).append(scores)
+
+    def __mean(self, samples):
+        """
+        The mean of each run's numeric scores over the samples, in the
+        shape of one sample. A sample with fewer runs (e.g. a run that
+        crashed) limits how many runs are averaged.
+        """
+        numRuns = min(len(sample) for sample in samples)
+        mean = []
+        for i in range(numRuns):
+            run = dict(samples[-1][i])
+            for key, value in run.items():
+                if isinstance(value, (int, float)) and not isinstance(value, bool):
+                    run[key] = sum(sample[i][key] for sample in samples) / float(len(samples))
+            mean.append(run)
+        return mean
+
+    def save(self):
+        """ Write the cache, replacing the file only once it is complete """
+        if self.policy == "off":
+            return
+        tmpName = self.filename + ".tmp"
+        fout = open(tmpName, 'w')
+        json.dump(self.entries, fout)
+        fout.close()
+        os.rename(tmpName, self.filename)
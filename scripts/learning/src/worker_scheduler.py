@@ -0,0 +1,160 @@
+import json
+import logging
+import os
+import select
+import shutil
+import socket
+import subprocess
+import tempfile
+
+class WorkerScheduler:
+    """
+    Runs jobs on a pool of long lived app processes instead of starting one
+    process per job. Each worker is started with --worker and connects back
+    over a Unix socket; it then runs one trial per request line and answers
+    with one line of scores. Only apps with a worker mode (currently
+    dev/dhustigschultz/BP_SC_Symmetric/AppQuadControl) can be used.
+
+    The pool is kept between calls to processJobs, so a learning run pays
+    for process startup and world creation once per worker instead of once
+    per trial.
+    """
+
+    # Seconds to wait for the workers to connect
+    __CONNECT_TIMEOUT = 60.0
+
+    # Times a job's remaining runs are sent out before giving up on it
+    __MAX_ATTEMPTS = 3
+
+    def __init__(self, executable, numProcesses, logPath):
+        self.executable = executable
+        self.numProcesses = numProcesses
+        self.logPath = logPath
+        self.socketDir = tempfile.mkdtemp(prefix="ntrt_workers")
+        self.socketPath = os.path.join(self.socketDir, "workers.sock")
+
+        # Kept open so workers that exit can be replaced
+        self.listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.listener.bind(self.socketPath)
+        self.listener.listen(numProcesses)
+        self.listener.settimeout(self.__CONNECT_TIMEOUT)
+
+        self.processes = []
+        self.logFiles = []
+        self.workers = []
+        for i in range(numProcesses):
+            self.__spawn()
+        # Workers are interchangeable, so accept them in any order
+        for i in range(numProcesses):
+            self.__accept()
+
+        logging.info("Worker scheduler started %d workers on %s." % (numProcesses, self.socketPath))
+
+    def processJobs(self, toProcess):
+        """
+        Runs every job and returns them in order of completion, like
+        ConcurrentScheduler.processJobs. All the runs of one job go to the
+        same worker, in order, and their scores are appended to the job's
+        trial file as they arrive.
+        If a run fails or its worker exits, the job's remaining runs are
+        sent out again (to a replacement if the worker died), so a job is
+        only returned once every run has been scored.
+        """
+        # Each entry is (job, the runs still to score, attempts so far)
+        jobsUnprocessed = [(job, job.workerRequests(), 1) for job in toProcess]
+        jobsComplete = []
+        busy = {}
+
+        while len(jobsUnprocessed) > 0 or len(busy) > 0:
+            for worker in self.workers:
+                if worker not in busy and len(jobsUnprocessed) > 0:
+                    job, requests, attempts = jobsUnprocessed.pop()
+                    logging.info("Sending job %s to a worker." % job.args['filename'])
+                    busy[worker] = (job, requests, attempts)
+                    worker.send(requests[0])
+
+            ready, _, _ = select.select(list(busy.keys()), [], [])
+            for worker in ready:
+                job, requests, attempts = busy.pop(worker)
+                reply = worker.receive()
+                if 'error' in reply:
+                    # The run in flight wasn't scored; the ones before it were
+                    if attempts >= self.__MAX_ATTEMPTS:
+                        raise RuntimeError("Job %s failed %d times: %s" %
+                                           (job.args['filename'], attempts, reply['error']))
+                    logging.warning("Job %s failed, sending its %d remaining runs again: %s" %
+                                    (job.args['filename'], len(requests), reply['error']))
+                    jobsUnprocessed.append((job, requests, attempts + 1))
+                else:
+                    job.recordScores(reply['scores'])
+                    if len(requests) > 1:
+                        busy[worker] = (job, requests[1:], attempts)
+                        worker.send(requests[1])
+                    else:
+                        jobsComplete.append(job)
+
+                if not worker.alive:
+                    logging.warning("A worker exited; starting a replacement.")
+                    self.workers.remove(worker)
+                    worker.close()
+                    self.__spawn()
+                    self.__accept()
+
+        return jobsComplete
+
+    def close(self):
+        """ Hangs up on the workers, which then exit. """
+        for worker in self.workers:
+            worker.close()
+        for process in self.processes:
+            process.wait()
+        for logFile in self.logFiles:
+            logFile.close()
+        self.listener.close()
+        shutil.rmtree(self.socketDir, ignore_errors=True)
+        self.workers = []
+        self.processes = []
+        self.logFiles = []
+
+    def __spawn(self):
+        """ Starts a worker process, which connects back to the listener. """
+        logName = "worker_%d_log.txt" % len(self.processes)
+        logFile = open(os.path.join(self.logPath, logName), 'wb')
+        self.logFiles.append(logFile)
+        self.processes.append(subprocess.Popen([self.executable, "-W", self.socketPath], stdout=logFile))
+
+    def __accept(self):
+        """ Waits for the next worker to connect. """
+        try:
+            connection, address = self.listener.accept()
+        except socket.timeout:
+            raise RuntimeError("No worker connected within %d seconds." % self.__CONNECT_TIMEOUT)
+        connection.settimeout(None)
+        self.workers.append(_Worker(connection))
+
+class _Worker:
+    """ One connected worker process. """
+
+    def __init__(self, connection):
+        self.connection = connection
+        self.stream = connection.makefile('r')
+        self.alive = True
+
+    def fileno(self):
+        return self.connection.fileno()
+
+    def send(self, request):
+        self.connection.sendall((json.dumps(request) + '\n').encode())
+
+    def receive(self):
+        # There is only ever one request outstanding, so a readable worker
+        # has sent (or is sending) exactly one line
+        line = self.stream.readline()
+        if not line:
+            self.alive = False
+            return {'error': "worker exited"}
+        return json.loads(line)
+
+    def close(self):
+        self.stream.close()
+        self.connection.close()
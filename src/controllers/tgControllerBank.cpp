@@ -0,0 +1,270 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file tgControllerBank.cpp
+ * @brief Implementation of the tgControllerBank class
+ * $Id$
+ */
+
+#include "tgControllerBank.h"
+
+#include "tgImpedanceController.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgSpringCable.h"
+#include "core/tgSpringCableActuator.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+/**
+ * Shortest rest length commanded to a tgBasicActuator, as in
+ * tgTensionController::control(tgBasicActuator&, double, double)
+ */
+static const double kMinRestLength = 0.1;
+
+tgControllerBank::tgControllerBank()
+{
+    // Postcondition
+    assert(invariant());
+}
+
+tgControllerBank::~tgControllerBank()
+{
+    // The actuators belong to their model
+}
+
+std::size_t
+tgControllerBank::addActuator(tgSpringCableActuator* actuator,
+                              const tgPIDController::Config& pidConfig,
+                              const tgImpedanceController& impedance)
+{
+    if (actuator == NULL)
+    {
+        throw std::invalid_argument("Actuator is NULL");
+    }
+
+    tgBasicActuator* const basicAct =
+        tgCast::cast<tgSpringCableActuator, tgBasicActuator>(actuator);
+
+    m_actuators.push_back(actuator);
+    m_basicActuators.push_back(basicAct);
+
+    if (basicAct != NULL)
+    {
+        const double stiffness = basicAct->getSpringCable()->getCoefK();
+        assert(stiffness > 0.0);
+        m_useRestLength.push_back(1.0);
+        m_inverseStiffness.push_back(1.0 / stiffness);
+        m_kP.push_back(0.0);
+        m_kI.push_back(0.0);
+        m_kD.push_back(0.0);
+    }
+    else
+    {
+        m_useRestLength.push_back(0.0);
+        m_inverseStiffness.push_back(0.0);
+        m_kP.push_back(pidConfig.kP);
+        m_kI.push_back(pidConfig.kI);
+        m_kD.push_back(pidConfig.kD);
+    }
+
+    m_prevError.push_back(0.0);
+    m_intError.push_back(0.0);
+
+    m_offsetTension.push_back(impedance.getOffsetTension());
+    m_lengthStiffness.push_back(impedance.getLengthStiffness());
+    m_velStiffness.push_back(impedance.getVelStiffness());
+
+    m_length.push_back(0.0);
+    m_velocity.push_back(0.0);
+    m_tension.push_back(0.0);
+    m_restLength.push_back(0.0);
+    m_setTension.push_back(0.0);
+    m_command.push_back(0.0);
+
+    // Postcondition
+    assert(invariant());
+
+    return m_actuators.size() - 1;
+}
+
+void tgControllerBank::setImpedance(std::size_t i,
+                                    const tgImpedanceController& impedance)
+{
+    if (i >= size())
+    {
+        throw std::out_of_range("Controller bank index out of range");
+    }
+    m_offsetTension[i] = impedance.getOffsetTension();
+    m_lengthStiffness[i] = impedance.getLengthStiffness();
+    m_velStiffness[i] = impedance.getVelStiffness();
+}
+
+void tgControllerBank::controlImpedance(double dt,
+                                        const double* positions,
+                                        const double* offsetTensions,
+                                        const double* offsetVels)
+{
+    if (dt <= 0.0)
+    {
+        throw std::runtime_error ("Timestep must be positive.");
+    }
+    const std::size_t n = size();
+    if (n == 0)
+    {
+        return;
+    }
+    assert(positions != NULL);
+
+    gatherSensors();
+
+    const double* const offset =
+        offsetTensions ? offsetTensions : &m_offsetTension[0];
+    const double* const length = &m_length[0];
+    const double* const velocity = &m_velocity[0];
+    const double* const kLength = &m_lengthStiffness[0];
+    const double* const kVelocity = &m_velStiffness[0];
+    double* const setTension = &m_setTension[0];
+
+    // Same as determineSetTension in tgImpedanceController.cpp
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double offsetVel = offsetVels ? offsetVels[i] : 0.0;
+        setTension[i] =
+            std::max(0.0, offset[i] +
+                          kLength[i] * (length[i] - positions[i]) +
+                          kVelocity[i] * (velocity[i] - offsetVel));
+    }
+
+    computeCommands(dt);
+    scatterCommands(dt);
+}
+
+void tgControllerBank::controlTension(double dt, const double* setTensions)
+{
+    if (dt <= 0.0)
+    {
+        throw std::runtime_error ("Timestep must be positive.");
+    }
+    const std::size_t n = size();
+    if (n == 0)
+    {
+        return;
+    }
+    assert(setTensions != NULL);
+
+    gatherSensors();
+    std::copy(setTensions, setTensions + n, m_setTension.begin());
+    computeCommands(dt);
+    scatterCommands(dt);
+}
+
+void tgControllerBank::resetState()
+{
+    std::fill(m_prevError.begin(), m_prevError.end(), 0.0);
+    std::fill(m_intError.begin(), m_intError.end(), 0.0);
+}
+
+void tgControllerBank::gatherSensors()
+{
+    const std::size_t n = size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const tgSpringCableActuator* const actuator = m_actuators[i];
+        m_length[i] = actuator->getCurrentLength();
+        m_velocity[i] = actuator->getVelocity();
+        m_tension[i] = actuator->getTension();
+        m_restLength[i] = actuator->getRestLength();
+    }
+}
+
+void tgControllerBank::computeCommands(double dt)
+{
+    const std::size_t n = size();
+
+    const double* const setTension = &m_setTension[0];
+    const double* const tension = &m_tension[0];
+    const double* const restLength = &m_restLength[0];
+    const double* const inverseStiffness = &m_inverseStiffness[0];
+    const double* const useRestLength = &m_useRestLength[0];
+    const double* const kP = &m_kP[0];
+    const double* const kI = &m_kI[0];
+    const double* const kD = &m_kD[0];
+    double* const prevError = &m_prevError[0];
+    double* const intError = &m_intError[0];
+    double* const command = &m_command[0];
+
+    // One branch free pass over every channel. Both laws are evaluated;
+    // the rest length law has zero gains on PID channels and vice versa.
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double error = setTension[i] - tension[i];
+
+        // tgPIDController::control: trapezoid rule for the integral
+        intError[i] += (error + prevError[i]) / 2.0 * dt;
+        const double dError = (error - prevError[i]) / dt;
+        const double pid = kP[i] * error + kI[i] * intError[i] +
+                           kD[i] * dError;
+        prevError[i] = error;
+
+        // tgTensionController::control for tgBasicActuators
+        const double newLength =
+            std::max(kMinRestLength, restLength[i] - error * inverseStiffness[i]);
+
+        command[i] = useRestLength[i] * newLength +
+                     (1.0 - useRestLength[i]) * pid;
+    }
+}
+
+void tgControllerBank::scatterCommands(double dt)
+{
+    const std::size_t n = size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        tgBasicActuator* const basicAct = m_basicActuators[i];
+        if (basicAct != NULL)
+        {
+            basicAct->setControlInput(m_command[i], dt);
+        }
+        else
+        {
+            m_actuators[i]->setControlInput(m_command[i]);
+        }
+    }
+}
+
+bool tgControllerBank::invariant() const
+{
+    const std::size_t n = m_actuators.size();
+    return (m_basicActuators.size() == n) &&
+           (m_useRestLength.size() == n) &&
+           (m_kP.size() == n) && (m_kI.size() == n) && (m_kD.size() == n) &&
+           (m_prevError.size() == n) && (m_intError.size() == n) &&
+           (m_offsetTension.size() == n) &&
+           (m_lengthStiffness.size() == n) &&
+           (m_velStiffness.size() == n) &&
+           (m_inverseStiffness.size() == n) &&
+           (m_length.size() == n) && (m_velocity.size() == n) &&
+           (m_tension.size() == n) && (m_restLength.size() == n) &&
+           (m_setTension.size() == n) && (m_command.size() == n);
+}
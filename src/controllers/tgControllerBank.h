@@ -0,0 +1,189 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef TG_CONTROLLER_BANK_H
+#define TG_CONTROLLER_BANK_H
+
+/**
+ * @file tgControllerBank.h
+ * @brief Definition of the tgControllerBank class
+ * $Id$
+ */
+
+#include "tgPIDController.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgBasicActuator;
+class tgImpedanceController;
+class tgSpringCableActuator;
+
+/**
+ * Runs impedance and PID (or tension) control for many spring-cable
+ * actuators at once. Gains, setpoints and integrator state are kept in
+ * one contiguous array per quantity, so each control tick reads the
+ * sensors of every actuator, computes every output in a single pass the
+ * compiler can vectorize, and then writes all the commands.
+ *
+ * The control law for each channel is the one of the scalar classes:
+ * tgImpedanceController computes a set tension, which is tracked by a
+ * tgPIDController, or for tgBasicActuators by the rest length update of
+ * tgTensionController. Results match a tgImpedanceController and one
+ * controller per actuator stepped with the same arguments.
+ */
+class tgControllerBank
+{
+public:
+
+    tgControllerBank();
+
+    /**
+     * The bank does not own the actuators.
+     */
+    ~tgControllerBank();
+
+    /**
+     * Add a channel.
+     * @param[in] actuator the actuator to control; must not be NULL.
+     * tgBasicActuators are driven through their rest length as in
+     * tgTensionController, and the PID gains are ignored.
+     * @param[in] pidConfig the gains for tracking the set tension
+     * @param[in] impedance the offset tension and stiffnesses
+     * @return the index of the new channel
+     */
+    std::size_t addActuator(tgSpringCableActuator* actuator,
+                            const tgPIDController::Config& pidConfig,
+                            const tgImpedanceController& impedance);
+
+    /** The number of channels */
+    std::size_t size() const
+    {
+        return m_actuators.size();
+    }
+
+    /**
+     * Replace the offset tension and stiffnesses of one channel.
+     * @param[in] i the channel index; must be less than size()
+     */
+    void setImpedance(std::size_t i, const tgImpedanceController& impedance);
+
+    /**
+     * Impedance control of every channel, as
+     * tgImpedanceController::controlTension.
+     * @param[in] dt the timestep; must be positive
+     * @param[in] positions the target length of each channel, size()
+     * values
+     * @param[in] offsetTensions size() values, or NULL to use the offset
+     * tension of each channel
+     * @param[in] offsetVels size() values, or NULL for zero
+     */
+    void controlImpedance(double dt,
+                          const double* positions,
+                          const double* offsetTensions = NULL,
+                          const double* offsetVels = NULL);
+
+    /**
+     * Track a tension on every channel without the impedance terms, as
+     * tgPIDController::control(dt, setTension, tension).
+     * @param[in] dt the timestep; must be positive
+     * @param[in] setTensions size() values
+     */
+    void controlTension(double dt, const double* setTensions);
+
+    /**
+     * The set tensions from the last control call, size() values
+     */
+    const std::vector<double>& getSetTensions() const
+    {
+        return m_setTension;
+    }
+
+    /**
+     * The command each actuator received in the last control call, a
+     * rest length for tgBasicActuators and the PID output otherwise
+     */
+    const std::vector<double>& getCommands() const
+    {
+        return m_command;
+    }
+
+    /**
+     * Clear the integrator and previous error of every channel.
+     */
+    void resetState();
+
+private:
+
+    /**
+     * Read length, velocity, tension and rest length of every actuator.
+     */
+    void gatherSensors();
+
+    /**
+     * Compute m_command from m_setTension and the sensor buffers, and
+     * update the PID state.
+     */
+    void computeCommands(double dt);
+
+    /**
+     * Send m_command to every actuator.
+     */
+    void scatterCommands(double dt);
+
+    bool invariant() const;
+
+    /** Channel handles. m_basicActuators[i] is NULL for PID channels. */
+    std::vector<tgSpringCableActuator*> m_actuators;
+    std::vector<tgBasicActuator*> m_basicActuators;
+
+    /** 1.0 for channels using the rest length law, 0.0 for PID */
+    std::vector<double> m_useRestLength;
+
+    /** PID gains, already negated for tension control */
+    std::vector<double> m_kP;
+    std::vector<double> m_kI;
+    std::vector<double> m_kD;
+
+    /** PID state */
+    std::vector<double> m_prevError;
+    std::vector<double> m_intError;
+
+    /** Impedance gains */
+    std::vector<double> m_offsetTension;
+    std::vector<double> m_lengthStiffness;
+    std::vector<double> m_velStiffness;
+
+    /** 1 / spring constant of tgBasicActuator channels, 0.0 otherwise */
+    std::vector<double> m_inverseStiffness;
+
+    /** Sensor values read at the start of each control call */
+    std::vector<double> m_length;
+    std::vector<double> m_velocity;
+    std::vector<double> m_tension;
+    std::vector<double> m_restLength;
+
+    /** Outputs of the last control call */
+    std::vector<double> m_setTension;
+    std::vector<double> m_command;
+};
+
+#endif  // TG_CONTROLLER_BANK_H
@@ -0,0 +1,698 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CordeModel.cpp
+ * @brief Defines structure for the Corde softbody String Model
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// This module
+#include "CordeModel.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+CordeModel::Config::Config(const std::size_t res,
+                            const double r, const double d,
+                            const double ym, const double shm,
+                            const double stm, const double csc,
+                            const double gt, const double gr) :
+    resolution(res),
+    radius(r),
+    density(d),
+    YoungMod(ym),
+    ShearMod(shm),
+    StretchMod(stm),
+    ConsSpringConst(csc),
+    gammaT(gt),
+    gammaR(gr)
+{
+    if (r <= 0.0)
+    {
+        throw std::invalid_argument("Corde string radius is not positive.");
+    }
+    else if (d <= 0.0)
+    {
+        throw std::invalid_argument("Corde String density is not positive.");
+    }
+    else if (ym < 0.0)
+    {
+        throw std::invalid_argument("String Young's Modulus is negative.");
+    }
+    else if (shm < 0.0)
+    {
+        throw std::invalid_argument("Shear Modulus is negative.");
+    }
+    else if (stm < 0.0)
+    {
+        throw std::invalid_argument("Stretch Modulus is negative.");
+    }
+    else if (csc < 0.0)
+    {
+        throw std::invalid_argument("Spring Constant is negative.");
+    }
+    else if (gt < 0.0)
+    {
+        throw std::invalid_argument("Damping Constant (position) is negative.");
+    }
+    else if (gr < 0.0)
+    {
+        throw std::invalid_argument("Damping Constant (rotation) is negative.");
+    }
+}
+
+
+namespace
+{
+    /**
+     * Number of links or segments handed to one thread at a time.
+     * Ropes shorter than this are always evaluated serially, since the
+     * cost of starting threads would outweigh the work.
+     */
+    const std::size_t kCordeChunkSize = 256;
+}
+
+CordeModel::CordeModel(btVector3 pos1, btVector3 pos2, btQuaternion quat1, btQuaternion quat2, const CordeModel::Config& Config) : 
+m_config(Config)
+{
+    if (m_config.resolution < 2)
+    {
+        throw std::invalid_argument("Corde string needs at least two mass points.");
+    }
+    
+	computeConstants();
+    
+    const std::size_t nPoints = m_config.resolution;
+    const std::size_t nLinks = nPoints - 1;
+    
+    btVector3 rodLength(pos2 - pos1);
+    btVector3 unitLength( rodLength / ((double) m_config.resolution - 1) );
+    
+    double unitMass =  m_config.density * M_PI * pow( m_config.radius, 2) * unitLength.length();
+    
+    m_pos.resize(nPoints);
+    m_vel.resize(nPoints);
+    m_force.resize(nPoints);
+    m_inverseMass.assign(nPoints, 1.0 / unitMass);
+    
+    // Setup mass elements
+    btVector3 massPos(pos1);
+    m_pos.set(0, massPos);
+    for (std::size_t i = 1; i < nPoints; i++)
+    {
+        massPos += unitLength;
+        m_pos.set(i, massPos);
+        // Introduce stretch
+        linkLengths.push_back(unitLength.length() * 1.0);
+        inverseLinkLengths5.push_back(1.0 / pow(linkLengths.back(), 5));
+    }
+    
+    m_q.resize(nLinks);
+    m_qdot.resize(nLinks);
+    m_tprime.resize(nLinks);
+    m_torques.resize(nLinks);
+    m_omega.resize(nLinks);
+    
+    m_q.set(0, quat1.normalized());
+    for (std::size_t i = 1; i < nLinks; i++)
+    {
+        m_q.set(i, quat1.slerp(quat2, (double) i / (double) nLinks).normalized());
+        quaternionShapes.push_back(unitLength.length());
+    }
+    
+    m_linkForce0.resize(nLinks);
+    m_linkForce1.resize(nLinks);
+    m_linkTorque.resize(nLinks);
+    
+    m_segmentTorque0.resize(nLinks - 1);
+    m_segmentTorque1.resize(nLinks - 1);
+    
+    assert(invariant());
+}
+
+CordeModel::~CordeModel()
+{
+}
+
+void CordeModel::step (btScalar dt)
+{
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("Timestep is not positive.");
+    }
+    
+	computeInternalForces();
+    unconstrainedMotion(dt);
+    
+    assert(invariant());
+}
+
+std::size_t CordeModel::getNumMassPoints() const
+{
+    return m_pos.x.size();
+}
+
+std::size_t CordeModel::getNumCenterlines() const
+{
+    return m_q.x.size();
+}
+
+btVector3 CordeModel::getPosition(std::size_t i) const
+{
+    assert(i < getNumMassPoints());
+    return m_pos.get(i);
+}
+
+btVector3 CordeModel::getVelocity(std::size_t i) const
+{
+    assert(i < getNumMassPoints());
+    return m_vel.get(i);
+}
+
+btVector3 CordeModel::getForce(std::size_t i) const
+{
+    assert(i < getNumMassPoints());
+    return m_force.get(i);
+}
+
+btQuaternion CordeModel::getQuaternion(std::size_t i) const
+{
+    assert(i < getNumCenterlines());
+    return m_q.get(i);
+}
+
+void CordeModel::computeConstants()
+{
+    assert(computedStiffness.empty());
+    
+    const double pir2 =  M_PI * pow(m_config.radius, 2);
+    
+    computedStiffness.push_back( m_config.StretchMod * pir2);
+    computedStiffness.push_back( m_config.YoungMod * pir2 / 4.0);
+    computedStiffness.push_back( m_config.YoungMod * pir2 / 4.0);
+    computedStiffness.push_back( m_config.ShearMod * pir2 / 2.0);
+    
+    /* Could probably do this in constructor directly, but easier
+     * here since pir2 is already computed
+     */
+    computedInertia.setValue(m_config.density * pir2 / 4.0, 
+                     m_config.density * pir2 / 4.0,
+                     m_config.density * pir2 / 2.0);
+    
+    // Can assume if one element is zero, all elements are zero and we've screwed up
+    // Should pass automatically based on exceptions in config constructor
+    assert(!computedInertia.fuzzyZero());
+    
+    inverseInertia.setValue(1.0/computedInertia[0],
+                            1.0/computedInertia[1],
+                            1.0/computedInertia[2]);
+                      
+}
+
+/**
+ * Each kernel writes only to its own links or segments, so the chunks
+ * are independent. gatherForces is a cheap serial pass in comparison.
+ */
+void CordeModel::computeInternalForces()
+{
+    const long nLinks = (long) linkLengths.size();
+    const long nSegments = (long) quaternionShapes.size();
+    
+    const long linkChunks = (nLinks + kCordeChunkSize - 1) / kCordeChunkSize;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (linkChunks > 1)
+#endif
+    for (long c = 0; c < linkChunks; c++)
+    {
+        const std::size_t begin = c * kCordeChunkSize;
+        computeLinkForces(begin, std::min(begin + kCordeChunkSize,
+                                          (std::size_t) nLinks));
+    }
+    
+    const long segmentChunks = (nSegments + kCordeChunkSize - 1) / kCordeChunkSize;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (segmentChunks > 1)
+#endif
+    for (long c = 0; c < segmentChunks; c++)
+    {
+        const std::size_t begin = c * kCordeChunkSize;
+        computeSegmentTorques(begin, std::min(begin + kCordeChunkSize,
+                                              (std::size_t) nSegments));
+    }
+    
+    gatherForces();
+}
+
+void CordeModel::computeLinkForces(std::size_t begin, std::size_t end)
+{
+    const std::size_t n = linkLengths.size();
+    
+    const btScalar k0 = computedStiffness[0];
+    const btScalar consSpring = m_config.ConsSpringConst;
+    const btScalar gammaT = m_config.gammaT;
+    
+    const btScalar* px = &m_pos.x[0];
+    const btScalar* py = &m_pos.y[0];
+    const btScalar* pz = &m_pos.z[0];
+    const btScalar* vx = &m_vel.x[0];
+    const btScalar* vy = &m_vel.y[0];
+    const btScalar* vz = &m_vel.z[0];
+    
+	for (std::size_t i = begin; i < end; i++)
+    {
+        // Get position elements in standard variable names
+        const btScalar x1 = px[i];
+        const btScalar y1 = py[i];
+        const btScalar z1 = pz[i];
+        
+        const btScalar x2 = px[i + 1];
+        const btScalar y2 = py[i + 1];
+        const btScalar z2 = pz[i + 1];
+        
+        // Same for quaternion elements
+        const btScalar q11 = m_q.x[i];
+        const btScalar q12 = m_q.y[i];
+        const btScalar q13 = m_q.z[i];
+        const btScalar q14 = m_q.w[i];
+        
+        // Setup common factors
+        const btScalar dx = x1 - x2;
+        const btScalar dy = y1 - y2;
+        const btScalar dz = z1 - z2;
+        const btScalar dx2 = dx * dx;
+        const btScalar dy2 = dy * dy;
+        const btScalar dz2 = dz * dz;
+        const btScalar velDot = dx * (vx[i] - vx[i + 1]) +
+                                dy * (vy[i] - vy[i + 1]) +
+                                dz * (vz[i] - vz[i + 1]);
+        const btScalar posNorm_2 = dx2 + dy2 + dz2;
+        const btScalar posNorm   = sqrt(posNorm_2);
+        const btScalar invNorm   = 1.0 / posNorm;
+        
+        const btScalar director0 = 2.0 * (q11 * q13 + q12 * q14);
+        const btScalar director1 = 2.0 * (q12 * q13 - q11 * q14);
+        const btScalar director2 = -1.0 * q11 * q11 - q12 * q12 + q13 * q13 + q14 * q14;
+        
+        const btScalar linkLength = linkLengths[i];
+        
+        // Sum Forces, have to split it out into components due to
+        // derivatives of energy quantaties
+
+        // Spring common
+        const btScalar spring_common = k0 * 
+            (linkLength - posNorm) / (linkLength * posNorm);
+        
+        const btScalar diss_common = gammaT * posNorm_2 * velDot *
+                                     inverseLinkLengths5[i];
+        
+        const btScalar axial = spring_common + diss_common;
+        
+        const btScalar cons_common = consSpring * linkLength *
+                                     invNorm * invNorm * invNorm;
+        
+        /* Quaternion Constraint X */
+        const btScalar quat_cons_x = cons_common *
+        ( director2 * dx * dz - director0 * ( dy2 + dz2 ) + director1 * dx * dy );
+        
+        /* Quaternion Constraint Y */
+        const btScalar quat_cons_y = cons_common *
+        ( -1.0 * director2 * dy * dz + director1 * ( dx2 + dz2 ) - director0 * dx * dz );
+        
+        /* Quaternion Constraint Z */
+        const btScalar quat_cons_z = cons_common *
+        ( -1.0 * director0 * dy * dz + director2 * ( dx2 + dy2 ) - director1 * dx * dz );
+        
+        /* Apply constraint equation with boundry conditions:
+         * the first link only pushes on its second mass point, the last
+         * link only on its first (unless it is also the first link).
+         */
+        const btScalar cons0 = (i == 0) ? 0.0 : 1.0;
+        const btScalar cons1 = (i == 0 || i != n - 1) ? 1.0 : 0.0;
+        
+        m_linkForce0.x[i] = -1.0 * dx * axial - cons0 * quat_cons_x;
+        m_linkForce0.y[i] = -1.0 * dy * axial - cons0 * quat_cons_y;
+        m_linkForce0.z[i] = -1.0 * dz * axial - cons0 * quat_cons_z;
+        
+        m_linkForce1.x[i] = dx * axial + cons1 * quat_cons_x;
+        m_linkForce1.y[i] = dy * axial + cons1 * quat_cons_y;
+        m_linkForce1.z[i] = dz * axial + cons1 * quat_cons_z;
+        
+        /* Torques resulting from quaternion alignment constraints.
+         * q.length2() should always be 1, but sometimes numerical precision
+         * renders it slightly greater. The simulation is much more stable
+         * if we just assume its one.
+         */
+        const btScalar torque_common = 2.0 * consSpring * linkLength;
+        
+        m_linkTorque.x[i] = torque_common * ( q11 + (q13 * dx -
+            q14 * dy - q11 * dz) * invNorm);
+        
+        m_linkTorque.y[i] = torque_common * ( q12 + (q14 * dx +
+            q13 * dy - q12 * dz) * invNorm);
+            
+        m_linkTorque.z[i] = torque_common * ( q13 + (q11 * dx +
+            q12 * dy + q13 * dz) * invNorm);
+            
+        m_linkTorque.w[i] = torque_common * ( q14 + (q12 * dx -
+            q11 * dy + q14 * dz) * invNorm);
+    }
+}
+
+void CordeModel::computeSegmentTorques(std::size_t begin, std::size_t end)
+{
+    const btScalar k1 = computedStiffness[1];
+    const btScalar k2 = computedStiffness[2];
+    const btScalar k3 = computedStiffness[3];
+    const btScalar gammaR = m_config.gammaR;
+    
+	for (std::size_t i = begin; i < end; i++)
+    {
+        /* Setup Variables */
+        const btScalar q11 = m_q.x[i];
+        const btScalar q12 = m_q.y[i];
+        const btScalar q13 = m_q.z[i];
+        const btScalar q14 = m_q.w[i];
+        
+        const btScalar q21 = m_q.x[i + 1];
+        const btScalar q22 = m_q.y[i + 1];
+        const btScalar q23 = m_q.z[i + 1];
+        const btScalar q24 = m_q.w[i + 1];
+        
+        const btScalar qdot11 = m_qdot.x[i];
+        const btScalar qdot12 = m_qdot.y[i];
+        const btScalar qdot13 = m_qdot.z[i];
+        const btScalar qdot14 = m_qdot.w[i];
+        
+        const btScalar qdot21 = m_qdot.x[i + 1];
+        const btScalar qdot22 = m_qdot.y[i + 1];
+        const btScalar qdot23 = m_qdot.z[i + 1];
+        const btScalar qdot24 = m_qdot.w[i + 1];
+        
+        const btScalar shape = quaternionShapes[i];
+        
+        /* I apologize for the mess below - the derivatives involved
+         * here do not leave a lot of common factors. If you see
+         * any nice vector operations I missed, implement them and/or
+         * let me know! _Brian
+         */
+        
+        /* Bending and torsional stiffness */        
+        const btScalar stiffness_common = 4.0 / shape *
+        (shape - 1.0) * (shape - 1.0);
+        
+        const btScalar q11_stiffness = stiffness_common * 
+        (k1 * q24 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
+         k2 * q23 * (q11 * q23 - q12 * q24 - q13 * q21 + q14 * q22) +
+         k3 * q22 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
+         
+        const btScalar q12_stiffness = stiffness_common * 
+        (k1 * q23 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
+         k2 * q24 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
+         k3 * q21 * (q12 * q21 - q11 * q22 - q13 * q24 + q14 * q23));
+         
+        const btScalar q13_stiffness = stiffness_common * 
+        (k1 * q22 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) +
+         k2 * q21 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
+         k3 * q24 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
+         
+        const btScalar q14_stiffness = stiffness_common * 
+        (k1 * q21 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
+         k2 * q22 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
+         k3 * q23 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));   
+        
+        const btScalar q21_stiffness = stiffness_common *
+        (k1 * q14 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
+         k2 * q13 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
+         k3 * q12 * (q12 * q21 - q11 * q22 + q14 * q23 - q13 * q24));
+        
+        const btScalar q22_stiffness = stiffness_common *
+        (k1 * q13 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) + 
+         k2 * q14 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
+         k3 * q11 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
+         
+        const btScalar q23_stiffness = stiffness_common *
+        (k1 * q12 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
+         k2 * q11 * (q11 * q23 - q13 * q21 - q12 * q24 + q14 * q22) +
+         k3 * q14 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));
+         
+        const btScalar q24_stiffness = stiffness_common *
+        (k1 * q11 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
+         k2 * q12 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
+         k3 * q13 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
+         
+        /* Torsional Damping */
+        const btScalar damping_common = 4.0 * gammaR / shape;
+        
+        const btScalar q11_damping = damping_common *
+        (q12 * (q12 * qdot11 - q11 * qdot12 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23) +
+         q13 * (q13 * qdot11 - q11 * qdot13 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22) +
+         q14 * (q14 * qdot11 - q11 * qdot14 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21));
+         
+        const btScalar q12_damping = damping_common *
+        (q11 * (q11 * qdot12 - q12 * qdot11 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23) +
+         q13 * (q13 * qdot12 - q13 * qdot13 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) + 
+         q14 * (q14 * qdot12 - q14 * qdot14 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22));
+         
+        const btScalar q13_damping = damping_common * 
+        (q11 * (q11 * qdot13 - q13 * qdot11 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
+         q12 * (q12 * qdot13 - q13 * qdot12 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21) +
+         q14 * (q14 * qdot13 - q13 * qdot14 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23));
+         
+        const btScalar q14_damping = damping_common *
+        (q11 * (q11 * qdot14 - q14 * qdot11 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) +
+         q12 * (q12 * qdot14 - q14 * qdot12 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
+         q13 * (q13 * qdot14 - q14 * qdot13 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23));
+        
+        const btScalar q21_damping = damping_common *
+        (q22 * (q22 * qdot21 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q21 * qdot22) +
+         q23 * (q23 * qdot21 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q21 * qdot23) +
+         q24 * (q24 * qdot21 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q21 * qdot24));
+         
+        const btScalar q22_damping = damping_common *
+        (q21 * (q21 * qdot22 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q22 * qdot21) +
+         q23 * (q23 * qdot22 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q22 * qdot23) +
+         q24 * (q24 * qdot22 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q22 * qdot24));
+         
+        const btScalar q23_damping = damping_common *
+        (q21 * (q21 * qdot23 - q11 * qdot13 + q13 * qdot11 - q12 * qdot14 + q14 * qdot12 - q23 * qdot21) +
+         q22 * (q22 * qdot23 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q22 * qdot22) +
+         q24 * (q24 * qdot23 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q23 * qdot24));
+         
+        const btScalar q24_damping = damping_common *
+        (q21 * (q21 * qdot24 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q24 * qdot21) +
+         q22 * (q21 * qdot24 - q11 * qdot13 - q12 * qdot14 + q13 * qdot11 + q14 * qdot12 - q24 * qdot22) +
+         q23 * (q23 * qdot24 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q24 * qdot23));
+      
+        /* Store torques */ /// @todo double check the sign convention. Looks good numerically.
+        m_segmentTorque0.x[i] = q11_stiffness + q11_damping;
+        m_segmentTorque0.y[i] = q12_stiffness + q12_damping;
+        m_segmentTorque0.z[i] = q13_stiffness + q13_damping;
+        m_segmentTorque0.w[i] = q14_stiffness + q14_damping;
+        
+        m_segmentTorque1.x[i] = q21_stiffness + q21_damping;
+        m_segmentTorque1.y[i] = q22_stiffness + q22_damping;
+        m_segmentTorque1.z[i] = q23_stiffness + q23_damping;
+        m_segmentTorque1.w[i] = q24_stiffness + q24_damping;
+    }
+}
+
+void CordeModel::gatherForces()
+{
+    const std::size_t nPoints = m_pos.x.size();
+    const std::size_t nLinks = linkLengths.size();
+    const std::size_t nSegments = quaternionShapes.size();
+    
+    // Interior points receive a force from the link on either side
+    m_force.x[0] = m_linkForce0.x[0];
+    m_force.y[0] = m_linkForce0.y[0];
+    m_force.z[0] = m_linkForce0.z[0];
+    for (std::size_t i = 1; i < nLinks; i++)
+    {
+        m_force.x[i] = m_linkForce0.x[i] + m_linkForce1.x[i - 1];
+        m_force.y[i] = m_linkForce0.y[i] + m_linkForce1.y[i - 1];
+        m_force.z[i] = m_linkForce0.z[i] + m_linkForce1.z[i - 1];
+    }
+    m_force.x[nPoints - 1] = m_linkForce1.x[nLinks - 1];
+    m_force.y[nPoints - 1] = m_linkForce1.y[nLinks - 1];
+    m_force.z[nPoints - 1] = m_linkForce1.z[nLinks - 1];
+    
+    // Every centerline has its own link, interior ones two segments
+    for (std::size_t i = 0; i < nLinks; i++)
+    {
+        m_tprime.x[i] = m_linkTorque.x[i];
+        m_tprime.y[i] = m_linkTorque.y[i];
+        m_tprime.z[i] = m_linkTorque.z[i];
+        m_tprime.w[i] = m_linkTorque.w[i];
+    }
+    for (std::size_t i = 0; i < nSegments; i++)
+    {
+        m_tprime.x[i] += m_segmentTorque0.x[i];
+        m_tprime.y[i] += m_segmentTorque0.y[i];
+        m_tprime.z[i] += m_segmentTorque0.z[i];
+        m_tprime.w[i] += m_segmentTorque0.w[i];
+    }
+    for (std::size_t i = 0; i < nSegments; i++)
+    {
+        m_tprime.x[i + 1] += m_segmentTorque1.x[i];
+        m_tprime.y[i + 1] += m_segmentTorque1.y[i];
+        m_tprime.z[i + 1] += m_segmentTorque1.z[i];
+        m_tprime.w[i + 1] += m_segmentTorque1.w[i];
+    }
+}
+
+void CordeModel::unconstrainedMotion(double dt)
+{
+    const std::size_t nPoints = m_pos.x.size();
+    for (std::size_t i = 0; i < nPoints; i++)
+    {
+        // Velocity update - semi-implicit Euler
+        const btScalar scale = dt * m_inverseMass[i];
+        m_vel.x[i] += scale * m_force.x[i];
+        m_vel.y[i] += scale * m_force.y[i];
+        m_vel.z[i] += scale * m_force.z[i];
+        // Position update, uses v(t + dt)
+        m_pos.x[i] += dt * m_vel.x[i];
+        m_pos.y[i] += dt * m_vel.y[i];
+        m_pos.z[i] += dt * m_vel.z[i];
+    }
+    
+    const btScalar I0 = computedInertia[0];
+    const btScalar I1 = computedInertia[1];
+    const btScalar I2 = computedInertia[2];
+    const btScalar invI0 = inverseInertia[0];
+    const btScalar invI1 = inverseInertia[1];
+    const btScalar invI2 = inverseInertia[2];
+    
+    const std::size_t nCenterlines = m_q.x.size();
+    for (std::size_t i = 0; i < nCenterlines; i++)
+    {
+        const btScalar q0 = m_q.x[i];
+        const btScalar q1 = m_q.y[i];
+        const btScalar q2 = m_q.z[i];
+        const btScalar q3 = m_q.w[i];
+        
+        const btScalar t0 = m_tprime.x[i];
+        const btScalar t1 = m_tprime.y[i];
+        const btScalar t2 = m_tprime.z[i];
+        const btScalar t3 = m_tprime.w[i];
+        
+        /* Transpose quaternion torques into Euclidean torques */
+        const btScalar tau0 = 1.0/2.0 * (q0 * t2 - q2 * t0 - q1 * t3 + q3 * t1);
+        const btScalar tau1 = 1.0/2.0 * (q1 * t0 - q0 * t1 - q2 * t3 + q3 * t2);
+        const btScalar tau2 = 1.0/2.0 * (q0 * t0 + q1 * t1 + q2 * t2 + q3 * t3);
+        m_torques.x[i] = tau0;
+        m_torques.y[i] = tau1;
+        m_torques.z[i] = tau2;
+        
+        // Since I is diagonal, we can use elementwise multiplication of vectors
+        const btScalar w0 = m_omega.x[i];
+        const btScalar w1 = m_omega.y[i];
+        const btScalar w2 = m_omega.z[i];
+        const btScalar cross0 = w1 * I2 * w2 - w2 * I1 * w1;
+        const btScalar cross1 = w2 * I0 * w0 - w0 * I2 * w2;
+        const btScalar cross2 = w0 * I1 * w1 - w1 * I0 * w0;
+        
+        const btScalar o0 = w0 + invI0 * (tau0 - cross0) * dt;
+        const btScalar o1 = w1 + invI1 * (tau1 - cross1) * dt;
+        const btScalar o2 = w2 + invI2 * (tau2 - cross2) * dt;
+        m_omega.x[i] = o0;
+        m_omega.y[i] = o1;
+        m_omega.z[i] = o2;
+        
+        // Must be computed after omega is updated
+        const btScalar qd0 = 1.0/2.0 * (q0 * o2 + q1 * o1 - q2 * o0);
+        const btScalar qd1 = 1.0/2.0 * (q1 * o2 - q0 * o1 + q3 * o0);
+        const btScalar qd2 = 1.0/2.0 * (q0 * o0 + q2 * o2 + q3 * o1);
+        const btScalar qd3 = 1.0/2.0 * (q3 * o2 - q2 * o1 - q1 * o0);
+        m_qdot.x[i] = qd0;
+        m_qdot.y[i] = qd1;
+        m_qdot.z[i] = qd2;
+        m_qdot.w[i] = qd3;
+        
+        const btScalar n0 = q0 + qd0 * dt;
+        const btScalar n1 = q1 + qd1 * dt;
+        const btScalar n2 = q2 + qd2 * dt;
+        const btScalar n3 = q3 + qd3 * dt;
+        const btScalar invLength = 1.0 / sqrt(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+        m_q.x[i] = n0 * invLength;
+        m_q.y[i] = n1 * invLength;
+        m_q.z[i] = n2 * invLength;
+        m_q.w[i] = n3 * invLength;
+    }
+}
+
+void CordeModel::CordeVectorBuffer::resize(std::size_t n)
+{
+    x.assign(n, 0.0);
+    y.assign(n, 0.0);
+    z.assign(n, 0.0);
+}
+
+btVector3 CordeModel::CordeVectorBuffer::get(std::size_t i) const
+{
+    return btVector3(x[i], y[i], z[i]);
+}
+
+void CordeModel::CordeVectorBuffer::set(std::size_t i, const btVector3& v)
+{
+    x[i] = v[0];
+    y[i] = v[1];
+    z[i] = v[2];
+}
+
+void CordeModel::CordeQuaternionBuffer::resize(std::size_t n)
+{
+    x.assign(n, 0.0);
+    y.assign(n, 0.0);
+    z.assign(n, 0.0);
+    w.assign(n, 0.0);
+}
+
+btQuaternion CordeModel::CordeQuaternionBuffer::get(std::size_t i) const
+{
+    return btQuaternion(x[i], y[i], z[i], w[i]);
+}
+
+void CordeModel::CordeQuaternionBuffer::set(std::size_t i, const btQuaternion& q)
+{
+    x[i] = q[0];
+    y[i] = q[1];
+    z[i] = q[2];
+    w[i] = q[3];
+}
+
+/// Checks lengths of vectors. @todo add additional invariants
+bool CordeModel::invariant() const
+{
+    const std::size_t nPoints = m_pos.x.size();
+    const std::size_t nCenterlines = m_q.x.size();
+    return (nPoints == nCenterlines + 1)
+        && (m_vel.x.size() == nPoints)
+        && (m_force.x.size() == nPoints)
+        && (m_inverseMass.size() == nPoints)
+        && (nCenterlines == linkLengths.size())
+        && (inverseLinkLengths5.size() == linkLengths.size())
+        && (linkLengths.size() == quaternionShapes.size() + 1)
+        && (m_segmentTorque0.x.size() == quaternionShapes.size())
+        && (computedStiffness.size() == 4);
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef CORDE_MODEL
+#define CORDE_MODEL
+
+/**
+ * @file CordeModel.h
+ * @brief Defines structure for the Corde softbody String Model
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// Bullet Linear Algebra
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btQuaternion.h"
+
+// The C++ Standard Library
+#include <vector>
+
+/**
+ * A Cosserat rod (Corde) model of a string, after Spillman and Teschner.
+ * The string is a chain of mass points connected by links, with one
+ * centerline quaternion per link.
+ *
+ * The state is stored as a structure of arrays (one contiguous buffer
+ * per component) so the internal force kernels can be vectorized by the
+ * compiler. Each kernel only writes to the element it is evaluating,
+ * contributions to neighbors are gathered in a second pass, so ranges of
+ * links and segments can be evaluated in parallel when the library is
+ * built with USE_OPENMP.
+ */
+class CordeModel
+{
+public:
+	struct Config
+	{
+		Config(const std::size_t res,
+				const double r, const double d,
+				const double ym, const double shm,
+				const double stm, const double csc,
+				const double gt, const double gr);
+
+		const std::size_t resolution;
+		const double radius;
+		const double density;
+		const double YoungMod;
+		const double ShearMod;
+		const double StretchMod;
+		const double ConsSpringConst;
+		/**
+		 * For really short segments (< .001 length) consider decreasing
+		 * these further or changing length to cubic (currently ^5)
+		 */
+		const double gammaT;
+		const double gammaR;
+	};
+
+	/**
+	 * A constructor which assumes uniformally distributed mass
+	 * points and rotation
+	 * pos1 and pos2 specify the start and end points of the rod.
+	 * quat1 and quat2 need to be computed based on the torsion in the rod.
+	 * Note that if there is neither bending nor torsion one can say quat1 = quat2
+	 * = btQuaternion((pos2 - pos1).normalize, 0) (axis-angle constructor)
+	 * @todo develop a constructor that can handle more complex shapes
+	 * i.e. wrapped around a motor. This one maxes out at 1 - eps rotations
+	 */
+	CordeModel(btVector3 pos1, btVector3 pos2, btQuaternion quat1, btQuaternion quat2, const CordeModel::Config& Config);
+
+	~CordeModel();
+
+	void step (btScalar dt);
+
+	/** The number of mass points, equal to config.resolution */
+	std::size_t getNumMassPoints() const;
+
+	/** The number of centerline quaternions, one fewer than mass points */
+	std::size_t getNumCenterlines() const;
+
+	btVector3 getPosition(std::size_t i) const;
+
+	btVector3 getVelocity(std::size_t i) const;
+
+	btVector3 getForce(std::size_t i) const;
+
+	btQuaternion getQuaternion(std::size_t i) const;
+
+private:
+	void computeConstants();
+
+	void computeInternalForces();
+
+	/**
+	 * Stretch, dissipation and alignment constraint terms for links
+	 * [begin, end). Results are written to the per link buffers only.
+	 */
+	void computeLinkForces(std::size_t begin, std::size_t end);
+
+	/**
+	 * Bending, torsion and rotational damping terms between adjacent
+	 * centerlines [begin, end). Results are written to the per segment
+	 * buffers only.
+	 */
+	void computeSegmentTorques(std::size_t begin, std::size_t end);
+
+	/**
+	 * Sums the per link and per segment contributions onto the mass
+	 * points and centerlines.
+	 */
+	void gatherForces();
+
+	void unconstrainedMotion(double dt);
+
+	/**
+	 * Contiguous x, y, z buffers for per element vector quantities
+	 */
+	struct CordeVectorBuffer
+	{
+		void resize(std::size_t n);
+
+		btVector3 get(std::size_t i) const;
+
+		void set(std::size_t i, const btVector3& v);
+
+		std::vector<btScalar> x;
+		std::vector<btScalar> y;
+		std::vector<btScalar> z;
+	};
+
+	/**
+	 * Contiguous x, y, z, w buffers for per element quaternion quantities.
+	 * Indices match btQuaternion's operator[], so q[0] is x and q[3] is w.
+	 */
+	struct CordeQuaternionBuffer
+	{
+		void resize(std::size_t n);
+
+		btQuaternion get(std::size_t i) const;
+
+		void set(std::size_t i, const btQuaternion& q);
+
+		std::vector<btScalar> x;
+		std::vector<btScalar> y;
+		std::vector<btScalar> z;
+		std::vector<btScalar> w;
+	};
+
+	CordeModel::Config m_config;
+
+	/**
+	 * Mass point state, length config.resolution
+	 */
+	CordeVectorBuffer m_pos;
+	CordeVectorBuffer m_vel;
+	CordeVectorBuffer m_force;
+	std::vector<btScalar> m_inverseMass;
+
+	/**
+	 * Centerline state, length config.resolution - 1
+	 */
+	CordeQuaternionBuffer m_q;
+	CordeQuaternionBuffer m_qdot;
+	/**
+	 * Just a 4x1 vector per centerline, but easier to store this way.
+	 */
+	CordeQuaternionBuffer m_tprime;
+	CordeVectorBuffer m_torques;
+	CordeVectorBuffer m_omega;
+
+	/**
+	 * Scratch space for computeLinkForces, one entry per link.
+	 * m_linkForce0 acts on the first mass point of the link,
+	 * m_linkForce1 on the second. m_linkTorque acts on the link's
+	 * centerline.
+	 */
+	CordeVectorBuffer m_linkForce0;
+	CordeVectorBuffer m_linkForce1;
+	CordeQuaternionBuffer m_linkTorque;
+
+	/**
+	 * Scratch space for computeSegmentTorques, one entry per pair of
+	 * adjacent centerlines
+	 */
+	CordeQuaternionBuffer m_segmentTorque0;
+	CordeQuaternionBuffer m_segmentTorque1;
+
+	/**
+	 * Should have length equal to the number of mass points - 1
+	 */
+	std::vector<double> linkLengths;
+	/**
+	 * 1.0 / linkLengths^5, used by the dissipation term
+	 */
+	std::vector<double> inverseLinkLengths5;
+	/**
+	 * Should have length equal to the number of centerlines - 1
+	 */
+	std::vector<double> quaternionShapes;
+
+	/**
+	 * Computed based on the values in config. Should have length 4
+	 * 0: linear stiffness used by mass models
+	 * 1 - 3: bending and torsion stiffnesses
+	 * @todo can this be const?
+	 */
+	std::vector<double> computedStiffness;
+
+	/**
+	 * Computed based on the values in config. Should have length 3
+	 * Assuming products of inertia are negligible as in the paper
+	 */
+	btVector3 computedInertia;
+	btVector3 inverseInertia;
+
+	bool invariant() const;
+};
+
+
+#endif // CORDE_MODEL
@@ -42,6 +42,7 @@
 
 // OpenGL_FreeGlut (patched Bullet)
 #include "tgGLDebugDrawer.h"
+#include "tgGlutStuff.h"
 // The Bullet Physics library
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 // The C++ Standard Library
@@ -65,34 +66,27 @@ void tgBulletRenderer::render(const tgSpringCableActuator& mSCA) const
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("tgBulletRenderer::renderString");
 #endif //BT_NO_PROFILE 
-        // Fetch the btDynamicsWorld
-        btDynamicsWorld& dynamicsWorld =
-      tgBulletUtil::worldToDynamicsWorld(m_world);
-
-    btIDebugDraw* const pDrawer = dynamicsWorld.getDebugDrawer();
-    
+    // The lines go to our own batch, so no debug drawer is needed
     const tgSpringCable* const pSpringCable = mSCA.getSpringCable();
     
-    if(pDrawer && pSpringCable)
+    if(pSpringCable)
     {
 		const std::vector<const tgSpringCableAnchor*>& anchors = pSpringCable->getAnchors();
-		std::size_t n = anchors.size() - 1;
-		for (std::size_t i = 0; i < n; i++)
-		{
-			const btVector3 lineFrom =
-			anchors[i]->getWorldPosition();
-		  const btVector3 lineTo = 
-			anchors[i+1]->getWorldPosition();
-		   // Should this be normalized??
-		  const double stretch = 
+		// Should this be normalized??
+		const double stretch = 
 			mSCA.getCurrentLength() - mSCA.getRestLength();
-		  const btVector3 color =
+		const btVector3 color =
 			(stretch < 0.0) ?
 			btVector3(0.0, 0.0, 1.0) :
 			btVector3(0.5 + stretch / 3.0, 
 				  0.5 - stretch / 2.0, 
 				  0.0);
-		  pDrawer->drawLine(lineFrom, lineTo, color);
+		std::size_t n = anchors.size() - 1;
+		for (std::size_t i = 0; i < n; i++)
+		{
+		  addLine(anchors[i]->getWorldPosition(),
+			  anchors[i+1]->getWorldPosition(),
+			  color);
 		}
 	}
 }
@@ -106,15 +100,10 @@ void tgBulletRenderer::render(const tgCompressionSpringActuator& mCSA) const
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("tgBulletRenderer::renderCompressionSpring");
 #endif //BT_NO_PROFILE 
-    // Fetch the btDynamicsWorld
-    btDynamicsWorld& dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(m_world);
-
-    btIDebugDraw* const pDrawer = dynamicsWorld.getDebugDrawer();
-    
     const tgBulletCompressionSpring* const pCompressionSpring =
       mCSA.getCompressionSpring();
     
-    if(pDrawer && pCompressionSpring)
+    if(pCompressionSpring)
     {
 		const std::vector<const tgSpringCableAnchor*>& anchors =
 		  pCompressionSpring->getAnchors();
@@ -171,7 +160,7 @@ void tgBulletRenderer::render(const tgCompressionSpringActuator& mCSA) const
 		      btVector3(0.0, 1.0, 0.0);
 		  }
 		  // Draw the string, now that color has been set.
-		  pDrawer->drawLine(springStartLoc, springEndLoc, color);
+		  addLine(springStartLoc, springEndLoc, color);
 		}
 	}
 }
@@ -188,10 +177,47 @@ void tgBulletRenderer::render(const tgModel& model) const
 	// Fetch the btDynamicsWorld
 	btDynamicsWorld& dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(m_world);
 	btIDebugDraw* const idraw = dynamicsWorld.getDebugDrawer();
-	for(int j=0;j<model.getMarkers().size() ;j++)
+	// There is no debug drawer when rendering offscreen
+	for(int j=0;idraw && j<model.getMarkers().size() ;j++)
 	{
 		abstractMarker mark = model.getMarkers()[j];
 		idraw->drawSphere(mark.getWorldPosition(),0.6,mark.getColor());
 	}
 }
 
+void tgBulletRenderer::flush() const
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgBulletRenderer::flush");
+#endif //BT_NO_PROFILE 
+    if (!m_lines.empty())
+    {
+        // Interleaved x, y, z, r, g, b
+        const GLsizei stride = 6 * sizeof(float);
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(3, GL_FLOAT, stride, &m_lines[0]);
+        glColorPointer(3, GL_FLOAT, stride, &m_lines[3]);
+        glDrawArrays(GL_LINES, 0, m_lines.size() / 6);
+        glPopClientAttrib();
+        // Keeps the capacity for the next frame
+        m_lines.clear();
+    }
+}
+
+void tgBulletRenderer::addLine(const btVector3& from,
+                               const btVector3& to,
+                               const btVector3& color) const
+{
+    const btVector3* const ends[2] = { &from, &to };
+    for (int k = 0; k < 2; k++)
+    {
+        m_lines.push_back(ends[k]->x());
+        m_lines.push_back(ends[k]->y());
+        m_lines.push_back(ends[k]->z());
+        m_lines.push_back(color.x());
+        m_lines.push_back(color.y());
+        m_lines.push_back(color.z());
+    }
+}
@@ -28,8 +28,11 @@
 
 // This application
 #include "tgModelVisitor.h"
+// The C++ Standard Library
+#include <vector>
 
 // Forward declarations
+class btVector3;
 class tgSpringCableActuator;
 class tgCompressionSpringActuator;
 class tgModel;
@@ -38,6 +41,8 @@ class tgWorld;
 
 /**
  * A concrete tgRenderer for Bullet Physics.
+ * Cables and springs are gathered into one vertex array while the models
+ * are visited, and drawn by flush() in a single call.
  */
 class tgBulletRenderer : public tgModelVisitor
 {
@@ -73,12 +78,38 @@ public:
    */
   virtual void render(const tgModel& model) const;
 
+  /**
+   * Draw the lines gathered since the last flush, and clear them. Call
+   * once per frame, after visiting the models.
+   */
+  void flush() const;
+
+  /**
+   * The lines gathered since the last flush, two vertices of x, y, z,
+   * r, g, b each, for drawing them some other way.
+   */
+  const std::vector<float>& getLines() const { return m_lines; }
+
+  /** Forget the gathered lines without drawing them */
+  void clearLines() const { m_lines.clear(); }
+
 private:
 
+  /** Add a line to the batch */
+  void addLine(const btVector3& from,
+               const btVector3& to,
+               const btVector3& color) const;
+
   /**
    * A reference to the tgWorld being rendered.
    */
   const tgWorld& m_world;
+
+  /**
+   * The lines to draw, two vertices of x, y, z, r, g, b each. Kept
+   * between frames so that its storage is reused.
+   */
+  mutable std::vector<float> m_lines;
 };
 
 #endif
@@ -0,0 +1,217 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgComponentRegistry.cpp
+ * @brief Contains the definitions of members of class tgComponentRegistry
+ * $Id$
+ */
+
+// This module
+#include "tgComponentRegistry.h"
+// This application
+#include "tgBaseRigid.h"
+#include "tgCompressionSpringActuator.h"
+#include "tgModel.h"
+#include "tgSpringCableActuator.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+
+tgComponentRegistry::tgComponentRegistry() :
+    m_removed(0)
+{
+}
+
+tgComponentRegistry::~tgComponentRegistry()
+{
+    for (std::size_t i = 0; i < m_actuators.size(); i++)
+    {
+        detach(m_actuators[i]);
+    }
+    for (std::size_t i = 0; i < m_compressionSprings.size(); i++)
+    {
+        detach(m_compressionSprings[i]);
+    }
+    for (std::size_t i = 0; i < m_rigids.size(); i++)
+    {
+        detach(m_rigids[i]);
+    }
+}
+
+void tgComponentRegistry::add(tgModel* pModel)
+{
+    if (pModel == NULL)
+    {
+        throw std::invalid_argument("pModel is NULL");
+    }
+    else if (pModel->m_pRegistry != NULL)
+    {
+        // Set up again, or already in another world
+        return;
+    }
+
+    // Setup is the only time we look at the type
+    if (tgSpringCableActuator* const pActuator =
+        dynamic_cast<tgSpringCableActuator*>(pModel))
+    {
+        append(m_actuators, pActuator, eActuator);
+    }
+    else if (tgCompressionSpringActuator* const pSpring =
+             dynamic_cast<tgCompressionSpringActuator*>(pModel))
+    {
+        append(m_compressionSprings, pSpring, eCompressionSpring);
+    }
+    else if (tgBaseRigid* const pRigid = dynamic_cast<tgBaseRigid*>(pModel))
+    {
+        append(m_rigids, pRigid, eRigid);
+    }
+}
+
+template <typename T>
+void tgComponentRegistry::append(std::vector<T*>& list, T* pComponent,
+                                 Kind kind)
+{
+    tgModel* const pModel = pComponent;
+    pModel->m_pRegistry = this;
+    pModel->m_registryKind = kind;
+    pModel->m_registrySlot = list.size();
+    list.push_back(pComponent);
+}
+
+void tgComponentRegistry::remove(tgModel* pModel)
+{
+    if (pModel == NULL || pModel->m_pRegistry != this)
+    {
+        return;
+    }
+
+    // The model may be part way through its destructor, so find its entry
+    // by the kind and slot it stored rather than by its type
+    const std::size_t slot = pModel->m_registrySlot;
+    switch (pModel->m_registryKind)
+    {
+    case eActuator:
+        assert(slot < m_actuators.size());
+        m_actuators[slot] = NULL;
+        break;
+    case eCompressionSpring:
+        assert(slot < m_compressionSprings.size());
+        m_compressionSprings[slot] = NULL;
+        break;
+    case eRigid:
+        assert(slot < m_rigids.size());
+        m_rigids[slot] = NULL;
+        break;
+    default:
+        assert(false);
+    }
+    ++m_removed;
+    detach(pModel);
+}
+
+void tgComponentRegistry::step(double dt)
+{
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("dt is not positive");
+    }
+    compact();
+
+    const std::size_t nActuators = m_actuators.size();
+    for (std::size_t i = 0; i < nActuators; i++)
+    {
+        // An actuator may tear down another while we step
+        if (m_actuators[i] != NULL)
+        {
+            m_actuators[i]->step(dt);
+        }
+    }
+
+    const std::size_t nSprings = m_compressionSprings.size();
+    for (std::size_t i = 0; i < nSprings; i++)
+    {
+        if (m_compressionSprings[i] != NULL)
+        {
+            m_compressionSprings[i]->step(dt);
+        }
+    }
+}
+
+const std::vector<tgSpringCableActuator*>&
+tgComponentRegistry::getActuators() const
+{
+    compact();
+    return m_actuators;
+}
+
+const std::vector<tgCompressionSpringActuator*>&
+tgComponentRegistry::getCompressionSprings() const
+{
+    compact();
+    return m_compressionSprings;
+}
+
+const std::vector<tgBaseRigid*>& tgComponentRegistry::getRigids() const
+{
+    compact();
+    return m_rigids;
+}
+
+std::size_t tgComponentRegistry::size() const
+{
+    return m_actuators.size() + m_compressionSprings.size() +
+        m_rigids.size() - m_removed;
+}
+
+void tgComponentRegistry::compact() const
+{
+    if (m_removed != 0)
+    {
+        compactList(m_actuators);
+        compactList(m_compressionSprings);
+        compactList(m_rigids);
+        m_removed = 0;
+    }
+}
+
+template <typename T>
+void tgComponentRegistry::compactList(std::vector<T*>& list) const
+{
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < list.size(); i++)
+    {
+        if (list[i] != NULL)
+        {
+            tgModel* const pModel = list[i];
+            pModel->m_registrySlot = n;
+            list[n++] = list[i];
+        }
+    }
+    list.resize(n);
+}
+
+void tgComponentRegistry::detach(tgModel* pModel)
+{
+    if (pModel != NULL)
+    {
+        pModel->m_pRegistry = NULL;
+        pModel->m_registryKind = eNone;
+        pModel->m_registrySlot = 0;
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_COMPONENT_REGISTRY_H
+#define TG_COMPONENT_REGISTRY_H
+
+/**
+ * @file tgComponentRegistry.h
+ * @brief Contains the definition of class tgComponentRegistry
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgBaseRigid;
+class tgCompressionSpringActuator;
+class tgModel;
+class tgSpringCableActuator;
+
+/**
+ * Flat lists, one per type, of the actuators and rigid bodies set up in a
+ * tgWorld. tgModel::setup() adds a model of one of these types to its
+ * world's registry and teardown() removes it, so the lists hold exactly
+ * the components in the world, in the order they were set up.
+ *
+ * A model in the registry is not stepped by its parent. tgSimulation
+ * steps the models first, so controllers see the state the world just
+ * computed and set their targets, then calls step() here, which steps
+ * the spring cable actuators and then the compression springs from their
+ * lists. Rigid bodies do nothing in step(), so they are listed but not
+ * stepped; a subclass of tgBaseRigid must not count on step() being
+ * called.
+ */
+class tgComponentRegistry
+{
+public:
+
+    tgComponentRegistry();
+
+    /** Detach the models still listed, which are then stepped by their parents */
+    ~tgComponentRegistry();
+
+    /**
+     * Add a model if it is of a listed type and not already in a registry.
+     * @param[in] pModel the model being set up
+     * @throw std::invalid_argument if pModel is NULL
+     */
+    void add(tgModel* pModel);
+
+    /**
+     * Remove a model, if it is in this registry. Safe to call from the
+     * model's destructor.
+     */
+    void remove(tgModel* pModel);
+
+    /**
+     * Step the spring cable actuators, then the compression springs.
+     * @param[in] dt the time step, which must be positive
+     * @throw std::invalid_argument if dt is not positive
+     */
+    void step(double dt);
+
+    /** The spring cable actuators, in the order they were set up */
+    const std::vector<tgSpringCableActuator*>& getActuators() const;
+
+    /** The compression spring actuators, in the order they were set up */
+    const std::vector<tgCompressionSpringActuator*>& getCompressionSprings() const;
+
+    /** The rigid bodies, in the order they were set up */
+    const std::vector<tgBaseRigid*>& getRigids() const;
+
+    /** The number of models listed */
+    std::size_t size() const;
+
+private:
+
+    /** Not copyable: listed models point back to us */
+    tgComponentRegistry(const tgComponentRegistry&);
+    tgComponentRegistry& operator=(const tgComponentRegistry&);
+
+    /** The list a model is in, stored in the model */
+    enum Kind
+    {
+        eNone,
+        eActuator,
+        eCompressionSpring,
+        eRigid
+    };
+
+    /**
+     * Remove the gaps left by remove(), keeping the order, and update the
+     * slots stored in the models.
+     */
+    void compact() const;
+
+    template <typename T>
+    void append(std::vector<T*>& list, T* pComponent, Kind kind);
+
+    template <typename T>
+    void compactList(std::vector<T*>& list) const;
+
+    static void detach(tgModel* pModel);
+
+    /** Entries of removed models are NULL until compact() */
+    mutable std::vector<tgSpringCableActuator*> m_actuators;
+
+    mutable std::vector<tgCompressionSpringActuator*> m_compressionSprings;
+
+    mutable std::vector<tgBaseRigid*> m_rigids;
+
+    /** The number of NULL entries in the lists */
+    mutable std::size_t m_removed;
+};
+
+#endif // TG_COMPONENT_REGISTRY_H
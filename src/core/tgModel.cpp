@@ -25,25 +25,42 @@
 // This module
 #include "tgModel.h"
 // This application
+#include "tgComponentRegistry.h"
 #include "tgModelVisitor.h"
+#include "tgWorld.h"
 #include "abstractMarker.h"
 // The C++ Standard Library
 #include <stdexcept>
 
-tgModel::tgModel()
+tgModel::tgModel() :
+  m_pParent(NULL),
+  m_indexValid(false),
+  m_pRegistry(NULL),
+  m_registryKind(0),
+  m_registrySlot(0)
 {
   // Postcondition
   assert(invariant());
 }
 
 tgModel::tgModel(const tgTags& tags) :
-        tgTaggable(tags)
+        tgTaggable(tags),
+        m_pParent(NULL),
+        m_indexValid(false),
+        m_pRegistry(NULL),
+        m_registryKind(0),
+        m_registrySlot(0)
 {
   assert(invariant());
 }
 
 tgModel::~tgModel()
 {
+  // In case we're deleted without a teardown
+  if (m_pRegistry != NULL)
+  {
+    m_pRegistry->remove(this);
+  }
   const size_t n = m_children.size();
   for (size_t i = 0; i < n; ++i)
   {
@@ -56,6 +73,9 @@ tgModel::~tgModel()
 
 void tgModel::setup(tgWorld& world)
 {
+  // Before the children, so the registry is in depth first order
+  world.components().add(this);
+
   for (std::size_t i = 0; i < m_children.size(); i++)
   {
     m_children[i]->setup(world);
@@ -67,12 +87,17 @@ void tgModel::setup(tgWorld& world)
 
 void tgModel::teardown()
 {
+  if (m_pRegistry != NULL)
+  {
+    m_pRegistry->remove(this);
+  }
   for (std::size_t i = 0; i < m_children.size(); i++)
   {
     m_children[i]->teardown();
     delete m_children[i];
   }
   m_children.clear();
+  invalidateIndex();
   //Clear the markers
   this->m_markers.clear();
 
@@ -96,7 +121,11 @@ void tgModel::step(double dt)
     {
       tgModel* const pChild = m_children[i];
       assert(pChild != NULL);
-      pChild->step(dt);
+      // The world's registry steps its components
+      if (pChild->m_pRegistry == NULL)
+      {
+        pChild->step(dt);
+      }
     }
   }
 
@@ -130,23 +159,31 @@ void tgModel::addChild(tgModel* pChild)
   {
     throw std::invalid_argument("child is this object");
   } 
+  else if (pChild->m_pParent != NULL)
+  {
+    // Whether it is our descendant or another tree's, it has an owner
+    throw std::invalid_argument("child already has a parent");
+  }
   else 
   {
-    const std::vector<tgModel*> descendants = getDescendants();
-    if (std::find(descendants.begin(), descendants.end(), pChild) !=
-    descendants.end())
+    // A child without a parent is a root, so only a cycle is left to check
+    for (const tgModel* p = m_pParent; p != NULL; p = p->m_pParent)
     {
-      throw std::invalid_argument("child is already a descendant");
+      if (p == pChild)
+      {
+        throw std::invalid_argument("child is an ancestor of this object");
+      }
     }
   }
 
   m_children.push_back(pChild);
+  pChild->m_pParent = this;
+  invalidateIndex();
 
   // Postcondition
   assert(invariant());
   assert(!m_children.empty());
-  assert(std::find(m_children.begin(), m_children.end(), pChild) !=
-     m_children.end());
+  assert(m_children.back() == pChild);
 }
 
 std::string tgModel::toString(std::string prefix) const
@@ -163,13 +200,20 @@ std::string tgModel::toString(std::string prefix) const
   return os.str();
 }
 
-/**
- * @todo Unnecessary copying can be avoided by pasing the result
- * collection in the recursive step.
- */
-std::vector<tgModel*> tgModel::getDescendants() const
+const std::vector<tgModel*>& tgModel::getDescendants() const
+{
+  if (!m_indexValid)
+  {
+    m_descendants.clear();
+    m_typeIndex.clear();
+    collectDescendants(m_descendants);
+    m_indexValid = true;
+  }
+  return m_descendants;
+}
+
+void tgModel::collectDescendants(std::vector<tgModel*>& result) const
 {
-  std::vector<tgModel*> result;
   const size_t n = m_children.size();
   for (std::size_t i = 0; i < n; i++)
   {
@@ -177,10 +221,17 @@ std::vector<tgModel*> tgModel::getDescendants() const
     assert(pChild != NULL);
     result.push_back(pChild);
     // Recursion
-    const std::vector<tgModel*> cd = pChild->getDescendants();
-    result.insert(result.end(), cd.begin(), cd.end());
+    pChild->collectDescendants(result);
+  }
+}
+
+void tgModel::invalidateIndex()
+{
+  // Ancestors may have built their caches after ours, so go all the way up
+  for (tgModel* p = this; p != NULL; p = p->m_pParent)
+  {
+    p->m_indexValid = false;
   }
-  return result;
 }
 
 /**
@@ -190,14 +241,10 @@ std::vector<tgModel*> tgModel::getDescendants() const
  */
 std::vector<tgSenseable*> tgModel::getSenseableDescendants() const
 {
-  // TO-DO: why can't we just return the results of getDescendants?
-  // There seems to be some polymorphism issue here...
-  std::vector<tgModel*> myDescendants = getDescendants();
-  std::vector<tgSenseable*> mySenseableDescendants;
-  for (size_t i=0; i < myDescendants.size(); i++) {
-    mySenseableDescendants.push_back(myDescendants[i]);
-  }
-  return mySenseableDescendants;
+  // A vector of tgModel* doesn't convert to one of tgSenseable*, but the
+  // elements do
+  const std::vector<tgModel*>& myDescendants = getDescendants();
+  return std::vector<tgSenseable*>(myDescendants.begin(), myDescendants.end());
 }
 
 const std::vector<abstractMarker>& tgModel::getMarkers() const {
@@ -33,9 +33,12 @@
 #include "tgSenseable.h"
 // The C++ Standard Library
 #include <iostream>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 // Forward declarations
+class tgComponentRegistry;
 class tgModelVisitor;
 class tgWorld;
 class abstractMarker;
@@ -73,18 +76,21 @@ public:
      * Setup takes a tgWorld and passes it to any children for their
      * own setup functions. All subclasses should call this at the 
      * appropriate time (usually end of setup) within their own
-     * setup function.
+     * setup function. Actuators and rigid bodies are also added to the
+     * world's tgComponentRegistry, which steps them instead of their
+     * parent.
      * @param[in] world - the tgWorld the models will exist in.
      */
     virtual void setup(tgWorld& world);
     
     /**
-     * Deletes the children (undoes setup)
+     * Deletes the children and leaves the world's registry (undoes setup)
      */
     virtual void teardown();
 
     /**
-    * Advance the simulation.
+    * Advance the simulation. Children in a tgComponentRegistry are
+    * skipped; tgSimulation steps them after the models.
     * @param[in] dt the number of seconds since the previous call;
     * std::invalid_argument is thrown if dt is not positive
     * @throw std::invalid_argument if dt is not positive
@@ -103,11 +109,19 @@ public:
     * The model takes ownership of the child sub-model and is responsible for
     * deallocating it.
     * @param[in,out] pChild a pointer to a sub-model
-    * @throw std::invalid_argument is pChild is NULL, this object, or already
-    * a descendant
-    * @todo Make sure that every child appears no more than once in the tree.
+    * @throw std::invalid_argument is pChild is NULL, this object, already
+    * has a parent, or is an ancestor of this object
     */
     void addChild(tgModel* pChild);
+
+    /**
+     * The model this one was added to with addChild().
+     * @return NULL for a root model
+     */
+    tgModel* getParent() const
+    {
+        return m_pParent;
+    }
 	
 	/**
 	 * Returns the tag names of this model and its children
@@ -127,7 +141,16 @@ public:
     template <typename T>
     std::vector<T*> find(const tgTagSearch& tagSearch)
     {
-        return tgCast::find<tgModel, T>(tagSearch, getDescendants());
+        const TypedDescendants& candidates = getTypedDescendants<T>();
+        std::vector<T*> result;
+        for (std::size_t i = 0; i < candidates.size(); i++)
+        {
+            if (tagSearch.matches(*candidates[i].first))
+            {
+                result.push_back(static_cast<T*>(candidates[i].second));
+            }
+        }
+        return result;
     }
 	
 	/**
@@ -140,16 +163,17 @@ public:
     template <typename T>
     std::vector<T*> find(const std::string& tagSearch)
     {
-        return tgCast::find<tgModel, T>(tgTagSearch(tagSearch), getDescendants());
+        return find<T>(tgTagSearch(tagSearch));
     }
 
     /**
-     * Return a std::vector of const pointers to all sub-models.
-     * @todo examine whether this should be public, and perhaps create
-     * a read only version
-     * @return a std::vector of const pointers all sub-models.
+     * Return a std::vector of pointers to all sub-models, depth first.
+     * The vector is cached, and rebuilt only after a child is added to or
+     * torn down from this model or one of its descendants.
+     * @return a std::vector of pointers to all sub-models, valid until
+     * the tree changes
      */
-    std::vector<tgModel*> getDescendants() const;
+    const std::vector<tgModel*>& getDescendants() const;
 
     const std::vector<abstractMarker>& getMarkers() const;
 
@@ -165,6 +189,48 @@ public:
 
 private:
 
+    friend class tgComponentRegistry;
+
+    /** Pairs of a descendant and its T* (as void*), for find<T>() */
+    typedef std::vector<std::pair<tgModel*, void*> > TypedDescendants;
+
+    /**
+     * The descendants that are a T, cached with the descendants so each
+     * type is dynamic_cast once per change to the tree. Matching tags
+     * is left to the query: tags can change after a model is added.
+     */
+    template <typename T>
+    const TypedDescendants& getTypedDescendants() const
+    {
+        const std::vector<tgModel*>& descendants = getDescendants();
+        const std::type_info& type = typeid(T);
+        for (std::size_t i = 0; i < m_typeIndex.size(); i++)
+        {
+            if (*m_typeIndex[i].first == type)
+            {
+                return m_typeIndex[i].second;
+            }
+        }
+        m_typeIndex.push_back(std::make_pair(&type, TypedDescendants()));
+        TypedDescendants& result = m_typeIndex.back().second;
+        for (std::size_t i = 0; i < descendants.size(); i++)
+        {
+            T* const pT = dynamic_cast<T*>(descendants[i]);
+            if (pT != NULL)
+            {
+                result.push_back(std::make_pair(descendants[i],
+                                                static_cast<void*>(pT)));
+            }
+        }
+        return result;
+    }
+
+    /** Mark the caches of this model and its ancestors stale */
+    void invalidateIndex();
+
+    /** Append the descendants, depth first */
+    void collectDescendants(std::vector<tgModel*>& result) const;
+
     /** Integrity predicate. */
     bool invariant() const;
 
@@ -177,8 +243,27 @@ private:
      */
     std::vector<tgModel*> m_children;
 
+    /** Set by the parent's addChild() */
+    tgModel* m_pParent;
+
+    /** The cache returned by getDescendants(), valid if m_indexValid */
+    mutable std::vector<tgModel*> m_descendants;
+
+    /** The caches of getTypedDescendants(), one per type queried */
+    mutable std::vector<std::pair<const std::type_info*, TypedDescendants> >
+        m_typeIndex;
+
+    mutable bool m_indexValid;
+
     std::vector<abstractMarker> m_markers;
 
+    /** The registry we're listed in, or NULL; kept by the registry */
+    tgComponentRegistry* m_pRegistry;
+
+    /** Which of the registry's lists we're in, and where */
+    int m_registryKind;
+    std::size_t m_registrySlot;
+
 };
 
 /**
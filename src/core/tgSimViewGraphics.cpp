@@ -36,7 +36,8 @@
 tgSimViewGraphics::tgSimViewGraphics(tgWorld& world,
                      double stepSize,
                      double renderRate) : 
-  tgSimView(world, stepSize, renderRate)
+  tgSimView(world, stepSize, renderRate),
+  m_pRenderer(NULL)
 {
     /// @todo figure out a good time to delete this
     gDebugDrawer = new tgGLDebugDrawer();
@@ -71,7 +72,8 @@ void tgSimViewGraphics::setup()
         dynamicsWorld.setDebugDrawer(gDebugDrawer);
         
         // @todo Valgrind thinks this is a leak. Perhaps its a GLUT issue?
-        m_pModelVisitor = new tgBulletRenderer(world);
+        m_pRenderer = new tgBulletRenderer(world);
+        m_pModelVisitor = m_pRenderer;
         std::cout << "setup graphics" << std::endl;
 }
 
@@ -92,6 +94,11 @@ void tgSimViewGraphics::render()
             GL_STENCIL_BUFFER_BIT);
         
         m_pSimulation->onVisit(*m_pModelVisitor);
+        // Draw what the visit gathered
+        if (m_pRenderer)
+        {
+            m_pRenderer->flush();
+        }
 
         //Freeglut code
 #if (0)
@@ -143,6 +143,9 @@ public:
 
 private:    
     tgGLDebugDrawer*    gDebugDrawer;   
+
+    /** The model visitor, as what it is; owned by tgSimView */
+    tgBulletRenderer*   m_pRenderer;
 };
 
 
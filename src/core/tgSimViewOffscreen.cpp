@@ -0,0 +1,498 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file tgSimViewOffscreen.cpp
+ * @brief Contains the definitions of members of class tgSimViewOffscreen
+ * $Id$
+ */
+
+// This module
+#include "tgSimViewOffscreen.h"
+// This application
+#include "tgBulletRenderer.h"
+#include "tgBulletUtil.h"
+#include "tgSimulation.h"
+#include "tgSoftwareRasterizer.h"
+#include "tgWorld.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/CollisionShapes/btConcaveShape.h"
+#include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+#include "BulletCollision/CollisionShapes/btStaticPlaneShape.h"
+#include "BulletCollision/CollisionShapes/btTriangleCallback.h"
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "LinearMath/btTransform.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    /** The number of sides of a drawn cylinder, and of slices of a sphere */
+    const int slices = 16;
+
+    /** The number of stacks of a drawn sphere */
+    const int stacks = 8;
+
+    /** Half the size of the square drawn for an infinite plane */
+    const double planeSize = 500.0;
+
+    /** A point with coordinate h along the axis and (u, v) across it */
+    btVector3 alongAxis(int axis, double h, double u, double v)
+    {
+        btVector3 p;
+        p[axis] = h;
+        p[(axis + 1) % 3] = u;
+        p[(axis + 2) % 3] = v;
+        return p;
+    }
+
+    void drawQuad(tgSoftwareRasterizer& r,
+                  const btVector3& a, const btVector3& b,
+                  const btVector3& c, const btVector3& d,
+                  const btVector3& color)
+    {
+        r.drawTriangle(a, b, c, color);
+        r.drawTriangle(a, c, d, color);
+    }
+
+    void drawBox(tgSoftwareRasterizer& r,
+                 const btTransform& t,
+                 const btVector3& halfExtents,
+                 const btVector3& color)
+    {
+        btVector3 corners[8];
+        for (int i = 0; i < 8; i++)
+        {
+            corners[i] = t * btVector3((i & 1) ? halfExtents.x() : -halfExtents.x(),
+                                       (i & 2) ? halfExtents.y() : -halfExtents.y(),
+                                       (i & 4) ? halfExtents.z() : -halfExtents.z());
+        }
+        const int faces[6][4] =
+        {
+            {0, 2, 6, 4}, {1, 5, 7, 3}, {0, 4, 5, 1},
+            {2, 3, 7, 6}, {0, 1, 3, 2}, {4, 6, 7, 5}
+        };
+        for (int f = 0; f < 6; f++)
+        {
+            drawQuad(r, corners[faces[f][0]], corners[faces[f][1]],
+                     corners[faces[f][2]], corners[faces[f][3]], color);
+        }
+    }
+
+    /** A cylinder, closed at both ends, from -h to h along the axis */
+    void drawCylinder(tgSoftwareRasterizer& r,
+                      const btTransform& t,
+                      int axis, double radius, double h,
+                      const btVector3& color)
+    {
+        const btVector3 bottom = t * alongAxis(axis, -h, 0.0, 0.0);
+        const btVector3 top = t * alongAxis(axis, h, 0.0, 0.0);
+        for (int i = 0; i < slices; i++)
+        {
+            const double a0 = 2.0 * M_PI * i / slices;
+            const double a1 = 2.0 * M_PI * (i + 1) / slices;
+            const double u0 = radius * std::cos(a0);
+            const double v0 = radius * std::sin(a0);
+            const double u1 = radius * std::cos(a1);
+            const double v1 = radius * std::sin(a1);
+            const btVector3 b0 = t * alongAxis(axis, -h, u0, v0);
+            const btVector3 b1 = t * alongAxis(axis, -h, u1, v1);
+            const btVector3 t0 = t * alongAxis(axis, h, u0, v0);
+            const btVector3 t1 = t * alongAxis(axis, h, u1, v1);
+            drawQuad(r, b0, b1, t1, t0, color);
+            r.drawTriangle(bottom, b1, b0, color);
+            r.drawTriangle(top, t0, t1, color);
+        }
+    }
+
+    /** A sphere, or with a positive h the two halves of a capsule's ends */
+    void drawSphere(tgSoftwareRasterizer& r,
+                    const btTransform& t,
+                    int axis, double radius, double h,
+                    const btVector3& color)
+    {
+        for (int j = 0; j < stacks; j++)
+        {
+            const double p0 = M_PI * j / stacks - M_PI / 2.0;
+            const double p1 = M_PI * (j + 1) / stacks - M_PI / 2.0;
+            // The lower half is shifted down and the upper half up
+            const double shift = (j < stacks / 2) ? -h : h;
+            for (int i = 0; i < slices; i++)
+            {
+                const double a0 = 2.0 * M_PI * i / slices;
+                const double a1 = 2.0 * M_PI * (i + 1) / slices;
+                btVector3 q[4];
+                const double p[4] = { p0, p0, p1, p1 };
+                const double a[4] = { a0, a1, a1, a0 };
+                for (int k = 0; k < 4; k++)
+                {
+                    q[k] = t * alongAxis(axis,
+                                         radius * std::sin(p[k]) + shift,
+                                         radius * std::cos(p[k]) * std::cos(a[k]),
+                                         radius * std::cos(p[k]) * std::sin(a[k]));
+                }
+                drawQuad(r, q[0], q[1], q[2], q[3], color);
+            }
+        }
+    }
+
+    /** Draws the triangles of a concave shape in world coordinates */
+    class TriangleDrawer : public btTriangleCallback
+    {
+    public:
+        TriangleDrawer(tgSoftwareRasterizer& r,
+                       const btTransform& t,
+                       const btVector3& color) :
+            m_r(r),
+            m_t(t),
+            m_color(color)
+        {
+        }
+
+        virtual void processTriangle(btVector3* triangle,
+                                     int partId,
+                                     int triangleIndex)
+        {
+            m_r.drawTriangle(m_t * triangle[0], m_t * triangle[1],
+                             m_t * triangle[2], m_color);
+        }
+
+    private:
+        tgSoftwareRasterizer& m_r;
+        const btTransform& m_t;
+        const btVector3 m_color;
+    };
+
+    void drawShape(tgSoftwareRasterizer& r,
+                   const btCollisionShape* pShape,
+                   const btTransform& t,
+                   const btVector3& color)
+    {
+        switch (pShape->getShapeType())
+        {
+        case BOX_SHAPE_PROXYTYPE:
+            {
+                const btBoxShape* const pBox =
+                    static_cast<const btBoxShape*>(pShape);
+                drawBox(r, t, pBox->getHalfExtentsWithMargin(), color);
+            }
+            break;
+        case CYLINDER_SHAPE_PROXYTYPE:
+            {
+                const btCylinderShape* const pCylinder =
+                    static_cast<const btCylinderShape*>(pShape);
+                const int axis = pCylinder->getUpAxis();
+                drawCylinder(r, t, axis, pCylinder->getRadius(),
+                             pCylinder->getHalfExtentsWithMargin()[axis],
+                             color);
+            }
+            break;
+        case SPHERE_SHAPE_PROXYTYPE:
+            {
+                const btSphereShape* const pSphere =
+                    static_cast<const btSphereShape*>(pShape);
+                drawSphere(r, t, 1, pSphere->getRadius(), 0.0, color);
+            }
+            break;
+        case CAPSULE_SHAPE_PROXYTYPE:
+            {
+                const btCapsuleShape* const pCapsule =
+                    static_cast<const btCapsuleShape*>(pShape);
+                const int axis = pCapsule->getUpAxis();
+                drawCylinder(r, t, axis, pCapsule->getRadius(),
+                             pCapsule->getHalfHeight(), color);
+                drawSphere(r, t, axis, pCapsule->getRadius(),
+                           pCapsule->getHalfHeight(), color);
+            }
+            break;
+        case COMPOUND_SHAPE_PROXYTYPE:
+            {
+                const btCompoundShape* const pCompound =
+                    static_cast<const btCompoundShape*>(pShape);
+                for (int i = 0; i < pCompound->getNumChildShapes(); i++)
+                {
+                    drawShape(r, pCompound->getChildShape(i),
+                              t * pCompound->getChildTransform(i), color);
+                }
+            }
+            break;
+        case STATIC_PLANE_PROXYTYPE:
+            {
+                const btStaticPlaneShape* const pPlane =
+                    static_cast<const btStaticPlaneShape*>(pShape);
+                const btVector3& n = pPlane->getPlaneNormal();
+                btVector3 u;
+                btVector3 v;
+                btPlaneSpace1(n, u, v);
+                const btVector3 o = n * pPlane->getPlaneConstant();
+                u *= planeSize;
+                v *= planeSize;
+                drawQuad(r, t * (o - u - v), t * (o + u - v),
+                         t * (o + u + v), t * (o - u + v), color);
+            }
+            break;
+        default:
+            if (pShape->isConcave())
+            {
+                // Heightfields and triangle meshes, such as the ground
+                btTransform identity;
+                identity.setIdentity();
+                btVector3 aabbMin;
+                btVector3 aabbMax;
+                pShape->getAabb(identity, aabbMin, aabbMax);
+                TriangleDrawer drawer(r, t, color);
+                static_cast<const btConcaveShape*>(pShape)->
+                    processAllTriangles(&drawer, aabbMin, aabbMax);
+            }
+            // Other convex shapes aren't made by the library
+            break;
+        }
+    }
+
+    /**
+     * Whether the output names a file per frame. It is then the printf
+     * format of the frame number, so it must have exactly one int
+     * conversion (flags, width and precision allowed) and no other '%'.
+     * @throw std::invalid_argument if it has a '%' but isn't such a
+     * pattern
+     */
+    bool isFramePattern(const std::string& output)
+    {
+        const std::string::size_type percent = output.find('%');
+        if (percent == std::string::npos)
+        {
+            return false;
+        }
+        const std::string digits("0123456789");
+        std::string::size_type i = output.find_first_not_of("-+ #0", percent + 1);
+        i = output.find_first_not_of(digits, i);
+        if (i != std::string::npos && output[i] == '.')
+        {
+            i = output.find_first_not_of(digits, i + 1);
+        }
+        if (i == std::string::npos || (output[i] != 'd' && output[i] != 'i') ||
+            output.find('%', i + 1) != std::string::npos)
+        {
+            throw std::invalid_argument("Output '" + output + "' needs exactly "
+                                        "one integer conversion such as %05d "
+                                        "and no other '%'");
+        }
+        return true;
+    }
+
+    /**
+     * Open the output if it is a single stream
+     * @return NULL if the output is a pattern of file names
+     */
+    std::ofstream* openStream(const std::string& output)
+    {
+        if (isFramePattern(output))
+        {
+            return NULL;
+        }
+        std::ofstream* const pStream =
+            new std::ofstream(output.c_str(), std::ios::out | std::ios::binary);
+        if (!pStream->is_open())
+        {
+            delete pStream;
+            throw std::runtime_error("Can't open " + output);
+        }
+        return pStream;
+    }
+} // namespace
+
+tgSimViewOffscreen::Config::Config(const std::string& output,
+                                   double frameRate,
+                                   int width,
+                                   int height) :
+    output(output),
+    frameRate(frameRate),
+    width(width),
+    height(height),
+    eye(0.0, 30.0, 60.0),
+    target(0.0, 0.0, 0.0),
+    fovY(0.7),
+    follow(false),
+    background(0.7, 0.8, 0.9)
+{
+    if (frameRate <= 0.0)
+    {
+        throw std::invalid_argument("frameRate is not positive");
+    }
+    else if (width <= 0 || height <= 0)
+    {
+        throw std::invalid_argument("Frame size is not positive");
+    }
+    isFramePattern(output);
+}
+
+tgSimViewOffscreen::tgSimViewOffscreen(tgWorld& world,
+                                       const Config& config,
+                                       double stepSize) :
+    tgSimView(world, stepSize, 1.0 / config.frameRate),
+    m_config(config),
+    m_pStream(openStream(config.output)),
+    m_pRasterizer(new tgSoftwareRasterizer(config.width, config.height)),
+    m_pRenderer(NULL),
+    m_frameCount(0)
+{
+    m_pRasterizer->setCamera(config.eye, config.target,
+                             btVector3(0.0, 1.0, 0.0), config.fovY);
+}
+
+tgSimViewOffscreen::~tgSimViewOffscreen()
+{
+    delete m_pRasterizer;
+    delete m_pStream;
+}
+
+void tgSimViewOffscreen::setup()
+{
+    tgSimView::setup();
+    // The world object lives through resets, so one renderer will do
+    if (m_pRenderer == NULL)
+    {
+        m_pRenderer = new tgBulletRenderer(world());
+        m_pModelVisitor = m_pRenderer;
+    }
+}
+
+void tgSimViewOffscreen::run(int steps)
+{
+    if (m_pSimulation != NULL)
+    {
+        if (m_frameCount == 0)
+        {
+            render();
+        }
+        for (int i = 0; i < steps; i++)
+        {
+            m_pSimulation->step(m_stepSize);
+            m_renderTime += m_stepSize;
+            // Keep the remainder, so frames stay on the frame rate
+            if (m_renderTime >= m_renderRate)
+            {
+                render();
+                m_renderTime -= m_renderRate;
+            }
+        }
+    }
+}
+
+void tgSimViewOffscreen::render() const
+{
+    if (m_pSimulation == NULL)
+    {
+        return;
+    }
+    m_pRasterizer->clear(m_config.background);
+    drawWorld();
+
+    // The cables, gathered as tgSimViewGraphics gathers them
+    if (m_pRenderer != NULL)
+    {
+        m_pSimulation->onVisit(*m_pRenderer);
+        const std::vector<float>& lines = m_pRenderer->getLines();
+        for (std::size_t i = 0; i + 12 <= lines.size(); i += 12)
+        {
+            m_pRasterizer->drawLine(btVector3(lines[i], lines[i + 1], lines[i + 2]),
+                                    btVector3(lines[i + 6], lines[i + 7], lines[i + 8]),
+                                    btVector3(lines[i + 3], lines[i + 4], lines[i + 5]));
+        }
+        m_pRenderer->clearLines();
+    }
+
+    writeFrame();
+    m_frameCount++;
+}
+
+void tgSimViewOffscreen::drawWorld() const
+{
+    const btDynamicsWorld& dynamicsWorld =
+        tgBulletUtil::worldToDynamicsWorld(m_pSimulation->getWorld());
+    const btCollisionObjectArray& objects =
+        dynamicsWorld.getCollisionObjectArray();
+
+    if (m_config.follow)
+    {
+        btVector3 sum(0.0, 0.0, 0.0);
+        int n = 0;
+        for (int i = 0; i < objects.size(); i++)
+        {
+            if (!objects[i]->isStaticOrKinematicObject())
+            {
+                sum += objects[i]->getWorldTransform().getOrigin();
+                n++;
+            }
+        }
+        if (n > 0)
+        {
+            const btVector3 target = sum / n;
+            m_pRasterizer->setCamera(m_config.eye - m_config.target + target,
+                                     target,
+                                     btVector3(0.0, 1.0, 0.0),
+                                     m_config.fovY);
+        }
+    }
+
+    for (int i = 0; i < objects.size(); i++)
+    {
+        const btCollisionObject* const pObject = objects[i];
+        // Roughly the colors of the demo application
+        const btVector3 color =
+            pObject->isStaticOrKinematicObject() ? btVector3(0.55, 0.55, 0.5) :
+            (i & 1) ? btVector3(0.3, 0.3, 1.0) : btVector3(1.0, 1.0, 0.5);
+        drawShape(*m_pRasterizer, pObject->getCollisionShape(),
+                  pObject->getWorldTransform(), color);
+    }
+}
+
+void tgSimViewOffscreen::writeFrame() const
+{
+    if (m_pStream != NULL)
+    {
+        m_pRasterizer->writePPM(*m_pStream);
+        m_pStream->flush();
+        if (!*m_pStream)
+        {
+            throw std::runtime_error("Can't write to " + m_config.output);
+        }
+    }
+    else
+    {
+        // openStream() checked that this is a format for one int
+        char name[4096];
+        snprintf(name, sizeof(name), m_config.output.c_str(), m_frameCount);
+        std::ofstream file(name, std::ios::out | std::ios::binary);
+        m_pRasterizer->writePPM(file);
+        if (!file)
+        {
+            throw std::runtime_error(std::string("Can't write ") + name);
+        }
+    }
+}
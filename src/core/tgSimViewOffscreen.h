@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef TG_SIM_VIEW_OFFSCREEN_H
+#define TG_SIM_VIEW_OFFSCREEN_H
+
+/**
+ * @file tgSimViewOffscreen.h
+ * @brief Contains the definition of class tgSimViewOffscreen
+ * $Id$
+ */
+
+// This module
+#include "tgSimView.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <iosfwd>
+#include <string>
+
+// Forward declarations
+class tgBulletRenderer;
+class tgSoftwareRasterizer;
+
+/**
+ * A view that renders the simulation without a display, for making
+ * videos on headless machines. The rigid bodies are drawn shaded and
+ * the cables as lines, as tgSimViewGraphics shows them, by a software
+ * rasterizer. Frames are written at a fixed rate of simulated time,
+ * either as numbered PPM files or one after another into a single
+ * stream, which ffmpeg can read with "-f image2pipe -c:v ppm".
+ */
+class tgSimViewOffscreen : public tgSimView
+{
+public:
+
+    struct Config
+    {
+        /**
+         * @param[in] output if it contains a printf conversion such as
+         * "frame%05d.ppm", each frame is written to its own file named
+         * by its number. The conversion must be the only '%' and be
+         * for an int (d or i). Otherwise all frames go into this one
+         * file, which can be a named pipe.
+         * @param[in] frameRate frames per second of simulated time
+         * @param[in] width the width of a frame in pixels
+         * @param[in] height the height of a frame in pixels
+         * @throw std::invalid_argument if frameRate, width or height is
+         * not positive, or output has a '%' that isn't a single int
+         * conversion
+         */
+        Config(const std::string& output = "frame%05d.ppm",
+               double frameRate = 30.0,
+               int width = 640,
+               int height = 480);
+
+        std::string output;
+        double frameRate;
+        int width;
+        int height;
+
+        /** Where the camera is */
+        btVector3 eye;
+
+        /** The point in the middle of the frame */
+        btVector3 target;
+
+        /** The vertical field of view in radians */
+        double fovY;
+
+        /**
+         * Whether the camera moves with the center of the non-static
+         * rigid bodies, keeping its offset from the target
+         */
+        bool follow;
+
+        btVector3 background;
+    };
+
+    /**
+     * @param[in] world the world being simulated
+     * @param[in] config where and how to write the frames
+     * @param[in] stepSize the time interval for advancing the simulation
+     * @throw std::invalid_argument if the step size is not positive, the
+     * frame interval is less than the step size, the frame size is not
+     * positive, or the output is not a valid file name pattern
+     * @throw std::runtime_error if the output can't be opened
+     */
+    tgSimViewOffscreen(tgWorld& world,
+                       const Config& config = Config(),
+                       double stepSize = 1.0/1000.0);
+
+    virtual ~tgSimViewOffscreen();
+
+    /** Create the renderer that gathers the cables */
+    virtual void setup();
+
+    /**
+     * Step the simulation, writing a frame whenever another frame
+     * interval of simulated time has passed.
+     */
+    virtual void run(int steps);
+
+    /** Render the scene and write it as the next frame */
+    virtual void render() const;
+
+    /** The number of frames written so far */
+    int getFrameCount() const { return m_frameCount; }
+
+private:
+
+    /** Draw every collision object in the world */
+    void drawWorld() const;
+
+    /** Write the image to the output */
+    void writeFrame() const;
+
+    const Config m_config;
+
+    /** The single output stream, or NULL for a file per frame */
+    std::ofstream* const m_pStream;
+
+    /** Owned */
+    tgSoftwareRasterizer* const m_pRasterizer;
+
+    /** The model visitor, as what it is; owned by tgSimView */
+    tgBulletRenderer* m_pRenderer;
+
+    mutable int m_frameCount;
+};
+
+#endif  // TG_SIM_VIEW_OFFSCREEN_H
@@ -26,10 +26,12 @@
 // This module
 #include "tgSimulation.h"
 // This application
+#include "tgComponentRegistry.h"
 #include "tgModel.h"
 #include "tgSimView.h"
 #include "tgSimViewGraphics.h"
 #include "tgWorld.h"
+#include "tgWorldArena.h"
 #include "sensors/tgDataManager.h" //for loggers etc.
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
@@ -71,7 +73,8 @@ void tgSimulation::addModel(tgModel* pModel)
     }
     else
     {
-
+        // The model's Bullet objects die with the world
+        tgWorldArena::Scope scope(m_view.world().arena());
         pModel->setup(m_view.world());
         m_models.push_back(pModel);
     }
@@ -90,7 +93,7 @@ void tgSimulation::addObstacle(tgModel* pObstacle)
     }
     else
     {
-
+        tgWorldArena::Scope scope(m_view.world().arena());
         pObstacle->setup(m_view.world());
         m_obstacles.push_back(pObstacle);
     }
@@ -139,10 +142,12 @@ void tgSimulation::reset()
     teardown();
 
     m_view.setup();
-    for (std::size_t i = 0; i != m_models.size(); i++)
     {
-        
-        m_models[i]->setup(m_view.world());
+        tgWorldArena::Scope scope(m_view.world().arena());
+        for (std::size_t i = 0; i != m_models.size(); i++)
+        {
+            m_models[i]->setup(m_view.world());
+        }
     }
     // Also, need to set up the data managers again.
     // Note that this MUST occur after calling setup on the models,
@@ -165,10 +170,12 @@ void tgSimulation::reset(tgGround* newGround)
     m_view.world().reset(newGround);
     
     m_view.setup();
-    for (std::size_t i = 0; i != m_models.size(); i++)
     {
-        
-        m_models[i]->setup(m_view.world());
+        tgWorldArena::Scope scope(m_view.world().arena());
+        for (std::size_t i = 0; i != m_models.size(); i++)
+        {
+            m_models[i]->setup(m_view.world());
+        }
     }
     // Also, need to set up the data managers again.
     // Note that this MUST occur after calling setup on the models,
@@ -200,11 +207,16 @@ void tgSimulation::step(double dt) const
     }
     else
     {
+        // Models may free Bullet objects they built in setup; nothing
+        // new goes into the arena
+        tgWorldArena::Scope scope(m_view.world().arena(), false);
+
         // Step the world.
         // This can be done before or after stepping the models.
         m_view.world().step(dt);
 
-        // Step the models
+        // Step the models, so controllers set their targets. The
+        // actuators are skipped: they are in the world's registry.
         for (std::size_t i = 0; i < m_models.size(); i++)
         {
             m_models[i]->step(dt);
@@ -217,6 +229,9 @@ void tgSimulation::step(double dt) const
             m_obstacles[i]->step(dt);
         }
 
+        // Step the actuators of every model, type by type
+        m_view.world().components().step(dt);
+
 	// Step the data managers
 	for (std::size_t i = 0; i < m_dataManagers.size(); i++) {
 	  m_dataManagers[i]->step(dt);
@@ -226,27 +241,31 @@ void tgSimulation::step(double dt) const
   
 void tgSimulation::teardown()
 {
-    const size_t n = m_models.size();
-    for (std::size_t i = 0; i < n; i++)
     {
-        tgModel * const pModel = m_models[i];
-        assert(pModel != NULL);
-        
-        pModel->teardown();
-    }
-    
-    while(m_obstacles.size() != 0)
-    {
-        tgModel * const pModel = m_obstacles.back();
-        assert(pModel != NULL);
-        
-        pModel->teardown();
+        tgWorldArena::Scope scope(m_view.world().arena(), false);
+
+        const size_t n = m_models.size();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            tgModel * const pModel = m_models[i];
+            assert(pModel != NULL);
+            
+            pModel->teardown();
+        }
         
-        // Remove and destroy element
-        delete pModel;
-        m_obstacles.pop_back();
+        while(m_obstacles.size() != 0)
+        {
+            tgModel * const pModel = m_obstacles.back();
+            assert(pModel != NULL);
+            
+            pModel->teardown();
+            
+            // Remove and destroy element
+            delete pModel;
+            m_obstacles.pop_back();
+        }
+        assert(m_obstacles.empty());
     }
-    assert(m_obstacles.empty());
 
     // Similar to the models and obstacles, tear down the data managers.
     const size_t num_DM = m_dataManagers.size(); //why not in the loop gaurd?...
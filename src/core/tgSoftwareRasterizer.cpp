@@ -0,0 +1,284 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file tgSoftwareRasterizer.cpp
+ * @brief Contains the definitions of members of class tgSoftwareRasterizer
+ * $Id$
+ */
+
+// This module
+#include "tgSoftwareRasterizer.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+    /** Nothing nearer to the camera than this is drawn */
+    const double nearPlane = 0.01;
+
+    /** Lets a line drawn on a surface win the depth test */
+    const double lineDepthBias = 1.001;
+
+    void toBytes(const btVector3& color, double brightness, unsigned char* rgb)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            const double c = std::min(1.0, std::max(0.0, color[k] * brightness));
+            rgb[k] = static_cast<unsigned char>(c * 255.0 + 0.5);
+        }
+    }
+
+    /** Twice the signed area of triangle (a, b, p) on the screen */
+    double edge(const btVector3& a, const btVector3& b, double px, double py)
+    {
+        return (b.x() - a.x()) * (py - a.y()) - (b.y() - a.y()) * (px - a.x());
+    }
+}
+
+tgSoftwareRasterizer::tgSoftwareRasterizer(int width, int height) :
+    m_width(width),
+    m_height(height),
+    m_light(btVector3(0.3, 1.0, 0.5).normalized())
+{
+    if (width <= 0)
+    {
+        throw std::invalid_argument("width is not positive");
+    }
+    else if (height <= 0)
+    {
+        throw std::invalid_argument("height is not positive");
+    }
+    m_pixels.resize(3 * width * height);
+    m_inverseDepth.resize(width * height);
+    setCamera(btVector3(0.0, 30.0, 60.0), btVector3(0.0, 0.0, 0.0));
+    clear(btVector3(0.0, 0.0, 0.0));
+}
+
+void tgSoftwareRasterizer::setCamera(const btVector3& eye,
+                                     const btVector3& target,
+                                     const btVector3& up,
+                                     double fovY)
+{
+    const btVector3 forward = target - eye;
+    if (forward.length() == 0.0)
+    {
+        throw std::invalid_argument("eye and target are the same");
+    }
+    const btVector3 right = forward.cross(up);
+    if (right.length() < 1.0e-9 * forward.length() * up.length())
+    {
+        throw std::invalid_argument("up is along the line of sight");
+    }
+    else if (!(fovY > 0.0 && fovY < M_PI))
+    {
+        throw std::invalid_argument("fovY is not in (0, pi)");
+    }
+    m_eye = eye;
+    m_forward = forward.normalized();
+    m_right = right.normalized();
+    m_up = m_right.cross(m_forward);
+    m_focal = 0.5 * m_height / std::tan(0.5 * fovY);
+}
+
+void tgSoftwareRasterizer::setLight(const btVector3& direction)
+{
+    if (direction.length() > 0.0)
+    {
+        m_light = direction.normalized();
+    }
+}
+
+void tgSoftwareRasterizer::clear(const btVector3& color)
+{
+    unsigned char rgb[3];
+    toBytes(color, 1.0, rgb);
+    for (std::size_t i = 0; i < m_pixels.size(); i += 3)
+    {
+        m_pixels[i] = rgb[0];
+        m_pixels[i + 1] = rgb[1];
+        m_pixels[i + 2] = rgb[2];
+    }
+    std::fill(m_inverseDepth.begin(), m_inverseDepth.end(), 0.0);
+}
+
+void tgSoftwareRasterizer::drawTriangle(const btVector3& a,
+                                        const btVector3& b,
+                                        const btVector3& c,
+                                        const btVector3& color)
+{
+    const btVector3 normal = (b - a).cross(c - a);
+    const double area = normal.length();
+    if (area == 0.0)
+    {
+        return;
+    }
+    unsigned char rgb[3];
+    toBytes(color, 0.3 + 0.7 * std::fabs(normal.dot(m_light)) / area, rgb);
+
+    // Clip to the near plane, which leaves at most four corners
+    const btVector3 corners[3] = { toCamera(a), toCamera(b), toCamera(c) };
+    btVector3 clipped[4];
+    int n = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        const btVector3& p = corners[i];
+        const btVector3& q = corners[(i + 1) % 3];
+        const bool pIn = p.z() >= nearPlane;
+        const bool qIn = q.z() >= nearPlane;
+        if (pIn)
+        {
+            clipped[n++] = p;
+        }
+        if (pIn != qIn)
+        {
+            const double t = (nearPlane - p.z()) / (q.z() - p.z());
+            clipped[n++] = p + (q - p) * t;
+        }
+    }
+    for (int i = 2; i < n; i++)
+    {
+        fillTriangle(clipped[0], clipped[i - 1], clipped[i], rgb);
+    }
+}
+
+void tgSoftwareRasterizer::drawLine(const btVector3& from,
+                                    const btVector3& to,
+                                    const btVector3& color)
+{
+    btVector3 p = toCamera(from);
+    btVector3 q = toCamera(to);
+    if (p.z() < nearPlane && q.z() < nearPlane)
+    {
+        return;
+    }
+    else if (p.z() < nearPlane)
+    {
+        p = p + (q - p) * ((nearPlane - p.z()) / (q.z() - p.z()));
+    }
+    else if (q.z() < nearPlane)
+    {
+        q = q + (p - q) * ((nearPlane - q.z()) / (p.z() - q.z()));
+    }
+
+    unsigned char rgb[3];
+    toBytes(color, 1.0, rgb);
+    const double x0 = 0.5 * m_width + m_focal * p.x() / p.z();
+    const double y0 = 0.5 * m_height - m_focal * p.y() / p.z();
+    const double x1 = 0.5 * m_width + m_focal * q.x() / q.z();
+    const double y1 = 0.5 * m_height - m_focal * q.y() / q.z();
+    // Both ends may be far off screen, so don't step through all of it
+    const double limit = 4.0 * (m_width + m_height);
+    const double length = std::max(std::fabs(x1 - x0), std::fabs(y1 - y0));
+    const int steps = static_cast<int>(std::min(limit, std::ceil(length)));
+    for (int k = 0; k <= steps; k++)
+    {
+        const double t = steps > 0 ? k / static_cast<double>(steps) : 0.0;
+        plot(static_cast<int>(std::floor(x0 + t * (x1 - x0))),
+             static_cast<int>(std::floor(y0 + t * (y1 - y0))),
+             (1.0 / p.z() + t * (1.0 / q.z() - 1.0 / p.z())) * lineDepthBias,
+             rgb);
+    }
+}
+
+void tgSoftwareRasterizer::writePPM(std::ostream& os) const
+{
+    os << "P6\n" << m_width << " " << m_height << "\n255\n";
+    os.write(reinterpret_cast<const char*>(&m_pixels[0]), m_pixels.size());
+}
+
+btVector3 tgSoftwareRasterizer::toCamera(const btVector3& point) const
+{
+    const btVector3 d = point - m_eye;
+    return btVector3(d.dot(m_right), d.dot(m_up), d.dot(m_forward));
+}
+
+void tgSoftwareRasterizer::fillTriangle(const btVector3& a,
+                                        const btVector3& b,
+                                        const btVector3& c,
+                                        const unsigned char* rgb)
+{
+    // Screen x and y, and one over the depth
+    const btVector3 corners[3] = { a, b, c };
+    btVector3 s[3];
+    for (int i = 0; i < 3; i++)
+    {
+        const btVector3& p = corners[i];
+        s[i] = btVector3(0.5 * m_width + m_focal * p.x() / p.z(),
+                         0.5 * m_height - m_focal * p.y() / p.z(),
+                         1.0 / p.z());
+    }
+    double area = edge(s[0], s[1], s[2].x(), s[2].y());
+    if (std::fabs(area) < 1.0e-12)
+    {
+        return;
+    }
+    const double sign = area > 0.0 ? 1.0 : -1.0;
+    area *= sign;
+
+    const double minX = std::min(s[0].x(), std::min(s[1].x(), s[2].x()));
+    const double maxX = std::max(s[0].x(), std::max(s[1].x(), s[2].x()));
+    const double minY = std::min(s[0].y(), std::min(s[1].y(), s[2].y()));
+    const double maxY = std::max(s[0].y(), std::max(s[1].y(), s[2].y()));
+    const int x0 = std::max(0, static_cast<int>(std::floor(std::max(-1.0, minX))));
+    const int x1 = std::min(m_width - 1,
+                            static_cast<int>(std::ceil(std::min<double>(m_width, maxX))));
+    const int y0 = std::max(0, static_cast<int>(std::floor(std::max(-1.0, minY))));
+    const int y1 = std::min(m_height - 1,
+                            static_cast<int>(std::ceil(std::min<double>(m_height, maxY))));
+
+    for (int y = y0; y <= y1; y++)
+    {
+        const double py = y + 0.5;
+        for (int x = x0; x <= x1; x++)
+        {
+            const double px = x + 0.5;
+            const double w0 = sign * edge(s[1], s[2], px, py);
+            const double w1 = sign * edge(s[2], s[0], px, py);
+            const double w2 = sign * edge(s[0], s[1], px, py);
+            if (w0 >= 0.0 && w1 >= 0.0 && w2 >= 0.0)
+            {
+                plot(x, y,
+                     (w0 * s[0].z() + w1 * s[1].z() + w2 * s[2].z()) / area,
+                     rgb);
+            }
+        }
+    }
+}
+
+void tgSoftwareRasterizer::plot(int x, int y,
+                                double inverseDepth,
+                                const unsigned char* rgb)
+{
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height)
+    {
+        return;
+    }
+    const int i = y * m_width + x;
+    if (inverseDepth > m_inverseDepth[i])
+    {
+        m_inverseDepth[i] = inverseDepth;
+        m_pixels[3 * i] = rgb[0];
+        m_pixels[3 * i + 1] = rgb[1];
+        m_pixels[3 * i + 2] = rgb[2];
+    }
+}
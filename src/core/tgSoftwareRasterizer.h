@@ -0,0 +1,138 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef TG_SOFTWARE_RASTERIZER_H
+#define TG_SOFTWARE_RASTERIZER_H
+
+/**
+ * @file tgSoftwareRasterizer.h
+ * @brief Contains the definition of class tgSoftwareRasterizer
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <iosfwd>
+#include <vector>
+
+/**
+ * Draws flat shaded triangles and lines into an RGB image in memory,
+ * with a depth buffer and a pinhole camera. It needs no display, GPU or
+ * OpenGL context, so any number of them can run side by side on a
+ * headless machine.
+ */
+class tgSoftwareRasterizer
+{
+public:
+
+    /**
+     * @param[in] width the width of the image in pixels
+     * @param[in] height the height of the image in pixels
+     * @throw std::invalid_argument if width or height is not positive
+     */
+    tgSoftwareRasterizer(int width, int height);
+
+    /**
+     * Place the camera.
+     * @param[in] eye where the camera is
+     * @param[in] target the point in the middle of the image
+     * @param[in] up the direction that is up in the image
+     * @param[in] fovY the vertical field of view in radians
+     * @throw std::invalid_argument if eye and target are the same, up is
+     * along the line of sight, or fovY is not in (0, pi)
+     */
+    void setCamera(const btVector3& eye,
+                   const btVector3& target,
+                   const btVector3& up = btVector3(0.0, 1.0, 0.0),
+                   double fovY = 0.7);
+
+    /** Shading is brightest on faces toward this direction */
+    void setLight(const btVector3& direction);
+
+    /** Fill the image with a color and empty the depth buffer */
+    void clear(const btVector3& color);
+
+    /**
+     * Draw a triangle, lit from both sides.
+     * @param[in] color red, green and blue in [0, 1]
+     */
+    void drawTriangle(const btVector3& a,
+                      const btVector3& b,
+                      const btVector3& c,
+                      const btVector3& color);
+
+    /**
+     * Draw a line one pixel wide, unlit.
+     * @param[in] color red, green and blue in [0, 1]
+     */
+    void drawLine(const btVector3& from,
+                  const btVector3& to,
+                  const btVector3& color);
+
+    int width() const { return m_width; }
+
+    int height() const { return m_height; }
+
+    /** The image, as rows of red, green, blue bytes from the top down */
+    const std::vector<unsigned char>& getPixels() const { return m_pixels; }
+
+    /** Write the image as a binary PPM (P6) */
+    void writePPM(std::ostream& os) const;
+
+private:
+
+    /** A point in camera coordinates: right, up, and depth ahead */
+    btVector3 toCamera(const btVector3& point) const;
+
+    /**
+     * Rasterize a triangle in camera coordinates, all in front of the
+     * near plane.
+     */
+    void fillTriangle(const btVector3& a,
+                      const btVector3& b,
+                      const btVector3& c,
+                      const unsigned char* rgb);
+
+    void plot(int x, int y, double inverseDepth, const unsigned char* rgb);
+
+    const int m_width;
+    const int m_height;
+
+    btVector3 m_eye;
+    btVector3 m_right;
+    btVector3 m_up;
+    btVector3 m_forward;
+
+    /** The distance of the image plane in pixels */
+    double m_focal;
+
+    /** Unit vector toward the light */
+    btVector3 m_light;
+
+    std::vector<unsigned char> m_pixels;
+
+    /**
+     * One over the depth of what was drawn at each pixel, 0 where
+     * nothing was. It is linear in screen space, unlike depth.
+     */
+    std::vector<double> m_inverseDepth;
+};
+
+#endif  // TG_SOFTWARE_RASTERIZER_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file tgTagAtoms.cpp
+ * @brief Contains the definitions of members of class tgTagAtoms
+ * $Id$
+ */
+
+// This module
+#include "tgTagAtoms.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+#include <tr1/unordered_map>
+#include <vector>
+// POSIX
+#include <pthread.h>
+
+namespace
+{
+    typedef std::tr1::unordered_map<std::string, int> AtomMap;
+
+    /** Constructed on first use, so tags made by static constructors work */
+    AtomMap& atoms()
+    {
+        static AtomMap table;
+        return table;
+    }
+
+    std::vector<std::string>& names()
+    {
+        static std::vector<std::string> table;
+        return table;
+    }
+
+    /**
+     * Guards both tables. Almost every call finds a tag that is already
+     * there, so those only share the lock. Statically initialized, so it
+     * is ready before any static constructor runs.
+     */
+    pthread_rwlock_t gAtomsLock = PTHREAD_RWLOCK_INITIALIZER;
+
+    /** -1 if the tag is not in the table; call with gAtomsLock held */
+    int find(const std::string& tag)
+    {
+        const AtomMap& table = atoms();
+        const AtomMap::const_iterator it = table.find(tag);
+        return it != table.end() ? it->second : -1;
+    }
+}
+
+int tgTagAtoms::intern(const std::string& tag)
+{
+    int atom = lookup(tag);
+    if (atom < 0)
+    {
+        pthread_rwlock_wrlock(&gAtomsLock);
+        // Another thread may have added it since lookup()
+        atom = find(tag);
+        if (atom < 0)
+        {
+            atom = static_cast<int>(names().size());
+            atoms()[tag] = atom;
+            names().push_back(tag);
+        }
+        pthread_rwlock_unlock(&gAtomsLock);
+    }
+    assert(atom >= 0);
+    return atom;
+}
+
+int tgTagAtoms::lookup(const std::string& tag)
+{
+    pthread_rwlock_rdlock(&gAtomsLock);
+    const int atom = find(tag);
+    pthread_rwlock_unlock(&gAtomsLock);
+    return atom;
+}
+
+std::string tgTagAtoms::name(int atom)
+{
+    std::string result;
+    bool found = false;
+    pthread_rwlock_rdlock(&gAtomsLock);
+    if (atom >= 0 && static_cast<std::size_t>(atom) < names().size())
+    {
+        result = names()[atom];
+        found = true;
+    }
+    pthread_rwlock_unlock(&gAtomsLock);
+    if (!found)
+    {
+        throw std::out_of_range("No such tag atom");
+    }
+    return result;
+}
+
+std::size_t tgTagAtoms::size()
+{
+    pthread_rwlock_rdlock(&gAtomsLock);
+    const std::size_t result = names().size();
+    pthread_rwlock_unlock(&gAtomsLock);
+    return result;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file tgTagAtoms.h
+ * @brief Contains the definition of class tgTagAtoms
+ * $Id$
+ */
+
+#ifndef TG_TAG_ATOMS_H
+#define TG_TAG_ATOMS_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * The process-wide table of tag atoms: every distinct tag string gets a
+ * small non-negative integer, the same for the life of the process.
+ * tgTags and tgTagSearch compare atoms instead of strings.
+ */
+class tgTagAtoms
+{
+public:
+
+    /**
+     * The atom of a tag, adding the tag if it is new. Safe to call from
+     * several threads, e.g. models built in parallel by a ParameterSweep.
+     */
+    static int intern(const std::string& tag);
+
+    /**
+     * The atom of a tag, or -1 if no tgTags has ever held it. Never adds
+     * to the table, so queries with unknown tags don't grow it.
+     */
+    static int lookup(const std::string& tag);
+
+    /** The tag of an atom returned by intern() */
+    static std::string name(int atom);
+
+    /** The number of atoms so far */
+    static std::size_t size();
+};
+
+#endif
@@ -27,23 +27,25 @@
 #define TG_TAG_SEARCH_H
 
 #include <string>
+#include <vector>
 
 #include "tgTags.h"
 #include "tgTaggable.h"
 
-/*  @todo: Implement more advanced search capability
-
-    Currently, tag searches just matches all tags, so something like
-    tgTagSearch("a b").matches(tgTags("a b c")) is true. 
-
-    Plans: search operators like 'or' and 'not', for instance
-    - tgTagSearch("a -b") would match tgTags("a c") but not tgTags("a b")
-    - tgTagSearch("a b|c") would match tgTags("a b") and tgTags("a c") 
-      but not tgTags("a d")
-*/
-
 /**
- * Represents a search to be performed on a tgTaggable
+ * Represents a search to be performed on a tgTaggable.
+ *
+ * A search is a space separated list of terms, all of which must match.
+ * A term is one or more alternatives separated by '|', any of which
+ * must match, and an alternative is a tag, or a tag prefixed with '-'
+ * for its absence. So
+ * - tgTagSearch("a b") matches tgTags("a b c")
+ * - tgTagSearch("a -b") matches tgTags("a c") but not tgTags("a b")
+ * - tgTagSearch("a b|c") matches tgTags("a b") and tgTags("a c")
+ *   but not tgTags("a d")
+ *
+ * The search is parsed once, into tag atoms (see tgTagAtoms), so
+ * matching compares integers.
  */
 class tgTagSearch
 {
@@ -51,8 +53,14 @@ public:
     
     tgTagSearch() {}
 
-    tgTagSearch(std::string search_string) : m_search(search_string)
-    {}
+    /**
+     * @throws tgTagException if a tag in the search is not valid or an
+     * alternative is empty
+     */
+    tgTagSearch(std::string search_string)
+    {
+        compile(search_string);
+    }
     
     virtual ~tgTagSearch() {}
 
@@ -61,9 +69,24 @@ public:
      */
     const bool matches(const tgTags& tags) const
     {
-        // Simple for now, just check that the tags contain the tags in the 
-        // search
-        return tags.contains(m_search);
+        std::size_t begin = 0;
+        for (std::size_t t = 0; t < m_termEnds.size(); t++)
+        {
+            const std::size_t end = m_termEnds[t];
+            bool any = false;
+            for (std::size_t i = begin; i < end && !any; i++)
+            {
+                const int literal = m_literals[i];
+                any = literal >= 0 ? tags.hasAtom(literal) :
+                                     !tags.hasAtom(~literal);
+            }
+            if (!any)
+            {
+                return false;
+            }
+            begin = end;
+        }
+        return true;
     }
 
     const bool matches(const tgTaggable& taggable) const
@@ -77,25 +100,95 @@ public:
      */
     bool matches(const tgTags& parentTags, const tgTags& tags)
     {
-        // @todo: make sure this works correctly...
         tgTags s(parentTags);
         s.append(tags);
         return matches(s);
     }
     
     /**
-     * Remove the given tags from the search
+     * Remove the given tags from the search: the search is simplified
+     * as if they were present. Terms they satisfy are dropped, and
+     * alternatives that need them absent can no longer match.
      */
     void remove(const tgTags& tags)
     {
-        tgTags s(tags);
-        m_search.remove(tags);
+        std::vector<int> literals;
+        std::vector<std::size_t> termEnds;
+        std::size_t begin = 0;
+        for (std::size_t t = 0; t < m_termEnds.size(); t++)
+        {
+            const std::size_t end = m_termEnds[t];
+            bool satisfied = false;
+            const std::size_t start = literals.size();
+            for (std::size_t i = begin; i < end && !satisfied; i++)
+            {
+                const int literal = m_literals[i];
+                if (literal >= 0 && tags.hasAtom(literal))
+                {
+                    satisfied = true;
+                }
+                else if (literal >= 0 || !tags.hasAtom(~literal))
+                {
+                    literals.push_back(literal);
+                }
+            }
+            if (satisfied)
+            {
+                literals.resize(start);
+            }
+            else
+            {
+                // An empty term never matches, like the search it came from
+                termEnds.push_back(literals.size());
+            }
+            begin = end;
+        }
+        m_literals.swap(literals);
+        m_termEnds.swap(termEnds);
     }
     
 private:
-    
-    // @todo: change this to a parsed representation of the and/or/not setup
-    tgTags m_search;
+
+    void compile(const std::string& search)
+    {
+        const std::deque<std::string> terms = tgTags::splitTags(search);
+        for (std::size_t t = 0; t < terms.size(); t++)
+        {
+            const std::deque<std::string> alternatives =
+                tgTags::splitTags(terms[t], '|');
+            if (alternatives.empty() ||
+                terms[t][0] == '|' || terms[t][terms[t].size() - 1] == '|' ||
+                terms[t].find("||") != std::string::npos)
+            {
+                throw tgTagException("Empty alternative in tag search '" +
+                                     search + "'");
+            }
+            for (std::size_t i = 0; i < alternatives.size(); i++)
+            {
+                const std::string& alternative = alternatives[i];
+                const bool negated = (alternative[0] == '-');
+                const std::string tag =
+                    negated ? alternative.substr(1) : alternative;
+                if (!tgTags::isValid(tag))
+                {
+                    throw tgTagException("Invalid tag '" + tag +
+                                         "' in tag search '" + search + "'");
+                }
+                const int atom = tgTagAtoms::intern(tag);
+                m_literals.push_back(negated ? ~atom : atom);
+            }
+            m_termEnds.push_back(m_literals.size());
+        }
+    }
+
+    /**
+     * The alternatives of all terms, one after another: an atom, or
+     * ~atom for its absence
+     */
+    std::vector<int> m_literals;
+
+    /** Where each term's alternatives end in m_literals */
+    std::vector<std::size_t> m_termEnds;
 
 };
 
@@ -33,14 +33,21 @@
 #include <iostream>
 #include <sstream>
 #include <locale>         // std::locale, std::isalnum
+#include <vector>
 
 #include "tgException.h"
+#include "tgTagAtoms.h"
 
 struct tgTagException : public tgException
 {
    tgTagException(std::string ss) : tgException(ss) {}
 };
 
+/**
+ * An ordered set of tags. Besides the strings, which keep the order they
+ * were added in, the tags are held as a sorted vector of their
+ * tgTagAtoms, so containment checks compare integers.
+ */
 class tgTags
 {
 public:
@@ -52,24 +59,109 @@ public:
     
     bool contains(const std::string& space_separated_tags) const
     {
-        const std::deque<std::string> tags = splitTags(space_separated_tags);
-        return contains(tags);
+        std::vector<int> atoms;
+        // A tag no tgTags has held can't be among ours
+        return atomsOf(space_separated_tags, atoms) && containsAtoms(atoms);
     }
 
     bool contains(const tgTags& tags) const
     {
-        return contains(tags.getTags());
+        return containsAtoms(tags.m_atoms);
     }
         
-    bool containsAny(const std::string& space_separated_tags)
+    bool containsAny(const std::string& space_separated_tags) const
+    {
+        std::vector<int> atoms;
+        atomsOf(space_separated_tags, atoms);
+        return containsAnyAtoms(atoms);
+    }
+
+    bool containsAny(const tgTags& tags) const
+    {
+        return containsAnyAtoms(tags.m_atoms);
+    }
+
+    /**
+     * Whether all of the atoms are among ours. Splitting and looking up a
+     * search once with atomsOf() and then calling this saves doing it
+     * for every candidate.
+     * @param[in] atoms sorted, as returned by atomsOf()
+     */
+    bool containsAtoms(const std::vector<int>& atoms) const
+    {
+        return std::includes(m_atoms.begin(), m_atoms.end(),
+                             atoms.begin(), atoms.end());
+    }
+
+    /**
+     * Whether any of the atoms is among ours.
+     * @param[in] atoms sorted, as returned by atomsOf()
+     */
+    bool containsAnyAtoms(const std::vector<int>& atoms) const
+    {
+        std::vector<int>::const_iterator a = m_atoms.begin();
+        std::vector<int>::const_iterator b = atoms.begin();
+        while (a != m_atoms.end() && b != atoms.end())
+        {
+            if (*a < *b)
+            {
+                ++a;
+            }
+            else if (*b < *a)
+            {
+                ++b;
+            }
+            else
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Whether we have the tag of this atom */
+    bool hasAtom(int atom) const
+    {
+        return std::binary_search(m_atoms.begin(), m_atoms.end(), atom);
+    }
+
+    /** Our atoms, sorted */
+    const std::vector<int>& getAtoms() const
     {
-        std::deque<std::string> tags = splitTags(space_separated_tags);
-        return containsAny(tags);
+        return m_atoms;
     }
 
-    bool containsAny(const tgTags& tags) 
+    /**
+     * The sorted, distinct atoms of space separated tags, without the
+     * stream that splitTags() uses. Tags that no tgTags has held have no
+     * atom and are left out; looking them up doesn't add them.
+     * @param[out] atoms the atoms of the known tags
+     * @return false if any of the tags was unknown
+     */
+    static bool atomsOf(const std::string& space_separated_tags,
+                        std::vector<int>& atoms)
     {
-        return containsAny(tags.getTags());
+        bool allKnown = true;
+        atoms.clear();
+        const std::string& s = space_separated_tags;
+        std::string::size_type begin = s.find_first_not_of(' ');
+        while (begin != std::string::npos)
+        {
+            const std::string::size_type end = s.find(' ', begin);
+            const int atom = tgTagAtoms::lookup(s.substr(begin, end - begin));
+            if (atom >= 0)
+            {
+                atoms.push_back(atom);
+            }
+            else
+            {
+                allKnown = false;
+            }
+            begin = s.find_first_not_of(' ', end);
+        }
+        std::sort(atoms.begin(), atoms.end());
+        atoms.erase(std::unique(atoms.begin(), atoms.end()), atoms.end());
+        return allKnown;
     }
 
     void append(const std::string& space_separated_tags)
@@ -114,11 +206,11 @@ public:
 
     static std::deque<std::string> splitTags(const std::string &s, char delim = ' ') {
         std::deque<std::string> elems;
-        std::stringstream ss(s);
-        std::string item;
-        while (std::getline(ss, item, delim)) {
-            if(!item.empty())
-                elems.push_back(item);
+        std::string::size_type begin = s.find_first_not_of(delim);
+        while (begin != std::string::npos) {
+            const std::string::size_type end = s.find(delim, begin);
+            elems.push_back(s.substr(begin, end - begin));
+            begin = s.find_first_not_of(delim, end);
         }
         return elems;
     }
@@ -153,7 +245,7 @@ public:
     /**
      * Determine if the string can be cast to an integer
      */
-    bool isIntegery(const std::string s) const
+    static bool isIntegery(const std::string s)
     {
         if(s.empty()) {
             return false;
@@ -166,7 +258,7 @@ public:
         return false;
     }
     
-    bool isValid(std::string tag)
+    static bool isValid(std::string tag)
     {
         if (tag.empty()) 
             return false;
@@ -187,11 +279,7 @@ public:
         return true;
     }
 
-    std::deque<std::string>& getTags()
-    {
-        return m_tags;
-    }
-
+    /** Read only, so that the atoms stay in step with the strings */
     const std::deque<std::string>& getTags() const
     {
         return m_tags;
@@ -206,15 +294,11 @@ public:
     }
 
     /**
-     * Return a non-const reference to the tag that is indexed by the
+     * Return a const reference to the tag that is indexed by the
      * int key. It must be in m_tags.
      * @param[in] key the key of the tag to retrieve
      * @reeturn a const reference to the tag that is indexed by key
      */
-    std::string& operator[](int key) { 
-        return m_tags[key]; 
-    }
-    
     const std::string& operator[](int key) const { 
         return m_tags[key]; 
     }
@@ -222,15 +306,15 @@ public:
     /**
      * Check if we contain the same tags regardless of ordering
      */
-    bool operator==(const tgTags& rhs)
+    bool operator==(const tgTags& rhs) const
     {
-        return rhs.asSet() == asSet(); 
+        return rhs.m_atoms == m_atoms;
     }
 
+    /** Append, skipping tags we already have */
     tgTags& operator+=(const tgTags& rhs)
     {
-        const std::deque<std::string>& other = rhs.getTags();
-        m_tags.insert(m_tags.end(), other.begin(), other.end());
+        append(rhs.getTags());
         return *this;
     }
 
@@ -244,7 +328,7 @@ private:
         if(!isValid(tag)) {
             throw tgTagException("Invalid tag '" + tag + "' - tags must be alphanumeric and may not be castable to int.");
         }
-        if(!containsOne(tag)) {
+        if(insertAtom(tgTagAtoms::intern(tag))) {
             m_tags.push_back(tag);
         }
     }
@@ -257,7 +341,7 @@ private:
     }
     
     void prependOne(std::string tag) {
-        if(isValid(tag) && !containsOne(tag)) {
+        if(isValid(tag) && insertAtom(tgTagAtoms::intern(tag))) {
             m_tags.push_front(tag);
         }
     }
@@ -269,40 +353,44 @@ private:
         }
     }
 
-    bool contains(const std::deque<std::string>& tags) const {
-        for(std::size_t i = 0; i < tags.size(); i++) {
-            if(!containsOne(tags[i])) 
-                return false;
+    /**
+     * Add an atom to the sorted atoms
+     * @return false if it was there already
+     */
+    bool insertAtom(int atom) {
+        std::vector<int>::iterator it =
+            std::lower_bound(m_atoms.begin(), m_atoms.end(), atom);
+        if(it != m_atoms.end() && *it == atom) {
+            return false;
         }
+        m_atoms.insert(it, atom);
         return true;
     }
 
-    bool containsAny(const std::deque<std::string>& tags) const {
-        for(std::size_t i = 0; i < tags.size(); i++) {
-            if(containsOne(tags[i])) 
-                return true;
+    void removeOne(const std::string& tag) {
+        // An unknown tag can't be among ours
+        const int atom = tgTagAtoms::lookup(tag);
+        if(atom < 0) {
+            return;
+        }
+        std::vector<int>::iterator it =
+            std::lower_bound(m_atoms.begin(), m_atoms.end(), atom);
+        if(it != m_atoms.end() && *it == atom) {
+            m_atoms.erase(it);
+            m_tags.erase(std::remove(m_tags.begin(), m_tags.end(), tag), m_tags.end());
         }
-        return false;
-    }
-    
-    /**
-     * Check whether we contain a tag that is known to be valid
-     */
-    bool containsOne(std::string tag) const {
-        return (std::find(m_tags.begin(), m_tags.end(), tag) != m_tags.end());
-    }
-    
-    void removeOne(std::string tag) {
-        m_tags.erase(std::remove(m_tags.begin(), m_tags.end(), tag), m_tags.end());
     }
     
-    void remove(std::deque<std::string> tags) {
+    void remove(const std::deque<std::string>& tags) {
         for(std::size_t i = 0; i < tags.size(); i++) {
             removeOne(tags[i]);
         }
     }
     
     std::deque<std::string> m_tags;
+
+    /** The atoms of m_tags, sorted */
+    std::vector<int> m_atoms;
 };
 
 /**
@@ -26,6 +26,8 @@
 // This module
 #include "tgWorld.h"
 // This application
+#include "tgComponentRegistry.h"
+#include "tgWorldArena.h"
 #include "tgWorldBulletPhysicsImpl.h"
 #include "terrain/tgBoxGround.h"
 // The C++ Standard Library
@@ -49,8 +51,11 @@ worldSize(ws)
 tgWorld::tgWorld() :
   m_config(),
   m_pGround(new tgBoxGround()),
-  m_pImpl(new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround))
+  m_pArena(new tgWorldArena()),
+  m_pComponents(new tgComponentRegistry()),
+  m_pImpl(NULL)
 {
+  reset();
   // Postcondition
   assert(invariant());
 }
@@ -62,8 +67,11 @@ tgWorld::tgWorld() :
 tgWorld::tgWorld(const tgWorld::Config& config) :
   m_config(config),
   m_pGround(new tgBoxGround()),
-  m_pImpl(new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround))
+  m_pArena(new tgWorldArena()),
+  m_pComponents(new tgComponentRegistry()),
+  m_pImpl(NULL)
 {
+  reset();
   // Postcondition
   assert(invariant());
 }
@@ -75,21 +83,39 @@ tgWorld::tgWorld(const tgWorld::Config& config) :
 tgWorld::tgWorld(const tgWorld::Config& config, tgGround* ground) :
   m_config(config),
   m_pGround(ground),
-  m_pImpl(new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround))
+  m_pArena(new tgWorldArena()),
+  m_pComponents(new tgComponentRegistry()),
+  m_pImpl(NULL)
 {
+  reset();
   // Postcondition
   assert(invariant());
 }
 
 tgWorld::~tgWorld()
 {
-  delete m_pImpl;
-  delete m_pGround;
+  {
+    // Recognize the arena's blocks as they are freed
+    tgWorldArena::Scope scope(*m_pArena, false);
+    delete m_pImpl;
+    delete m_pGround;
+  }
+  delete m_pArena;
+  delete m_pComponents;
 }
 
 void tgWorld::reset()
 {
-  delete m_pImpl;
+  // Run the destructors while the arena's memory is still valid,
+  // then reclaim all of it at once
+  {
+    tgWorldArena::Scope scope(*m_pArena, false);
+    delete m_pImpl;
+    m_pImpl = NULL;
+  }
+  m_pArena->release();
+
+  tgWorldArena::Scope scope(*m_pArena);
   m_pImpl = new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround);
   // Postcondition
   assert(invariant());
@@ -124,6 +150,9 @@ void tgWorld::step(double dt) const
   }
   else
   {
+    // Per-step allocations go to malloc so the arena doesn't grow
+    // over a trial; frees of blocks from setup are still recognized
+    tgWorldArena::Scope scope(*m_pArena, false);
     // Forward to the implementation
     m_pImpl->step(dt);
   }
@@ -140,5 +169,5 @@ double tgWorld::getWorldGravity() const
 
 bool tgWorld::invariant() const
 {
-  return m_pImpl != 0;
+  return (m_pImpl != 0) && (m_pArena != 0) && (m_pComponents != 0);
 }
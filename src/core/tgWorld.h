@@ -27,7 +27,9 @@
  */
 
 // Forward declarations
+class tgComponentRegistry;
 class tgWorldImpl;
+class tgWorldArena;
 class tgGround;
 
 /**
@@ -78,7 +80,10 @@ public:
   /** Delete the implementation. */
   ~tgWorld();
 
-  /** Replace the implementation. */
+  /**
+   * Replace the implementation. Everything allocated in the world's
+   * arena is released at once before the new implementation is built.
+   */
   void reset();
 
   /**
@@ -114,6 +119,26 @@ public:
    * Returns the level of gravity in this world.
    */
   double getWorldGravity() const;
+
+  /**
+   * The arena holding this world's Bullet objects. Activate a
+   * tgWorldArena::Scope with it while creating objects that are
+   * destroyed with the world, such as a model's rigid bodies.
+   */
+  tgWorldArena& arena() const
+  {
+    return *m_pArena;
+  }
+
+  /**
+   * The actuators and rigid bodies of the models set up in this world,
+   * in flat lists by type. It outlives reset(): models leave it when
+   * they are torn down.
+   */
+  tgComponentRegistry& components() const
+  {
+    return *m_pComponents;
+  }
  
 private:
 
@@ -130,6 +155,15 @@ private:
   /** Implementation of the ground, such as a box, hills or ramp */
   tgGround* m_pGround;
 
+  /**
+   * Backs the implementation's Bullet allocations. Declared before
+   * m_pImpl so it exists while the implementation is built.
+   */
+  tgWorldArena * const m_pArena;
+
+  /** Kept up to date by tgModel::setup() and teardown() */
+  tgComponentRegistry * const m_pComponents;
+
   /** The implementation of the tgWorld. */
   tgWorldImpl * m_pImpl;
 };
@@ -0,0 +1,266 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgWorldArena.cpp
+ * @brief Contains the definitions of members of class tgWorldArena
+ * $Id$
+ */
+
+// This module
+#include "tgWorldArena.h"
+// The Bullet Physics library
+#include "LinearMath/btAlignedAllocator.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+// POSIX
+#include <pthread.h>
+
+namespace
+{
+    /** Bullet asks for at most 16 byte alignment */
+    const std::size_t arenaAlignment = 16;
+
+    std::size_t alignUp(std::size_t n)
+    {
+        return (n + arenaAlignment - 1) & ~(arenaAlignment - 1);
+    }
+
+    /** The arena whose blocks this thread may free, if any */
+    __thread tgWorldArena* tCurrentArena = NULL;
+
+    /** True if this thread's Bullet allocations come from tCurrentArena */
+    __thread bool tArenaAllocates = false;
+
+    /**
+     * Every live arena, for frees made outside any scope. Chunk lists
+     * are only modified while holding gRegistryLock for writing, so
+     * concurrent lookups only share it.
+     */
+    std::vector<const tgWorldArena*> gArenas;
+    pthread_rwlock_t gRegistryLock = PTHREAD_RWLOCK_INITIALIZER;
+    pthread_once_t gHooksOnce = PTHREAD_ONCE_INIT;
+
+    bool registryContains(const void* p)
+    {
+        bool result = false;
+        pthread_rwlock_rdlock(&gRegistryLock);
+        for (std::size_t i = 0; i < gArenas.size() && !result; i++)
+        {
+            result = gArenas[i]->contains(p);
+        }
+        pthread_rwlock_unlock(&gRegistryLock);
+        return result;
+    }
+
+    void* arenaAllocFunc(size_t size)
+    {
+        tgWorldArena* const pArena = tCurrentArena;
+        if (pArena && tArenaAllocates)
+        {
+            return pArena->allocate(size);
+        }
+        return std::malloc(size);
+    }
+
+    /**
+     * Bullet's default allocator is malloc, so anything that is not ours
+     * (including blocks allocated before the hooks were installed) can be
+     * handed to free. Inside a scope, which covers every step, only the
+     * current arena is checked; the registry is the fallback for frees
+     * made outside one.
+     */
+    void arenaFreeFunc(void* p)
+    {
+        if (p == NULL)
+        {
+            return;
+        }
+        tgWorldArena* const pArena = tCurrentArena;
+        if (pArena)
+        {
+            if (!pArena->contains(p))
+            {
+                std::free(p);
+            }
+        }
+        else if (!registryContains(p))
+        {
+            std::free(p);
+        }
+    }
+
+    void installHooks()
+    {
+        btAlignedAllocSetCustom(arenaAllocFunc, arenaFreeFunc);
+    }
+}
+
+tgWorldArena::Scope::Scope(tgWorldArena& arena, bool allocate) :
+    m_pPrevious(tCurrentArena),
+    m_previousAllocates(tArenaAllocates)
+{
+    tCurrentArena = &arena;
+    tArenaAllocates = allocate;
+}
+
+tgWorldArena::Scope::~Scope()
+{
+    tCurrentArena = m_pPrevious;
+    tArenaAllocates = m_previousAllocates;
+}
+
+tgWorldArena::tgWorldArena(std::size_t chunkSize) :
+    m_chunkSize(alignUp(chunkSize)),
+    m_currentChunk(0),
+    m_offset(0),
+    m_bytesInUse(0)
+{
+    if (chunkSize == 0)
+    {
+        throw std::invalid_argument("Arena chunk size is not positive");
+    }
+
+    pthread_once(&gHooksOnce, installHooks);
+
+    pthread_rwlock_wrlock(&gRegistryLock);
+    gArenas.push_back(this);
+    pthread_rwlock_unlock(&gRegistryLock);
+
+    // Postcondition
+    assert(invariant());
+}
+
+tgWorldArena::~tgWorldArena()
+{
+    assert(tCurrentArena != this);
+
+    pthread_rwlock_wrlock(&gRegistryLock);
+    gArenas.erase(std::remove(gArenas.begin(), gArenas.end(), this),
+                  gArenas.end());
+    for (std::size_t i = 0; i < m_chunks.size(); i++)
+    {
+        std::free(m_chunks[i].begin);
+    }
+    m_chunks.clear();
+    pthread_rwlock_unlock(&gRegistryLock);
+}
+
+void* tgWorldArena::allocate(std::size_t size)
+{
+    const std::size_t n = alignUp(size > 0 ? size : 1);
+
+    // Move forward through chunks kept from before the last release
+    while (m_currentChunk < m_chunks.size() &&
+           m_offset + n > m_chunks[m_currentChunk].size)
+    {
+        m_currentChunk++;
+        m_offset = 0;
+    }
+
+    if (m_currentChunk == m_chunks.size())
+    {
+        addChunk(std::max(n, m_chunkSize));
+        m_offset = 0;
+    }
+
+    void* const result = m_chunks[m_currentChunk].begin + m_offset;
+    m_offset += n;
+    m_bytesInUse += n;
+
+    // Postcondition
+    assert(invariant());
+    return result;
+}
+
+bool tgWorldArena::contains(const void* p) const
+{
+    const char* const c = static_cast<const char*>(p);
+    for (std::size_t i = 0; i < m_chunks.size(); i++)
+    {
+        if (c >= m_chunks[i].begin && c < m_chunks[i].begin + m_chunks[i].size)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void tgWorldArena::release()
+{
+    m_currentChunk = 0;
+    m_offset = 0;
+    m_bytesInUse = 0;
+
+    // Postcondition
+    assert(invariant());
+}
+
+std::size_t tgWorldArena::bytesInUse() const
+{
+    return m_bytesInUse;
+}
+
+std::size_t tgWorldArena::capacity() const
+{
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < m_chunks.size(); i++)
+    {
+        result += m_chunks[i].size;
+    }
+    return result;
+}
+
+tgWorldArena* tgWorldArena::current()
+{
+    return tCurrentArena;
+}
+
+bool tgWorldArena::allocating()
+{
+    return (tCurrentArena != NULL) && tArenaAllocates;
+}
+
+void tgWorldArena::addChunk(std::size_t size)
+{
+    // malloc returns memory aligned for any type, at least 16 bytes on
+    // the platforms we support
+    Chunk chunk;
+    chunk.begin = static_cast<char*>(std::malloc(size));
+    chunk.size = size;
+    if (chunk.begin == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    pthread_rwlock_wrlock(&gRegistryLock);
+    m_chunks.push_back(chunk);
+    pthread_rwlock_unlock(&gRegistryLock);
+}
+
+bool tgWorldArena::invariant() const
+{
+    return (m_chunkSize > 0) &&
+           (m_currentChunk <= m_chunks.size()) &&
+           (m_currentChunk == m_chunks.size() ||
+            m_offset <= m_chunks[m_currentChunk].size);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_WORLD_ARENA_H
+#define TG_WORLD_ARENA_H
+
+/**
+ * @file tgWorldArena.h
+ * @brief Contains the definition of class tgWorldArena
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * A bump allocator owned by a tgWorld. While a tgWorldArena::Scope is
+ * active on a thread, every Bullet allocation made on that thread
+ * (through btAlignedAlloc, which backs new for all Bullet objects)
+ * is served from the arena, and frees of arena memory do nothing.
+ * release() reclaims everything at once and keeps the chunks, so the
+ * next world is built into warm memory.
+ *
+ * Only objects that die with the world may be created inside a scope:
+ * anything still alive after release() points into reused memory.
+ * tgWorld activates a scope while it builds its implementation, and
+ * tgSimulation while it sets up models. Stepping uses a scope that does
+ * not allocate: Bullet's per-step temporaries come and go with malloc,
+ * so the arena stays the same size however long a trial runs, but
+ * blocks the arena handed out during setup are still recognized when
+ * Bullet frees them.
+ */
+class tgWorldArena
+{
+public:
+
+    /**
+     * Makes an arena current on this thread for the lifetime of the
+     * Scope. Scopes nest; the previous arena is restored on destruction.
+     * While a scope is active, frees are checked against its arena
+     * alone, without a lock: a world's objects must not be freed inside
+     * another world's scope.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @param[in] arena the arena to make current
+         * @param[in] allocate if false, allocations go to malloc and the
+         * arena only recognizes its own blocks when they are freed
+         */
+        explicit Scope(tgWorldArena& arena, bool allocate = true);
+
+        ~Scope();
+
+    private:
+        /** Not copyable */
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        tgWorldArena* m_pPrevious;
+        bool m_previousAllocates;
+    };
+
+    /**
+     * @param[in] chunkSize the size in bytes of each block requested
+     * from the system; must be positive. Larger allocations get a chunk
+     * of their own.
+     */
+    explicit tgWorldArena(std::size_t chunkSize = 1024 * 1024);
+
+    /**
+     * Returns all chunks to the system. No memory from this arena may be
+     * in use afterwards.
+     */
+    ~tgWorldArena();
+
+    /**
+     * Allocate size bytes aligned to 16 bytes. Never returns NULL;
+     * throws std::bad_alloc if the system is out of memory.
+     */
+    void* allocate(std::size_t size);
+
+    /** True if p points into one of this arena's chunks. */
+    bool contains(const void* p) const;
+
+    /**
+     * Invalidate every allocation at once. The chunks are kept for reuse.
+     */
+    void release();
+
+    /** Bytes handed out since construction or the last release() */
+    std::size_t bytesInUse() const;
+
+    /** Bytes held from the system */
+    std::size_t capacity() const;
+
+    /** The arena current on this thread, or NULL */
+    static tgWorldArena* current();
+
+    /** True if this thread's Bullet allocations come from current() */
+    static bool allocating();
+
+private:
+
+    /** Not copyable */
+    tgWorldArena(const tgWorldArena&);
+    tgWorldArena& operator=(const tgWorldArena&);
+
+    struct Chunk
+    {
+        char* begin;
+        std::size_t size;
+    };
+
+    void addChunk(std::size_t size);
+
+    bool invariant() const;
+
+    const std::size_t m_chunkSize;
+
+    std::vector<Chunk> m_chunks;
+
+    /** Index into m_chunks of the chunk being filled */
+    std::size_t m_currentChunk;
+
+    /** Offset of the next free byte in the current chunk */
+    std::size_t m_offset;
+
+    std::size_t m_bytesInUse;
+};
+
+#endif  // TG_WORLD_ARENA_H
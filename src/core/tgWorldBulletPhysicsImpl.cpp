@@ -40,6 +40,8 @@
 #include "BulletCollision/CollisionShapes/btBoxShape.h"
 #include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 #include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
@@ -50,6 +52,8 @@
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btVector3.h"
 #include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <cmath>
 
 // Ghost objects
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
@@ -65,6 +69,16 @@
 
 #endif //MLCP_SOLVER
 
+namespace
+{
+    /**
+     * Dimensions of shared shapes are compared after rounding to this
+     * many length units, so rods built from rotated node positions still
+     * share a shape with their identical siblings.
+     */
+    const double sharedShapeQuantum = 1.0e-9;
+}
+
 /**
  * Helper class to bundle objects that have the same life cycle, so they can be
  * constructed and destructed together.
@@ -252,14 +266,94 @@ void tgWorldBulletPhysicsImpl::deleteCollisionShape(btCollisionShape* pShape)
 				deleteCollisionShape(cShape->getChildShape(i));
 			}
 		}
-		m_collisionShapes.remove(pShape);
-        delete pShape;
+		if (!isSharedShape(pShape))
+		{
+			m_collisionShapes.remove(pShape);
+			delete pShape;
+		}
     }
 
       // Postcondition
       assert(invariant());
 }
 
+tgWorldBulletPhysicsImpl::SharedShapeKey::SharedShapeKey(int shapeType,
+        const btVector3& shapeDimensions) :
+    type(shapeType)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        dimensions[i] =
+            static_cast<long long>(std::floor(shapeDimensions[i] / sharedShapeQuantum + 0.5));
+    }
+}
+
+bool tgWorldBulletPhysicsImpl::SharedShapeKey::operator<(
+        const SharedShapeKey& other) const
+{
+    if (type != other.type)
+    {
+        return type < other.type;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        if (dimensions[i] != other.dimensions[i])
+        {
+            return dimensions[i] < other.dimensions[i];
+        }
+    }
+    return false;
+}
+
+btCollisionShape*
+tgWorldBulletPhysicsImpl::findSharedShape(const SharedShapeKey& key) const
+{
+    const SharedShapeMap::const_iterator it = m_sharedShapes.find(key);
+    return (it == m_sharedShapes.end()) ? NULL : it->second;
+}
+
+btCollisionShape*
+tgWorldBulletPhysicsImpl::addSharedShape(const SharedShapeKey& key,
+                                         btCollisionShape* pShape)
+{
+    assert(pShape != NULL);
+    assert(findSharedShape(key) == NULL);
+
+    m_sharedShapes[key] = pShape;
+    m_sharedShapeSet.insert(pShape);
+    addCollisionShape(pShape);
+    return pShape;
+}
+
+btCollisionShape*
+tgWorldBulletPhysicsImpl::getCylinderShape(const btVector3& halfExtents)
+{
+    const SharedShapeKey key(CYLINDER_SHAPE_PROXYTYPE, halfExtents);
+    btCollisionShape* const pShape = findSharedShape(key);
+    return pShape ? pShape : addSharedShape(key, new btCylinderShape(halfExtents));
+}
+
+btCollisionShape*
+tgWorldBulletPhysicsImpl::getBoxShape(const btVector3& halfExtents)
+{
+    const SharedShapeKey key(BOX_SHAPE_PROXYTYPE, halfExtents);
+    btCollisionShape* const pShape = findSharedShape(key);
+    return pShape ? pShape : addSharedShape(key, new btBoxShape(halfExtents));
+}
+
+btCollisionShape* tgWorldBulletPhysicsImpl::getSphereShape(btScalar radius)
+{
+    const SharedShapeKey key(SPHERE_SHAPE_PROXYTYPE, btVector3(radius, 0, 0));
+    btCollisionShape* const pShape = findSharedShape(key);
+    return pShape ? pShape : addSharedShape(key, new btSphereShape(radius));
+}
+
+bool
+tgWorldBulletPhysicsImpl::isSharedShape(const btCollisionShape* pShape) const
+{
+    return m_sharedShapeSet.count(pShape) != 0;
+}
+
 bool tgWorldBulletPhysicsImpl::invariant() const
 {
     return (m_pDynamicsWorld != 0);
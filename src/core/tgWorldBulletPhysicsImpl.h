@@ -31,11 +31,15 @@
 #include "tgWorld.h"
 #include "tgWorldImpl.h"
 #include "LinearMath/btAlignedObjectArray.h"
-
+#include "LinearMath/btScalar.h"
+// The C++ Standard Library
+#include <map>
+#include <set>
 
 
 // Forward declarations
 class btCollisionShape;
+class btVector3;
 class btTypedConstraint;
 class btDynamicsWorld;
 class btRigidBody;
@@ -89,8 +93,43 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
 	 */
 	void addCollisionShape(btCollisionShape* pShape);
 	
+	/**
+	 * Return a btCylinderShape (aligned with the y axis) shared by every
+	 * caller asking for the same dimensions. The world owns the shape.
+	 * @param[in] halfExtents the radius, half length and radius
+	 */
+	btCollisionShape* getCylinderShape(const btVector3& halfExtents);
+
+	/**
+	 * Return a btBoxShape shared by every caller asking for the same
+	 * dimensions. The world owns the shape.
+	 * @param[in] halfExtents the box half extents
+	 */
+	btCollisionShape* getBoxShape(const btVector3& halfExtents);
+
+	/**
+	 * Return a btSphereShape shared by every caller asking for the same
+	 * radius. The world owns the shape.
+	 * @param[in] radius the sphere radius
+	 */
+	btCollisionShape* getSphereShape(btScalar radius);
+
+	/**
+	 * True if pShape was handed out by one of the shared shape getters,
+	 * in which case it must not be deleted by its users.
+	 */
+	bool isSharedShape(const btCollisionShape* pShape) const;
+
+	/** The number of distinct shared shapes created so far */
+	std::size_t sharedShapeCount() const
+	{
+	  return m_sharedShapes.size();
+	}
+	
 	/**
 	 * Immediately delete a collision shape to avoid leaking memory during a rial
+	 * Shared shapes (and shared children of compound shapes) are left
+	 * alone, since other bodies may still refer to them.
 	 * @param[in] pShape a pointer to a btCollisionShape; do nothing if NULL
 	 */
 	void deleteCollisionShape(btCollisionShape* pShape);
@@ -121,6 +160,35 @@ private:
      * @return the newly-created btSoftRigidDynamicsWorld
      */
         btDynamicsWorld* createDynamicsWorld() const;
+
+    /**
+     * Key of the shared shape registry: the shape type and its
+     * dimensions, quantized so that dimensions differing only by
+     * rounding error map to the same shape.
+     */
+    struct SharedShapeKey
+    {
+        SharedShapeKey(int type, const btVector3& dimensions);
+
+        bool operator<(const SharedShapeKey& other) const;
+
+        int type;
+        long long dimensions[3];
+    };
+
+    typedef std::map<SharedShapeKey, btCollisionShape*> SharedShapeMap;
+
+    /**
+     * Find the shared shape for key, or return NULL.
+     */
+    btCollisionShape* findSharedShape(const SharedShapeKey& key) const;
+
+    /**
+     * Register a newly created shape as shared under key and hand its
+     * ownership to the world.
+     */
+    btCollisionShape* addSharedShape(const SharedShapeKey& key,
+                                     btCollisionShape* pShape);
     
     /** Integrity predicate. */
     bool invariant() const;
@@ -144,6 +212,18 @@ private:
      */
     btAlignedObjectArray<btCollisionShape*> m_collisionShapes;
 
+    /**
+     * Shapes shared between rigid bodies, by type and dimensions. Every
+     * shape in here is also in m_collisionShapes, which owns it.
+     */
+    SharedShapeMap m_sharedShapes;
+
+    /**
+     * The shapes in m_sharedShapes, for deleteCollisionShape to look up
+     * without scanning the registry.
+     */
+    std::set<const btCollisionShape*> m_sharedShapeSet;
+
     /* 
      * A vector of constraints for easy reference. Does not affect
      * physics or rendering unles the constraint is placed into the dynamics
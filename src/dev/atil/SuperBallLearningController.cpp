@@ -44,6 +44,9 @@ SuperBallPrefLengthController::SuperBallPrefLengthController(const double initia
 	this->m_totalTime=0.0;
 
 	evolution = new AnnealEvolution("superball");
+	// Every trial starts on the same plane with the goal in the same
+	// place, and nothing is random, so scoreCachePolicy 3 may reuse scores
+	evolution->setTrialConditions(0, "plane", true);
 
 }
 
@@ -160,6 +160,11 @@ void JSONQuadFeedbackControl::onSetup(BaseSpineModelLearning& subject)
     
     nn->loadWeights(nnFile.c_str());
     
+    m_feedbackCables = subject.find<tgSpringCableActuator> ("leg_to ");
+    m_nnInputs.assign(m_config.numStates, 0.0);
+    m_feedback.clear();
+    m_feedback.reserve(m_feedbackCables.size() * m_config.numActions);
+    
     initConditions = subject.getSegmentCOM(m_config.segmentNumber);
     for (int i = 0; i < initConditions.size(); i++)
     {
@@ -207,7 +212,7 @@ void JSONQuadFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = getFeedback(subject);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -417,83 +422,52 @@ array_2D JSONQuadFeedbackControl::scaleNodeActions (Json::Value actions)
     return nodeActions;
 }
 
-std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
+std::vector<double>& JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
 {
-    // Placeholder
-    std::vector<double> feedback;
-    
-    const std::vector<tgSpringCableActuator*>& spineCables = subject.find<tgSpringCableActuator> ("leg_to ");
+    // clear keeps the capacity reserved in onSetup
+    m_feedback.clear();
     
-    double *inputs = new double[m_config.numStates];
+    assert(m_config.numStates >= 2);
     
-    std::size_t n = spineCables.size();
+    std::size_t n = m_feedbackCables.size();
     for(std::size_t i = 0; i != n; i++)
     {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(spineCables[i]);
-        std::vector<double > state = getCableState(cable);
+        const tgSpringCableActuator& cable = *(m_feedbackCables[i]);
+        getCableState(cable, &m_nnInputs[0]);
         
         // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
+        for (std::size_t j = 0; j < 2; j++)
         {
-            inputs[i]=state[i] / 2.0 + 0.5;
+            m_nnInputs[j] = m_nnInputs[j] / 2.0 + 0.5;
         }
         
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
-
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
+        const double *output = nn->feedForwardPattern(&m_nnInputs[0]);
+        transformFeedbackActions(output, m_feedback);
     }
     
-    
-    return feedback;
+    return m_feedback;
 }
 
-std::vector<double> JSONQuadFeedbackControl::getCableState(const tgSpringCableActuator& cable)
+void JSONQuadFeedbackControl::getCableState(const tgSpringCableActuator& cable,
+                                            double* state) const
 {
 	// For each string, scale value from -1 to 1 based on initial length or max tension of motor
     
-    std::vector<double> state;
-    
     // Scale length by starting length
     const double startLength = cable.getStartLength();
-    state.push_back((cable.getCurrentLength() - startLength) / startLength);
+    state[0] = (cable.getCurrentLength() - startLength) / startLength;
     
     const double maxTension = cable.getConfig().maxTens;
-    state.push_back((cable.getTension() - maxTension / 2.0) / maxTension);
-    
-	return state;
+    state[1] = (cable.getTension() - maxTension / 2.0) / maxTension;
 }
 
-std::vector<double> JSONQuadFeedbackControl::transformFeedbackActions(std::vector< std::vector<double> >& actions)
+void JSONQuadFeedbackControl::transformFeedbackActions(const double* actions,
+                                                       std::vector<double>& feedback) const
 {
-	// Placeholder
-	std::vector<double> feedback;
-    
-    // Leave in place for generalization later
-    const std::size_t numControllers = 1;
-    const std::size_t numActions = m_config.numActions;
-    
-    assert( actions.size() == numControllers);
-    assert( actions[0].size() == numActions);
-    
     // Scale values back to -1 to +1
-    for( std::size_t i = 0; i < numControllers; i++)
+    for( int j = 0; j < m_config.numActions; j++)
     {
-        for( std::size_t j = 0; j < numActions; j++)
-        {
-            feedback.push_back(actions[i][j] * 2.0 - 1.0);
-        }
+        feedback.push_back(actions[j] * 2.0 - 1.0);
     }
-    
-	return feedback;
 }
 
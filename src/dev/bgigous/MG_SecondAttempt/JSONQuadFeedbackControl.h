@@ -116,11 +116,19 @@ protected:
     
     virtual array_2D scaleNodeActions (Json::Value actions);
     
-    std::vector<double> getFeedback(BaseSpineModelLearning& subject);
+    /**
+     * Fill m_feedback with the descending commands for every cable.
+     * All buffers are members that keep their capacity, so after the
+     * first control step this does not allocate.
+     */
+    std::vector<double>& getFeedback(BaseSpineModelLearning& subject);
     
-    std::vector<double> getCableState(const tgSpringCableActuator& cable);
+    /** Write the scaled length and tension of cable into state */
+    void getCableState(const tgSpringCableActuator& cable, double* state) const;
     
-    std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
+    /** Append the network outputs, scaled back to -1 to +1, to feedback */
+    void transformFeedbackActions(const double* actions,
+                                  std::vector<double>& feedback) const;
     
     JSONQuadFeedbackControl::Config m_config;
 
@@ -129,6 +137,13 @@ protected:
     /// @todo generalize this if we need more than one
     neuralNetwork* nn;
     
+    /** The cables providing feedback, found once in onSetup */
+    std::vector<tgSpringCableActuator*> m_feedbackCables;
+    
+    /** Reused buffers for getFeedback */
+    std::vector<double> m_nnInputs;
+    std::vector<double> m_feedback;
+    
 };
 
 #endif // JSON_QUAD_FEEDBACK_CONTROL_H
@@ -24,9 +24,8 @@
  * $Id$
  */
 
-// This application
-#include "CordeModel.h"
 // This library
+#include "core/CordeModel.h"
 #include "core/tgModel.h"
 #include "core/tgSimViewGraphics.h"
 #include "core/tgSimulation.h"
@@ -83,6 +82,19 @@ int main(int argc, char** argv)
 	{
 		testString.step(dt);
 		t += dt;
+		
+		if (i % 100 == 99)
+		{
+			for (std::size_t j = 0; j < testString.getNumMassPoints(); j++)
+			{
+				std::cout << "Position " << j << " " << testString.getPosition(j) << std::endl
+						  << "Force " << j << " " << testString.getForce(j) << std::endl;
+				if (j < testString.getNumCenterlines())
+				{
+				std::cout << "Quaternion " << j << " " << testString.getQuaternion(j) << std::endl;
+				}
+			}
+		}
 	}
 	#ifdef BT_USE_DOUBLE_PRECISION
 		std::cout << "Double precision" << std::endl;
@@ -384,6 +384,11 @@ double JSONCPGControl::getScore() const
 		throw std::runtime_error("Called before scores were obtained!");
 	}
 }
+
+const std::vector<double>& JSONCPGControl::getScores() const
+{
+	return scores;
+}
 	
 
 array_4D JSONCPGControl::scaleEdgeActions  
@@ -125,6 +125,9 @@ struct Config
 	
 	double getScore() const;
 	
+	/** Distance and energy of the last run, empty before the first teardown */
+	const std::vector<double>& getScores() const;
+	
 protected:
     /**
      * Takes a vector of parameters reported by learning, and then 
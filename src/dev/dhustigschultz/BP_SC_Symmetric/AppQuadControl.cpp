@@ -28,8 +28,98 @@
 #include "AppQuadControl.h"
 #include "dev/btietz/JSONTests/tgCPGJSONLogger.h"
 
+// JSON
+#include <json/reader.h>
+#include <json/writer.h>
+
+// The C++ Standard Library
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+// POSIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    /** Connect to a listening Unix domain stream socket */
+    int connectWorkerSocket(const std::string& path)
+    {
+        sockaddr_un address;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw std::invalid_argument("Worker socket path is too long");
+        }
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path.c_str());
+
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not create worker socket");
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address),
+                    sizeof(address)) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Could not connect to " + path);
+        }
+        return fd;
+    }
+
+    /** Read up to and excluding the next newline. False at end of file. */
+    bool readLine(FILE* stream, std::string& line)
+    {
+        line.clear();
+        int c;
+        while ((c = std::fgetc(stream)) != EOF && c != '\n')
+        {
+            line += static_cast<char>(c);
+        }
+        return c != EOF || !line.empty();
+    }
+
+    void writeAll(int fd, const std::string& message)
+    {
+        std::size_t written = 0;
+        while (written < message.size())
+        {
+            const ssize_t n = write(fd, message.data() + written,
+                                    message.size() - written);
+            if (n <= 0)
+            {
+                throw std::runtime_error("Lost connection to the scheduler");
+            }
+            written += n;
+        }
+    }
+
+    /**
+     * Check that request's member name, if present, is of the type
+     * isType tests for, e.g. &Json::Value::isBool. Its as...() accessor
+     * would throw Json::LogicError otherwise.
+     */
+    void checkMember(const Json::Value& request, const char* name,
+                     bool (Json::Value::*isType)() const,
+                     const char* typeName)
+    {
+        if (request.isMember(name) && !(request[name].*isType)())
+        {
+            throw std::invalid_argument(std::string(name) + " is not " + typeName);
+        }
+    }
+}
+
 AppQuadControl::AppQuadControl(int argc, char** argv)
 {
+    world = NULL;
+    view = NULL;
+    simulation = NULL;
+    control = NULL;
+    trialModel = NULL;
     bSetup = false;
     use_graphics = false;
     add_controller = true;
@@ -68,12 +158,37 @@ bool AppQuadControl::setup()
     // Third create the simulation
     simulation = new tgSimulation(*view);
 
+    // Worker trials add the model once their parameters arrive
+    if (!workerSocket.empty())
+    {
+        bSetup = true;
+        return bSetup;
+    }
+
     // Fourth create the models with their controllers and add the models to the
     // simulation
     /// @todo add position and angle to configuration
         //FlemonsSpineModelContact* myModel =
       //new FlemonsSpineModelContact(nSegments); 
 
+    // Fifth create the controllers, attach to model
+    BigPuppySymmetric* myModel = createModel();
+
+    // Sixth add model & controller to simulation
+    simulation->addModel(myModel);
+    
+    if (add_blocks)
+    {
+        tgModel* blockField = getBlocks();
+        simulation->addObstacle(blockField);
+    }
+    
+    bSetup = true;
+    return bSetup;
+}
+
+BigPuppySymmetric* AppQuadControl::createModel()
+{
     //Parameters for the structure:
     const int segments = 7;
     const int hips = 4;
@@ -82,7 +197,7 @@ bool AppQuadControl::setup()
 
     BigPuppySymmetric* myModel = new BigPuppySymmetric(segments, hips, legs, feet);
 
-    // Fifth create the controllers, attach to model
+    control = NULL;
     if (add_controller)
     {
         const int segmentSpan = 3; //Not sure what this will be for mine!
@@ -140,9 +255,7 @@ bool AppQuadControl::setup()
                                                     pfMax,
 						    maxH,
 						    minH);
-        /// @todo fix memory leak that occurs here
-       JSONQuadFeedbackControl* const myControl =
-        new JSONQuadFeedbackControl(control_config, suffix, lowerPath);
+       control = new JSONQuadFeedbackControl(control_config, suffix, lowerPath);
 
 #if (0)        
             tgCPGJSONLogger* const myLogger = 
@@ -150,20 +263,10 @@ bool AppQuadControl::setup()
     
     myControl->attach(myLogger);
 #endif        
-        myModel->attach(myControl);
+        myModel->attach(control);
     }
 
-    // Sixth add model & controller to simulation
-    simulation->addModel(myModel);
-    
-    if (add_blocks)
-    {
-        tgModel* blockField = getBlocks();
-        simulation->addObstacle(blockField);
-    }
-    
-    bSetup = true;
-    return bSetup;
+    return myModel;
 }
 
 void AppQuadControl::handleOptions(int argc, char **argv)
@@ -189,6 +292,7 @@ void AppQuadControl::handleOptions(int argc, char **argv)
         ("goal_angle,B", po::value<double>(&goalAngle), "Angle of starting rotation for goal box. Degrees. Default = 0")
         ("learning_controller,l", po::value<std::string>(&suffix), "Which learned controller to write to or use. Default = default")
 	("lower_path,P", po::value<std::string>(&lowerPath), "Which resources folder in which you want to store controllers. Default = default")
+        ("worker,W", po::value<std::string>(&workerSocket), "Serve trials to the learning scripts over this Unix socket instead of running episodes.")
     ;
 
     po::variables_map vm;
@@ -254,31 +358,34 @@ const tgBoxGround::Config AppQuadControl::getBoxConfig()
 
 tgModel* AppQuadControl::getBlocks()
 {
-    // Room to add a config
-    tgBlockField* myObstacle = new tgBlockField();
+    // The blocks never move, so they can share one compound body
+    tgBlockField::Config config;
+    config.m_batch = tgStaticBoxBatch::eCompound;
+    tgBlockField* myObstacle = new tgBlockField(config);
     return myObstacle;
 }
 
-tgWorld* AppQuadControl::createWorld()
+tgBulletGround* AppQuadControl::createGround()
 {
-    const tgWorld::Config config(
-        981 // gravity, cm/sec^2
-    );
-    
-    tgBulletGround* ground;
-    
     if (add_hills)
     {
         const tgHillyGround::Config hillGroundConfig = getHillyConfig();
-        ground = new tgHillyGround(hillGroundConfig);
+        return new tgHillyGround(hillGroundConfig);
     }
     else
     {
         const tgBoxGround::Config groundConfig = getBoxConfig();
-        ground = new tgBoxGround(groundConfig);
+        return new tgBoxGround(groundConfig);
     }
+}
+
+tgWorld* AppQuadControl::createWorld()
+{
+    const tgWorld::Config config(
+        981 // gravity, cm/sec^2
+    );
     
-    return new tgWorld(config, ground);
+    return new tgWorld(config, createGround());
 }
 
 tgSimViewGraphics *AppQuadControl::createGraphicsView(tgWorld *world)
@@ -298,7 +405,11 @@ bool AppQuadControl::run()
         setup();
     }
 
-    if (use_graphics)
+    if (!workerSocket.empty())
+    {
+        serve();
+    }
+    else if (use_graphics)
     {
         // Run until the user stops
         simulation->run();
@@ -311,12 +422,165 @@ bool AppQuadControl::run()
     
     ///@todo consider app.cleanup()
    delete simulation;
+   // Only after the model's teardown, which scores the last trial
+   delete control;
    delete view;
    delete world;
     
     return true;
 }
 
+bool AppQuadControl::serve()
+{
+    const int fd = connectWorkerSocket(workerSocket);
+    FILE* const stream = fdopen(fd, "r");
+    if (stream == NULL)
+    {
+        close(fd);
+        throw std::runtime_error("Could not read from worker socket");
+    }
+
+    Json::FastWriter writer;
+    std::string line;
+    bool usable = true;
+    while (usable && readLine(stream, line))
+    {
+        Json::Value request;
+        Json::Reader reader;
+        Json::Value reply;
+        if (reader.parse(line, request))
+        {
+            usable = runTrial(request, reply);
+        }
+        else
+        {
+            reply["error"] = reader.getFormattedErrorMessages();
+        }
+        // FastWriter ends each message with a newline
+        writeAll(fd, writer.write(reply));
+    }
+
+    // Also closes fd
+    fclose(stream);
+    return true;
+}
+
+bool AppQuadControl::runTrial(const Json::Value& request, Json::Value& reply)
+{
+    try
+    {
+        if (!request.isObject())
+        {
+            throw std::invalid_argument("Request is not an object");
+        }
+        checkMember(request, "params", &Json::Value::isObject, "an object");
+        checkMember(request, "filename", &Json::Value::isString, "a string");
+        checkMember(request, "path", &Json::Value::isString, "a string");
+        checkMember(request, "steps", &Json::Value::isInt, "an integer");
+        checkMember(request, "blocks", &Json::Value::isBool, "a boolean");
+        checkMember(request, "hills", &Json::Value::isBool, "a boolean");
+        if (!request.isMember("params"))
+        {
+            throw std::invalid_argument("No params");
+        }
+        if (request.get("steps", nSteps).asInt() < 0)
+        {
+            throw std::invalid_argument("steps is negative");
+        }
+        if (trialModel != NULL &&
+            request.get("path", lowerPath).asString() != lowerPath)
+        {
+            throw std::invalid_argument("path differs from this worker's");
+        }
+        if (!add_controller)
+        {
+            throw std::invalid_argument("The worker has no controller");
+        }
+    }
+    catch (const std::invalid_argument& e)
+    {
+        // Nothing was changed, so the next request can still run
+        reply["filename"] = request.isObject() && request["filename"].isString() ?
+                            request["filename"] : Json::Value("");
+        reply["error"] = e.what();
+        return true;
+    }
+
+    reply["filename"] = request.get("filename", "").asString();
+    const int steps = request.get("steps", nSteps).asInt();
+    const bool blocks = request.get("blocks", false).asBool();
+    const bool hills = request.get("hills", false).asBool();
+
+    try
+    {
+        if (trialModel == NULL)
+        {
+            // Only rebuild the world's ground when the terrain changes
+            if (hills != add_hills)
+            {
+                add_hills = hills;
+                world->reset(createGround());
+            }
+            lowerPath = request.get("path", lowerPath).asString();
+            BigPuppySymmetric* const myModel = createModel();
+            control->setParameters(request["params"]);
+            try
+            {
+                simulation->addModel(myModel);
+            }
+            catch (...)
+            {
+                // Never added, so the simulation won't delete it
+                delete myModel;
+                delete control;
+                control = NULL;
+                throw;
+            }
+            trialModel = myModel;
+        }
+        else
+        {
+            // Tears down the last trial, sets up with the new parameters
+            control->setParameters(request["params"]);
+            if (hills != add_hills)
+            {
+                add_hills = hills;
+                simulation->reset(createGround());
+            }
+            else
+            {
+                simulation->reset();
+            }
+        }
+        if (blocks)
+        {
+            simulation->addObstacle(getBlocks());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // Most likely bad parameters. The world may hold part of a
+        // model, so let the scheduler start a fresh worker.
+        reply["error"] = e.what();
+        return false;
+    }
+
+    try
+    {
+        simulation->run(steps);
+    }
+    catch (const std::runtime_error& e)
+    {
+        // Nothing to do here, score will be set to -1
+    }
+
+    control->updateScores(*trialModel);
+    const std::vector<double>& scores = control->getScores();
+    reply["scores"]["distance"] = scores[0];
+    reply["scores"]["energy"] = scores[1];
+    return true;
+}
+
 void AppQuadControl::simulate(tgSimulation *simulation)
 {
     for (int i=0; i<nEpisodes; i++) {
@@ -325,7 +589,7 @@ void AppQuadControl::simulate(tgSimulation *simulation)
         {
             simulation->run(nSteps);
         }
-        catch (std::runtime_error e)
+        catch (const std::runtime_error& e)
         {
             // Nothing to do here, score will be set to -1
         }
@@ -47,6 +47,9 @@
 // Boost
 #include <boost/program_options.hpp>
 
+// JSON
+#include <json/value.h>
+
 // The C++ Standard Library
 #include <iostream>
 #include <string>
@@ -63,6 +66,14 @@ public:
     /** Run the simulation */
     bool run();
 
+    /**
+     * Worker mode: connect to the Unix socket given with --worker and
+     * run one trial per request line until the other end hangs up or a
+     * trial leaves the simulation unusable. The simulation, model and
+     * controller are built once and reset between trials.
+     */
+    bool serve();
+
 private:
     /** Parse command line options */
     void handleOptions(int argc, char** argv);
@@ -73,9 +84,18 @@ private:
     
     tgModel* getBlocks();
     
+    /** The ground selected by add_hills */
+    tgBulletGround* createGround();
+
     /** Create the tgWorld object */
     tgWorld *createWorld();
 
+    /**
+     * Create the robot and, if add_controller is set, attach a new
+     * controller for the current suffix and lowerPath to it.
+     */
+    BigPuppySymmetric* createModel();
+
     /** Use for displaying tensegrities in simulation */
     tgSimViewGraphics *createGraphicsView(tgWorld *world);
 
@@ -84,12 +104,30 @@ private:
 
     /** Run a series of episodes for nSteps each */
     void simulate(tgSimulation *simulation);
+
+    /**
+     * Run one worker request: {"params", "filename", "path", "steps",
+     * "blocks", "hills"}. params is the trial's parameter document, as
+     * in a parameter file, and is required; filename only labels the
+     * reply. The first request's path is where the controller finds its
+     * neural network weights; later requests must use the same one.
+     * No files are read or written besides the weights.
+     * @param[out] reply {"filename", "scores": {"distance", "energy"}},
+     * or {"filename", "error"} if the request was malformed or the
+     * trial could not be set up
+     * @return false if the simulation can't be used for more trials
+     */
+    bool runTrial(const Json::Value& request, Json::Value& reply);
     
     
     // Keep these around for cleanup
     tgWorld* world;
     tgSimView* view;
     tgSimulation* simulation;
+    /** The controller of the latest model, NULL without a controller */
+    JSONQuadFeedbackControl* control;
+    /** The model worker trials reuse, NULL before the first trial */
+    BigPuppySymmetric* trialModel;
 
     bool use_graphics;
     bool add_controller;
@@ -111,6 +149,8 @@ private:
     
     std::string lowerPath; 
     std::string suffix;
+    /** Socket to serve trials on, empty unless running as a worker */
+    std::string workerSocket;
     
     bool bSetup;
 };
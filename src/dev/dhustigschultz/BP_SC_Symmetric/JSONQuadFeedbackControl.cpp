@@ -105,7 +105,9 @@ JSONQuadFeedbackControl::JSONQuadFeedbackControl(JSONQuadFeedbackControl::Config
                                                 std::string args,
                                                 std::string resourcePath) :
 JSONCPGControl(config, args, resourcePath),
-m_config(config)
+m_config(config),
+nn(NULL),
+m_hasParameters(false)
 {
     // Path and filename handled by base class
     
@@ -123,8 +125,11 @@ void JSONQuadFeedbackControl::onSetup(BaseSpineModelLearning& subject)
     Json::Value root; // will contains the root value after parsing.
     Json::Reader reader;
 
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
-    if ( !parsingSuccessful )
+    if (m_hasParameters)
+    {
+        root = m_parameters;
+    }
+    else if ( !reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root ) )
     {
         // report to the user the failure and their locations in the document.
         std::cout << "Failed to parse configuration\n"
@@ -156,10 +161,17 @@ void JSONQuadFeedbackControl::onSetup(BaseSpineModelLearning& subject)
     
     std::string nnFile = controlFilePath + feedbackParams.get("neuralFilename", "UTF-8").asString();
     
+    // Set up again on every reset
+    delete nn;
     nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
     
+    m_feedbackCables = subject.find<tgSpringCableActuator> ("spine ");
+    m_nnInputs.assign(m_config.numStates, 0.0);
+    m_feedback.clear();
+    m_feedback.reserve(m_feedbackCables.size() * m_config.numActions);
+    
     initConditions = subject.getSegmentCOM(m_config.segmentNumber);
     for (int i = 0; i < initConditions.size(); i++)
     {
@@ -183,7 +195,7 @@ void JSONQuadFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = getFeedback(subject);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -221,6 +233,57 @@ void JSONQuadFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
 }
 
 void JSONQuadFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
+{
+    updateScores(subject);
+    
+    std::cout << "Dist travelled " << scores[0] << std::endl;
+    
+    if (!m_hasParameters)
+    {
+        Json::Value root; // will contains the root value after parsing.
+        Json::Reader reader;
+
+        bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
+        if ( !parsingSuccessful )
+        {
+            // report to the user the failure and their locations in the document.
+            std::cout << "Failed to parse configuration\n"
+                << reader.getFormattedErrorMessages();
+            throw std::invalid_argument("Bad filename for JSON");
+        }
+        
+        Json::Value prevScores = root.get("scores", Json::nullValue);
+        
+        Json::Value subScores;
+        subScores["distance"] = scores[0];
+        subScores["energy"] = scores[1];
+        
+        prevScores.append(subScores);
+        root["scores"] = prevScores;
+        
+        ofstream payloadLog;
+        payloadLog.open(controlFilename.c_str(),ofstream::out);
+        
+        payloadLog << root << std::endl;
+    }
+    
+    delete m_pCPGSys;
+    m_pCPGSys = NULL;
+    
+    for(size_t i = 0; i < m_spineControllers.size(); i++)
+    {
+        delete m_spineControllers[i];
+    }
+    m_spineControllers.clear();    
+}
+
+void JSONQuadFeedbackControl::setParameters(const Json::Value& root)
+{
+    m_parameters = root;
+    m_hasParameters = true;
+}
+
+void JSONQuadFeedbackControl::updateScores(BaseSpineModelLearning& subject)
 {
     scores.clear();
     // @todo - check to make sure we ran for the right amount of time
@@ -269,43 +332,6 @@ void JSONQuadFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
     }
     
     scores.push_back(totalEnergySpent);
-    
-    std::cout << "Dist travelled " << scores[0] << std::endl;
-    
-    Json::Value root; // will contains the root value after parsing.
-    Json::Reader reader;
-
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
-    if ( !parsingSuccessful )
-    {
-        // report to the user the failure and their locations in the document.
-        std::cout << "Failed to parse configuration\n"
-            << reader.getFormattedErrorMessages();
-        throw std::invalid_argument("Bad filename for JSON");
-    }
-    
-    Json::Value prevScores = root.get("scores", Json::nullValue);
-    
-    Json::Value subScores;
-    subScores["distance"] = scores[0];
-    subScores["energy"] = totalEnergySpent;
-    
-    prevScores.append(subScores);
-    root["scores"] = prevScores;
-    
-    ofstream payloadLog;
-    payloadLog.open(controlFilename.c_str(),ofstream::out);
-    
-    payloadLog << root << std::endl;
-    
-    delete m_pCPGSys;
-    m_pCPGSys = NULL;
-    
-    for(size_t i = 0; i < m_spineControllers.size(); i++)
-    {
-        delete m_spineControllers[i];
-    }
-    m_spineControllers.clear();    
 }
 
 void JSONQuadFeedbackControl::setupCPGs(BaseSpineModelLearning& subject, array_2D nodeActions, array_4D edgeActions)
@@ -392,83 +418,52 @@ array_2D JSONQuadFeedbackControl::scaleNodeActions (Json::Value actions)
     return nodeActions;
 }
 
-std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
+std::vector<double>& JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
 {
-    // Placeholder
-    std::vector<double> feedback;
-    
-    const std::vector<tgSpringCableActuator*>& spineCables = subject.find<tgSpringCableActuator> ("spine ");
+    // clear keeps the capacity reserved in onSetup
+    m_feedback.clear();
     
-    double *inputs = new double[m_config.numStates];
+    assert(m_config.numStates >= 2);
     
-    std::size_t n = spineCables.size();
+    std::size_t n = m_feedbackCables.size();
     for(std::size_t i = 0; i != n; i++)
     {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(spineCables[i]);
-        std::vector<double > state = getCableState(cable);
+        const tgSpringCableActuator& cable = *(m_feedbackCables[i]);
+        getCableState(cable, &m_nnInputs[0]);
         
         // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
+        for (std::size_t j = 0; j < 2; j++)
         {
-            inputs[i]=state[i] / 2.0 + 0.5;
+            m_nnInputs[j] = m_nnInputs[j] / 2.0 + 0.5;
         }
         
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
-
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
+        const double *output = nn->feedForwardPattern(&m_nnInputs[0]);
+        transformFeedbackActions(output, m_feedback);
     }
     
-    
-    return feedback;
+    return m_feedback;
 }
 
-std::vector<double> JSONQuadFeedbackControl::getCableState(const tgSpringCableActuator& cable)
+void JSONQuadFeedbackControl::getCableState(const tgSpringCableActuator& cable,
+                                            double* state) const
 {
 	// For each string, scale value from -1 to 1 based on initial length or max tension of motor
     
-    std::vector<double> state;
-    
     // Scale length by starting length
     const double startLength = cable.getStartLength();
-    state.push_back((cable.getCurrentLength() - startLength) / startLength);
+    state[0] = (cable.getCurrentLength() - startLength) / startLength;
     
     const double maxTension = cable.getConfig().maxTens;
-    state.push_back((cable.getTension() - maxTension / 2.0) / maxTension);
-    
-	return state;
+    state[1] = (cable.getTension() - maxTension / 2.0) / maxTension;
 }
 
-std::vector<double> JSONQuadFeedbackControl::transformFeedbackActions(std::vector< std::vector<double> >& actions)
+void JSONQuadFeedbackControl::transformFeedbackActions(const double* actions,
+                                                       std::vector<double>& feedback) const
 {
-	// Placeholder
-	std::vector<double> feedback;
-    
-    // Leave in place for generalization later
-    const std::size_t numControllers = 1;
-    const std::size_t numActions = m_config.numActions;
-    
-    assert( actions.size() == numControllers);
-    assert( actions[0].size() == numActions);
-    
     // Scale values back to -1 to +1
-    for( std::size_t i = 0; i < numControllers; i++)
+    for( int j = 0; j < m_config.numActions; j++)
     {
-        for( std::size_t j = 0; j < numActions; j++)
-        {
-            feedback.push_back(actions[i][j] * 2.0 - 1.0);
-        }
+        feedback.push_back(actions[j] * 2.0 - 1.0);
     }
-    
-	return feedback;
 }
 
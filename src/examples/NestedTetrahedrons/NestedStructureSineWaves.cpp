@@ -33,11 +33,17 @@
 // NTRTSim
 #include "core/tgBasicActuator.h"
 #include "controllers/tgImpedanceController.h"
+#include "controllers/tgPIDController.h"
 #include "tgcreator/tgUtil.h"
 
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+
 NestedStructureSineWaves::NestedStructureSineWaves() :
     in_controller(new tgImpedanceController(100, 500, 50)),
     out_controller(new tgImpedanceController(100, 500, 100)),
+    numInside(0),
     segments(1.0),
     insideLength(16.5),
     outsideLength(19.5),
@@ -61,42 +67,39 @@ NestedStructureSineWaves::~NestedStructureSineWaves()
 	delete out_controller;
 }
 
-void NestedStructureSineWaves::applyImpedanceControlInside(const std::vector<tgBasicActuator*> stringList, double dt)
+void NestedStructureSineWaves::addGroup(const std::vector<tgBasicActuator*>& stringList,
+                                        const tgImpedanceController& impedance,
+                                        std::size_t phase)
 {
+    // The PID gains are unused: tgBasicActuators track the set tension
+    // through their rest length, as in tgImpedanceController::control
+    const tgPIDController::Config unusedPID;
     for(std::size_t i = 0; i < stringList.size(); i++)
     {
-        double setTension = in_controller->control(*(stringList[i]),
-                                            dt,
-                                            insideLength
-                                            );
-        #if (0) // Conditional compile for verbose control
-        std::cout << "Inside String " << i << " tension " << setTension
-        << " act tension " << stringList[i]->getMuscle()->getTension()
-        << " length " << stringList[i]->getMuscle()->getActualLength() << std::endl;
-        #endif
-    }    
+        bank.addActuator(stringList[i], unusedPID, impedance);
+        groupIndex.push_back(i);
+        groupPhase.push_back(phase);
+    }
 }
 
-void NestedStructureSineWaves::applyImpedanceControlOutside(const std::vector<tgBasicActuator*> stringList,
-                                                            double dt,
-                                                            std::size_t phase)
+void NestedStructureSineWaves::onSetup(NestedStructureTestModel& subject)
 {
-    for(std::size_t i = 0; i < stringList.size(); i++)
-    {
-        cycle = sin(simTime * cpgFrequency + 2 * bodyWaves * M_PI * i / (segments) + phaseOffsets[phase]);
-        target = offsetSpeed + cycle*cpgAmplitude;
-        
-        double setTension = out_controller->control(*(stringList[i]),
-                                            dt,
-                                            outsideLength,
-                                            target
-                                            );
-        #if(0) // Conditional compile for verbose control
-        std::cout << "Outside String " << i << " com tension " << setTension
-        << " act tension " << stringList[i]->getMuscle()->getTension()
-        << " length " << stringList[i]->getMuscle()->getActualLength() << std::endl;
-        #endif
-    }    
+    bank = tgControllerBank();
+    groupIndex.clear();
+    groupPhase.clear();
+    
+    addGroup(subject.getActuators("inner top"), *in_controller, 0);
+    addGroup(subject.getActuators("inner left"), *in_controller, 0);
+    addGroup(subject.getActuators("inner right"), *in_controller, 0);
+    numInside = bank.size();
+    
+    addGroup(subject.getActuators("outer top"), *out_controller, 0);
+    addGroup(subject.getActuators("outer left"), *out_controller, 1);
+    addGroup(subject.getActuators("outer right"), *out_controller, 2);
+    
+    positions.assign(bank.size(), outsideLength);
+    std::fill(positions.begin(), positions.begin() + numInside, insideLength);
+    offsetVels.assign(bank.size(), 0.0);
 }
 
 void NestedStructureSineWaves::onStep(NestedStructureTestModel& subject, double dt)
@@ -105,13 +108,25 @@ void NestedStructureSineWaves::onStep(NestedStructureTestModel& subject, double
     
     segments = subject.getSegments();
     
-    applyImpedanceControlInside(subject.getActuators("inner top"), dt);
-    applyImpedanceControlInside(subject.getActuators("inner left") , dt);
-    applyImpedanceControlInside(subject.getActuators("inner right"), dt);
+    for(std::size_t i = numInside; i < bank.size(); i++)
+    {
+        cycle = sin(simTime * cpgFrequency + 2 * bodyWaves * M_PI * groupIndex[i] / (segments) + phaseOffsets[groupPhase[i]]);
+        target = offsetSpeed + cycle*cpgAmplitude;
+        offsetVels[i] = target;
+    }
+    
+    if (bank.size() > 0)
+    {
+        bank.controlImpedance(dt, &positions[0], NULL, &offsetVels[0]);
+    }
     
-    applyImpedanceControlOutside(subject.getActuators("outer top"), dt, 0);
-    applyImpedanceControlOutside(subject.getActuators("outer left"), dt, 1);
-    applyImpedanceControlOutside(subject.getActuators("outer right"), dt, 2);
+    #if (0) // Conditional compile for verbose control
+    const std::vector<double>& setTensions = bank.getSetTensions();
+    for(std::size_t i = 0; i < bank.size(); i++)
+    {
+        std::cout << "String " << i << " com tension " << setTensions[i]
+        << " rest length " << bank.getCommands()[i] << std::endl;
+    }
+    #endif
 }
     
-
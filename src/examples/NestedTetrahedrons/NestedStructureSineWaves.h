@@ -29,8 +29,10 @@
 
 // NTRTSim
 #include "core/tgObserver.h"
+#include "controllers/tgControllerBank.h"
 
 // The C++ Standard Library
+#include <cstddef>
 #include <vector>
 
 // Forward Declarations
@@ -59,30 +61,19 @@ public:
     ~NestedStructureSineWaves();
     
     /**
-     * Applies the impedance controllers using a velocity setpoint of 0.
-     * Called during this classes onStep function.
-     * @param[in] stringList a std::vector of strings taken from the
-     * subject's MuscleMap
-     * @param[in] dt - a timestep. Must be positive.
+     * Put every actuator of the subject in one controller bank, the
+     * inner ones with in_controller's gains and the outer ones with
+     * out_controller's. Called by the subject's setup, so a reset
+     * rebuilds the bank around the new actuators.
+     * @param[in] subject - the NestedStructureTestModel that was set up
      */
-    void applyImpedanceControlInside(const std::vector<tgBasicActuator*> stringList,
-									double dt);
-    /**
-     * Applies the impedance controllers using a velocity setpoint determined.
-     * by the phase parameter and 
-     * Called during this classes onStep function.
-     * @param[in] stringList a std::vector of strings taken from the
-     * subject's MuscleMap
-     * @param[in] dt - a timestep. Must be positive.
-     * @param[in] phase - reads the index out of the phaseOffsets vector
-     */                                    
-    void applyImpedanceControlOutside(const std::vector<tgBasicActuator*> stringList,
-                                    double dt,
-                                    std::size_t phase);
+    virtual void onSetup(NestedStructureTestModel& subject);
     
     /**
      * Apply the sineWave controller. Called my notifyStep(dt) of its
-     * subject. Calls the applyImpedanceControl functions of this class
+     * subject. Runs the impedance control of every actuator in one
+     * pass of the bank, with a velocity setpoint of 0 inside and the
+     * sine waves outside
      * @param[in] subject - the NestedStructureTestModel that is being 
      * Subject must have a MuscleMap populated
      * @param[in] dt, current timestep must be positive
@@ -96,6 +87,26 @@ private:
     tgImpedanceController* in_controller;
     tgImpedanceController* out_controller;
     
+    /**
+     * The impedance control of every actuator, filled by onSetup
+     */
+    tgControllerBank bank;
+    
+    /**
+     * The target length and velocity of each channel of the bank
+     */
+    std::vector<double> positions;
+    std::vector<double> offsetVels;
+    
+    /**
+     * For each channel, its index within its group of actuators and
+     * the index of its entry in phaseOffsets. Unused for the inner
+     * channels, which come first in the bank.
+     */
+    std::vector<std::size_t> groupIndex;
+    std::vector<std::size_t> groupPhase;
+    std::size_t numInside;
+    
     std::size_t segments;
     
     /**
@@ -129,6 +140,17 @@ private:
     double simTime;
     double cycle;
     double target;
+    
+    /**
+     * Add a group of actuators to the bank.
+     * @param[in] stringList the group, taken from the subject's
+     * actuator map
+     * @param[in] impedance the gains of every channel of the group
+     * @param[in] phase the index of the group in phaseOffsets
+     */
+    void addGroup(const std::vector<tgBasicActuator*>& stringList,
+                  const tgImpedanceController& impedance,
+                  std::size_t phase);
 };
 
 #endif // MY_MODEL_CONTROLLER_H
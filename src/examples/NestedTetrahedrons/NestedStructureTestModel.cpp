@@ -175,6 +175,9 @@ void NestedStructureTestModel::setup(tgWorld& world)
 
     trace(structureInfo, *this);
 
+    // Notify controllers that setup has finished.
+    notifySetup();
+
     // Actually setup the children
     tgModel::setup(world);
 }
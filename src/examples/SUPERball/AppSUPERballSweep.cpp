@@ -0,0 +1,202 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file AppSUPERballSweep.cpp
+ * @brief A parameter sweep over SUPERball's stiffness, pretension and
+ * rod density
+ * $Id$
+ */
+
+// This application
+#include "T6Model.h"
+// This library
+#include "core/tgBasicActuator.h"
+#include "core/tgObserver.h"
+#include "core/tgRod.h"
+#include "learning/ParameterSweep/ParameterSweep.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * One SUPERball run. The controller contracts each actuator in turn
+     * by up to a fifth of its initial rest length, in a wave around the
+     * ball. The metrics are how far the center of mass moved over the
+     * ground, its final height, and the largest final tension.
+     */
+    class T6Trial : public ParameterSweep::Trial, public tgObserver<T6Model>
+    {
+    public:
+        T6Trial(const ParameterSweep::Sample& sample) :
+            m_sample(sample),
+            m_time(0.0)
+        {
+        }
+
+        virtual tgModel* createModel()
+        {
+            T6Model* const pModel = new T6Model(m_sample.rod,
+                                                m_sample.actuator);
+            pModel->attach(this);
+            return pModel;
+        }
+
+        virtual void onSetup(T6Model& subject)
+        {
+            const std::vector<tgBasicActuator*>& actuators =
+                subject.getAllActuators();
+            m_initialLengths.resize(actuators.size());
+            for (std::size_t i = 0; i < actuators.size(); i++)
+            {
+                m_initialLengths[i] = actuators[i]->getRestLength();
+            }
+            m_start = center(subject);
+            m_time = 0.0;
+        }
+
+        virtual void onStep(T6Model& subject, double dt)
+        {
+            m_time += dt;
+            const std::vector<tgBasicActuator*>& actuators =
+                subject.getAllActuators();
+            const double n = actuators.size();
+            for (std::size_t i = 0; i < actuators.size(); i++)
+            {
+                const double phase = 2.0 * M_PI * (m_time + i / n);
+                const double contraction = 0.1 * (1.0 + std::sin(phase));
+                actuators[i]->setControlInput(
+                    (1.0 - contraction) * m_initialLengths[i], dt);
+            }
+        }
+
+        virtual void measure(tgModel& model, double* metrics)
+        {
+            T6Model& t6 = static_cast<T6Model&>(model);
+            const btVector3 end = center(t6);
+            metrics[0] = btVector3(end.x() - m_start.x(), 0.0,
+                                   end.z() - m_start.z()).length();
+            metrics[1] = end.y();
+
+            const std::vector<tgBasicActuator*>& actuators =
+                t6.getAllActuators();
+            double maxTension = 0.0;
+            for (std::size_t i = 0; i < actuators.size(); i++)
+            {
+                maxTension = std::max(maxTension, actuators[i]->getTension());
+            }
+            metrics[2] = maxTension;
+        }
+
+    private:
+        static btVector3 center(T6Model& subject)
+        {
+            const std::vector<tgRod*> rods = subject.find<tgRod>("rod");
+            btVector3 sum(0.0, 0.0, 0.0);
+            for (std::size_t i = 0; i < rods.size(); i++)
+            {
+                sum += rods[i]->centerOfMass();
+            }
+            return rods.empty() ? sum : sum / rods.size();
+        }
+
+        const ParameterSweep::Sample m_sample;
+        std::vector<double> m_initialLengths;
+        btVector3 m_start;
+        double m_time;
+    };
+
+    class T6TrialFactory : public ParameterSweep::Factory
+    {
+    public:
+        virtual std::vector<std::string> getMetricNames() const
+        {
+            std::vector<std::string> names;
+            names.push_back("distance");
+            names.push_back("height");
+            names.push_back("maxTension");
+            return names;
+        }
+
+        virtual ParameterSweep::Trial* create(const ParameterSweep::Sample& sample)
+        {
+            return new T6Trial(sample);
+        }
+    };
+}
+
+/**
+ * The entry point.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1] is the number of samples (default 64),
+ * argv[2] the number of threads (default all cores if Bullet was built
+ * without its profiler, else 1; 0 for all cores), argv[3] the results
+ * file (default standard output)
+ * @return 0
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppSUPERballSweep" << std::endl;
+
+    const std::size_t n = argc > 1 ? std::atoi(argv[1]) : 64;
+#ifdef BT_NO_PROFILE
+    const int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+#else
+    const int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+#endif
+
+    // The baseline is T6Model's own parameters, in decimeters
+    const tgRod::Config rodConfig(0.31, 0.688, 0.99, 0.01, 0.0);
+    const tgBasicActuator::Config actuatorConfig(613.0, 200.0, 2452.0, false,
+                                                 100000, 10000);
+    const tgWorld::Config worldConfig(98.1);
+
+    // 10 s of simulation per sample
+    const ParameterSweep::Config config(rodConfig, actuatorConfig, worldConfig,
+                                        ParameterSweep::latinHypercube, n,
+                                        10000, 0.001, threads);
+    ParameterSweep sweep(config);
+    sweep.addRange(ParameterSweep::Range("actuator.stiffness", 300.0, 1500.0));
+    sweep.addRange(ParameterSweep::Range("actuator.pretension", 1000.0, 4000.0));
+    sweep.addRange(ParameterSweep::Range("rod.density", 0.4, 1.0));
+
+    T6TrialFactory factory;
+    sweep.run(factory);
+
+    if (argc > 3)
+    {
+        std::ofstream table(argv[3]);
+        sweep.writeTable(table);
+    }
+    else
+    {
+        sweep.writeTable(std::cout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppSUPERballVectorEnv.cpp
+ * @brief Steps many SUPERballs in lockstep through VectorEnvironment,
+ * with random actions, as a reinforcement learning loop would
+ * $Id$
+ */
+
+// This application
+#include "T6Model.h"
+// This library
+#include "core/tgBasicActuator.h"
+#include "core/tgObserver.h"
+#include "core/tgRod.h"
+#include "core/tgSimulation.h"
+#include "learning/VectorEnvironment/VectorEnvironment.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    /**
+     * SUPERball as a reinforcement learning task. An action row holds one
+     * value in [0, 1] per actuator, mapped to a target rest length
+     * between half and all of the actuator's initial rest length. The
+     * observation is the center of mass of each rod, then the length of
+     * each actuator. The reward is the distance rolled in +x during the
+     * tick.
+     */
+    class T6Environment : public VectorEnvironment::Environment,
+                          public tgObserver<T6Model>
+    {
+    public:
+        T6Environment() :
+            m_pModel(NULL),
+            m_previousX(0.0)
+        {
+        }
+
+        virtual std::size_t getNumObservations() const
+        {
+            return 6 * 3 + 24;
+        }
+
+        virtual std::size_t getNumActions() const
+        {
+            return 24;
+        }
+
+        virtual void populate(tgSimulation& simulation)
+        {
+            m_pModel = new T6Model();
+            m_pModel->attach(this);
+            simulation.addModel(m_pModel);
+        }
+
+        virtual void onReset(tgSimulation& simulation)
+        {
+            // Rods and actuators are rebuilt by every setup
+            m_rods = m_pModel->find<tgRod>("rod");
+            const std::vector<tgBasicActuator*>& actuators =
+                m_pModel->getAllActuators();
+            m_initialLengths.resize(actuators.size());
+            for (std::size_t i = 0; i < actuators.size(); i++)
+            {
+                m_initialLengths[i] = actuators[i]->getRestLength();
+            }
+            m_targets = m_initialLengths;
+            m_previousX = centerX();
+        }
+
+        virtual void applyActions(const double* actions, double dt)
+        {
+            for (std::size_t i = 0; i < m_targets.size(); i++)
+            {
+                const double a = std::min(1.0, std::max(0.0, actions[i]));
+                m_targets[i] = (0.5 + 0.5 * a) * m_initialLengths[i];
+            }
+        }
+
+        /** Move toward the targets on every physics step */
+        virtual void onStep(T6Model& subject, double dt)
+        {
+            const std::vector<tgBasicActuator*>& actuators =
+                subject.getAllActuators();
+            for (std::size_t i = 0; i < actuators.size(); i++)
+            {
+                actuators[i]->setControlInput(m_targets[i], dt);
+            }
+        }
+
+        virtual void observe(double* observations)
+        {
+            for (std::size_t i = 0; i < m_rods.size(); i++)
+            {
+                const btVector3 com = m_rods[i]->centerOfMass();
+                observations[3 * i] = com.x();
+                observations[3 * i + 1] = com.y();
+                observations[3 * i + 2] = com.z();
+            }
+            const std::vector<tgBasicActuator*>& actuators =
+                m_pModel->getAllActuators();
+            for (std::size_t i = 0; i < actuators.size(); i++)
+            {
+                observations[3 * m_rods.size() + i] =
+                    actuators[i]->getCurrentLength();
+            }
+        }
+
+        virtual double reward(bool& done)
+        {
+            const double x = centerX();
+            const double result = x - m_previousX;
+            m_previousX = x;
+            // A blown up simulation can't be recovered, start over
+            done = !(std::fabs(x) < 1.0e6);
+            return done ? 0.0 : result;
+        }
+
+    private:
+        double centerX() const
+        {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < m_rods.size(); i++)
+            {
+                sum += m_rods[i]->centerOfMass().x();
+            }
+            return m_rods.empty() ? 0.0 : sum / m_rods.size();
+        }
+
+        /** Owned by the simulation */
+        T6Model* m_pModel;
+        std::vector<tgRod*> m_rods;
+        std::vector<double> m_initialLengths;
+        std::vector<double> m_targets;
+        double m_previousX;
+    };
+
+    class T6Factory : public VectorEnvironment::Factory
+    {
+    public:
+        virtual VectorEnvironment::Environment* create(std::size_t index)
+        {
+            return new T6Environment();
+        }
+    };
+}
+
+/**
+ * The entry point.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1] is the number of environments (default 8),
+ * argv[2] the number of threads (default 1, 0 for all cores)
+ * @return 0
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppSUPERballVectorEnv" << std::endl;
+
+    const std::size_t n = argc > 1 ? std::atoi(argv[1]) : 8;
+    const int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+
+    // 10 ms control ticks of 1 ms physics steps, 10 s episodes
+    VectorEnvironment::Config config(n, 0.001, 10, 1000, threads);
+    config.world = tgWorld::Config(98.1);
+
+    T6Factory factory;
+    VectorEnvironment environments(factory, config);
+
+    std::vector<double> actions(environments.size() *
+                                environments.getNumActions());
+    double totalReward = 0.0;
+    const int ticks = 2000;
+    const std::clock_t start = std::clock();
+    for (int t = 0; t < ticks; t++)
+    {
+        for (std::size_t i = 0; i < actions.size(); i++)
+        {
+            actions[i] = std::rand() / (double) RAND_MAX;
+        }
+        environments.step(&actions[0]);
+        for (std::size_t i = 0; i < environments.size(); i++)
+        {
+            totalReward += environments.getRewards()[i];
+        }
+    }
+    // CPU time summed over threads
+    const double seconds = (std::clock() - start) / (double) CLOCKS_PER_SEC;
+
+    std::cout << "Mean reward per tick " << totalReward / (ticks * n)
+              << ", " << ticks * n * config.stepsPerTick / seconds
+              << " physics steps per CPU second" << std::endl;
+
+    return 0;
+}
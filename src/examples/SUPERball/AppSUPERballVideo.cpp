@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file AppSUPERballVideo.cpp
+ * @brief Renders SUPERball rolling down a slope to video frames, without
+ * a display
+ * $Id$
+ */
+
+// This application
+#include "T6Model.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgSimViewOffscreen.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/**
+ * The entry point.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1] is where to write the frames (default
+ * "superball%05d.ppm"; a name without '%' gets every frame, e.g. a named
+ * pipe to ffmpeg), argv[2] the number of simulated seconds (default 10)
+ * @return 0
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppSUPERballVideo" << std::endl;
+
+    const std::string output = argc > 1 ? argv[1] : "superball%05d.ppm";
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 10.0;
+
+    const tgBoxGround::Config groundConfig(btVector3(0.0, M_PI/15.0, 0.0));
+    // the world will delete this
+    tgBoxGround* ground = new tgBoxGround(groundConfig);
+    tgWorld world(tgWorld::Config(98.1), ground);
+
+    // 30 frames per simulated second, following the robot
+    tgSimViewOffscreen::Config viewConfig(output, 30.0, 640, 480);
+    viewConfig.eye = btVector3(0.0, 40.0, 80.0);
+    viewConfig.follow = true;
+    const double timestep_physics = 0.001; // Seconds
+    tgSimViewOffscreen view(world, viewConfig, timestep_physics);
+
+    tgSimulation simulation(view);
+    simulation.addModel(new T6Model());
+
+    simulation.run(static_cast<int>(seconds / timestep_physics));
+
+    std::cout << view.getFrameCount() << " frames written" << std::endl;
+    return 0;
+}
@@ -92,7 +92,21 @@ namespace
   };
 } // namespace
 
-T6Model::T6Model() : tgModel() 
+T6Model::T6Model() :
+    tgModel(),
+    m_rodConfig(c.radius, c.density, c.friction, c.rollFriction,
+                c.restitution),
+    /// @todo acceleration constraint was removed on 12/10/14 Replace with tgKinematicActuator as appropreate
+    m_actuatorConfig(c.stiffness, c.damping, c.pretension, c.hist,
+                     c.maxTens, c.targetVelocity)
+{
+}
+
+T6Model::T6Model(const tgRod::Config& rodConfig,
+                 const tgBasicActuator::Config& actuatorConfig) :
+    tgModel(),
+    m_rodConfig(rodConfig),
+    m_actuatorConfig(actuatorConfig)
 {
 }
 
@@ -168,13 +182,6 @@ void T6Model::addActuators(tgStructure& s)
 void T6Model::setup(tgWorld& world)
 {
 
-    const tgRod::Config rodConfig(c.radius, c.density, c.friction, 
-				c.rollFriction, c.restitution);
-    
-    /// @todo acceleration constraint was removed on 12/10/14 Replace with tgKinematicActuator as appropreate
-    tgBasicActuator::Config muscleConfig(c.stiffness, c.damping, c.pretension, c.hist, 
-					    c.maxTens, c.targetVelocity);
-            
     // Start creating the structure
     tgStructure s;
     addNodes(s);
@@ -191,8 +198,8 @@ void T6Model::setup(tgWorld& world)
 
     // Create the build spec that uses tags to turn the structure into a real model
     tgBuildSpec spec;
-    spec.addBuilder("rod", new tgRodInfo(rodConfig));
-    spec.addBuilder("muscle", new tgBasicActuatorInfo(muscleConfig));
+    spec.addBuilder("rod", new tgRodInfo(m_rodConfig));
+    spec.addBuilder("muscle", new tgBasicActuatorInfo(m_actuatorConfig));
     
     // Create your structureInfo
     tgStructureInfo structureInfo(s, spec);
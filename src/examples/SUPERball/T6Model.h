@@ -26,13 +26,14 @@
  */
 
 // This library
+#include "core/tgBasicActuator.h"
 #include "core/tgModel.h"
+#include "core/tgRod.h"
 #include "core/tgSubject.h"
 // The C++ Standard Library
 #include <vector>
 
 // Forward declarations
-class tgBasicActuator;
 class tgModelVisitor;
 class tgStructure;
 class tgWorld;
@@ -45,11 +46,20 @@ class T6Model : public tgSubject<T6Model>, public tgModel
 public: 
 	
 	/**
-     * The only constructor. Utilizes default constructor of tgModel
+     * The default constructor. Utilizes default constructor of tgModel
      * Configuration parameters are within the .cpp file in this case,
      * not passed in. 
      */
     T6Model();
+
+    /**
+     * Build with other rod and actuator parameters than the ones in the
+     * .cpp file, e.g. for a ParameterSweep.
+     * @param[in] rodConfig the config of the six rods
+     * @param[in] actuatorConfig the config of the 24 actuators
+     */
+    T6Model(const tgRod::Config& rodConfig,
+            const tgBasicActuator::Config& actuatorConfig);
 	
     /**
      * Destructor. Deletes controllers, if any were added during setup.
@@ -125,6 +135,9 @@ private:
      * through setup
      */
     std::vector<tgBasicActuator*> allActuators;
+
+    const tgRod::Config m_rodConfig;
+    const tgBasicActuator::Config m_actuatorConfig;
 };
 
 #endif  // T6_MODEL_H
@@ -162,7 +162,7 @@ void SpineFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = getFeedback(subject);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -347,12 +347,10 @@ array_2D SpineFeedbackControl::scaleNodeActions
     return nodeActions;
 }
 
-std::vector<double> SpineFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
+std::vector<double>& SpineFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
 {
-    // Placeholder
-    std:vector<double> feedback;
-    // Adapter doesn't use this anyway, so just do zero here for now (will trigger errors if it starts to use it =) )
-    const double dt = 0;
+    // clear keeps the capacity from the previous control step
+    m_feedback.clear();
     
     const std::vector<tgSpringCableActuator*>& allCables = subject.getAllMuscles();
     
@@ -360,49 +358,44 @@ std::vector<double> SpineFeedbackControl::getFeedback(BaseSpineModelLearning& su
     for(std::size_t i = 0; i != n; i++)
     {
         const tgSpringCableActuator& cable = *(allCables[i]);
-        std::vector<double > state = getCableState(cable);
-        std::vector< std::vector<double> > actions = feedbackAdapter.step(m_updateTime, state);
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-       
+        getCableState(cable, m_cableState);
+        feedbackAdapter.step(m_updateTime, m_cableState, m_feedbackActions);
+        transformFeedbackActions(m_feedbackActions, m_feedback);
+    }
+    
 #if (0)
-        for (std::size_t j = 0; j < cableFeedback.size(); j++)
-        {
-            std::cout << cableFeedback[j] << " ";
-        }
+    for (std::size_t j = 0; j < m_feedback.size(); j++)
+    {
+        std::cout << m_feedback[j] << " ";
     }
     std::cout << std::endl;
-#else
-    }
 #endif
     
-    return feedback;
+    return m_feedback;
 }
 
-std::vector<double> SpineFeedbackControl::getCableState(const tgSpringCableActuator& cable)
+void SpineFeedbackControl::getCableState(const tgSpringCableActuator& cable,
+                                         std::vector<double>& state) const
 {
 	// For each string, scale value from -1 to 1 based on initial length or max tension of motor
     
-    std::vector<double> state;
+    state.resize(2);
     
     // Scale length by starting length
     const double startLength = cable.getStartLength();
-    state.push_back((cable.getCurrentLength() - startLength) / startLength);
+    state[0] = (cable.getCurrentLength() - startLength) / startLength;
     
     const double maxTension = cable.getConfig().maxTens;
-    state.push_back((cable.getTension() - maxTension / 2.0) / maxTension);
-    
-	return state;
+    state[1] = (cable.getTension() - maxTension / 2.0) / maxTension;
 }
 
-std::vector<double> SpineFeedbackControl::transformFeedbackActions(std::vector< std::vector<double> >& actions)
+void SpineFeedbackControl::transformFeedbackActions(const std::vector< std::vector<double> >& actions,
+                                                    std::vector<double>& feedback) const
 {
-	// Placeholder
-	std:vector<double> feedback;
-    
-    std::size_t numControllers = feedbackConfigData.getintvalue("numberOfControllers");
-    std::size_t numActions = feedbackConfigData.getintvalue("numberOfActions");
+    // Same values as numberOfControllers and numberOfActions in the
+    // feedback config, without a string lookup per cable
+    std::size_t numControllers = feedbackAdapter.getNumberOfControllers();
+    std::size_t numActions = feedbackAdapter.getNumberOfActions();
     
     assert( actions.size() == numControllers);
     assert( actions[0].size() == numActions);
@@ -415,6 +408,5 @@ std::vector<double> SpineFeedbackControl::transformFeedbackActions(std::vector<
             feedback.push_back(actions[i][j] * 2.0 - 1.0);
         }
     }
-    
-	return feedback;
 }
+
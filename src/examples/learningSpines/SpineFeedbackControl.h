@@ -106,11 +106,20 @@ protected:
     
     virtual array_2D scaleNodeActions (std::vector< std::vector <double> > actions);
     
-    std::vector<double> getFeedback(BaseSpineModelLearning& subject);
+    /**
+     * Fill m_feedback with the descending commands for every cable.
+     * All buffers are members that keep their capacity, so after the
+     * first control step this does not allocate.
+     */
+    std::vector<double>& getFeedback(BaseSpineModelLearning& subject);
     
-    std::vector<double> getCableState(const tgSpringCableActuator& cable);
+    /** Write the scaled length and tension of cable into state */
+    void getCableState(const tgSpringCableActuator& cable,
+                       std::vector<double>& state) const;
     
-    std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
+    /** Append the actions, scaled back to -1 to +1, to feedback */
+    void transformFeedbackActions(const std::vector< std::vector<double> >& actions,
+                                  std::vector<double>& feedback) const;
     
     SpineFeedbackControl::Config m_config;
     
@@ -122,6 +131,11 @@ protected:
     bool feedbackLearning;
     
     configuration feedbackConfigData;
+    
+    /** Reused buffers for getFeedback */
+    std::vector<double> m_cableState;
+    std::vector< std::vector<double> > m_feedbackActions;
+    std::vector<double> m_feedback;
 };
 
 #endif // SPINE_FEEDBACK_CONTROL_H
@@ -25,6 +25,8 @@
  * $Id$
  */
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 #include <iostream>
 #include <sstream>
@@ -68,26 +70,42 @@ void AnnealAdapter::initialize(AnnealEvolution *evo,bool isLearning,configuratio
     errorOfFirstController=0.0;
 }
 
-vector<vector<double> > AnnealAdapter::step(double deltaTimeSeconds,vector<double> state)
+void AnnealAdapter::step(double deltaTimeSeconds, double* actions)
+{
+    totalTime+=deltaTimeSeconds;
+
+    const std::size_t stride = getNumberOfActions();
+    for(std::size_t i=0;i<currentControllers.size();i++)
+    {
+        const AnnealEvoParameters& params = currentControllers[i]->statelessParameters;
+        assert(params.size() == stride);
+        std::copy(params.begin(), params.end(), actions + i * stride);
+    }
+}
+
+void AnnealAdapter::step(double deltaTimeSeconds, const vector<double>& state,
+                         vector<vector<double> >& actions)
 {
     totalTime+=deltaTimeSeconds;
 //  cout<<"NN adapter, state: "<<state[0]<<" "<<state[1]<<" "<<state[2]<<" "<<state[3]<<" "<<state[4]<<" "<<endl;
-    vector< vector<double> > actions;
 
-    for(int i=0;i<currentControllers.size();i++)
+    actions.resize(currentControllers.size());
+    for(std::size_t i=0;i<currentControllers.size();i++)
     {
-        vector<double> tmpAct;
-        for(int j=0;j<currentControllers[i]->statelessParameters.size();j++)
-        {
-            tmpAct.push_back(currentControllers[i]->statelessParameters[j]);
-        }
-        actions.push_back(tmpAct);
+        // assign reuses the row's storage when the length is unchanged
+        actions[i].assign(currentControllers[i]->statelessParameters.begin(),
+                          currentControllers[i]->statelessParameters.end());
     }
+}
 
+vector<vector<double> > AnnealAdapter::step(double deltaTimeSeconds, const vector<double>& state)
+{
+    vector< vector<double> > actions;
+    step(deltaTimeSeconds, state, actions);
     return actions;
 }
 
-void AnnealAdapter::endEpisode(vector<double> scores)
+void AnnealAdapter::endEpisode(const vector<double>& scores)
 {
     if(scores.size()==0)
     {
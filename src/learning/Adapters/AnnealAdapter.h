@@ -43,8 +43,39 @@ public:
      * AnnealEvolution, we can't create it here
      */
     void initialize(AnnealEvolution *evo,bool isLearning,configuration config);
-    std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
-    void endEpisode(std::vector<double> state);
+
+    /**
+     * Write the parameters of every controller into actions, one row
+     * per controller. Rows are only resized when their length changes,
+     * so a buffer kept by the caller is reused without allocating on
+     * later calls. The state is unused by annealing.
+     */
+    void step(double deltaTimeSeconds, const std::vector<double>& state,
+              std::vector<std::vector<double> >& actions);
+
+    /**
+     * As above, for a flat buffer of getNumberOfControllers() *
+     * getNumberOfActions() values, controller by controller.
+     */
+    void step(double deltaTimeSeconds, double* actions);
+
+    /** Allocates the returned rows; prefer the buffer versions in loops */
+    std::vector<std::vector<double> > step(double deltaTimeSeconds, const std::vector<double>& state);
+
+    void endEpisode(const std::vector<double>& state);
+
+    /** The number of controllers of the current trial */
+    std::size_t getNumberOfControllers() const
+    {
+        return currentControllers.size();
+    }
+
+    /** The number of parameters of each controller */
+    std::size_t getNumberOfActions() const
+    {
+        return currentControllers.empty() ? 0 :
+            currentControllers[0]->statelessParameters.size();
+    }
 
 private:
     int numberOfActions;
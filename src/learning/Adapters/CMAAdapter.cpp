@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CMAAdapter.cpp
+ * @brief Contains the implementation of class CMAAdapter.
+ * $Id$
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <iostream>
+#include "CMAAdapter.h"
+
+using namespace std;
+
+CMAAdapter::CMAAdapter() :
+cmaEvo(NULL),
+totalTime(0.0)
+{
+}
+CMAAdapter::~CMAAdapter(){};
+
+void CMAAdapter::initialize(CMAEvolution *evo,bool isLearning,configuration configdata)
+{
+    totalTime=0.0;
+
+    // Without learning CMAEvolution hands out the saved parameters
+    this->cmaEvo = evo;
+    currentControllers = this->cmaEvo->nextSetOfControllers();
+}
+
+void CMAAdapter::step(double deltaTimeSeconds, double* actions)
+{
+    totalTime+=deltaTimeSeconds;
+
+    const std::size_t stride = getNumberOfActions();
+    for(std::size_t i=0;i<currentControllers.size();i++)
+    {
+        assert(currentControllers[i].size() == stride);
+        std::copy(currentControllers[i].begin(), currentControllers[i].end(),
+                  actions + i * stride);
+    }
+}
+
+void CMAAdapter::step(double deltaTimeSeconds, const vector<double>& state,
+                      vector<vector<double> >& actions)
+{
+    totalTime+=deltaTimeSeconds;
+
+    actions.resize(currentControllers.size());
+    for(std::size_t i=0;i<currentControllers.size();i++)
+    {
+        // assign reuses the row's storage when the length is unchanged
+        actions[i].assign(currentControllers[i].begin(),
+                          currentControllers[i].end());
+    }
+}
+
+vector<vector<double> > CMAAdapter::step(double deltaTimeSeconds, const vector<double>& state)
+{
+    vector< vector<double> > actions;
+    step(deltaTimeSeconds, state, actions);
+    return actions;
+}
+
+void CMAAdapter::endEpisode(const vector<double>& scores)
+{
+    if(scores.size()==0)
+    {
+        vector< double > tmp(1);
+        tmp[0]=-1;
+        cmaEvo->updateScores(tmp);
+        cout<<"Exploded"<<endl;
+    }
+    else
+    {
+        cout<<"Dist Moved: "<<scores[0]<<" energy: "<<scores[1]<<endl;
+        cmaEvo->updateScores(scores);
+    }
+    return;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef CMAADAPTER_H_
+#define CMAADAPTER_H_
+
+/**
+ * @file CMAAdapter.h
+ * @brief Defines a class CMAAdapter to pass parameters from CMAEvolution to a controller.
+ * The same interface as AnnealAdapter
+ * $Id$
+ */
+
+#include <vector>
+#include "learning/CMAEvolution/CMAEvolution.h"
+#include "learning/Configuration/configuration.h"
+
+class CMAAdapter
+{
+public:
+    CMAAdapter();
+    ~CMAAdapter();
+    /**
+     * Initialize needs to be called at the beginning of each trial
+     * For NTRT this means main or simulator needs to own the pointer to
+     * CMAEvolution, we can't create it here. The sizes come from
+     * CMAEvolution's own config, so config is only kept for
+     * AnnealAdapter compatibility.
+     */
+    void initialize(CMAEvolution *evo,bool isLearning,configuration config);
+
+    /**
+     * Write the parameters of every controller into actions, one row
+     * per controller. Rows are only resized when their length changes,
+     * so a buffer kept by the caller is reused without allocating on
+     * later calls. The state is unused by CMA-ES.
+     */
+    void step(double deltaTimeSeconds, const std::vector<double>& state,
+              std::vector<std::vector<double> >& actions);
+
+    /**
+     * As above, for a flat buffer of getNumberOfControllers() *
+     * getNumberOfActions() values, controller by controller.
+     */
+    void step(double deltaTimeSeconds, double* actions);
+
+    /** Allocates the returned rows; prefer the buffer versions in loops */
+    std::vector<std::vector<double> > step(double deltaTimeSeconds, const std::vector<double>& state);
+
+    void endEpisode(const std::vector<double>& state);
+
+    /** The number of controllers of the current trial */
+    std::size_t getNumberOfControllers() const
+    {
+        return currentControllers.size();
+    }
+
+    /** The number of parameters of each controller */
+    std::size_t getNumberOfActions() const
+    {
+        return currentControllers.empty() ? 0 : currentControllers[0].size();
+    }
+
+private:
+    CMAEvolution *cmaEvo;
+    std::vector< std::vector<double> > currentControllers;
+    double totalTime;
+};
+
+#endif /* CMAADAPTER_H_ */
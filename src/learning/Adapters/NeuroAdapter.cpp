@@ -27,8 +27,9 @@
 #include "NeuroAdapter.h"
 #include "learning/Configuration/configuration.h"
 #include "helpers/FileHelpers.h"
-#include "neuralNet/Neural Network v2/neuralNetwork.h"
+#include "learning/NeuroEvolution/NeuroNetwork.h"
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -49,6 +50,7 @@ void NeuroAdapter::initialize(NeuroEvolution *evo,bool isLearning,configuration
 	numberOfStates=configdata.getDoubleValue("numberOfStates");
 	numberOfControllers=configdata.getDoubleValue("numberOfControllers");
 	totalTime=0.0;
+	m_inputs.assign(numberOfStates > 0 ? numberOfStates : 0, 0.0);
 
 	//This Function initializes the parameterset from evo.
 	this->neuroEvo = evo;
@@ -69,52 +71,86 @@ void NeuroAdapter::initialize(NeuroEvolution *evo,bool isLearning,configuration
 	errorOfFirstController=0.0;
 }
 
-vector<vector<double> > NeuroAdapter::step(double deltaTimeSeconds,vector<double> state)
+std::size_t NeuroAdapter::getNumberOfActions() const
+{
+	if(numberOfStates>0 || currentControllers.empty())
+	{
+		return numberOfActions;
+	}
+	return currentControllers[0]->statelessParameters.size();
+}
+
+void NeuroAdapter::scaleInputs(const double* state)
+{
+	//scale inputs to 0-1 from -1 to 1 (unit vector provided from the controller).
+	// Assumes inputs are already scaled -1 to 1
+	for (int i = 0; i < numberOfStates; i++)
+	{
+		m_inputs[i]=state[i] / 2.0 + 0.5;
+	}
+}
+
+void NeuroAdapter::controllerActions(std::size_t i, double* out)
+{
+	NeuroEvoMember* const member = currentControllers[i];
+	if(numberOfStates>0)
+	{
+		member->getNn()->feedForward(&m_inputs[0], out);
+	}
+	else
+	{
+		std::copy(member->statelessParameters.begin(),
+		          member->statelessParameters.end(),
+		          out);
+	}
+}
+
+void NeuroAdapter::step(double deltaTimeSeconds, const double* state, double* actions)
 {
 	totalTime+=deltaTimeSeconds;
-//	cout<<"NN adapter, state: "<<state[0]<<" "<<state[1]<<" "<<state[2]<<" "<<state[3]<<" "<<state[4]<<" "<<endl;
-	vector< vector<double> > actions;
 	if(numberOfStates>0)
 	{
-		double *inputs = new double[numberOfStates];
+		scaleInputs(state);
+	}
+	const std::size_t stride = getNumberOfActions();
+	for(std::size_t i=0;i<currentControllers.size();i++)
+	{
+		assert(numberOfStates>0 || currentControllers[i]->statelessParameters.size() == stride);
+		controllerActions(i, actions + i * stride);
+	}
+}
 
-		//scale inputs to 0-1 from -1 to 1 (unit vector provided from the controller).
-		// Assumes inputs are already scaled -1 to 1
+void NeuroAdapter::step(double deltaTimeSeconds, const vector<double>& state,
+                        vector<vector<double> >& actions)
+{
+	totalTime+=deltaTimeSeconds;
+//	cout<<"NN adapter, state: "<<state[0]<<" "<<state[1]<<" "<<state[2]<<" "<<state[3]<<" "<<state[4]<<" "<<endl;
+	if(numberOfStates>0)
+	{
 		assert (state.size() == numberOfStates);
-		for (int i = 0; i < numberOfStates; i++)
-		{
-			inputs[i]=state[i] / 2.0 + 0.5;
-		}
-		for(std::size_t i=0;i<currentControllers.size();i++)
-		{
-			double *output=currentControllers[i]->getNn()->feedForwardPattern(inputs);
-			vector<double> tmpAct;
-			for(int j=0;j<numberOfActions;j++)
-			{
-				tmpAct.push_back(output[j]);
-			}
-			actions.push_back(tmpAct);
-		}
-		delete[]inputs;
+		scaleInputs(&state[0]);
 	}
-	else
+	actions.resize(currentControllers.size());
+	for(std::size_t i=0;i<currentControllers.size();i++)
 	{
-		for(std::size_t i=0;i<currentControllers.size();i++)
+		const std::size_t n = (numberOfStates>0) ? numberOfActions :
+			currentControllers[i]->statelessParameters.size();
+		actions[i].resize(n);
+		if(n>0)
 		{
-			vector<double> tmpAct;
-			for(std::size_t j=0;j<currentControllers[i]->statelessParameters.size();j++)
-			{
-				tmpAct.push_back(currentControllers[i]->statelessParameters[j]);
-			}
-			actions.push_back(tmpAct);
+			controllerActions(i, &actions[i][0]);
 		}
 	}
+}
 
-
-    return actions;
+vector<vector<double> > NeuroAdapter::step(double deltaTimeSeconds, const vector<double>& state)
+{
+	vector< vector<double> > actions;
+	step(deltaTimeSeconds, state, actions);
+	return actions;
 }
 
-void NeuroAdapter::endEpisode(vector<double> scores)
+void NeuroAdapter::endEpisode(const vector<double>& scores)
 {
 	if(scores.size()==0)
 	{
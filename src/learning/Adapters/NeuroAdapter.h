@@ -42,10 +42,49 @@ public:
 	 * NeuroEvolution, we can't create it here
 	 */
 	void initialize(NeuroEvolution *evo,bool isLearning,configuration config);
-	std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
-	void endEpisode(std::vector<double> state);
+
+	/**
+	 * Compute the actions of every controller for state and write them
+	 * into actions, one row per controller. Rows are only resized when
+	 * their length changes, so a buffer kept by the caller is reused
+	 * without allocating on later calls.
+	 */
+	void step(double deltaTimeSeconds, const std::vector<double>& state,
+	          std::vector<std::vector<double> >& actions);
+
+	/**
+	 * As above, for flat buffers.
+	 * @param[in] state numberOfStates values, ignored for stateless
+	 * parameters
+	 * @param[out] actions getNumberOfControllers() * getNumberOfActions()
+	 * values, controller by controller
+	 */
+	void step(double deltaTimeSeconds, const double* state, double* actions);
+
+	/** Allocates the returned rows; prefer the buffer versions in loops */
+	std::vector<std::vector<double> > step(double deltaTimeSeconds, const std::vector<double>& state);
+
+	void endEpisode(const std::vector<double>& state);
+
+	/** The number of controllers of the current trial */
+	std::size_t getNumberOfControllers() const
+	{
+		return currentControllers.size();
+	}
+
+	/** The number of actions of each controller */
+	std::size_t getNumberOfActions() const;
 
 private:
+	/**
+	 * Write the actions of controller i into out, reading the scaled
+	 * state from m_inputs.
+	 */
+	void controllerActions(std::size_t i, double* out);
+
+	/** Scale state from -1 to 1 into m_inputs from 0 to 1 */
+	void scaleInputs(const double* state);
+
 	int numberOfActions;
 	int numberOfStates;
 	int numberOfControllers;
@@ -55,6 +94,8 @@ private:
 	double errorOfFirstController;
     /** Appears unused */
 	double totalTime;
+	/** Network inputs, sized once in initialize */
+	std::vector<double> m_inputs;
 };
 
 #endif /* NEUROADAPTER_H_ */
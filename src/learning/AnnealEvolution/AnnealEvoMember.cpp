@@ -26,6 +26,7 @@
  */
 
 #include "AnnealEvoMember.h"
+#include "learning/Checkpoint/EvoCheckpoint.h"
 #include <fstream>
 #include <iostream>
 #include <assert.h>
@@ -40,7 +41,7 @@ AnnealEvoMember::AnnealEvoMember(configuration config)
     this->devBase=config.getDoubleValue("deviation");
     this->monteCarlo=config.getintvalue("MonteCarlo");
     
-    statelessParameters.resize(numOutputs);
+    statelessParameters = std::vector<double>(numOutputs);
     for(int i=0;i<numOutputs;i++)
         statelessParameters[i]=rand()*1.0/RAND_MAX;
 
@@ -54,35 +55,38 @@ AnnealEvoMember::~AnnealEvoMember()
 void AnnealEvoMember::mutate(std::tr1::ranlux64_base_01 *eng, double T){
     
     assert (T <= 1.0);
-    std::tr1::uniform_real<double> unif(0, 1);
-
-    //TODO: for each weight of the NN with 0.5 probability mutate it
+    std::vector<double> noise(statelessParameters.size());
+    mutateRow(statelessParameters.data(), statelessParameters.data(),
+              statelessParameters.size(), deviation(T), monteCarlo, eng,
+              noise.empty() ? NULL : &noise[0]);
+}
 
-    double dev = devBase * T / 100.0; 
-    std::tr1::normal_distribution<double> normal(0, dev);
-    for(std::size_t i=0;i<statelessParameters.size();i++)
+void AnnealEvoMember::mutateRow(const double* source, double* dest, std::size_t n,
+                                double dev, bool monteCarlo,
+                                std::tr1::ranlux64_base_01 *eng, double* noise)
+{
+    if (monteCarlo)
     {
-        double newParam;
-        if (monteCarlo)
+        std::tr1::uniform_real<double> unif(0, 1);
+        for(std::size_t i=0;i<n;i++)
         {
-            newParam= unif(*eng);
+            dest[i] = unif(*eng);
         }
-        else
-        {   
-            double mutAmount = normal(*eng);
-              //std::cout<<"param: "<<i<<" dev: "<<dev<<" rand: "<<mutAmount<<endl;
-            newParam= statelessParameters[i] + mutAmount;
-        }
-
-        if(newParam < 0.0)
-            statelessParameters[i] = 0.0;
-        else if(newParam > 1.0)
-            statelessParameters[i] = 1.0;
-        else
-            statelessParameters[i] =newParam;
+        return;
     }
 
-
+    // A fresh distribution per row, so the random sequence is the same as
+    // when each member mutated itself
+    std::tr1::normal_distribution<double> normal(0, dev);
+    for(std::size_t i=0;i<n;i++)
+    {
+        noise[i] = normal(*eng);
+    }
+    for(std::size_t i=0;i<n;i++)
+    {
+        const double newParam = source[i] + noise[i];
+        dest[i] = newParam < 0.0 ? 0.0 : (newParam > 1.0 ? 1.0 : newParam);
+    }
 }
 
 void AnnealEvoMember::copyFrom(AnnealEvoMember* otherMember)
@@ -141,3 +145,23 @@ void AnnealEvoMember::loadFromFile(const char * outputFilename)
     ss.close();
 
 }
+
+void AnnealEvoMember::saveState(EvoCheckpointWriter& checkpoint) const
+{
+    checkpoint.writeDoubles(statelessParameters.data(), statelessParameters.size());
+    checkpoint.writeDouble(maxScore);
+    checkpoint.writeDouble(maxScore1);
+    checkpoint.writeDouble(maxScore2);
+    checkpoint.writeDouble(averageScore);
+    checkpoint.writeDoubles(pastScores);
+}
+
+void AnnealEvoMember::loadState(EvoCheckpointReader& checkpoint)
+{
+    checkpoint.readDoubles(statelessParameters.data(), statelessParameters.size());
+    maxScore = checkpoint.readDouble();
+    maxScore1 = checkpoint.readDouble();
+    maxScore2 = checkpoint.readDouble();
+    averageScore = checkpoint.readDouble();
+    checkpoint.readDoubles(pastScores);
+}
@@ -31,8 +31,13 @@
 #include <string>
 #include <vector>
 #include <tr1/random>
+#include "AnnealEvoParameters.h"
 #include "learning/Configuration/configuration.h"
 
+// Forward declarations
+class EvoCheckpointReader;
+class EvoCheckpointWriter;
+
 
 class AnnealEvoMember
 {
@@ -41,11 +46,26 @@ public:
     ~AnnealEvoMember();
     void mutate(std::tr1::ranlux64_base_01 *eng, double T);
 
+    /**
+     * The mutation kernel: dest = clamp(source + N(0, dev)) element-wise,
+     * or uniform samples when monteCarlo. Noise is drawn into noise (n
+     * values) first so the update is one branch free loop. source and
+     * dest may be the same row.
+     */
+    static void mutateRow(const double* source, double* dest, std::size_t n,
+                          double dev, bool monteCarlo,
+                          std::tr1::ranlux64_base_01 *eng, double* noise);
+
     void copyFrom(AnnealEvoMember *otherMember);
     void saveToFile(const char* outputFilename);
     void loadFromFile(const char* inputFilename);
 
-    std::vector<double> statelessParameters;
+    /** Write the parameters and scores to a checkpoint */
+    void saveState(EvoCheckpointWriter& checkpoint) const;
+    /** Read what saveState wrote; the parameter count must match */
+    void loadState(EvoCheckpointReader& checkpoint);
+
+    AnnealEvoParameters statelessParameters;
     //scores for evaluation
     std::vector<double> pastScores;
     double maxScore;
@@ -53,6 +73,17 @@ public:
     double maxScore2;
     double averageScore;
 
+    /** The standard deviation of a mutation at temperature T */
+    double deviation(double T) const
+    {
+        return devBase * T / 100.0;
+    }
+
+    bool isMonteCarlo() const
+    {
+        return monteCarlo;
+    }
+
 private:
     int numOutputs;
     double devBase;
@@ -0,0 +1,194 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef ANNEALEVOPARAMETERS_H_
+#define ANNEALEVOPARAMETERS_H_
+
+/**
+ * @file AnnealEvoParameters.h
+ * @brief Contains the definition of class AnnealEvoParameters
+ * $Id$
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * The parameters of one AnnealEvoMember. A member created on its own
+ * owns its parameters; once AnnealEvoPopulation binds it, they are a row
+ * of the population's contiguous parameter matrix, so mutation and
+ * copying work on plain arrays.
+ *
+ * Supports the parts of std::vector<double> the learning code uses
+ * (size, indexing, iteration) and converts to a std::vector<double>.
+ * Copies own their storage; assignment copies values.
+ */
+class AnnealEvoParameters
+{
+public:
+    typedef double value_type;
+    typedef double* iterator;
+    typedef const double* const_iterator;
+
+    explicit AnnealEvoParameters(std::size_t n = 0) :
+        m_owned(n),
+        m_data(n > 0 ? &m_owned[0] : NULL),
+        m_size(n)
+    {
+    }
+
+    AnnealEvoParameters(const AnnealEvoParameters& other) :
+        m_owned(other.begin(), other.end()),
+        m_data(other.m_size > 0 ? &m_owned[0] : NULL),
+        m_size(other.m_size)
+    {
+    }
+
+    /**
+     * Copy the values of other.
+     * @throws std::length_error if the sizes differ and this is bound to
+     * a row, which can't be resized
+     */
+    AnnealEvoParameters& operator=(const AnnealEvoParameters& other)
+    {
+        assign(other.begin(), other.end());
+        return *this;
+    }
+
+    AnnealEvoParameters& operator=(const std::vector<double>& values)
+    {
+        if (values.empty())
+        {
+            assign(NULL, NULL);
+        }
+        else
+        {
+            assign(&values[0], &values[0] + values.size());
+        }
+        return *this;
+    }
+
+    operator std::vector<double>() const
+    {
+        return std::vector<double>(begin(), end());
+    }
+
+    /**
+     * Move the values to row, which must hold size() values and outlive
+     * this object, and use it from now on.
+     */
+    void bind(double* row)
+    {
+        assert(row != NULL || m_size == 0);
+        for (std::size_t i = 0; i < m_size; i++)
+        {
+            row[i] = m_data[i];
+        }
+        m_data = row;
+        std::vector<double>().swap(m_owned);
+    }
+
+    bool isBound() const
+    {
+        return m_size > 0 && m_owned.empty();
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    double& operator[](std::size_t i)
+    {
+        assert(i < m_size);
+        return m_data[i];
+    }
+
+    const double& operator[](std::size_t i) const
+    {
+        assert(i < m_size);
+        return m_data[i];
+    }
+
+    double* data()
+    {
+        return m_data;
+    }
+
+    const double* data() const
+    {
+        return m_data;
+    }
+
+    iterator begin()
+    {
+        return m_data;
+    }
+
+    iterator end()
+    {
+        return m_data + m_size;
+    }
+
+    const_iterator begin() const
+    {
+        return m_data;
+    }
+
+    const_iterator end() const
+    {
+        return m_data + m_size;
+    }
+
+private:
+
+    void assign(const double* first, const double* last)
+    {
+        const std::size_t n = last - first;
+        if (n != m_size)
+        {
+            if (isBound())
+            {
+                throw std::length_error("Can't resize parameters that belong to a population");
+            }
+            m_owned.resize(n);
+            m_data = n > 0 ? &m_owned[0] : NULL;
+            m_size = n;
+        }
+        // The ranges may be the same row
+        for (std::size_t i = 0; i < n; i++)
+        {
+            m_data[i] = first[i];
+        }
+    }
+
+    /** Empty once bound */
+    std::vector<double> m_owned;
+    double* m_data;
+    std::size_t m_size;
+};
+
+#endif /* ANNEALEVOPARAMETERS_H_ */
@@ -26,12 +26,16 @@
  */
 
 #include "AnnealEvoPopulation.h"
+#include "learning/Checkpoint/EvoCheckpoint.h"
+#include "learning/EvoRanking.h"
 #include <string>
 #include <vector>
 #include <iostream>
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <stdexcept>
+#include <cassert>
 
 using namespace std;
 
@@ -41,11 +45,25 @@ AnnealEvoPopulation::AnnealEvoPopulation(int populationSize,configuration config
     clearScoresBetweenGenerations=false;
     this->compareAverageScores=config.getintvalue("compareAverageScores");
     this->clearScoresBetweenGenerations=config.getintvalue("clearScoresBetweenGenerations");
+    this->populationSize=populationSize;
+    this->numParameters=config.getintvalue("numberOfActions");
+    this->devBase=config.getDoubleValue("deviation");
+    this->monteCarlo=config.getintvalue("MonteCarlo");
+
+    // Sized once: members point into it from here on
+    parameters.resize(populationSize * numParameters);
+    noise.resize(numParameters);
+    rankKeys.resize(populationSize);
+    rankOrder.resize(populationSize);
+    unranked.resize(populationSize);
 
     for(int i=0;i<populationSize;i++)
     {
         //cout<<"  creating members"<<endl;
-        controllers.push_back(new AnnealEvoMember(config));
+        AnnealEvoMember* member = new AnnealEvoMember(config);
+        member->statelessParameters.bind(parameters.empty() ? NULL :
+                                        &parameters[0] + i * numParameters);
+        controllers.push_back(member);
     }
 }
 
@@ -59,43 +77,38 @@ AnnealEvoPopulation::~AnnealEvoPopulation()
 
 void AnnealEvoPopulation::mutate(std::tr1::ranlux64_base_01 *engPntr,std::size_t numMutate, double T)
 {
+    assert (T <= 1.0);
+    const double dev = devBase * T / 100.0;
+    double* const pNoise = noise.empty() ? NULL : &noise[0];
     for(std::size_t i=0;i<numMutate;i++)
     {
-        int copyFrom = 0; // Always copy from the best
-        int copyTo = this->controllers.size()-1-i;
-        controllers.at(copyTo)->copyFrom(controllers.at(copyFrom));
-        controllers.at(copyTo)->mutate(engPntr, T);
+        // Always copy from the best. When the whole population mutates the
+        // best row is the last one written, as before
+        const double* from = controllers.at(0)->statelessParameters.data();
+        double* to = controllers.at(this->controllers.size()-1-i)->statelessParameters.data();
+        AnnealEvoMember::mutateRow(from, to, numParameters, dev, monteCarlo,
+                                   engPntr, pNoise);
     }
     return;
 }
 
-bool AnnealEvoPopulation::comparisonFuncForAverage(AnnealEvoMember * elm1, AnnealEvoMember * elm2)
-{
-        return elm1->averageScore > elm2->averageScore;
-}
-bool AnnealEvoPopulation::comparisonFuncForMax(AnnealEvoMember * elm1, AnnealEvoMember * elm2)
-{
-    return elm1->maxScore > elm2->maxScore;
-}
-
-
 void AnnealEvoPopulation::orderPopulation()
 {
+    const std::size_t n = controllers.size();
     //calculate each member's average score
-    for(std::size_t i=0;i<this->controllers.size();i++)
+    for(std::size_t i=0;i<n;i++)
     {
-        double ave = std::accumulate(controllers[i]->pastScores.begin(),controllers[i]->pastScores.end(),0);
-        ave /=  (double) controllers[i]->pastScores.size();
-        controllers[i]->averageScore=ave;
+        AnnealEvoMember* member = controllers[i];
+        double ave = std::accumulate(member->pastScores.begin(),member->pastScores.end(),0);
+        ave /=  (double) member->pastScores.size();
+        member->averageScore=ave;
         if(clearScoresBetweenGenerations)
-            controllers[i]->pastScores.clear();
+            member->pastScores.clear();
+
+        rankKeys[i] = compareAverageScores ? ave : member->maxScore;
     }
 //  cout<<"ordering the whole population"<<endl;
-    if(compareAverageScores)
-        sort(controllers.begin(),controllers.end(),this->comparisonFuncForAverage);
-    else
-        sort(controllers.begin(),controllers.end(),this->comparisonFuncForMax);
-
+    rankMembers(controllers, rankKeys, rankOrder, unranked);
 }
 
 void AnnealEvoPopulation::readConfigFromXML(std::string configFile)
@@ -139,3 +152,25 @@ void AnnealEvoPopulation::readConfigFromXML(std::string configFile)
     }while(elementTxt != "</configuration>" || in.eof());
     in.close();
 }
+
+void AnnealEvoPopulation::saveState(EvoCheckpointWriter& checkpoint) const
+{
+    checkpoint.writeInt(controllers.size());
+    for(std::size_t i=0;i<controllers.size();i++)
+    {
+        controllers[i]->saveState(checkpoint);
+    }
+}
+
+void AnnealEvoPopulation::loadState(EvoCheckpointReader& checkpoint)
+{
+    if(checkpoint.readInt() != static_cast<long long>(controllers.size()))
+    {
+        throw std::runtime_error("Checkpoint population size does not match the configuration");
+    }
+    // Members keep their storage; only the values move
+    for(std::size_t i=0;i<controllers.size();i++)
+    {
+        controllers[i]->loadState(checkpoint);
+    }
+}
@@ -31,6 +31,13 @@
 #include "AnnealEvoMember.h"
 #include <vector>
 
+/**
+ * The parameters of all members are rows of one contiguous row major
+ * matrix owned by the population. Members keep their row for life;
+ * controllers holds them in rank order after orderPopulation().
+ * Mutation and ranking work on the matrix and on buffers sized once, so
+ * a generation allocates nothing.
+ */
 class AnnealEvoPopulation {
 public:
     AnnealEvoPopulation(int numControllers,configuration config);
@@ -41,13 +48,38 @@ public:
     AnnealEvoMember * selectMemberToEvaluate();
     AnnealEvoMember * getMember(int i){return controllers[i];};
 
+    /** Write every member, in rank order */
+    void saveState(EvoCheckpointWriter& checkpoint) const;
+    /**
+     * Read what saveState wrote, restoring the rank order
+     * @throws std::runtime_error if the population size differs
+     */
+    void loadState(EvoCheckpointReader& checkpoint);
+
+    /** The number of parameters per member */
+    std::size_t getNumberOfParameters() const
+    {
+        return numParameters;
+    }
+
 private:
-    static bool comparisonFuncForAverage(AnnealEvoMember * elm1, AnnealEvoMember * elm2);
-    static bool comparisonFuncForMax(AnnealEvoMember * elm1, AnnealEvoMember * elm2);
     void readConfigFromXML(std::string configFile);
     bool compareAverageScores;
     bool clearScoresBetweenGenerations;
     int populationSize;
+
+    std::size_t numParameters;
+    double devBase;
+    bool monteCarlo;
+
+    /** populationSize x numParameters, row major, one row per member */
+    std::vector<double> parameters;
+    /** Scratch for one row of mutation noise */
+    std::vector<double> noise;
+    /** Ranking scratch: scores, sorted indices, members before sorting */
+    std::vector<double> rankKeys;
+    std::vector<std::size_t> rankOrder;
+    std::vector<AnnealEvoMember*> unranked;
 };
 
 
@@ -29,6 +29,7 @@
 #include "learning/Configuration/configuration.h"
 #include "core/tgString.h"
 #include "helpers/FileHelpers.h"
+#include "learning/Checkpoint/EvoCheckpoint.h"
 #include <iostream>
 #include <numeric>
 #include <string>
@@ -55,7 +56,12 @@ unsigned long long rdtsc(){
 
 AnnealEvolution::AnnealEvolution(std::string suff, std::string config, std::string path) :
 suffix(suff),
-Temp(1.0)
+Temp(1.0),
+scoreCache(NULL),
+currentTrialKey(0),
+trialSeed(0),
+trialDeterministic(false),
+replayingCachedScore(false)
 {
     currentTest=0;
     subTests = 0;
@@ -85,6 +91,29 @@ Temp(1.0)
     
     bool learning = myconfigdataaa.getintvalue("learning");
 
+    // Optional: periodic checkpoints, and resuming from the last one
+    checkpointInterval = 0;
+    bool resume = false;
+    if (learning && myconfigdataaa.iskey("checkpointInterval"))
+    {
+        checkpointInterval = myconfigdataaa.getintvalue("checkpointInterval");
+    }
+    if (learning && myconfigdataaa.iskey("resumeFromCheckpoint"))
+    {
+        resume = myconfigdataaa.getintvalue("resumeFromCheckpoint");
+    }
+    checkpointFile = resourcePath + "logs/checkpoint-" + suffix + ".bin";
+
+    // Optional, off unless the config asks for it
+    if (learning && myconfigdataaa.iskey("scoreCachePolicy"))
+    {
+        const int samples = myconfigdataaa.iskey("scoreCacheSamples") ?
+            myconfigdataaa.getintvalue("scoreCacheSamples") : 1;
+        scoreCache = new ScoreCache(myconfigdataaa.getintvalue("scoreCachePolicy"),
+                                    samples,
+                                    resourcePath + "logs/scoreCache-" + suffix + ".csv");
+    }
+
     srand(rdtsc());
     eng.seed(rdtsc());
 
@@ -104,9 +133,16 @@ Temp(1.0)
             seededPop->loadFromFile(ss.str().c_str());
         }
     }
+    // Resuming replaces the random or seeded populations. Without a
+    // checkpoint yet, this is the start of the run
+    const bool resumed = resume && EvoCheckpointReader::exists(checkpointFile);
+    if(resumed)
+    {
+        loadCheckpoint(checkpointFile);
+    }
     if(learning)
     {
-        evolutionLog.open((resourcePath + "logs/evolution" + suffix + ".csv").c_str(),ios::out);
+        evolutionLog.open((resourcePath + "logs/evolution" + suffix + ".csv").c_str(),resumed ? ios::app : ios::out);
         if (!evolutionLog.is_open())
         {
 			throw std::runtime_error("Logs does not exist. Please create a logs folder in your build directory or update your cmake file");
@@ -116,6 +152,7 @@ Temp(1.0)
 
 AnnealEvolution::~AnnealEvolution()
 {
+    delete scoreCache;
     // @todo - solve the invalid pointer that occurs here
     #if (0)
     for(std::size_t i = 0; i < populations.size(); i++)
@@ -185,6 +222,17 @@ double diffclock(clock_t clock1,clock_t clock2)
 #endif
 
 vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
+{
+    // Trials with a usable cached score are scored without simulating
+    do
+    {
+        selectControllers();
+    } while (reuseCachedScore());
+
+    return selectedControllers;
+}
+
+void AnnealEvolution::selectControllers()
 {
     int testsToDo=0;
     if(coevolution)
@@ -204,6 +252,13 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
             currentTest=0;//Start from 0
         else
             currentTest=populationSize-numberOfElementsToMutate; //start from the mutated ones only (last x)
+
+        // Between generations nothing is in flight, so a resumed run
+        // continues exactly from here
+        if(checkpointInterval > 0 && generationNumber % checkpointInterval == 0)
+        {
+            saveCheckpoint(checkpointFile);
+        }
     }
 
     selectedControllers.clear();
@@ -211,7 +266,7 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
     {
         int selectedOne=0;
         if(coevolution)
-            selectedOne=rand()%populationSize; //select random one from each pool
+            selectedOne=std::tr1::uniform_int<int>(0, populationSize - 1)(eng); //select random one from each pool
         else
             selectedOne=currentTest; //select the same from each pool
 
@@ -227,8 +282,41 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
         subTests = 0;
     }
 //  cout<<"currentTest:"<<currentTest<<endl;
+}
 
-    return selectedControllers;
+bool AnnealEvolution::reuseCachedScore()
+{
+    if (scoreCache == NULL)
+    {
+        return false;
+    }
+
+    vector<const AnnealEvoParameters*> params;
+    for (std::size_t i = 0; i < selectedControllers.size(); i++)
+    {
+        params.push_back(&selectedControllers[i]->statelessParameters);
+    }
+    currentTrialKey = ScoreCache::makeKey(params, trialSeed, trialTerrain);
+
+    vector<double> scores;
+    if (!scoreCache->lookup(currentTrialKey, trialDeterministic, scores))
+    {
+        return false;
+    }
+
+    replayingCachedScore = true;
+    updateScores(scores);
+    replayingCachedScore = false;
+    return true;
+}
+
+void AnnealEvolution::setTrialConditions(unsigned long seed,
+                                         const std::string& terrain,
+                                         bool deterministic)
+{
+    trialSeed = seed;
+    trialTerrain = terrain;
+    trialDeterministic = deterministic;
 }
 
 void AnnealEvolution::updateScores(vector <double> multiscore)
@@ -270,5 +358,35 @@ void AnnealEvolution::updateScores(vector <double> multiscore)
 
     payloadLog<<endl;
     payloadLog.close();
+
+    if (scoreCache != NULL && !replayingCachedScore)
+    {
+        scoreCache->record(currentTrialKey, multiscore);
+    }
     return;
 }
+
+void AnnealEvolution::saveCheckpoint(const std::string& filename)
+{
+    EvoCheckpointWriter checkpoint(filename, "AnnealEvolution");
+    runState().save(checkpoint);
+    checkpoint.writeDouble(Temp);
+    savePopulations(checkpoint, populations);
+    checkpoint.commit();
+}
+
+void AnnealEvolution::loadCheckpoint(const std::string& filename)
+{
+    EvoCheckpointReader checkpoint(filename, "AnnealEvolution");
+    runState().load(checkpoint);
+    Temp = checkpoint.readDouble();
+    loadPopulations(checkpoint, populations);
+    selectedControllers.clear();
+}
+
+EvoRunState AnnealEvolution::runState()
+{
+    return EvoRunState(numberOfControllers, populationSize, currentTest,
+                       subTests, generationNumber, eng,
+                       scoresOfTheGeneration);
+}
@@ -30,9 +30,13 @@
 
 #include "AnnealEvoPopulation.h"
 #include "AnnealEvoMember.h"
+#include "ScoreCache.h"
 #include <fstream>
 #include <boost/iterator/iterator_concepts.hpp>
 
+// Forward declarations
+class EvoRunState;
+
 class AnnealEvolution
 {
 public:
@@ -43,11 +47,57 @@ public:
     void evaluatePopulation();
     std::vector< AnnealEvoMember *> nextSetOfControllers();
     void updateScores(std::vector<double> scores);
+
+    /**
+     * Describe the conditions of the coming trials for the score cache.
+     * Trials are only matched against cached ones run under the same
+     * seed and terrain. The default is seed 0, no terrain description,
+     * not deterministic, so scoreCachePolicy 3 only reuses scores once
+     * the app has called this with the real conditions of its trials.
+     */
+    void setTrialConditions(unsigned long seed, const std::string& terrain,
+                            bool deterministic);
+
+    /**
+     * Write the whole optimizer state (populations, scores, counters and
+     * random engine) so loadCheckpoint can continue the run exactly.
+     * Written atomically: an interrupted save keeps the old checkpoint.
+     * The random engine is reseeded from its own output, since the tr1
+     * engine can't be written out with its position.
+     */
+    void saveCheckpoint(const std::string& filename);
+
+    /**
+     * Replace the optimizer state with a checkpoint. Call before the
+     * first nextSetOfControllers.
+     * @throws std::runtime_error if the file is unreadable or was written
+     * with a different population size or controller shape
+     */
+    void loadCheckpoint(const std::string& filename);
+
+    /** The number of generations ordered so far */
+    int getGeneration() const
+    {
+        return generationNumber;
+    }
+
     const std::string suffix;
     /// @todo make this const if we decide to force everyone to put their logs in resources
     std::string resourcePath;
     
 private:
+    /** One step of the selection done by nextSetOfControllers */
+    void selectControllers();
+
+    /**
+     * If the cache has a usable score for the selected controllers,
+     * apply it as updateScores would and return true
+     */
+    bool reuseCachedScore();
+
+    /** The members saveCheckpoint shares with NeuroEvolution */
+    EvoRunState runState();
+
     int populationSize;
     int numberOfControllers;
     std::tr1::ranlux64_base_01 eng;
@@ -68,6 +118,18 @@ private:
     int numberOfElementsToMutate;
     int numberOfSubtests;
     int subTests;
+
+    /** NULL unless scoreCachePolicy is set in the config */
+    ScoreCache* scoreCache;
+    unsigned long long currentTrialKey;
+    unsigned long trialSeed;
+    std::string trialTerrain;
+    bool trialDeterministic;
+    bool replayingCachedScore;
+
+    /** Generations between checkpoints, 0 for none */
+    int checkpointInterval;
+    std::string checkpointFile;
 };
 
 #endif /* ANNEALEVOLUTION_H_ */
@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file ScoreCache.cpp
+ * @brief Contains the implementation of class ScoreCache
+ * $Id$
+ */
+
+#include "ScoreCache.h"
+#include "AnnealEvoParameters.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    const unsigned long long fnvOffset = 14695981039346656037ULL;
+    const unsigned long long fnvPrime = 1099511628211ULL;
+
+    unsigned long long fnv(unsigned long long hash, const void* data, size_t n)
+    {
+        const unsigned char* const bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; i++)
+        {
+            hash ^= bytes[i];
+            hash *= fnvPrime;
+        }
+        return hash;
+    }
+}
+
+ScoreCache::ScoreCache(int policy, int samples, const std::string& filename) :
+m_policy(policy),
+m_samples(samples),
+m_filename(filename)
+{
+    if (policy < policyOff || policy > policyDeterministic)
+    {
+        throw std::invalid_argument("Unknown score cache policy");
+    }
+    if (samples <= 0)
+    {
+        throw std::invalid_argument("Score cache needs at least one sample");
+    }
+    if (m_policy != policyOff && !m_filename.empty())
+    {
+        load();
+    }
+}
+
+unsigned long long ScoreCache::makeKey(const vector<const AnnealEvoParameters*>& params,
+                                       unsigned long seed,
+                                       const string& terrain)
+{
+    unsigned long long hash = fnvOffset;
+    for (size_t i = 0; i < params.size(); i++)
+    {
+        const AnnealEvoParameters& p = *params[i];
+        // The length too, so [a][b, c] and [a, b][c] differ
+        const unsigned long long n = p.size();
+        hash = fnv(hash, &n, sizeof(n));
+        if (!p.empty())
+        {
+            hash = fnv(hash, p.data(), p.size() * sizeof(double));
+        }
+    }
+    hash = fnv(hash, &seed, sizeof(seed));
+    return fnv(hash, terrain.data(), terrain.size());
+}
+
+bool ScoreCache::lookup(unsigned long long key, bool deterministic,
+                        vector<double>& scores) const
+{
+    if (m_policy == policyOff ||
+        (m_policy == policyDeterministic && !deterministic))
+    {
+        return false;
+    }
+
+    const map<unsigned long long, Entry>::const_iterator it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+    const Entry& entry = it->second;
+    if (m_policy == policyResample && entry.samples < m_samples)
+    {
+        return false;
+    }
+
+    scores.resize(entry.sum.size());
+    for (size_t i = 0; i < entry.sum.size(); i++)
+    {
+        scores[i] = entry.sum[i] / entry.samples;
+    }
+    return true;
+}
+
+void ScoreCache::record(unsigned long long key, const vector<double>& scores)
+{
+    if (m_policy == policyOff)
+    {
+        return;
+    }
+
+    add(key, scores);
+
+    if (!m_filename.empty())
+    {
+        ofstream out(m_filename.c_str(), ios::app);
+        out << hex << key << dec;
+        out.precision(17);
+        for (size_t i = 0; i < scores.size(); i++)
+        {
+            out << "," << scores[i];
+        }
+        out << endl;
+    }
+}
+
+void ScoreCache::add(unsigned long long key, const vector<double>& scores)
+{
+    Entry& entry = m_entries[key];
+    if (entry.samples == 0)
+    {
+        entry.sum.assign(scores.size(), 0.0);
+    }
+    else if (entry.sum.size() != scores.size())
+    {
+        // Results of a different shape for the same trial; keep the first
+        return;
+    }
+    for (size_t i = 0; i < scores.size(); i++)
+    {
+        entry.sum[i] += scores[i];
+    }
+    entry.samples++;
+}
+
+void ScoreCache::load()
+{
+    ifstream in(m_filename.c_str());
+    string line;
+    while (getline(in, line))
+    {
+        stringstream ss(line);
+        string field;
+        if (!getline(ss, field, ','))
+        {
+            continue;
+        }
+        const unsigned long long key = strtoull(field.c_str(), NULL, 16);
+        vector<double> scores;
+        while (getline(ss, field, ','))
+        {
+            scores.push_back(atof(field.c_str()));
+        }
+        // A line cut short by a crash has no scores
+        if (!scores.empty())
+        {
+            add(key, scores);
+        }
+    }
+}
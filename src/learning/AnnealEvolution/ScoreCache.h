@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef SCORECACHE_H_
+#define SCORECACHE_H_
+
+/**
+ * @file ScoreCache.h
+ * @brief Contains the definition of class ScoreCache
+ * $Id$
+ */
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class AnnealEvoParameters;
+
+/**
+ * Scores of trials that were already simulated, keyed by a hash of the
+ * trial's parameters and conditions (seed and terrain). Evolution asks
+ * the cache before running a trial and skips the simulation when the
+ * policy allows reusing what is there.
+ *
+ * With a filename, every recorded result is appended to that file as
+ * it arrives and the file is read back on construction, so a cache
+ * outlives the run and survives a crash.
+ */
+class ScoreCache
+{
+public:
+
+    enum Policy
+    {
+        /** Always simulate, nothing is recorded */
+        policyOff = 0,
+        /** Reuse any recorded result */
+        policyAlwaysReuse = 1,
+        /** Simulate until there are K results, then reuse their mean */
+        policyResample = 2,
+        /** Reuse only trials whose conditions are deterministic */
+        policyDeterministic = 3
+    };
+
+    /**
+     * @param[in] policy one of the Policy values
+     * @param[in] samples K for policyResample; must be positive
+     * @param[in] filename where results are kept between runs, empty to
+     * only keep them in memory
+     */
+    ScoreCache(int policy, int samples, const std::string& filename = "");
+
+    /**
+     * Hash a trial: all of its parameter vectors in order, the seed and
+     * a description of the terrain. 64 bit FNV-1a over the raw bytes, so
+     * only bit identical parameters match.
+     */
+    static unsigned long long makeKey(const std::vector<const AnnealEvoParameters*>& params,
+                                      unsigned long seed,
+                                      const std::string& terrain);
+
+    /**
+     * Whether the trial with this key can be skipped.
+     * @param[in] deterministic whether the trial's conditions are
+     * deterministic, used by policyDeterministic
+     * @param[out] scores the mean of the recorded results if true
+     */
+    bool lookup(unsigned long long key, bool deterministic,
+                std::vector<double>& scores) const;
+
+    /** Add the result of a simulated trial */
+    void record(unsigned long long key, const std::vector<double>& scores);
+
+    /** The number of distinct trials recorded */
+    std::size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    int getPolicy() const
+    {
+        return m_policy;
+    }
+
+private:
+
+    struct Entry
+    {
+        Entry() : samples(0) { }
+
+        std::vector<double> sum;
+        int samples;
+    };
+
+    void add(unsigned long long key, const std::vector<double>& scores);
+
+    void load();
+
+    const int m_policy;
+    const int m_samples;
+    const std::string m_filename;
+    std::map<unsigned long long, Entry> m_entries;
+};
+
+#endif /* SCORECACHE_H_ */
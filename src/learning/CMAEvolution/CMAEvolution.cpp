@@ -0,0 +1,548 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CMAEvolution.cpp
+ * @brief Contains the implementation of class CMAEvolution
+ * $Id$
+ */
+
+#include "CMAEvolution.h"
+#include "learning/Configuration/configuration.h"
+#include "helpers/FileHelpers.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    /** Eigenvalues of C are kept at least this large */
+    const double minEigenvalue = 1e-20;
+
+    /**
+     * Cyclic Jacobi eigen decomposition of the symmetric n x n matrix a,
+     * which is overwritten. On return the diagonal of a holds the
+     * eigenvalues and the columns of v the eigenvectors.
+     */
+    void jacobiEigen(vector<double>& a, vector<double>& v, size_t n)
+    {
+        v.assign(n * n, 0.0);
+        for (size_t i = 0; i < n; i++)
+        {
+            v[i * n + i] = 1.0;
+        }
+
+        for (int sweep = 0; sweep < 100; sweep++)
+        {
+            double off = 0.0;
+            double diag = 0.0;
+            for (size_t i = 0; i < n; i++)
+            {
+                diag += a[i * n + i] * a[i * n + i];
+                for (size_t j = i + 1; j < n; j++)
+                {
+                    off += a[i * n + j] * a[i * n + j];
+                }
+            }
+            if (off <= 1e-24 * diag)
+            {
+                return;
+            }
+
+            for (size_t p = 0; p < n; p++)
+            {
+                for (size_t q = p + 1; q < n; q++)
+                {
+                    const double apq = a[p * n + q];
+                    if (apq == 0.0)
+                    {
+                        continue;
+                    }
+                    const double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                        (fabs(theta) + sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / sqrt(t * t + 1.0);
+                    const double s = t * c;
+
+                    for (size_t k = 0; k < n; k++)
+                    {
+                        const double akp = a[k * n + p];
+                        const double akq = a[k * n + q];
+                        a[k * n + p] = c * akp - s * akq;
+                        a[k * n + q] = s * akp + c * akq;
+                    }
+                    for (size_t k = 0; k < n; k++)
+                    {
+                        const double apk = a[p * n + k];
+                        const double aqk = a[q * n + k];
+                        a[p * n + k] = c * apk - s * aqk;
+                        a[q * n + k] = s * apk + c * aqk;
+                    }
+                    for (size_t k = 0; k < n; k++)
+                    {
+                        const double vkp = v[k * n + p];
+                        const double vkq = v[k * n + q];
+                        v[k * n + p] = c * vkp - s * vkq;
+                        v[k * n + q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+    }
+
+    /** Orders candidate indices by descending score */
+    struct ScoreGreater
+    {
+        explicit ScoreGreater(const vector<double>& s) : scores(s) { }
+
+        bool operator()(size_t a, size_t b) const
+        {
+            return scores[a] > scores[b];
+        }
+
+        const vector<double>& scores;
+    };
+}
+
+CMAEvolution::CMAEvolution(std::string suff, std::string config, std::string path) :
+suffix(suff),
+m_eigenGeneration(0),
+m_asked(false),
+m_nextCandidate(0),
+m_scoredCandidates(0),
+m_bestScore(-numeric_limits<double>::max()),
+m_generation(0)
+{
+    if (path != "")
+    {
+        resourcePath = FileHelpers::getResourcePath(path);
+    }
+    else
+    {
+        resourcePath = "";
+    }
+
+    configuration myconfigdata;
+    myconfigdata.readFile(resourcePath + config);
+    numberOfActions = myconfigdata.getintvalue("numberOfActions");
+    numberOfControllers = myconfigdata.getintvalue("numberOfControllers");
+    const int populationSize = myconfigdata.getintvalue("populationSize");
+    learning = myconfigdata.getintvalue("learning");
+    const bool seeded = myconfigdata.getintvalue("startSeed");
+    m_sigma = myconfigdata.iskey("initialSigma") ?
+        myconfigdata.getDoubleValue("initialSigma") : 0.3;
+    const unsigned long seed = myconfigdata.iskey("seed") ?
+        myconfigdata.getintvalue("seed") : time(NULL);
+
+    if (numberOfActions <= 0 || numberOfControllers <= 0)
+    {
+        throw std::invalid_argument("CMAEvolution needs at least one parameter");
+    }
+    if (m_sigma <= 0.0)
+    {
+        throw std::invalid_argument("initialSigma is not positive");
+    }
+
+    m_n = numberOfActions * numberOfControllers;
+    const double n = m_n;
+    m_lambda = populationSize > 0 ? populationSize :
+        4 + (size_t) floor(3.0 * log(n));
+    if (m_lambda < 2)
+    {
+        throw std::invalid_argument("CMAEvolution needs a populationSize of at least 2");
+    }
+    m_mu = m_lambda / 2;
+
+    // Log-linear recombination weights
+    m_weights.resize(m_mu);
+    double sumW = 0.0;
+    for (size_t i = 0; i < m_mu; i++)
+    {
+        m_weights[i] = log(m_mu + 0.5) - log(i + 1.0);
+        sumW += m_weights[i];
+    }
+    double sumW2 = 0.0;
+    for (size_t i = 0; i < m_mu; i++)
+    {
+        m_weights[i] /= sumW;
+        sumW2 += m_weights[i] * m_weights[i];
+    }
+    m_mueff = 1.0 / sumW2;
+
+    // Default strategy parameters from the tutorial
+    m_cc = (4.0 + m_mueff / n) / (n + 4.0 + 2.0 * m_mueff / n);
+    m_cs = (m_mueff + 2.0) / (n + m_mueff + 5.0);
+    m_c1 = 2.0 / ((n + 1.3) * (n + 1.3) + m_mueff);
+    m_cmu = min(1.0 - m_c1,
+                2.0 * (m_mueff - 2.0 + 1.0 / m_mueff) /
+                ((n + 2.0) * (n + 2.0) + m_mueff));
+    m_damps = 1.0 + 2.0 * max(0.0, sqrt((m_mueff - 1.0) / (n + 1.0)) - 1.0) + m_cs;
+    m_chiN = sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    m_mean.assign(m_n, 0.5);
+    m_pc.assign(m_n, 0.0);
+    m_ps.assign(m_n, 0.0);
+    m_C.assign(m_n * m_n, 0.0);
+    m_B.assign(m_n * m_n, 0.0);
+    m_D.assign(m_n, 1.0);
+    for (size_t i = 0; i < m_n; i++)
+    {
+        m_C[i * m_n + i] = 1.0;
+        m_B[i * m_n + i] = 1.0;
+    }
+
+    m_candidates.assign(m_lambda, vector<double>(m_n));
+    m_pendingScores.assign(m_lambda, 0.0);
+
+    eng.seed(seed);
+
+    // Without learning the saved parameters are used as they are
+    if (seeded || !learning)
+    {
+        loadMean();
+    }
+    m_best = m_mean;
+
+    if (learning)
+    {
+        evolutionLog.open((resourcePath + "logs/evolution" + suffix + ".csv").c_str(), ios::out);
+        if (!evolutionLog.is_open())
+        {
+            throw std::runtime_error("Logs does not exist. Please create a logs folder in your build directory or update your cmake file");
+        }
+    }
+}
+
+CMAEvolution::~CMAEvolution()
+{
+}
+
+const vector<vector<double> >& CMAEvolution::ask()
+{
+    if (m_asked)
+    {
+        return m_candidates;
+    }
+
+    vector<double> z(m_n);
+    for (size_t k = 0; k < m_lambda; k++)
+    {
+        for (size_t j = 0; j < m_n; j++)
+        {
+            z[j] = m_D[j] * m_normal(eng);
+        }
+
+        vector<double>& x = m_candidates[k];
+        for (size_t i = 0; i < m_n; i++)
+        {
+            // x = m + sigma * B * D * z
+            double y = 0.0;
+            const double* const row = &m_B[i * m_n];
+            for (size_t j = 0; j < m_n; j++)
+            {
+                y += row[j] * z[j];
+            }
+            x[i] = min(1.0, max(0.0, m_mean[i] + m_sigma * y));
+        }
+    }
+
+    m_asked = true;
+    return m_candidates;
+}
+
+void CMAEvolution::tell(const vector<double>& scores)
+{
+    if (!m_asked)
+    {
+        throw std::logic_error("tell() without a preceding ask()");
+    }
+    if (scores.size() != m_lambda)
+    {
+        throw std::invalid_argument("Need one score per candidate");
+    }
+
+    vector<size_t> order(m_lambda);
+    for (size_t k = 0; k < m_lambda; k++)
+    {
+        order[k] = k;
+    }
+    sort(order.begin(), order.end(), ScoreGreater(scores));
+
+    double averageScore = 0.0;
+    for (size_t k = 0; k < m_lambda; k++)
+    {
+        averageScore += scores[k];
+    }
+    averageScore /= m_lambda;
+
+    if (scores[order[0]] > m_bestScore)
+    {
+        m_bestScore = scores[order[0]];
+        m_best = m_candidates[order[0]];
+        if (learning)
+        {
+            saveBest();
+        }
+    }
+
+    // New mean and the step it took, in units of sigma
+    const vector<double> oldMean = m_mean;
+    vector<double> yw(m_n, 0.0);
+    for (size_t i = 0; i < m_n; i++)
+    {
+        double mean = 0.0;
+        for (size_t k = 0; k < m_mu; k++)
+        {
+            mean += m_weights[k] * m_candidates[order[k]][i];
+        }
+        m_mean[i] = mean;
+        yw[i] = (mean - oldMean[i]) / m_sigma;
+    }
+
+    // Conjugate evolution path, using C^-1/2 = B * D^-1 * B^T
+    vector<double> tmp(m_n, 0.0);
+    for (size_t j = 0; j < m_n; j++)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < m_n; i++)
+        {
+            sum += m_B[i * m_n + j] * yw[i];
+        }
+        tmp[j] = sum / m_D[j];
+    }
+    const double csFactor = sqrt(m_cs * (2.0 - m_cs) * m_mueff);
+    double psNorm2 = 0.0;
+    for (size_t i = 0; i < m_n; i++)
+    {
+        double sum = 0.0;
+        const double* const row = &m_B[i * m_n];
+        for (size_t j = 0; j < m_n; j++)
+        {
+            sum += row[j] * tmp[j];
+        }
+        m_ps[i] = (1.0 - m_cs) * m_ps[i] + csFactor * sum;
+        psNorm2 += m_ps[i] * m_ps[i];
+    }
+    const double psNorm = sqrt(psNorm2);
+
+    m_generation++;
+    const bool hsig = psNorm /
+        sqrt(1.0 - pow(1.0 - m_cs, 2.0 * m_generation)) / m_chiN <
+        1.4 + 2.0 / (m_n + 1.0);
+
+    const double ccFactor = sqrt(m_cc * (2.0 - m_cc) * m_mueff);
+    for (size_t i = 0; i < m_n; i++)
+    {
+        m_pc[i] = (1.0 - m_cc) * m_pc[i] + (hsig ? ccFactor * yw[i] : 0.0);
+    }
+
+    // Rank one and rank mu updates of the covariance matrix
+    vector<vector<double> > steps(m_mu, vector<double>(m_n));
+    for (size_t k = 0; k < m_mu; k++)
+    {
+        for (size_t i = 0; i < m_n; i++)
+        {
+            steps[k][i] = (m_candidates[order[k]][i] - oldMean[i]) / m_sigma;
+        }
+    }
+    const double decay = 1.0 - m_c1 - m_cmu +
+        (hsig ? 0.0 : m_c1 * m_cc * (2.0 - m_cc));
+    for (size_t i = 0; i < m_n; i++)
+    {
+        for (size_t j = 0; j <= i; j++)
+        {
+            double rankMu = 0.0;
+            for (size_t k = 0; k < m_mu; k++)
+            {
+                rankMu += m_weights[k] * steps[k][i] * steps[k][j];
+            }
+            const double c = decay * m_C[i * m_n + j] +
+                m_c1 * m_pc[i] * m_pc[j] + m_cmu * rankMu;
+            m_C[i * m_n + j] = c;
+            m_C[j * m_n + i] = c;
+        }
+    }
+
+    m_sigma *= exp((m_cs / m_damps) * (psNorm / m_chiN - 1.0));
+
+    // The decomposition is O(n^3), so only redo it once enough
+    // evaluations have gone into C since the last one
+    const double evaluationsSinceEigen =
+        (double) (m_generation - m_eigenGeneration) * m_lambda;
+    if (evaluationsSinceEigen > m_lambda / (m_c1 + m_cmu) / m_n / 10.0)
+    {
+        updateEigensystem();
+    }
+
+    if (learning)
+    {
+        evolutionLog << m_generation * m_lambda << "," << averageScore << ","
+                     << scores[order[0]] << "," << m_bestScore << ","
+                     << m_sigma << endl;
+    }
+
+    m_asked = false;
+}
+
+void CMAEvolution::runGeneration(Evaluator& evaluator)
+{
+    const vector<vector<double> >& candidates = ask();
+    vector<double> scores(candidates.size(), 0.0);
+    evaluator.evaluate(candidates, scores);
+    tell(scores);
+}
+
+const vector<vector<double> >& CMAEvolution::nextSetOfControllers()
+{
+    if (!learning)
+    {
+        return getBestControllers();
+    }
+
+    if (!m_asked)
+    {
+        ask();
+        m_nextCandidate = 0;
+        m_scoredCandidates = 0;
+    }
+    else if (m_nextCandidate == m_lambda)
+    {
+        throw std::logic_error("Every candidate was handed out, but not every one was scored");
+    }
+
+    splitControllers(m_candidates[m_nextCandidate], m_controllerRows);
+    m_nextCandidate++;
+    return m_controllerRows;
+}
+
+void CMAEvolution::updateScores(const vector<double>& multiscore)
+{
+    if (!learning)
+    {
+        return;
+    }
+    if (!m_asked || m_nextCandidate == 0)
+    {
+        throw std::logic_error("updateScores() without nextSetOfControllers()");
+    }
+
+    const double score = multiscore.size() == 2 ? multiscore[0] : -1.0;
+    const vector<double>& candidate = m_candidates[m_nextCandidate - 1];
+
+    //Record it to the file
+    ofstream payloadLog;
+    payloadLog.open((resourcePath + "logs/scores.csv").c_str(), ios::app);
+    payloadLog << score << "," << (multiscore.size() == 2 ? multiscore[1] : -1.0);
+    for (size_t i = 0; i < candidate.size(); i++)
+    {
+        payloadLog << "," << candidate[i];
+    }
+    payloadLog << endl;
+    payloadLog.close();
+
+    m_pendingScores[m_nextCandidate - 1] = score;
+    m_scoredCandidates++;
+    if (m_scoredCandidates == m_lambda)
+    {
+        tell(m_pendingScores);
+    }
+}
+
+const vector<vector<double> >& CMAEvolution::getBestControllers()
+{
+    splitControllers(m_best, m_bestRows);
+    return m_bestRows;
+}
+
+vector<double> CMAEvolution::getMean() const
+{
+    vector<double> result(m_mean);
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        result[i] = min(1.0, max(0.0, result[i]));
+    }
+    return result;
+}
+
+void CMAEvolution::updateEigensystem()
+{
+    vector<double> a(m_C);
+    jacobiEigen(a, m_B, m_n);
+    for (size_t i = 0; i < m_n; i++)
+    {
+        m_D[i] = sqrt(max(a[i * m_n + i], minEigenvalue));
+    }
+    m_eigenGeneration = m_generation;
+}
+
+void CMAEvolution::splitControllers(const vector<double>& x,
+                                    vector<vector<double> >& rows) const
+{
+    assert(x.size() == m_n);
+    rows.resize(numberOfControllers);
+    for (int i = 0; i < numberOfControllers; i++)
+    {
+        rows[i].assign(x.begin() + i * numberOfActions,
+                       x.begin() + (i + 1) * numberOfActions);
+    }
+}
+
+void CMAEvolution::saveBest() const
+{
+    for (int i = 0; i < numberOfControllers; i++)
+    {
+        stringstream ss;
+        ss << resourcePath << "logs/bestParameters-" << suffix << "-" << i << ".nnw";
+        ofstream out(ss.str().c_str());
+        for (int j = 0; j < numberOfActions; j++)
+        {
+            out << m_best[i * numberOfActions + j];
+            if (j != numberOfActions - 1)
+                out << ",";
+        }
+    }
+}
+
+void CMAEvolution::loadMean()
+{
+    for (int i = 0; i < numberOfControllers; i++)
+    {
+        stringstream ss;
+        ss << resourcePath << "logs/bestParameters-" << suffix << "-" << i << ".nnw";
+        ifstream in(ss.str().c_str());
+        if (!in.is_open())
+        {
+            cout << "File of name " << ss.str() << " does not exist" << std::endl;
+            cout << "Try turning learning on in config.ini to generate parameters" << std::endl;
+            throw std::invalid_argument("Parameter file does not exist");
+        }
+        string value;
+        for (int j = 0; j < numberOfActions && getline(in, value, ','); j++)
+        {
+            m_mean[i * numberOfActions + j] = atof(value.c_str());
+        }
+    }
+}
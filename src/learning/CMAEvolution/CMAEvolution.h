@@ -0,0 +1,215 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef CMAEVOLUTION_H_
+#define CMAEVOLUTION_H_
+
+/**
+ * @file CMAEvolution.h
+ * @brief Contains the definition of class CMAEvolution.
+ * A covariance matrix adaptation evolution strategy with a batched
+ * ask/tell interface
+ * $Id$
+ */
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <tr1/random>
+
+/**
+ * CMA-ES (Hansen, "The CMA Evolution Strategy: A Tutorial") over all
+ * numberOfControllers * numberOfActions parameters of a trial at once.
+ * Parameters live in [0, 1] like AnnealEvolution's, so controllers can
+ * switch between the two without rescaling. Samples outside the box are
+ * clamped, and the clamped sample is what the distribution is updated
+ * with.
+ *
+ * A generation is asked for as a batch, evaluated in any order or in
+ * parallel, and told back as one vector of scores (higher is better).
+ * nextSetOfControllers() and updateScores() drive the same loop one
+ * trial at a time, so CMAAdapter can be used in place of AnnealAdapter.
+ *
+ * Reads populationSize, numberOfActions, numberOfControllers, learning
+ * and startSeed from the config file. populationSize 0 picks the
+ * default 4 + 3 ln(n). The optional initialSigma sets the initial step
+ * size (default 0.3), and the optional seed fixes the random sequence.
+ */
+class CMAEvolution
+{
+public:
+
+    /**
+     * Evaluates a whole generation. Implementations are free to run the
+     * candidates concurrently, e.g. one tgSimulation per thread or one
+     * trial per worker process.
+     */
+    class Evaluator
+    {
+    public:
+        virtual ~Evaluator() { }
+
+        /**
+         * @param[in] candidates populationSize rows of
+         * getNumberOfParameters() values in [0, 1]
+         * @param[out] scores one score per candidate, in the same order;
+         * already sized to candidates.size()
+         */
+        virtual void evaluate(const std::vector<std::vector<double> >& candidates,
+                              std::vector<double>& scores) = 0;
+    };
+
+    CMAEvolution(std::string suffix, std::string config = "config.ini", std::string path = "");
+    ~CMAEvolution();
+
+    /**
+     * Sample a new generation. Calling ask() again before tell()
+     * returns the same candidates.
+     * @return populationSize rows of getNumberOfParameters() values
+     */
+    const std::vector<std::vector<double> >& ask();
+
+    /**
+     * Update the distribution with the scores of the last ask(), one per
+     * candidate in the same order.
+     * @throws std::invalid_argument if the number of scores is wrong
+     * @throws std::logic_error if there was no ask() since the last tell()
+     */
+    void tell(const std::vector<double>& scores);
+
+    /** ask(), evaluate the whole generation, tell() */
+    void runGeneration(Evaluator& evaluator);
+
+    /**
+     * The next untested candidate of the current generation, split into
+     * one row per controller. Asks for a new generation when needed.
+     */
+    const std::vector<std::vector<double> >& nextSetOfControllers();
+
+    /**
+     * Score the candidate of the last nextSetOfControllers(). The first
+     * score is maximized; a result without two scores counts as -1.
+     * Tells the generation once every candidate has a score.
+     */
+    void updateScores(const std::vector<double>& multiscore);
+
+    /** The best parameters found so far, one row per controller */
+    const std::vector<std::vector<double> >& getBestControllers();
+
+    double getBestScore() const
+    {
+        return m_bestScore;
+    }
+
+    double getStepSize() const
+    {
+        return m_sigma;
+    }
+
+    int getGeneration() const
+    {
+        return m_generation;
+    }
+
+    std::size_t getPopulationSize() const
+    {
+        return m_lambda;
+    }
+
+    std::size_t getNumberOfParameters() const
+    {
+        return m_n;
+    }
+
+    /**
+     * The mean of the search distribution, clamped to [0, 1]
+     */
+    std::vector<double> getMean() const;
+
+    const std::string suffix;
+    std::string resourcePath;
+
+private:
+
+    /** Recompute B and D from C, and the diagonal update bookkeeping */
+    void updateEigensystem();
+
+    /** Split a flat parameter vector into per controller rows */
+    void splitControllers(const std::vector<double>& x,
+                          std::vector<std::vector<double> >& rows) const;
+
+    /** Write the best parameters in AnnealEvoMember's file format */
+    void saveBest() const;
+
+    /** Read the mean from the files saveBest() writes */
+    void loadMean();
+
+    std::size_t m_n;
+    std::size_t m_lambda;
+    std::size_t m_mu;
+    int numberOfActions;
+    int numberOfControllers;
+
+    /** Recombination weights, decreasing, summing to one */
+    std::vector<double> m_weights;
+    double m_mueff;
+
+    /** Learning rates and damping, fixed by n and mueff */
+    double m_cc;
+    double m_cs;
+    double m_c1;
+    double m_cmu;
+    double m_damps;
+    double m_chiN;
+
+    double m_sigma;
+    std::vector<double> m_mean;
+    std::vector<double> m_pc;
+    std::vector<double> m_ps;
+
+    /** Covariance matrix, row major n x n */
+    std::vector<double> m_C;
+    /** Eigenvectors of C, one per column, row major n x n */
+    std::vector<double> m_B;
+    /** Square roots of the eigenvalues of C */
+    std::vector<double> m_D;
+    int m_eigenGeneration;
+
+    /** The current generation, sampled and clamped */
+    std::vector<std::vector<double> > m_candidates;
+    bool m_asked;
+
+    /** Sequential interface state */
+    std::vector<double> m_pendingScores;
+    std::size_t m_nextCandidate;
+    std::size_t m_scoredCandidates;
+    std::vector<std::vector<double> > m_controllerRows;
+
+    std::vector<double> m_best;
+    std::vector<std::vector<double> > m_bestRows;
+    double m_bestScore;
+    int m_generation;
+
+    bool learning;
+    std::tr1::ranlux64_base_01 eng;
+    std::tr1::normal_distribution<double> m_normal;
+    std::ofstream evolutionLog;
+};
+
+#endif /* CMAEVOLUTION_H_ */
@@ -0,0 +1,292 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file EvoCheckpoint.cpp
+ * @brief Contains the definitions of members of classes
+ * EvoCheckpointWriter, EvoCheckpointReader and EvoRunState
+ * $Id$
+ */
+
+// This module
+#include "EvoCheckpoint.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <stdexcept>
+// POSIX
+#include <unistd.h>
+
+namespace
+{
+    const char checkpointMagic[8] = { 'N', 'T', 'R', 'T', 'E', 'V', 'O', 'C' };
+    /** Bump when the header or EvoRunState changes */
+    const long long checkpointVersion = 2;
+}
+
+EvoCheckpointWriter::EvoCheckpointWriter(const std::string& filename,
+                                         const std::string& kind) :
+    m_filename(filename),
+    m_tmpFilename(filename + ".tmp"),
+    m_file(std::fopen(m_tmpFilename.c_str(), "wb")),
+    m_failed(false)
+{
+    if (m_file == NULL)
+    {
+        throw std::runtime_error("Can't create checkpoint " + m_tmpFilename);
+    }
+    writeBytes(checkpointMagic, sizeof(checkpointMagic));
+    writeInt(checkpointVersion);
+    writeString(kind);
+}
+
+EvoCheckpointWriter::~EvoCheckpointWriter()
+{
+    if (m_file != NULL)
+    {
+        std::fclose(m_file);
+        std::remove(m_tmpFilename.c_str());
+    }
+}
+
+void EvoCheckpointWriter::writeInt(long long value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void EvoCheckpointWriter::writeDouble(double value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void EvoCheckpointWriter::writeString(const std::string& value)
+{
+    writeInt(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void EvoCheckpointWriter::writeDoubles(const double* values, std::size_t n)
+{
+    writeInt(n);
+    writeBytes(values, n * sizeof(double));
+}
+
+void EvoCheckpointWriter::writeDoubles(const std::vector<double>& values)
+{
+    writeDoubles(values.empty() ? NULL : &values[0], values.size());
+}
+
+void EvoCheckpointWriter::commit()
+{
+    if (m_file == NULL)
+    {
+        throw std::logic_error("Checkpoint was already committed");
+    }
+    if (std::fflush(m_file) != 0 || fsync(fileno(m_file)) != 0)
+    {
+        m_failed = true;
+    }
+    const bool closed = (std::fclose(m_file) == 0);
+    m_file = NULL;
+    if (m_failed || !closed ||
+        std::rename(m_tmpFilename.c_str(), m_filename.c_str()) != 0)
+    {
+        std::remove(m_tmpFilename.c_str());
+        throw std::runtime_error("Can't write checkpoint " + m_filename);
+    }
+}
+
+void EvoCheckpointWriter::writeBytes(const void* p, std::size_t n)
+{
+    if (n > 0 && std::fwrite(p, 1, n, m_file) != n)
+    {
+        m_failed = true;
+    }
+}
+
+EvoCheckpointReader::EvoCheckpointReader(const std::string& filename,
+                                         const std::string& kind) :
+    m_filename(filename),
+    m_file(std::fopen(filename.c_str(), "rb"))
+{
+    if (m_file == NULL)
+    {
+        throw std::runtime_error("Can't open checkpoint " + filename);
+    }
+
+    // The destructor won't run if this throws, truncated headers included
+    try
+    {
+        char magic[sizeof(checkpointMagic)];
+        readBytes(magic, sizeof(magic));
+        if (!std::equal(magic, magic + sizeof(magic), checkpointMagic) ||
+            readInt() != checkpointVersion)
+        {
+            throw std::runtime_error(filename + " is not a checkpoint of this version");
+        }
+        if (readString() != kind)
+        {
+            throw std::runtime_error(filename + " is not a " + kind + " checkpoint");
+        }
+    }
+    catch (...)
+    {
+        std::fclose(m_file);
+        throw;
+    }
+}
+
+EvoCheckpointReader::~EvoCheckpointReader()
+{
+    std::fclose(m_file);
+}
+
+bool EvoCheckpointReader::exists(const std::string& filename)
+{
+    std::FILE* const file = std::fopen(filename.c_str(), "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    std::fclose(file);
+    return true;
+}
+
+long long EvoCheckpointReader::readInt()
+{
+    long long value;
+    readBytes(&value, sizeof(value));
+    return value;
+}
+
+double EvoCheckpointReader::readDouble()
+{
+    double value;
+    readBytes(&value, sizeof(value));
+    return value;
+}
+
+std::string EvoCheckpointReader::readString()
+{
+    const long long n = readInt();
+    if (n < 0)
+    {
+        throw std::runtime_error("Corrupt checkpoint " + m_filename);
+    }
+    std::string value(static_cast<std::size_t>(n), '\0');
+    if (n > 0)
+    {
+        readBytes(&value[0], value.size());
+    }
+    return value;
+}
+
+void EvoCheckpointReader::readDoubles(std::vector<double>& values)
+{
+    const long long n = readInt();
+    if (n < 0)
+    {
+        throw std::runtime_error("Corrupt checkpoint " + m_filename);
+    }
+    values.resize(static_cast<std::size_t>(n));
+    if (n > 0)
+    {
+        readBytes(&values[0], values.size() * sizeof(double));
+    }
+}
+
+void EvoCheckpointReader::readDoubles(double* values, std::size_t n)
+{
+    if (readInt() != static_cast<long long>(n))
+    {
+        throw std::runtime_error("Checkpoint " + m_filename +
+                                 " does not match the configuration");
+    }
+    readBytes(values, n * sizeof(double));
+}
+
+void EvoCheckpointReader::readBytes(void* p, std::size_t n)
+{
+    if (n > 0 && std::fread(p, 1, n, m_file) != n)
+    {
+        throw std::runtime_error("Checkpoint " + m_filename + " is truncated");
+    }
+}
+
+EvoRunState::EvoRunState(int numberOfControllers,
+                         int populationSize,
+                         int& currentTest,
+                         int& subTests,
+                         int& generationNumber,
+                         std::tr1::ranlux64_base_01& eng,
+                         std::vector<std::vector<double> >& scoresOfTheGeneration) :
+    m_numberOfControllers(numberOfControllers),
+    m_populationSize(populationSize),
+    m_currentTest(currentTest),
+    m_subTests(subTests),
+    m_generationNumber(generationNumber),
+    m_eng(eng),
+    m_scores(scoresOfTheGeneration)
+{
+}
+
+void EvoRunState::save(EvoCheckpointWriter& checkpoint) const
+{
+    checkpoint.writeInt(m_numberOfControllers);
+    checkpoint.writeInt(m_populationSize);
+    checkpoint.writeInt(m_currentTest);
+    checkpoint.writeInt(m_subTests);
+    checkpoint.writeInt(m_generationNumber);
+
+    const unsigned long engSeed =
+        static_cast<unsigned long>(m_eng() * 4294967295.0) + 1;
+    m_eng.seed(engSeed);
+    checkpoint.writeInt(engSeed);
+
+    checkpoint.writeInt(m_scores.size());
+    for (std::size_t i = 0; i < m_scores.size(); i++)
+    {
+        checkpoint.writeDoubles(m_scores[i]);
+    }
+}
+
+void EvoRunState::load(EvoCheckpointReader& checkpoint) const
+{
+    if (checkpoint.readInt() != m_numberOfControllers ||
+        checkpoint.readInt() != m_populationSize)
+    {
+        throw std::runtime_error("Checkpoint " + checkpoint.getFilename() +
+                                 " does not match the configuration");
+    }
+    m_currentTest = checkpoint.readInt();
+    m_subTests = checkpoint.readInt();
+    m_generationNumber = checkpoint.readInt();
+
+    m_eng.seed(static_cast<unsigned long>(checkpoint.readInt()));
+
+    const long long numScores = checkpoint.readInt();
+    if (numScores < 0)
+    {
+        throw std::runtime_error("Corrupt checkpoint " + checkpoint.getFilename());
+    }
+    m_scores.resize(static_cast<std::size_t>(numScores));
+    for (std::size_t i = 0; i < m_scores.size(); i++)
+    {
+        checkpoint.readDoubles(m_scores[i]);
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef EVOCHECKPOINT_H_
+#define EVOCHECKPOINT_H_
+
+/**
+ * @file EvoCheckpoint.h
+ * @brief Contains the definitions of classes EvoCheckpointWriter,
+ * EvoCheckpointReader and EvoRunState, binary snapshots of an optimizer's
+ * state
+ * $Id$
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <tr1/random>
+#include <vector>
+
+/**
+ * Writes a checkpoint: a header naming the kind of optimizer, then
+ * whatever values the optimizer writes, in native byte order. Everything
+ * goes to filename.tmp, which commit() syncs and renames over filename,
+ * so a crash at any point leaves the previous checkpoint intact.
+ * Checkpoints are meant for resuming on the same kind of machine, not
+ * for exchange.
+ */
+class EvoCheckpointWriter
+{
+public:
+    /**
+     * @param[in] filename the checkpoint to replace on commit()
+     * @param[in] kind identifies the optimizer, checked when reading
+     * @throws std::runtime_error if the temporary file can't be created
+     */
+    EvoCheckpointWriter(const std::string& filename, const std::string& kind);
+
+    /** Removes the temporary file unless commit() succeeded */
+    ~EvoCheckpointWriter();
+
+    void writeInt(long long value);
+    void writeDouble(double value);
+    void writeString(const std::string& value);
+
+    /** n followed by n values */
+    void writeDoubles(const double* values, std::size_t n);
+    void writeDoubles(const std::vector<double>& values);
+
+    /**
+     * Flush, sync and rename over the checkpoint.
+     * @throws std::runtime_error if any write failed
+     */
+    void commit();
+
+private:
+    /** Not copyable */
+    EvoCheckpointWriter(const EvoCheckpointWriter&);
+    EvoCheckpointWriter& operator=(const EvoCheckpointWriter&);
+
+    void writeBytes(const void* p, std::size_t n);
+
+    const std::string m_filename;
+    const std::string m_tmpFilename;
+    std::FILE* m_file;
+    bool m_failed;
+};
+
+/**
+ * Reads a checkpoint written by EvoCheckpointWriter. Values must be
+ * read back in the order and with the types they were written.
+ * A truncated or foreign file, or one written for a different
+ * configuration, throws std::runtime_error.
+ */
+class EvoCheckpointReader
+{
+public:
+    /**
+     * @throws std::runtime_error if the file can't be opened or was not
+     * written for this kind of optimizer
+     */
+    EvoCheckpointReader(const std::string& filename, const std::string& kind);
+    ~EvoCheckpointReader();
+
+    /** Whether there is a checkpoint to resume from */
+    static bool exists(const std::string& filename);
+
+    long long readInt();
+    double readDouble();
+    std::string readString();
+
+    /** Read a vector of any length */
+    void readDoubles(std::vector<double>& values);
+
+    /**
+     * Read a vector that must have exactly n values
+     * @throws std::runtime_error if the length differs
+     */
+    void readDoubles(double* values, std::size_t n);
+
+    const std::string& getFilename() const
+    {
+        return m_filename;
+    }
+
+private:
+    /** Not copyable */
+    EvoCheckpointReader(const EvoCheckpointReader&);
+    EvoCheckpointReader& operator=(const EvoCheckpointReader&);
+
+    void readBytes(void* p, std::size_t n);
+
+    const std::string m_filename;
+    std::FILE* m_file;
+};
+
+/**
+ * The state AnnealEvolution and NeuroEvolution checkpoint the same way:
+ * the configured shape, the trial counters, the random engine and the
+ * scores of the current generation. Binds the optimizer's members, so
+ * save and load read and write them in place. The optimizer writes
+ * anything of its own, then its populations, after these.
+ */
+class EvoRunState
+{
+public:
+    EvoRunState(int numberOfControllers,
+                int populationSize,
+                int& currentTest,
+                int& subTests,
+                int& generationNumber,
+                std::tr1::ranlux64_base_01& eng,
+                std::vector<std::vector<double> >& scoresOfTheGeneration);
+
+    /**
+     * The tr1 stream operators drop the engine's position in its state,
+     * so the engine is restarted from a seed drawn from it and the seed
+     * is written. The run continues the same way whether or not it is
+     * resumed from here.
+     */
+    void save(EvoCheckpointWriter& checkpoint) const;
+
+    /**
+     * @throws std::runtime_error if the checkpoint was written with a
+     * different number of controllers or population size
+     */
+    void load(EvoCheckpointReader& checkpoint) const;
+
+private:
+    const int m_numberOfControllers;
+    const int m_populationSize;
+    int& m_currentTest;
+    int& m_subTests;
+    int& m_generationNumber;
+    std::tr1::ranlux64_base_01& m_eng;
+    std::vector<std::vector<double> >& m_scores;
+};
+
+/** Write every population with its saveState, in order */
+template <class Population>
+void savePopulations(EvoCheckpointWriter& checkpoint,
+                     const std::vector<Population*>& populations)
+{
+    for (std::size_t i = 0; i < populations.size(); i++)
+    {
+        populations[i]->saveState(checkpoint);
+    }
+}
+
+/** Read what savePopulations wrote into populations of the same shape */
+template <class Population>
+void loadPopulations(EvoCheckpointReader& checkpoint,
+                     const std::vector<Population*>& populations)
+{
+    for (std::size_t i = 0; i < populations.size(); i++)
+    {
+        populations[i]->loadState(checkpoint);
+    }
+}
+
+#endif /* EVOCHECKPOINT_H_ */
@@ -0,0 +1,76 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef EVORANKING_H_
+#define EVORANKING_H_
+
+/**
+ * @file EvoRanking.h
+ * @brief Contains the ranking shared by AnnealEvoPopulation and
+ * NeuroEvoPopulation
+ * $Id$
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/** Orders member indices by descending score */
+class EvoRankComparison
+{
+public:
+    EvoRankComparison(const std::vector<double>& keys) : m_keys(keys) { }
+    bool operator()(std::size_t a, std::size_t b) const
+    {
+        return m_keys[a] > m_keys[b];
+    }
+private:
+    const std::vector<double>& m_keys;
+};
+
+/**
+ * Put members in descending order of their scores. Sorts indices by a
+ * contiguous key array rather than chasing member pointers in every
+ * comparison.
+ * @param[in,out] members the population, reordered in place
+ * @param[in] keys keys[i] is the score of members[i]
+ * @param[out] order scratch for the sorted indices
+ * @param[out] unranked scratch for the members before sorting
+ */
+template <class Member>
+void rankMembers(std::vector<Member*>& members,
+                 const std::vector<double>& keys,
+                 std::vector<std::size_t>& order,
+                 std::vector<Member*>& unranked)
+{
+    const std::size_t n = members.size();
+    order.resize(n);
+    unranked.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        order[i] = i;
+        unranked[i] = members[i];
+    }
+    std::sort(order.begin(), order.end(), EvoRankComparison(keys));
+    for (std::size_t i = 0; i < n; i++)
+    {
+        members[i] = unranked[order[i]];
+    }
+}
+
+#endif /* EVORANKING_H_ */
@@ -25,7 +25,8 @@
  */
 
 #include "NeuroEvoMember.h"
-#include "neuralNet/Neural Network v2/neuralNetwork.h"
+#include "NeuroNetwork.h"
+#include "learning/Checkpoint/EvoCheckpoint.h"
 #include <fstream>
 #include <iostream>
 #include <assert.h>
@@ -33,7 +34,8 @@
 
 using namespace std;
 
-NeuroEvoMember::NeuroEvoMember(configuration config)
+NeuroEvoMember::NeuroEvoMember(configuration config) :
+nn(NULL)
 {
 	this->numInputs=config.getintvalue("numberOfStates");
     this->numOutputs=config.getintvalue("numberOfActions");
@@ -41,7 +43,7 @@ NeuroEvoMember::NeuroEvoMember(configuration config)
     assert(numOutputs > 0);
 	cout<<"creating NN"<<endl;
 	if(numInputs>0)
-		nn = new neuralNetwork(numInputs, numHidden,numOutputs);
+		nn = new NeuroNetwork(numInputs, numHidden,numOutputs);
 	else
 	{
 		statelessParameters.resize(numOutputs);
@@ -94,7 +96,7 @@ void NeuroEvoMember::copyFrom(NeuroEvoMember* otherMember)
 {
 	if(numInputs>0)
 	{
-		this->nn->copyWeightFrom(otherMember->getNn());
+		this->nn->copyWeightFrom(*otherMember->getNn());
 		this->maxScore=-10000;
 		this->pastScores.clear();
 	}
@@ -108,7 +110,7 @@ void NeuroEvoMember::copyFrom(NeuroEvoMember *otherMember1, NeuroEvoMember *othe
 {
     if(numInputs>0)
     {
-        this->nn->combineWeights(otherMember1->getNn(), otherMember2->getNn(), eng);
+        this->nn->combineWeights(*otherMember1->getNn(), *otherMember2->getNn(), eng);
         this->maxScore=-10000;
         this->pastScores.clear();
     }
@@ -188,3 +190,29 @@ void NeuroEvoMember::loadFromFile(const char * outputFilename)
 	}
 
 }
+
+void NeuroEvoMember::saveState(EvoCheckpointWriter& checkpoint) const
+{
+	if(numInputs > 0)
+		checkpoint.writeDoubles(nn->getWeights(), nn->getNumWeights());
+	else
+		checkpoint.writeDoubles(statelessParameters);
+	checkpoint.writeDouble(maxScore);
+	checkpoint.writeDouble(maxScore1);
+	checkpoint.writeDouble(maxScore2);
+	checkpoint.writeDouble(averageScore);
+	checkpoint.writeDoubles(pastScores);
+}
+
+void NeuroEvoMember::loadState(EvoCheckpointReader& checkpoint)
+{
+	if(numInputs > 0)
+		checkpoint.readDoubles(nn->getWeights(), nn->getNumWeights());
+	else
+		checkpoint.readDoubles(&statelessParameters[0], statelessParameters.size());
+	maxScore = checkpoint.readDouble();
+	maxScore1 = checkpoint.readDouble();
+	maxScore2 = checkpoint.readDouble();
+	averageScore = checkpoint.readDouble();
+	checkpoint.readDoubles(pastScores);
+}
@@ -33,7 +33,9 @@
 #include "learning/Configuration/configuration.h"
 
 // Forward Declarations
-class neuralNetwork;
+class EvoCheckpointReader;
+class EvoCheckpointWriter;
+class NeuroNetwork;
 
 class NeuroEvoMember
 {
@@ -42,7 +44,7 @@ public:
 	~NeuroEvoMember();
 	void mutate(std::tr1::ranlux64_base_01 *eng);
 
-	neuralNetwork* getNn(){
+	NeuroNetwork* getNn(){
 		return nn;
 	}
 
@@ -51,6 +53,11 @@ public:
 	void saveToFile(const char* outputFilename);
 	void loadFromFile(const char* inputFilename);
 
+    /** Write the weights or parameters and the scores to a checkpoint */
+    void saveState(EvoCheckpointWriter& checkpoint) const;
+    /** Read what saveState wrote; the network shape must match */
+    void loadState(EvoCheckpointReader& checkpoint);
+
 	std::vector<double> statelessParameters;
 	//scores for evaluation
 	std::vector<double> pastScores;
@@ -60,7 +67,7 @@ public:
 	double averageScore;
 
 private:
-	neuralNetwork *nn;
+	NeuroNetwork *nn;
 
 	int numInputs;
 	int numOutputs;
@@ -25,6 +25,8 @@
  */
 
 #include "NeuroEvoPopulation.h"
+#include "learning/Checkpoint/EvoCheckpoint.h"
+#include "learning/EvoRanking.h"
 // The C++ Standard Library
 #include <string>
 #include <vector>
@@ -58,6 +60,10 @@ NeuroEvoPopulation::~NeuroEvoPopulation()
 	{
 		delete controllers[i];
 	}
+	for(std::size_t i=0;i<spares.size();i++)
+	{
+		delete spares[i];
+	}
 }
 
 void NeuroEvoPopulation::mutate(std::tr1::ranlux64_base_01 *engPntr,std::size_t numMutate)
@@ -86,17 +92,19 @@ void NeuroEvoPopulation::combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::
         throw std::invalid_argument("Population will grow in size with these parameters");
     }
     
-    std::vector<double> probabilities = generateMatingProbabilities();
+    generateMatingProbabilities();
     
-    std::vector<NeuroEvoMember*> newControllers;
-    for(int i = 0; i < numToCombine; i++)
+    // Children are built in spares, since their parents may be among the
+    // members they replace
+    std::size_t numChildren = 0;
+    for(std::size_t i = 0; i < numToCombine; i++)
     {
         
         double val1 = unif(*eng);
         double val2 = unif(*eng);
         
-        int index1 = getIndexFromProbability(probabilities, val1);
-        int index2 = getIndexFromProbability(probabilities, val2);
+        int index1 = getIndexFromProbability(matingProbabilities, val1);
+        int index2 = getIndexFromProbability(matingProbabilities, val2);
         
         if(index1 == index2)
         {
@@ -110,77 +118,85 @@ void NeuroEvoPopulation::combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::
             }
         }
         
-        NeuroEvoMember* newController = new NeuroEvoMember(m_config);
+        NeuroEvoMember* newController = takeSpare(numChildren++);
         newController->copyFrom(controllers[index1], controllers[index2], eng);
         
         if(unif(*eng) > 0.9)
         {
             newController->mutate(eng);
         }
-        
-        newControllers.push_back(newController);
     }
     
-    for(int i = 0; i < numToMutate; i++)
+    for(std::size_t i = 0; i < numToMutate; i++)
     {
         double val1 = unif(*eng);
-        int index1 = getIndexFromProbability(probabilities, val1);
-        NeuroEvoMember* newController = new NeuroEvoMember(m_config);
+        int index1 = getIndexFromProbability(matingProbabilities, val1);
+        NeuroEvoMember* newController = takeSpare(numChildren++);
         newController->copyFrom(controllers[index1]);
         newController->mutate(eng);
-        newControllers.push_back(newController);
     }
     
-    
+    // The children replace the last members, which become spares
     const std::size_t n = controllers.size();
-    const std::size_t m = newControllers.size();
-    while(controllers.size() > n - m)
+    for(std::size_t i = 0; i < numChildren; i++)
     {
-        controllers.pop_back();
+        std::swap(controllers[n - numChildren + i], spares[i]);
     }
-    
-    controllers.insert(controllers.end(), newControllers.begin(), newControllers.end());
-    
-    assert(controllers.size() == n);
+}
+
+NeuroEvoMember* NeuroEvoPopulation::takeSpare(std::size_t i)
+{
+    if(i == spares.size())
+    {
+        // Only while the pool grows to its size, in the first generation
+        spares.push_back(new NeuroEvoMember(m_config));
+    }
+    NeuroEvoMember* member = spares[i];
+    member->pastScores.clear();
+    member->maxScore = -1000;
+    return member;
 }
 
 
 void NeuroEvoPopulation::orderPopulation()
 {
+	const std::size_t n = controllers.size();
+	rankKeys.resize(n);
+
 	//calculate each member's average score
-	for(std::size_t i=0;i<this->controllers.size();i++)
+	for(std::size_t i=0;i<n;i++)
 	{
-		double ave = std::accumulate(controllers[i]->pastScores.begin(),controllers[i]->pastScores.end(),0);
+		NeuroEvoMember* member = controllers[i];
+		double ave = std::accumulate(member->pastScores.begin(),member->pastScores.end(),0);
 		
-        double n = (double) controllers[i]->pastScores.size(); 
-        if (n > 0)
+        double count = (double) member->pastScores.size(); 
+        if (count > 0)
         {
-            ave /= n;
+            ave /= count;
         }
         else
         {
             ave = -100000;
         }
         
-        //assert(controllers[i]->pastScores.size() > 0);
+        //assert(member->pastScores.size() > 0);
         
-		controllers[i]->averageScore=ave;
+		member->averageScore=ave;
 		if(clearScoresBetweenGenerations)
-			controllers[i]->pastScores.clear();
+			member->pastScores.clear();
+
+		rankKeys[i] = compareAverageScores ? ave : member->maxScore;
 	}
 //	cout<<"ordering the whole population"<<endl;
-	if(compareAverageScores)
-		sort(controllers.begin(),controllers.end(),this->comparisonFuncForAverage);
-	else
-		sort(controllers.begin(),controllers.end(),this->comparisonFuncForMax);
-    
+	rankMembers(controllers, rankKeys, rankOrder, unranked);
 }
 
-std::vector<double> NeuroEvoPopulation::generateMatingProbabilities()
+void NeuroEvoPopulation::generateMatingProbabilities()
 {
     double totalScore = 0.0;
     const std::size_t n = controllers.size();
-    std::vector<double> probabilties;
+    std::vector<double>& probabilties = matingProbabilities;
+    probabilties.resize(n);
     if (compareAverageScores)
     {
         double floor = controllers[n - 1]->averageScore;
@@ -190,11 +206,10 @@ std::vector<double> NeuroEvoPopulation::generateMatingProbabilities()
             totalScore += (controllers[i]->averageScore - floor);
         }
         
-        probabilties.push_back((controllers[0]->averageScore - floor) / totalScore);
+        probabilties[0] = (controllers[0]->averageScore - floor) / totalScore;
         for (std::size_t i = 1; i < n; i++)
         {
-            double nextScore = (controllers[i]->averageScore - floor) / totalScore + probabilties[i - 1];
-            probabilties.push_back(nextScore);
+            probabilties[i] = (controllers[i]->averageScore - floor) / totalScore + probabilties[i - 1];
         }
     }
     else
@@ -206,18 +221,15 @@ std::vector<double> NeuroEvoPopulation::generateMatingProbabilities()
             totalScore += (controllers[i]->maxScore - floor);
         }
         
-        probabilties.push_back((controllers[0]->maxScore - floor) / totalScore);
+        probabilties[0] = (controllers[0]->maxScore - floor) / totalScore;
         for (std::size_t i = 1; i < n; i++)
         {
-            double nextScore = (controllers[i]->maxScore - floor) / totalScore + probabilties[i - 1];
-            probabilties.push_back(nextScore);
+            probabilties[i] = (controllers[i]->maxScore - floor) / totalScore + probabilties[i - 1];
         }
     }
-    
-    return probabilties;
 }
 
-int NeuroEvoPopulation::getIndexFromProbability(std::vector<double>& probs, double val)
+int NeuroEvoPopulation::getIndexFromProbability(const std::vector<double>& probs, double val)
 {
     int i = 0;
     
@@ -229,11 +241,24 @@ int NeuroEvoPopulation::getIndexFromProbability(std::vector<double>& probs, doub
     return i;
 }
 
-bool NeuroEvoPopulation::comparisonFuncForAverage(NeuroEvoMember * elm1, NeuroEvoMember * elm2)
+void NeuroEvoPopulation::saveState(EvoCheckpointWriter& checkpoint) const
 {
-    return elm1->averageScore > elm2->averageScore;
+    checkpoint.writeInt(controllers.size());
+    for(std::size_t i=0;i<controllers.size();i++)
+    {
+        controllers[i]->saveState(checkpoint);
+    }
 }
-bool NeuroEvoPopulation::comparisonFuncForMax(NeuroEvoMember * elm1, NeuroEvoMember * elm2)
+
+void NeuroEvoPopulation::loadState(EvoCheckpointReader& checkpoint)
 {
-    return elm1->maxScore > elm2->maxScore;
+    if(checkpoint.readInt() != static_cast<long long>(controllers.size()))
+    {
+        throw std::runtime_error("Checkpoint population size does not match the configuration");
+    }
+    // Members keep their storage; only the values move
+    for(std::size_t i=0;i<controllers.size();i++)
+    {
+        controllers[i]->loadState(checkpoint);
+    }
 }
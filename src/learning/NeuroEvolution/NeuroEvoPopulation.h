@@ -31,6 +31,12 @@
 #include <vector>
 #include <tr1/random>
 
+/**
+ * Members are recycled between generations: children are built in a
+ * pool of spare members and swapped in for the ones they replace, and
+ * ranking and mating use buffers sized once, so a generation allocates
+ * nothing after the first.
+ */
 class NeuroEvoPopulation {
 public:
 	NeuroEvoPopulation(int numControllers, configuration& config);
@@ -41,15 +47,33 @@ public:
 	void orderPopulation();
 	NeuroEvoMember * getMember(int i){return controllers[i];};
 
+    /** Write every member, in rank order */
+    void saveState(EvoCheckpointWriter& checkpoint) const;
+    /**
+     * Read what saveState wrote, restoring the rank order
+     * @throws std::runtime_error if the population size differs
+     */
+    void loadState(EvoCheckpointReader& checkpoint);
+
 private:
-    std::vector<double> generateMatingProbabilities();
-    int getIndexFromProbability(std::vector<double>& probs, double val);
-	static bool comparisonFuncForAverage(NeuroEvoMember * elm1, NeuroEvoMember * elm2);
-	static bool comparisonFuncForMax(NeuroEvoMember * elm1, NeuroEvoMember * elm2);
+    /** Fill matingProbabilities with the cumulative mating distribution */
+    void generateMatingProbabilities();
+    int getIndexFromProbability(const std::vector<double>& probs, double val);
+    /** A spare member with no scores, ready to be overwritten */
+    NeuroEvoMember* takeSpare(std::size_t i);
+
 	bool compareAverageScores;
 	bool clearScoresBetweenGenerations;
 	int populationSize;
     configuration m_config;
+
+    /** Members replaced in the last generation, reused for children */
+    std::vector<NeuroEvoMember*> spares;
+    std::vector<double> matingProbabilities;
+    /** Ranking scratch: scores, sorted indices, members before sorting */
+    std::vector<double> rankKeys;
+    std::vector<std::size_t> rankOrder;
+    std::vector<NeuroEvoMember*> unranked;
 };
 
 
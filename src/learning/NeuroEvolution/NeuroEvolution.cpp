@@ -28,6 +28,7 @@
 #include "learning/Configuration/configuration.h"
 #include "core/tgString.h"
 #include "helpers/FileHelpers.h"
+#include "learning/Checkpoint/EvoCheckpoint.h"
 // The C++ Standard Library
 #include <iostream>
 #include <numeric>
@@ -57,6 +58,7 @@ NeuroEvolution::NeuroEvolution(std::string suff, std::string config, std::string
 suffix(suff)
 {
 	currentTest=0;
+	subTests=0;
 	generationNumber=0;
 	if (path != "")
 	{
@@ -82,6 +84,19 @@ suffix(suff)
     seeded = myconfigdataaa.getintvalue("startSeed");
     
     bool learning = myconfigdataaa.getintvalue("learning");
+
+    // Optional: periodic checkpoints, and resuming from the last one
+    checkpointInterval = 0;
+    bool resume = false;
+    if (learning && myconfigdataaa.iskey("checkpointInterval"))
+    {
+        checkpointInterval = myconfigdataaa.getintvalue("checkpointInterval");
+    }
+    if (learning && myconfigdataaa.iskey("resumeFromCheckpoint"))
+    {
+        resume = myconfigdataaa.getintvalue("resumeFromCheckpoint");
+    }
+    checkpointFile = resourcePath + "logs/checkpoint-" + suffix + ".bin";
     
     if (populationSize < numberOfElementsToMutate + numberOfChildren)
     {
@@ -108,9 +123,16 @@ suffix(suff)
             seededPop->loadFromFile(ss.str().c_str());
         }
     }
+    // Resuming replaces the random or seeded populations. Without a
+    // checkpoint yet, this is the start of the run
+    const bool resumed = resume && EvoCheckpointReader::exists(checkpointFile);
+    if(resumed)
+    {
+        loadCheckpoint(checkpointFile);
+    }
     if(learning)
     {
-		evolutionLog.open((resourcePath + "logs/evolution"+suffix+".csv").c_str(),ios::out);
+		evolutionLog.open((resourcePath + "logs/evolution"+suffix+".csv").c_str(),resumed ? ios::app : ios::out);
 		if (!evolutionLog.is_open())
 		{
 			throw std::runtime_error("Logs does not exist. Please create a logs folder in your build directory or update your cmake file");
@@ -217,6 +239,13 @@ vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
 			currentTest=0;//Start from 0
 		else
 			currentTest=populationSize - numberOfElementsToMutate - numberOfChildren; //start from the mutated ones only (last x)
+
+		// Between generations nothing is in flight, so a resumed run
+		// continues exactly from here
+		if(checkpointInterval > 0 && generationNumber % checkpointInterval == 0)
+		{
+			saveCheckpoint(checkpointFile);
+		}
 	}
 
 	selectedControllers.clear();
@@ -224,7 +253,7 @@ vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
 	{
 		int selectedOne=0;
 		if(coevolution)
-			selectedOne=rand()%populationSize; //select random one from each pool
+			selectedOne=std::tr1::uniform_int<int>(0, populationSize - 1)(eng); //select random one from each pool
 		else
 			selectedOne=currentTest; //select the same from each pool
 
@@ -276,3 +305,26 @@ void NeuroEvolution::updateScores(vector <double> multiscore)
 	payloadLog.close();
 	return;
 }
+
+void NeuroEvolution::saveCheckpoint(const std::string& filename)
+{
+    EvoCheckpointWriter checkpoint(filename, "NeuroEvolution");
+    runState().save(checkpoint);
+    savePopulations(checkpoint, populations);
+    checkpoint.commit();
+}
+
+void NeuroEvolution::loadCheckpoint(const std::string& filename)
+{
+    EvoCheckpointReader checkpoint(filename, "NeuroEvolution");
+    runState().load(checkpoint);
+    loadPopulations(checkpoint, populations);
+    selectedControllers.clear();
+}
+
+EvoRunState NeuroEvolution::runState()
+{
+    return EvoRunState(numberOfControllers, populationSize, currentTest,
+                       subTests, generationNumber, eng,
+                       scoresOfTheGeneration);
+}
@@ -32,6 +32,9 @@
 #include "NeuroEvoMember.h"
 #include <fstream>
 
+// Forward declarations
+class EvoRunState;
+
 class NeuroEvolution
 {
 public:
@@ -43,10 +46,30 @@ public:
 	void evaluatePopulation();
 	std::vector< NeuroEvoMember *> nextSetOfControllers();
 	void updateScores(std::vector<double> scores);
+
+    /**
+     * Write the whole optimizer state (populations, scores, counters and
+     * random engine) so loadCheckpoint can continue the run exactly.
+     * Written atomically: an interrupted save keeps the old checkpoint.
+     * The random engine is reseeded from its own output, since the tr1
+     * engine can't be written out with its position.
+     */
+    void saveCheckpoint(const std::string& filename);
+
+    /**
+     * Replace the optimizer state with a checkpoint. Call before the
+     * first nextSetOfControllers.
+     * @throws std::runtime_error if the file is unreadable or was written
+     * with a different population size or controller shape
+     */
+    void loadCheckpoint(const std::string& filename);
     const std::string suffix;
     /// @todo make this const if we decide to force everyone to put their logs in resources
     std::string resourcePath;
 private:
+    /** The members saveCheckpoint shares with AnnealEvolution */
+    EvoRunState runState();
+
 	int populationSize;
 	int numberOfControllers;
 	std::tr1::ranlux64_base_01 eng;
@@ -66,6 +89,10 @@ private:
     int numberOfChildren;
     int numberOfSubtests;
     int subTests;
+
+    /** Generations between checkpoints, 0 for none */
+    int checkpointInterval;
+    std::string checkpointFile;
 };
 
 #endif /* NEUROEVOLUTION_H_ */
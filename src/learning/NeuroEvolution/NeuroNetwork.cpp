@@ -0,0 +1,278 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file NeuroNetwork.cpp
+ * @brief A feed forward neural network with contiguous weight storage
+ * $Id$
+ */
+
+#include "NeuroNetwork.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    /** Value of the bias neurons, as in neuralNetwork */
+    const double biasValue = -1.0;
+
+    inline double activationFunction(double x)
+    {
+        return 1.0 / (1.0 + std::exp(-x));
+    }
+
+    /** Random weight in [-range, range], as neuralNetwork::initializeWeights */
+    inline double randomWeight(double range)
+    {
+        return (((double)(rand() % 100) + 1) / 100 * 2 * range) - range;
+    }
+}
+
+NeuroNetwork::NeuroNetwork(int nInput, int nHidden, int nOutput) :
+    m_nInput(nInput),
+    m_nHidden(nHidden),
+    m_nOutput(nOutput)
+{
+    if (nInput <= 0 || nHidden <= 0 || nOutput <= 0)
+    {
+        throw std::invalid_argument("Network layer sizes must be positive");
+    }
+
+    m_weights.resize(hiddenOutputOffset() +
+                     static_cast<std::size_t>(nHidden + 1) * nOutput);
+
+    m_inputNeurons.assign(nInput + 1, 0.0);
+    m_inputNeurons[nInput] = biasValue;
+    m_hiddenNeurons.assign(nHidden + 1, 0.0);
+    m_hiddenNeurons[nHidden] = biasValue;
+    m_outputNeurons.assign(nOutput, 0.0);
+
+    // Same ranges and draw order as neuralNetwork::initializeWeights
+    const double rH = 1.0 / std::sqrt((double) nInput);
+    const double rO = 1.0 / std::sqrt((double) nHidden);
+    const std::size_t offset = hiddenOutputOffset();
+    for (std::size_t i = 0; i < offset; i++)
+    {
+        m_weights[i] = randomWeight(rH);
+    }
+    for (std::size_t i = offset; i < m_weights.size(); i++)
+    {
+        m_weights[i] = randomWeight(rO);
+    }
+}
+
+void NeuroNetwork::evaluateLayer(const double* in, int nIn,
+                                 const double* w, int nOut, double* out)
+{
+    for (int k = 0; k < nOut; k++)
+    {
+        out[k] = 0.0;
+    }
+    // Accumulate one input (row of w) at a time over every output, which
+    // keeps the per output sums in the same order as neuralNetwork
+    for (int i = 0; i <= nIn; i++)
+    {
+        const double x = in[i];
+        const double* const row = w + static_cast<std::size_t>(i) * nOut;
+        for (int k = 0; k < nOut; k++)
+        {
+            out[k] += x * row[k];
+        }
+    }
+    for (int k = 0; k < nOut; k++)
+    {
+        out[k] = activationFunction(out[k]);
+    }
+}
+
+void NeuroNetwork::feedForward(const double* pattern, double* output)
+{
+    std::copy(pattern, pattern + m_nInput, m_inputNeurons.begin());
+
+    evaluateLayer(&m_inputNeurons[0], m_nInput,
+                  &m_weights[0], m_nHidden,
+                  &m_hiddenNeurons[0]);
+    evaluateLayer(&m_hiddenNeurons[0], m_nHidden,
+                  &m_weights[hiddenOutputOffset()], m_nOutput,
+                  output);
+}
+
+const double* NeuroNetwork::feedForwardPattern(const double* pattern)
+{
+    feedForward(pattern, &m_outputNeurons[0]);
+    return &m_outputNeurons[0];
+}
+
+void NeuroNetwork::feedForwardBatch(const double* patterns, std::size_t count,
+                                    double* outputs)
+{
+    for (std::size_t n = 0; n < count; n++)
+    {
+        feedForward(patterns + n * m_nInput, outputs + n * m_nOutput);
+    }
+}
+
+void NeuroNetwork::feedForwardMembers(const std::vector<NeuroNetwork*>& networks,
+                                      const double* pattern,
+                                      double* outputs)
+{
+    double* out = outputs;
+    for (std::size_t n = 0; n < networks.size(); n++)
+    {
+        NeuroNetwork* const nn = networks[n];
+        assert(nn != NULL && nn->sameShape(*networks[0]));
+        nn->feedForward(pattern, out);
+        out += nn->m_nOutput;
+    }
+}
+
+void NeuroNetwork::copyWeightFrom(const NeuroNetwork& nn)
+{
+    if (!sameShape(nn))
+    {
+        throw std::invalid_argument("Networks have different shapes");
+    }
+    std::copy(nn.m_weights.begin(), nn.m_weights.end(), m_weights.begin());
+}
+
+void NeuroNetwork::combineWeights(const NeuroNetwork& nn1,
+                                  const NeuroNetwork& nn2,
+                                  std::tr1::ranlux64_base_01* eng)
+{
+    if (!sameShape(nn1) || !sameShape(nn2))
+    {
+        throw std::invalid_argument("Networks have different shapes");
+    }
+    std::tr1::uniform_real<double> unif(0, 1);
+    const double* const w1 = &nn1.m_weights[0];
+    const double* const w2 = &nn2.m_weights[0];
+    double* const w = &m_weights[0];
+    const std::size_t n = m_weights.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        w[i] = (unif(*eng) > 0.5) ? w1[i] : w2[i];
+    }
+}
+
+void NeuroNetwork::mutate(std::tr1::ranlux64_base_01* eng)
+{
+    std::tr1::uniform_real<double> unif(0, 1);
+    const double range = 10.0; //range of the variable
+    const double dev = 10.0 * range / 100.0;  //10% of the range
+    const std::size_t offset = hiddenOutputOffset();
+    double* const w = &m_weights[0];
+    const std::size_t n = m_weights.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (unif(*eng) > 0.5)
+        {
+            continue;
+        }
+        // A fresh distribution per draw keeps the random sequence of the
+        // patched neuralNetwork
+        std::tr1::normal_distribution<double> normal(0, dev);
+        const double mutAmount = normal(*eng);
+        if (i < offset)
+        {
+            w[i] += mutAmount;
+        }
+        else
+        {
+            w[i] = mutAmount;
+        }
+    }
+}
+
+bool NeuroNetwork::loadWeights(const char* inputFilename)
+{
+    std::ifstream inputFile(inputFilename);
+    if (!inputFile.is_open())
+    {
+        std::cout << std::endl << "Error - Weight input file '"
+                  << inputFilename << "' could not be opened: " << std::endl;
+        return false;
+    }
+
+    std::vector<double> weights;
+    weights.reserve(m_weights.size());
+    std::string line;
+    while (std::getline(inputFile, line))
+    {
+        if (line.length() <= 2)
+        {
+            continue;
+        }
+        std::istringstream ss(line);
+        std::string value;
+        while (std::getline(ss, value, ','))
+        {
+            weights.push_back(atof(value.c_str()));
+        }
+    }
+
+    if (weights.size() != m_weights.size())
+    {
+        std::cout << std::endl << "Error - Incorrect number of weights in input file: "
+                  << inputFilename << std::endl;
+        return false;
+    }
+
+    std::copy(weights.begin(), weights.end(), m_weights.begin());
+    return true;
+}
+
+bool NeuroNetwork::saveWeights(const char* outputFilename) const
+{
+    std::ofstream outputFile(outputFilename);
+    if (!outputFile.is_open())
+    {
+        std::cout << std::endl << "Error - Weight output file '"
+                  << outputFilename << "' could not be created: " << std::endl;
+        return false;
+    }
+
+    // Enough digits that loading gives back the same network
+    outputFile.precision(std::numeric_limits<double>::digits10 + 2);
+    const std::size_t n = m_weights.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        outputFile << m_weights[i];
+        if (i + 1 != n)
+        {
+            outputFile << ",";
+        }
+    }
+    return true;
+}
+
+bool NeuroNetwork::sameShape(const NeuroNetwork& other) const
+{
+    return (m_nInput == other.m_nInput) &&
+           (m_nHidden == other.m_nHidden) &&
+           (m_nOutput == other.m_nOutput);
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef NEURONETWORK_H_
+#define NEURONETWORK_H_
+
+/**
+ * @file NeuroNetwork.h
+ * @brief A feed forward neural network with contiguous weight storage
+ * $Id$
+ */
+
+#include <cstddef>
+#include <vector>
+#include <tr1/random>
+
+/**
+ * A single hidden layer feed forward network with sigmoid activations
+ * and bias neurons, numerically equivalent to the neuralNetwork class
+ * installed by bin/setup/setup_neuralnet.sh, and reading and writing the
+ * same weight files.
+ *
+ * All weights live in one contiguous buffer: first the (nInput + 1) x
+ * nHidden input to hidden matrix, then the (nHidden + 1) x nOutput
+ * hidden to output matrix, both row major with the bias weights in the
+ * last row. This is the order of the weight files. Each layer is
+ * evaluated as a sequence of row updates of the whole next layer, which
+ * the compiler vectorizes without changing the order of the sums.
+ *
+ * Copying, mutation and crossover work on the buffer in place and never
+ * reallocate.
+ */
+class NeuroNetwork
+{
+public:
+    /**
+     * Create a network with random weights drawn with rand(), as the
+     * neuralNetwork constructor does.
+     * @param[in] nInput the number of inputs; must be positive
+     * @param[in] nHidden the number of hidden neurons; must be positive
+     * @param[in] nOutput the number of outputs; must be positive
+     */
+    NeuroNetwork(int nInput, int nHidden, int nOutput);
+
+    int getNumInputs() const
+    {
+        return m_nInput;
+    }
+
+    int getNumHidden() const
+    {
+        return m_nHidden;
+    }
+
+    int getNumOutputs() const
+    {
+        return m_nOutput;
+    }
+
+    /** The length of the weight buffer */
+    std::size_t getNumWeights() const
+    {
+        return m_weights.size();
+    }
+
+    /** The weight buffer, in weight file order */
+    double* getWeights()
+    {
+        return &m_weights[0];
+    }
+
+    const double* getWeights() const
+    {
+        return &m_weights[0];
+    }
+
+    /**
+     * Evaluate one pattern.
+     * @param[in] pattern getNumInputs() values
+     * @param[out] output getNumOutputs() values
+     */
+    void feedForward(const double* pattern, double* output);
+
+    /**
+     * Evaluate one pattern into an internal buffer, which is valid until
+     * the next call. Matches neuralNetwork::feedForwardPattern.
+     */
+    const double* feedForwardPattern(const double* pattern);
+
+    /**
+     * Evaluate many patterns, for example successive timesteps.
+     * @param[in] patterns count rows of getNumInputs() values
+     * @param[in] count the number of patterns
+     * @param[out] outputs count rows of getNumOutputs() values
+     */
+    void feedForwardBatch(const double* patterns, std::size_t count,
+                          double* outputs);
+
+    /**
+     * Evaluate one pattern with many networks of the same shape, for
+     * example every controller of a trial.
+     * @param[in] networks the networks; all must have the same shape
+     * @param[in] pattern the shared input
+     * @param[out] outputs one row of getNumOutputs() values per network
+     */
+    static void feedForwardMembers(const std::vector<NeuroNetwork*>& networks,
+                                   const double* pattern,
+                                   double* outputs);
+
+    /**
+     * Overwrite the weights with those of nn, which must have the same
+     * shape.
+     */
+    void copyWeightFrom(const NeuroNetwork& nn);
+
+    /**
+     * Uniform crossover: each weight comes from nn1 or nn2 with equal
+     * probability. Both must have the same shape as this network.
+     */
+    void combineWeights(const NeuroNetwork& nn1, const NeuroNetwork& nn2,
+                        std::tr1::ranlux64_base_01* eng);
+
+    /**
+     * Mutate each weight with probability one half. Like the patched
+     * neuralNetwork, input to hidden weights are perturbed and hidden to
+     * output weights are replaced by the perturbation, so evolved
+     * parameters stay comparable.
+     */
+    void mutate(std::tr1::ranlux64_base_01* eng);
+
+    /**
+     * Load comma separated weights in file order.
+     * @return false if the file can't be read or has the wrong number
+     * of weights
+     */
+    bool loadWeights(const char* inputFilename);
+
+    /**
+     * Save comma separated weights in file order.
+     * @return false if the file can't be written
+     */
+    bool saveWeights(const char* outputFilename) const;
+
+private:
+
+    /** Start of the hidden to output matrix in m_weights */
+    std::size_t hiddenOutputOffset() const
+    {
+        return static_cast<std::size_t>(m_nInput + 1) * m_nHidden;
+    }
+
+    /**
+     * out[0, nOut) = sigmoid(in[0, nIn] * w), where in[nIn] is the bias
+     * neuron and w is (nIn + 1) x nOut row major.
+     */
+    static void evaluateLayer(const double* in, int nIn,
+                              const double* w, int nOut, double* out);
+
+    bool sameShape(const NeuroNetwork& other) const;
+
+    int m_nInput;
+    int m_nHidden;
+    int m_nOutput;
+
+    std::vector<double> m_weights;
+
+    /** Layer buffers, each with a trailing bias neuron */
+    std::vector<double> m_inputNeurons;
+    std::vector<double> m_hiddenNeurons;
+    std::vector<double> m_outputNeurons;
+};
+
+#endif /* NEURONETWORK_H_ */
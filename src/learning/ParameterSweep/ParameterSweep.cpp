@@ -0,0 +1,467 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file ParameterSweep.cpp
+ * @brief Contains the definitions of members of class ParameterSweep
+ * $Id$
+ */
+
+// This module
+#include "ParameterSweep.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgModel.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+// The C++ Standard Library
+#include <cassert>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <tr1/random>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+    /** The sweepable fields, in the order of parameterNames */
+    enum Field
+    {
+        rodRadius,
+        rodDensity,
+        rodFriction,
+        rodRollFriction,
+        rodRestitution,
+        actuatorStiffness,
+        actuatorDamping,
+        actuatorPretension,
+        actuatorMaxTension,
+        actuatorTargetVelocity,
+        actuatorMinActualLength,
+        actuatorMinRestLength,
+        worldGravity,
+        worldSize,
+        fieldCount
+    };
+
+    const char* const parameterNames[fieldCount] =
+    {
+        "rod.radius",
+        "rod.density",
+        "rod.friction",
+        "rod.rollFriction",
+        "rod.restitution",
+        "actuator.stiffness",
+        "actuator.damping",
+        "actuator.pretension",
+        "actuator.maxTens",
+        "actuator.targetVelocity",
+        "actuator.minActualLength",
+        "actuator.minRestLength",
+        "world.gravity",
+        "world.worldSize"
+    };
+
+    int threadCount(int requested)
+    {
+#ifdef _OPENMP
+        return requested > 0 ? requested : omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    /** Uniform on [0, 1) */
+    double uniform(std::tr1::ranlux64_base_01& eng)
+    {
+        return std::tr1::uniform_real<double>(0.0, 1.0)(eng);
+    }
+
+    /** Write a CSV field, quoted if it needs to be */
+    void writeField(std::ostream& os, const std::string& field)
+    {
+        if (field.find_first_of(",\"\n") == std::string::npos)
+        {
+            os << field;
+            return;
+        }
+        os << '"';
+        for (std::size_t i = 0; i < field.size(); i++)
+        {
+            if (field[i] == '"')
+            {
+                os << '"';
+            }
+            os << field[i];
+        }
+        os << '"';
+    }
+}
+
+ParameterSweep::Range::Range(const std::string& name,
+                             double min,
+                             double max,
+                             std::size_t levels) :
+    name(name),
+    min(min),
+    max(max),
+    levels(levels)
+{
+}
+
+ParameterSweep::Sample::Sample(std::size_t index,
+                               const std::vector<double>& values,
+                               const tgRod::Config& rod,
+                               const tgBasicActuator::Config& actuator,
+                               const tgWorld::Config& world) :
+    index(index),
+    values(values),
+    rod(rod),
+    actuator(actuator),
+    world(world)
+{
+}
+
+ParameterSweep::Config::Config(const tgRod::Config& rod,
+                               const tgBasicActuator::Config& actuator,
+                               const tgWorld::Config& world,
+                               Sampling sampling,
+                               std::size_t numSamples,
+                               int steps,
+                               double stepSize,
+                               int numThreads,
+                               unsigned long seed) :
+    rod(rod),
+    actuator(actuator),
+    world(world),
+    sampling(sampling),
+    numSamples(numSamples),
+    steps(steps),
+    stepSize(stepSize),
+    numThreads(numThreads),
+    seed(seed)
+{
+}
+
+ParameterSweep::ParameterSweep(const Config& config) :
+    m_config(config)
+{
+    if (config.steps <= 0)
+    {
+        throw std::invalid_argument("steps is not positive");
+    }
+    else if (config.stepSize <= 0.0)
+    {
+        throw std::invalid_argument("stepSize is not positive");
+    }
+    else if (config.numThreads < 0)
+    {
+        throw std::invalid_argument("numThreads is negative");
+    }
+    else if (config.sampling != grid && config.numSamples == 0)
+    {
+        throw std::invalid_argument("No samples");
+    }
+#ifndef BT_NO_PROFILE
+    if (threadCount(config.numThreads) > 1)
+    {
+        throw std::invalid_argument("Running on more than one thread needs "
+                                    "Bullet built with BT_NO_PROFILE: re-run "
+                                    "setup.sh and rebuild");
+    }
+#endif
+}
+
+void ParameterSweep::addRange(const Range& range)
+{
+    int field = 0;
+    while (field < fieldCount && range.name != parameterNames[field])
+    {
+        field++;
+    }
+    if (field == fieldCount)
+    {
+        throw std::invalid_argument("Unknown parameter " + range.name);
+    }
+    for (std::size_t i = 0; i < m_fields.size(); i++)
+    {
+        if (m_fields[i] == field)
+        {
+            throw std::invalid_argument(range.name + " is already swept");
+        }
+    }
+    if (!(range.min <= range.max) || range.levels == 0)
+    {
+        throw std::invalid_argument("The range of " + range.name + " is empty");
+    }
+    m_ranges.push_back(range);
+    m_fields.push_back(field);
+}
+
+std::vector<std::vector<double> > ParameterSweep::samples() const
+{
+    const std::size_t dims = m_ranges.size();
+    std::vector<std::vector<double> > result;
+    if (dims == 0)
+    {
+        return result;
+    }
+
+    if (m_config.sampling == grid)
+    {
+        std::size_t count = 1;
+        for (std::size_t d = 0; d < dims; d++)
+        {
+            count *= m_ranges[d].levels;
+        }
+        result.resize(count, std::vector<double>(dims));
+        for (std::size_t s = 0; s < count; s++)
+        {
+            // The last range varies fastest
+            std::size_t rest = s;
+            for (std::size_t d = dims; d-- > 0; )
+            {
+                const Range& r = m_ranges[d];
+                const std::size_t level = rest % r.levels;
+                rest /= r.levels;
+                result[s][d] = r.levels == 1 ? r.min :
+                    r.min + (r.max - r.min) * level / (r.levels - 1);
+            }
+        }
+        return result;
+    }
+
+    const std::size_t n = m_config.numSamples;
+    result.resize(n, std::vector<double>(dims));
+    std::tr1::ranlux64_base_01 eng(m_config.seed);
+
+    if (m_config.sampling == latinHypercube)
+    {
+        std::vector<std::size_t> strata(n);
+        for (std::size_t d = 0; d < dims; d++)
+        {
+            // Fisher-Yates, so the order doesn't depend on the library
+            for (std::size_t s = 0; s < n; s++)
+            {
+                strata[s] = s;
+            }
+            for (std::size_t s = n - 1; s > 0; s--)
+            {
+                const std::size_t j =
+                    std::tr1::uniform_int<std::size_t>(0, s)(eng);
+                std::swap(strata[s], strata[j]);
+            }
+            const Range& r = m_ranges[d];
+            for (std::size_t s = 0; s < n; s++)
+            {
+                result[s][d] = r.min +
+                    (r.max - r.min) * (strata[s] + uniform(eng)) / n;
+            }
+        }
+    }
+    else
+    {
+        for (std::size_t s = 0; s < n; s++)
+        {
+            for (std::size_t d = 0; d < dims; d++)
+            {
+                const Range& r = m_ranges[d];
+                result[s][d] = r.min + (r.max - r.min) * uniform(eng);
+            }
+        }
+    }
+    return result;
+}
+
+const std::vector<ParameterSweep::Result>& ParameterSweep::run(Factory& factory)
+{
+    if (m_ranges.empty())
+    {
+        throw std::invalid_argument("No ranges to sweep");
+    }
+    m_metricNames = factory.getMetricNames();
+    if (m_metricNames.empty())
+    {
+        throw std::invalid_argument("The factory has no metrics");
+    }
+
+    const std::vector<std::vector<double> > all = samples();
+    m_results.assign(all.size(), Result());
+
+    const long n = static_cast<long>(all.size());
+    const int threads = threadCount(m_config.numThreads);
+    // Runs differ a lot in cost (a failing sample stops at once), so
+    // hand them out one at a time
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+    for (long i = 0; i < n; i++)
+    {
+        runOne(factory, i, all[i]);
+    }
+    return m_results;
+}
+
+ParameterSweep::Sample
+ParameterSweep::makeSample(std::size_t i,
+                           const std::vector<double>& values) const
+{
+    const tgRod::Config& rod = m_config.rod;
+    const tgBasicActuator::Config& actuator = m_config.actuator;
+    const tgWorld::Config& world = m_config.world;
+
+    double p[fieldCount] =
+    {
+        rod.radius,
+        rod.density,
+        rod.friction,
+        rod.rollFriction,
+        rod.restitution,
+        actuator.stiffness,
+        actuator.damping,
+        actuator.pretension,
+        actuator.maxTens,
+        actuator.targetVelocity,
+        actuator.minActualLength,
+        actuator.minRestLength,
+        world.gravity,
+        world.worldSize
+    };
+    for (std::size_t d = 0; d < m_fields.size(); d++)
+    {
+        p[m_fields[d]] = values[d];
+    }
+
+    // The constructors check the values
+    return Sample(i, values,
+                  tgRod::Config(p[rodRadius],
+                                p[rodDensity],
+                                p[rodFriction],
+                                p[rodRollFriction],
+                                p[rodRestitution]),
+                  tgBasicActuator::Config(p[actuatorStiffness],
+                                          p[actuatorDamping],
+                                          p[actuatorPretension],
+                                          actuator.hist,
+                                          p[actuatorMaxTension],
+                                          p[actuatorTargetVelocity],
+                                          p[actuatorMinActualLength],
+                                          p[actuatorMinRestLength],
+                                          actuator.rotation,
+                                          actuator.moveCablePointAToEdge,
+                                          actuator.moveCablePointBToEdge),
+                  tgWorld::Config(p[worldGravity], p[worldSize]));
+}
+
+void ParameterSweep::runOne(Factory& factory, std::size_t i,
+                            const std::vector<double>& values)
+{
+    Result& result = m_results[i];
+    result.values = values;
+    result.metrics.assign(m_metricNames.size(),
+                          std::numeric_limits<double>::quiet_NaN());
+
+    Trial* pTrial = NULL;
+    try
+    {
+        const Sample sample = makeSample(i, values);
+        pTrial = factory.create(sample);
+        if (pTrial == NULL)
+        {
+            throw std::invalid_argument("Factory returned a NULL trial");
+        }
+
+        // The world deletes the ground, the simulation the model; all of
+        // it is gone before the trial that may own the controller
+        tgGround* const pGround = pTrial->createGround();
+        tgWorld world(sample.world, pGround ? pGround : new tgBoxGround());
+        tgSimView view(world, m_config.stepSize);
+        tgSimulation simulation(view);
+
+        tgModel* const pModel = pTrial->createModel();
+        if (pModel == NULL)
+        {
+            throw std::invalid_argument("Trial returned a NULL model");
+        }
+        simulation.addModel(pModel);
+
+        for (int step = 0; step < m_config.steps; step++)
+        {
+            simulation.step(m_config.stepSize);
+        }
+
+        std::vector<double> metrics(m_metricNames.size());
+        pTrial->measure(*pModel, &metrics[0]);
+        result.metrics = metrics;
+    }
+    catch (const std::exception& e)
+    {
+        result.error = e.what();
+    }
+    catch (...)
+    {
+        result.error = "Unknown exception";
+    }
+    delete pTrial;
+}
+
+void ParameterSweep::writeTable(std::ostream& os) const
+{
+    const std::streamsize precision = os.precision(17);
+
+    os << "index";
+    for (std::size_t d = 0; d < m_ranges.size(); d++)
+    {
+        os << ',' << m_ranges[d].name;
+    }
+    for (std::size_t m = 0; m < m_metricNames.size(); m++)
+    {
+        os << ',';
+        writeField(os, m_metricNames[m]);
+    }
+    os << ",error\n";
+
+    for (std::size_t i = 0; i < m_results.size(); i++)
+    {
+        const Result& result = m_results[i];
+        os << i;
+        for (std::size_t d = 0; d < result.values.size(); d++)
+        {
+            os << ',' << result.values[d];
+        }
+        for (std::size_t m = 0; m < result.metrics.size(); m++)
+        {
+            os << ',' << result.metrics[m];
+        }
+        os << ',';
+        writeField(os, result.error);
+        os << '\n';
+    }
+
+    os.precision(precision);
+    os.flush();
+}
+
+std::vector<std::string> ParameterSweep::getParameterNames()
+{
+    return std::vector<std::string>(parameterNames, parameterNames + fieldCount);
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef PARAMETERSWEEP_H_
+#define PARAMETERSWEEP_H_
+
+/**
+ * @file ParameterSweep.h
+ * @brief Contains the definition of class ParameterSweep.
+ * Runs a model over ranges of rod, actuator and world parameters
+ * $Id$
+ */
+
+// This library
+#include "core/tgBasicActuator.h"
+#include "core/tgRod.h"
+#include "core/tgWorld.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgGround;
+class tgModel;
+
+/**
+ * A design study: one simulation per sample of a set of parameter
+ * ranges, each measured at the end of its run, collected in one table.
+ *
+ * Parameters are fields of tgRod::Config, tgBasicActuator::Config and
+ * tgWorld::Config, named "rod.density", "actuator.stiffness",
+ * "world.gravity" and so on (see getParameterNames()). A sample starts
+ * from the baseline configs and overrides the swept fields; the
+ * Factory turns it into a model with its controller.
+ *
+ * Every sample gets its own world and simulation, so with OpenMP the
+ * samples run concurrently on numThreads threads. As with
+ * VectorEnvironment, Bullet's profiler is global, so more than one
+ * thread needs Bullet built with BT_NO_PROFILE, as setup.sh does.
+ */
+class ParameterSweep
+{
+public:
+
+    /** How the ranges are sampled */
+    enum Sampling
+    {
+        /** Every combination of each range's levels */
+        grid,
+        /** numSamples samples, each range's strata used once */
+        latinHypercube,
+        /** numSamples independent uniform samples */
+        uniformRandom
+    };
+
+    /** The values of one parameter */
+    struct Range
+    {
+        /**
+         * @param[in] name the parameter, e.g. "actuator.pretension"
+         * @param[in] min the lowest value
+         * @param[in] max the highest value; not less than min
+         * @param[in] levels evenly spaced values from min to max, for
+         * grid sampling. 1 means min alone.
+         */
+        Range(const std::string& name, double min, double max,
+              std::size_t levels = 2);
+
+        std::string name;
+        double min;
+        double max;
+        std::size_t levels;
+    };
+
+    /** The configs of one run */
+    struct Sample
+    {
+        Sample(std::size_t index,
+               const std::vector<double>& values,
+               const tgRod::Config& rod,
+               const tgBasicActuator::Config& actuator,
+               const tgWorld::Config& world);
+
+        /** The row of the results table */
+        std::size_t index;
+        /** The swept values, in the order of the ranges */
+        std::vector<double> values;
+        tgRod::Config rod;
+        tgBasicActuator::Config actuator;
+        tgWorld::Config world;
+    };
+
+    /**
+     * One run: builds the model for a sample and measures it. Made by a
+     * Factory and deleted once its simulation is gone, so it can own
+     * the model's controller.
+     */
+    class Trial
+    {
+    public:
+        virtual ~Trial() { }
+
+        /**
+         * The ground of the trial's world. The world deletes it.
+         * @return NULL for the default flat ground
+         */
+        virtual tgGround* createGround()
+        {
+            return NULL;
+        }
+
+        /**
+         * Build the model from the sample, with its controller attached.
+         * The simulation owns and deletes the model.
+         */
+        virtual tgModel* createModel() = 0;
+
+        /**
+         * Called after the last step, while the model still exists.
+         * @param[out] metrics one value per Factory::getMetricNames()
+         */
+        virtual void measure(tgModel& model, double* metrics) = 0;
+    };
+
+    /** Creates the trials; create() is called from the worker threads */
+    class Factory
+    {
+    public:
+        virtual ~Factory() { }
+
+        /** The metric columns of the results table */
+        virtual std::vector<std::string> getMetricNames() const = 0;
+
+        /**
+         * @return a new Trial for the sample, owned by the sweep. Must not
+         * change anything shared with other trials.
+         */
+        virtual Trial* create(const Sample& sample) = 0;
+    };
+
+    struct Config
+    {
+        /**
+         * @param[in] rod, actuator, world the baseline that samples
+         * start from
+         * @param[in] sampling how to sample the ranges
+         * @param[in] numSamples samples for latinHypercube and
+         * uniformRandom; grid ignores it
+         * @param[in] steps physics steps per run; must be positive
+         * @param[in] stepSize the physics timestep in seconds
+         * @param[in] numThreads threads to run on, 0 for all cores
+         * @param[in] seed for latinHypercube and uniformRandom
+         */
+        Config(const tgRod::Config& rod,
+               const tgBasicActuator::Config& actuator,
+               const tgWorld::Config& world,
+               Sampling sampling = grid,
+               std::size_t numSamples = 0,
+               int steps = 10000,
+               double stepSize = 1.0/1000.0,
+               int numThreads = 1,
+               unsigned long seed = 1);
+
+        tgRod::Config rod;
+        tgBasicActuator::Config actuator;
+        tgWorld::Config world;
+        Sampling sampling;
+        std::size_t numSamples;
+        int steps;
+        double stepSize;
+        int numThreads;
+        unsigned long seed;
+    };
+
+    /** One row of the results table */
+    struct Result
+    {
+        std::vector<double> values;
+        /** NaN if the run failed */
+        std::vector<double> metrics;
+        /** What the run threw, or empty */
+        std::string error;
+    };
+
+    /**
+     * @throws std::invalid_argument if the config is not valid
+     */
+    ParameterSweep(const Config& config);
+
+    /**
+     * Add a range to sweep.
+     * @throws std::invalid_argument if the parameter is unknown or
+     * already swept, or the range is empty
+     */
+    void addRange(const Range& range);
+
+    /**
+     * The sampled values, one row per sample with one value per range.
+     * Fixed by the config and the ranges, so the same sweep can be
+     * rerun, or split across machines by index.
+     */
+    std::vector<std::vector<double> > samples() const;
+
+    /**
+     * Run every sample. A run that throws is recorded in its Result and
+     * the others carry on.
+     * @return one Result per sample, in sample order
+     * @throws std::invalid_argument if there are no ranges or the
+     * factory has no metrics
+     */
+    const std::vector<Result>& run(Factory& factory);
+
+    const std::vector<Result>& getResults() const
+    {
+        return m_results;
+    }
+
+    /**
+     * Write the results as CSV: the parameter columns, the metric
+     * columns, then the error column.
+     */
+    void writeTable(std::ostream& os) const;
+
+    /** The parameters that can be swept */
+    static std::vector<std::string> getParameterNames();
+
+private:
+
+    /** The baseline configs with the swept fields overridden */
+    Sample makeSample(std::size_t i, const std::vector<double>& values) const;
+
+    /** Run sample i into m_results[i]; never throws */
+    void runOne(Factory& factory, std::size_t i,
+                const std::vector<double>& values);
+
+    const Config m_config;
+    std::vector<Range> m_ranges;
+    /** The index into getParameterNames() of each range */
+    std::vector<int> m_fields;
+
+    std::vector<std::string> m_metricNames;
+    std::vector<Result> m_results;
+};
+
+#endif /* PARAMETERSWEEP_H_ */
@@ -0,0 +1,272 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file VectorEnvironment.cpp
+ * @brief Contains the definitions of members of class VectorEnvironment
+ * $Id$
+ */
+
+// This module
+#include "VectorEnvironment.h"
+// This library
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics library
+#include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <stdexcept>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+VectorEnvironment::Config::Config(std::size_t n,
+                                  double stepSize,
+                                  int stepsPerTick,
+                                  int maxTicks,
+                                  int numThreads) :
+    n(n),
+    stepSize(stepSize),
+    stepsPerTick(stepsPerTick),
+    maxTicks(maxTicks),
+    numThreads(numThreads)
+{
+}
+
+namespace
+{
+    int threadCount(int requested)
+    {
+#ifdef _OPENMP
+        return requested > 0 ? requested : omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+}
+
+VectorEnvironment::VectorEnvironment(Factory& factory, const Config& config) :
+    m_config(config),
+    m_numObservations(0),
+    m_numActions(0)
+{
+    if (config.n == 0)
+    {
+        throw std::invalid_argument("No environments");
+    }
+    else if (config.stepSize <= 0.0)
+    {
+        throw std::invalid_argument("stepSize is not positive");
+    }
+    else if (config.stepsPerTick <= 0)
+    {
+        throw std::invalid_argument("stepsPerTick is not positive");
+    }
+    else if (config.maxTicks < 0 || config.numThreads < 0)
+    {
+        throw std::invalid_argument("maxTicks or numThreads is negative");
+    }
+#ifndef BT_NO_PROFILE
+    if (threadCount(config.numThreads) > 1)
+    {
+        throw std::invalid_argument("Stepping on more than one thread needs "
+                                    "Bullet built with BT_NO_PROFILE: re-run "
+                                    "setup.sh and rebuild");
+    }
+#endif
+
+    for (std::size_t i = 0; i < config.n; i++)
+    {
+        Environment* const pEnvironment = factory.create(i);
+        if (pEnvironment == NULL)
+        {
+            throw std::invalid_argument("Factory returned a NULL environment");
+        }
+        m_environments.push_back(pEnvironment);
+
+        if (i == 0)
+        {
+            m_numObservations = pEnvironment->getNumObservations();
+            m_numActions = pEnvironment->getNumActions();
+        }
+        else if (pEnvironment->getNumObservations() != m_numObservations ||
+                 pEnvironment->getNumActions() != m_numActions)
+        {
+            throw std::invalid_argument("Environments differ in observation or action length");
+        }
+
+        tgGround* const pGround = pEnvironment->createGround();
+        m_worlds.push_back(pGround ? new tgWorld(config.world, pGround) :
+                                     new tgWorld(config.world));
+        // Headless: the render rate only matters to tgSimView::run
+        m_views.push_back(new tgSimView(*m_worlds.back(), config.stepSize));
+        m_simulations.push_back(new tgSimulation(*m_views.back()));
+
+        pEnvironment->populate(*m_simulations.back());
+    }
+
+    m_observations.resize(config.n * m_numObservations);
+    m_terminalObservations.resize(config.n * m_numObservations);
+    m_rewards.resize(config.n);
+    m_dones.resize(config.n);
+    m_episodeTicks.resize(config.n);
+    m_errors.resize(config.n);
+
+    for (std::size_t i = 0; i < config.n; i++)
+    {
+        m_environments[i]->onReset(*m_simulations[i]);
+        m_environments[i]->observe(&m_observations[i * m_numObservations]);
+    }
+}
+
+VectorEnvironment::~VectorEnvironment()
+{
+    // Simulations first: they delete the models the environments use
+    for (std::size_t i = 0; i < m_simulations.size(); i++)
+    {
+        delete m_simulations[i];
+    }
+    for (std::size_t i = 0; i < m_views.size(); i++)
+    {
+        delete m_views[i];
+    }
+    for (std::size_t i = 0; i < m_worlds.size(); i++)
+    {
+        delete m_worlds[i];
+    }
+    for (std::size_t i = 0; i < m_environments.size(); i++)
+    {
+        delete m_environments[i];
+    }
+}
+
+void VectorEnvironment::reset()
+{
+    const long n = (long) size();
+    const int threads = threadCount(m_config.numThreads);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(threads) if (threads > 1)
+#endif
+    for (long i = 0; i < n; i++)
+    {
+        m_dones[i] = 0;
+        m_rewards[i] = 0.0;
+        resetOne(i);
+    }
+    rethrowErrors();
+}
+
+void VectorEnvironment::step(const double* actions)
+{
+    if (actions == NULL)
+    {
+        throw std::invalid_argument("NULL actions");
+    }
+
+    const long n = (long) size();
+    const int threads = threadCount(m_config.numThreads);
+    // Episodes differ in cost (contacts, resets), so hand out
+    // environments one at a time
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(threads) if (threads > 1)
+#endif
+    for (long i = 0; i < n; i++)
+    {
+        stepOne(i, actions);
+    }
+    rethrowErrors();
+}
+
+void VectorEnvironment::stepOne(std::size_t i, const double* actions)
+{
+    Environment& environment = *m_environments[i];
+    tgSimulation& simulation = *m_simulations[i];
+    double* const observation = &m_observations[i * m_numObservations];
+    try
+    {
+        environment.applyActions(actions + i * m_numActions,
+                                 m_config.stepSize * m_config.stepsPerTick);
+        for (int s = 0; s < m_config.stepsPerTick; s++)
+        {
+            simulation.step(m_config.stepSize);
+        }
+        m_episodeTicks[i]++;
+
+        bool done = false;
+        m_rewards[i] = environment.reward(done);
+        environment.observe(observation);
+        if (m_config.maxTicks > 0 && m_episodeTicks[i] >= m_config.maxTicks)
+        {
+            done = true;
+        }
+        m_dones[i] = done ? 1 : 0;
+    }
+    catch (const std::exception& e)
+    {
+        // Exceptions can't leave an OpenMP loop; end the episode instead
+        m_errors[i] = e.what();
+        m_dones[i] = 1;
+    }
+
+    if (m_dones[i])
+    {
+        std::copy(observation, observation + m_numObservations,
+                  &m_terminalObservations[i * m_numObservations]);
+        resetOne(i);
+    }
+}
+
+void VectorEnvironment::resetOne(std::size_t i)
+{
+    try
+    {
+        m_simulations[i]->reset();
+        m_environments[i]->onReset(*m_simulations[i]);
+        m_environments[i]->observe(&m_observations[i * m_numObservations]);
+    }
+    catch (const std::exception& e)
+    {
+        if (m_errors[i].empty())
+        {
+            m_errors[i] = e.what();
+        }
+    }
+    m_episodeTicks[i] = 0;
+}
+
+void VectorEnvironment::rethrowErrors()
+{
+    std::string message;
+    for (std::size_t i = 0; i < m_errors.size(); i++)
+    {
+        if (!m_errors[i].empty() && message.empty())
+        {
+            message = m_errors[i];
+        }
+        m_errors[i].clear();
+    }
+    if (!message.empty())
+    {
+        throw std::runtime_error(message);
+    }
+}
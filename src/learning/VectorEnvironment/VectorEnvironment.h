@@ -0,0 +1,265 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef VECTORENVIRONMENT_H_
+#define VECTORENVIRONMENT_H_
+
+/**
+ * @file VectorEnvironment.h
+ * @brief Contains the definition of class VectorEnvironment.
+ * Many copies of one task stepped in lockstep, for reinforcement learning
+ * $Id$
+ */
+
+// This library
+#include "core/tgWorld.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgGround;
+class tgSimulation;
+class tgSimView;
+
+/**
+ * Owns N independent simulations of the same task and advances them
+ * together one control tick at a time. Observations, actions, rewards
+ * and done flags are contiguous arrays with one row per environment, so
+ * a learner can read and write a whole batch at once.
+ *
+ * An environment whose episode ends is reset within the same step():
+ * its simulation is reset (the world releases its arena and rebuilds,
+ * the models are set up again) and its observation row then holds the
+ * first observation of the next episode. The last observation of the
+ * finished episode is kept in getTerminalObservations().
+ *
+ * With numThreads > 1 and OpenMP, environments are stepped concurrently.
+ * The simulations share no state in NTRT, but Bullet's built-in profiler
+ * keeps one global call tree, so this needs Bullet built with
+ * BT_NO_PROFILE. setup.sh builds it that way and the NTRT build picks
+ * the flag up from Bullet's CMake cache; against an older Bullet build the
+ * constructor throws.
+ */
+class VectorEnvironment
+{
+public:
+
+    /**
+     * One copy of the task: the robot, how actions drive it, and what is
+     * observed and rewarded. Created by a Factory, one per simulation.
+     */
+    class Environment
+    {
+    public:
+        virtual ~Environment() { }
+
+        /** The length of one observation row */
+        virtual std::size_t getNumObservations() const = 0;
+
+        /** The length of one action row */
+        virtual std::size_t getNumActions() const = 0;
+
+        /**
+         * The ground of this environment's world. The world deletes it.
+         * @return NULL for the default flat ground
+         */
+        virtual tgGround* createGround()
+        {
+            return NULL;
+        }
+
+        /**
+         * Add the models, once. The simulation owns them and sets them up
+         * again on every reset, so keep pointers to them but don't delete
+         * them.
+         */
+        virtual void populate(tgSimulation& simulation) = 0;
+
+        /**
+         * Called after every reset, e.g. to add obstacles (which a reset
+         * deletes) or clear episode statistics.
+         */
+        virtual void onReset(tgSimulation& simulation) { }
+
+        /** Apply one row of actions before the tick's physics steps */
+        virtual void applyActions(const double* actions, double dt) = 0;
+
+        /** Write one row of observations */
+        virtual void observe(double* observations) = 0;
+
+        /**
+         * The reward for the tick just simulated.
+         * @param[out] done set to true to end the episode; false on entry
+         */
+        virtual double reward(bool& done) = 0;
+    };
+
+    /** Creates the environments */
+    class Factory
+    {
+    public:
+        virtual ~Factory() { }
+
+        /**
+         * @param[in] index which environment, 0 to size() - 1, e.g. to
+         * vary the terrain
+         * @return a new Environment, owned by the VectorEnvironment
+         */
+        virtual Environment* create(std::size_t index) = 0;
+    };
+
+    struct Config
+    {
+        /**
+         * @param[in] n the number of environments; must be positive
+         * @param[in] stepSize the physics timestep in seconds
+         * @param[in] stepsPerTick physics steps per step(); must be
+         * positive
+         * @param[in] maxTicks ticks after which an episode is ended, 0 for
+         * no limit
+         * @param[in] numThreads threads to step with, 0 for all cores
+         */
+        Config(std::size_t n,
+               double stepSize = 1.0/1000.0,
+               int stepsPerTick = 10,
+               int maxTicks = 0,
+               int numThreads = 1);
+
+        std::size_t n;
+        double stepSize;
+        int stepsPerTick;
+        int maxTicks;
+        int numThreads;
+        tgWorld::Config world;
+    };
+
+    /**
+     * Create config.n environments, their worlds and simulations, and
+     * populate them.
+     * @throws std::invalid_argument if the config is not valid, or the
+     * environments don't agree on the observation and action lengths
+     */
+    VectorEnvironment(Factory& factory, const Config& config);
+
+    /** Deletes the simulations (and so the models), then the environments */
+    ~VectorEnvironment();
+
+    /** Reset every environment and observe the first states */
+    void reset();
+
+    /**
+     * Advance every environment by one control tick.
+     * @param[in] actions size() rows of getNumActions() values
+     * @throws std::runtime_error if an environment threw; the others
+     * have still been stepped
+     */
+    void step(const double* actions);
+
+    std::size_t size() const
+    {
+        return m_environments.size();
+    }
+
+    std::size_t getNumObservations() const
+    {
+        return m_numObservations;
+    }
+
+    std::size_t getNumActions() const
+    {
+        return m_numActions;
+    }
+
+    /** size() rows of getNumObservations() values */
+    const std::vector<double>& getObservations() const
+    {
+        return m_observations;
+    }
+
+    /** Rows valid where getDones() is set after the last step() */
+    const std::vector<double>& getTerminalObservations() const
+    {
+        return m_terminalObservations;
+    }
+
+    /** The reward of each environment for the last step() */
+    const std::vector<double>& getRewards() const
+    {
+        return m_rewards;
+    }
+
+    /** 1 where the last step() ended an episode, one byte each */
+    const std::vector<unsigned char>& getDones() const
+    {
+        return m_dones;
+    }
+
+    /** Ticks into the current episode of each environment */
+    const std::vector<int>& getEpisodeTicks() const
+    {
+        return m_episodeTicks;
+    }
+
+    Environment& getEnvironment(std::size_t i)
+    {
+        return *m_environments[i];
+    }
+
+    tgSimulation& getSimulation(std::size_t i)
+    {
+        return *m_simulations[i];
+    }
+
+private:
+
+    /** Not copyable */
+    VectorEnvironment(const VectorEnvironment&);
+    VectorEnvironment& operator=(const VectorEnvironment&);
+
+    /** Step environment i; never throws */
+    void stepOne(std::size_t i, const double* actions);
+
+    /** Reset environment i and observe; never throws */
+    void resetOne(std::size_t i);
+
+    /** Throw the first recorded error, if any, and clear them */
+    void rethrowErrors();
+
+    const Config m_config;
+    std::size_t m_numObservations;
+    std::size_t m_numActions;
+
+    std::vector<Environment*> m_environments;
+    std::vector<tgWorld*> m_worlds;
+    std::vector<tgSimView*> m_views;
+    std::vector<tgSimulation*> m_simulations;
+
+    std::vector<double> m_observations;
+    std::vector<double> m_terminalObservations;
+    std::vector<double> m_rewards;
+    std::vector<unsigned char> m_dones;
+    std::vector<int> m_episodeTicks;
+
+    /** What each environment threw in the last step, if anything */
+    std::vector<std::string> m_errors;
+};
+
+#endif /* VECTORENVIRONMENT_H_ */
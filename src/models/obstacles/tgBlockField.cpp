@@ -47,7 +47,8 @@ tgBlockField::Config::Config(btVector3 origin,
                              size_t nBlocks, 
                              double blockLength, 
                              double blockWidth, 
-                             double blockHeight) :
+                             double blockHeight,
+                             tgStaticBoxBatch::Mode batch) :
 m_origin(origin),
 m_friction(friction),
 m_restitution(restitution),
@@ -56,7 +57,8 @@ m_maxPos(maxPos),
 m_nBlocks(nBlocks),
 m_length(blockLength),
 m_width(blockWidth),
-m_height(blockHeight)
+m_height(blockHeight),
+m_batch(batch)
 {
     assert(m_friction >= 0.0);
     assert(m_restitution >= 0.0);
@@ -94,15 +96,24 @@ void tgBlockField::setup(tgWorld& world) {
     tgStructure s;
     addNodes(s);
 
-    // Create the build spec that uses tags to turn the structure into a real model
-    tgBuildSpec spec;
-    spec.addBuilder("box", new tgBoxInfo(boxConfig));
+    if (m_config.m_batch == tgStaticBoxBatch::eSeparate)
+    {
+        // Create the build spec that uses tags to turn the structure into a real model
+        tgBuildSpec spec;
+        spec.addBuilder("box", new tgBoxInfo(boxConfig));
 
-    // Create your structureInfo
-    tgStructureInfo structureInfo(s, spec);
+        // Create your structureInfo
+        tgStructureInfo structureInfo(s, spec);
 
-    // Use the structureInfo to build ourselves
-    structureInfo.buildInto(*this, world);
+        // Use the structureInfo to build ourselves
+        structureInfo.buildInto(*this, world);
+    }
+    else
+    {
+        // One static body, and one broadphase proxy, for the whole field
+        addChild(tgStaticBoxBatch::create(world, s.getPairs(), boxConfig,
+                                          m_config.m_batch, tgTags("box")));
+    }
 
     // Actually setup the children
     tgModel::setup(world);
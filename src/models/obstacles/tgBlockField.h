@@ -30,6 +30,7 @@
 
 // This library
 #include "core/tgModel.h"
+#include "tgStaticBoxBatch.h"
 // The Bullet Physics Library
 #include "LinearMath/btVector3.h"
 // The C++ Standard Library
@@ -59,7 +60,8 @@ public:
                     size_t nBlocks = 500,
                     double blockLength = 5.0,
                     double blockWidth = 5.0,
-                    double blockHeight = 5.0);
+                    double blockHeight = 5.0,
+                    tgStaticBoxBatch::Mode batch = tgStaticBoxBatch::eSeparate);
 
             /** Origin position of the block field */
             btVector3 m_origin;
@@ -87,6 +89,12 @@ public:
             
             /** Height of the blocks */
             double m_height;
+
+            /**
+             * Whether the blocks are separate rigid bodies, or one static
+             * body. A large field is much cheaper as one body.
+             */
+            tgStaticBoxBatch::Mode m_batch;
     };
     
    /**
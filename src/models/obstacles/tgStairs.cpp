@@ -45,7 +45,8 @@ tgStairs::Config::Config(btVector3 origin,
                              double stairWidth, 
                              double stepWidth, 
                              double stepHeight,
-                             double angle) :
+                             double angle,
+                             tgStaticBoxBatch::Mode batch) :
 m_origin(origin),
 m_friction(friction),
 m_restitution(restitution),
@@ -53,7 +54,8 @@ m_nBlocks(nBlocks),
 m_length(stairWidth),
 m_width(stepWidth),
 m_height(stepHeight),
-m_angle(angle)
+m_angle(angle),
+m_batch(batch)
 {
     assert(m_friction >= 0.0);
     assert(m_restitution >= 0.0);
@@ -85,15 +87,23 @@ void tgStairs::setup(tgWorld& world) {
     tgStructure s;
     addNodes(s);
 
-    // Create the build spec that uses tags to turn the structure into a real model
-    tgBuildSpec spec;
-    spec.addBuilder("box", new tgBoxInfo(boxConfig));
+    if (m_config.m_batch == tgStaticBoxBatch::eSeparate)
+    {
+        // Create the build spec that uses tags to turn the structure into a real model
+        tgBuildSpec spec;
+        spec.addBuilder("box", new tgBoxInfo(boxConfig));
 
-    // Create your structureInfo
-    tgStructureInfo structureInfo(s, spec);
+        // Create your structureInfo
+        tgStructureInfo structureInfo(s, spec);
 
-    // Use the structureInfo to build ourselves
-    structureInfo.buildInto(*this, world);
+        // Use the structureInfo to build ourselves
+        structureInfo.buildInto(*this, world);
+    }
+    else
+    {
+        addChild(tgStaticBoxBatch::create(world, s.getPairs(), boxConfig,
+                                          m_config.m_batch, tgTags("box")));
+    }
 
     // Actually setup the children
     tgModel::setup(world);
@@ -30,6 +30,7 @@
 
 // This library
 #include "core/tgModel.h"
+#include "tgStaticBoxBatch.h"
 // The Bullet Physics Library
 #include "LinearMath/btVector3.h"
 // The C++ Standard Library
@@ -58,7 +59,8 @@ public:
                     double stairWidth = 20.0,
                     double stepWidth = 5.0,
                     double stepHeight = 1.0,
-                    double angle = 0.0);
+                    double angle = 0.0,
+                    tgStaticBoxBatch::Mode batch = tgStaticBoxBatch::eSeparate);
 
             /** Origin position of the block field */
             btVector3 m_origin;
@@ -83,6 +85,9 @@ public:
             
             /** Angle of the stairs in the xz plane. Default has the stairs ascending along the +z direction */
             double m_angle;
+
+            /** Whether the steps are separate rigid bodies, or one static body */
+            tgStaticBoxBatch::Mode m_batch;
     };
     
    /**
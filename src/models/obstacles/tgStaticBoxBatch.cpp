@@ -0,0 +1,166 @@
+/*
+ * Copyright © 2014, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/**
+ * @file tgStaticBoxBatch.cpp
+ * @brief Contains the implementation of class tgStaticBoxBatch.
+ * $Id$
+ */
+
+// This module
+#include "tgStaticBoxBatch.h"
+// This library
+#include "core/tgBulletUtil.h"
+#include "core/tgWorld.h"
+#include "core/tgWorldBulletPhysicsImpl.h"
+#include "tgcreator/tgBoxInfo.h"
+#include "tgcreator/tgPairs.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/CollisionShapes/btTriangleMesh.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * A triangle mesh shape that deletes its mesh, so that the world,
+     * which deletes the shapes, cleans up both.
+     */
+    class OwningMeshShape : public btBvhTriangleMeshShape
+    {
+    public:
+        explicit OwningMeshShape(btTriangleMesh* pMesh) :
+            btBvhTriangleMeshShape(pMesh, true),
+            m_pMesh(pMesh)
+        {
+        }
+
+        virtual ~OwningMeshShape()
+        {
+            delete m_pMesh;
+        }
+
+    private:
+        btTriangleMesh* const m_pMesh;
+    };
+
+    /** The corners of each face, counterclockwise seen from outside */
+    const int faces[6][4] =
+    {
+        {0, 4, 6, 2}, {1, 3, 7, 5}, // -x, +x
+        {0, 1, 5, 4}, {2, 6, 7, 3}, // -y, +y
+        {0, 2, 3, 1}, {4, 5, 7, 6}  // -z, +z
+    };
+
+    /** Add the 12 triangles of a box with the given half extents */
+    void addBoxTriangles(btTriangleMesh& mesh,
+                         const btTransform& transform,
+                         const btVector3& halfExtents)
+    {
+        btVector3 corners[8];
+        for (int i = 0; i < 8; i++)
+        {
+            // Bit 0 is x, bit 1 is y, bit 2 is z
+            const btVector3 corner((i & 1) ? halfExtents.x() : -halfExtents.x(),
+                                   (i & 2) ? halfExtents.y() : -halfExtents.y(),
+                                   (i & 4) ? halfExtents.z() : -halfExtents.z());
+            corners[i] = transform * corner;
+        }
+        for (int i = 0; i < 6; i++)
+        {
+            const int* const f = faces[i];
+            mesh.addTriangle(corners[f[0]], corners[f[1]], corners[f[2]]);
+            mesh.addTriangle(corners[f[0]], corners[f[2]], corners[f[3]]);
+        }
+    }
+} // namespace
+
+tgStaticBoxBatch::tgStaticBoxBatch(btRigidBody* pRigidBody,
+                                   const tgTags& tags,
+                                   std::size_t size) :
+    tgBaseRigid(pRigidBody, tags),
+    m_size(size)
+{
+}
+
+tgStaticBoxBatch::~tgStaticBoxBatch() {}
+
+tgStaticBoxBatch* tgStaticBoxBatch::create(tgWorld& world,
+                                           const tgPairs& pairs,
+                                           const tgBox::Config& config,
+                                           Mode mode,
+                                           const tgTags& tags)
+{
+    if (mode == eSeparate)
+    {
+        throw std::invalid_argument("Separate boxes are not a batch");
+    }
+    else if (pairs.size() == 0)
+    {
+        throw std::invalid_argument("No boxes to batch");
+    }
+
+    tgWorldBulletPhysicsImpl& bulletWorld =
+        (tgWorldBulletPhysicsImpl&)world.implementation();
+
+    btCollisionShape* pShape = NULL;
+    if (mode == eCompound)
+    {
+        btCompoundShape* const pCompound = new btCompoundShape();
+        for (int i = 0; i < pairs.size(); i++)
+        {
+            // The same transform and shared shape as a separate box
+            const tgBoxInfo box(config, pairs[i]);
+            pCompound->addChildShape(box.getTransform(),
+                                     box.getCollisionShape(world));
+        }
+        pShape = pCompound;
+    }
+    else
+    {
+        btTriangleMesh* const pMesh = new btTriangleMesh();
+        for (int i = 0; i < pairs.size(); i++)
+        {
+            const tgBoxInfo box(config, pairs[i]);
+            // As in tgBoxInfo::getCollisionShape
+            const btVector3 halfExtents(config.width,
+                                        box.getLength() / 2.0,
+                                        config.height);
+            addBoxTriangles(*pMesh, box.getTransform(), halfExtents);
+        }
+        pShape = new OwningMeshShape(pMesh);
+    }
+    // The world deletes the shape with the others
+    bulletWorld.addCollisionShape(pShape);
+
+    btTransform identity;
+    identity.setIdentity();
+    btRigidBody* const pBody =
+        tgBulletUtil::createRigidBody(&bulletWorld.dynamicsWorld(),
+                                      0.0, identity, pShape);
+    pBody->setFriction(config.friction);
+    pBody->setRollingFriction(config.rollFriction);
+    pBody->setRestitution(config.restitution);
+
+    return new tgStaticBoxBatch(pBody, tags, pairs.size());
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2014, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#ifndef TG_STATIC_BOX_BATCH_H
+#define TG_STATIC_BOX_BATCH_H
+
+/**
+ * @file tgStaticBoxBatch.h
+ * @brief Contains the definition of class tgStaticBoxBatch.
+ * The static boxes of an obstacle merged into one rigid body
+ * $Id$
+ */
+
+// This library
+#include "core/tgBaseRigid.h"
+#include "core/tgBox.h"
+// The C++ Standard Library
+#include <cstddef>
+
+// Forward declarations
+class btRigidBody;
+class tgPairs;
+class tgTags;
+class tgWorld;
+
+/**
+ * The boxes of a static obstacle (a block field, stairs, a wall) as a
+ * single rigid body. The broadphase then has one proxy for the whole
+ * obstacle instead of one per box, and the narrowphase finds the boxes
+ * near a body through the shape's own tree. Each box is the one that
+ * tgBoxInfo would build from the same pair and config.
+ */
+class tgStaticBoxBatch : public tgBaseRigid
+{
+public:
+
+    /** How an obstacle builds its boxes */
+    enum Mode
+    {
+        /** A tgBox, with its own rigid body, for every box */
+        eSeparate,
+        /**
+         * One btCompoundShape with a child btBoxShape for every box.
+         * Contacts are the same as with separate boxes.
+         */
+        eCompound,
+        /**
+         * One btBvhTriangleMeshShape of the faces of the boxes. The
+         * faces are the same as with separate boxes, but a body that
+         * ends up inside a box is not pushed out.
+         */
+        eTriangleMesh
+    };
+
+    /**
+     * Build the boxes of the pairs into one static rigid body in the
+     * world. The boxes are static whatever the density of the config.
+     * @param[in] world the world to build into; it owns the body and shape
+     * @param[in] pairs one box per pair, as for tgBoxInfo
+     * @param[in] config the size, friction and restitution of the boxes
+     * @param[in] mode eCompound or eTriangleMesh
+     * @param[in] tags the tags of the model
+     * @return a model to add as a child of the obstacle
+     * @throw std::invalid_argument if mode is eSeparate or pairs is empty
+     */
+    static tgStaticBoxBatch* create(tgWorld& world,
+                                    const tgPairs& pairs,
+                                    const tgBox::Config& config,
+                                    Mode mode,
+                                    const tgTags& tags);
+
+    /** A class with a virtual memeber function requires a virtual destructor. */
+    virtual ~tgStaticBoxBatch();
+
+    /** The number of boxes in the body */
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+
+    tgStaticBoxBatch(btRigidBody* pRigidBody,
+                     const tgTags& tags,
+                     std::size_t size);
+
+    /** The number of boxes in the body */
+    const std::size_t m_size;
+};
+
+#endif // TG_STATIC_BOX_BATCH_H
@@ -0,0 +1,555 @@
+/*
+ * Copyright © 2014, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/**
+ * @file tgTiledTerrain.cpp
+ * @brief Contains the implementation of class tgTiledTerrain.
+ * $Id$
+ */
+
+// This module
+#include "tgTiledTerrain.h"
+// This library
+#include "core/tgBaseRigid.h"
+#include "core/tgBulletUtil.h"
+#include "core/tgCast.h"
+#include "core/tgWorld.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * A heightfield that deletes its heights, so that deleting the shape
+     * cleans up both.
+     */
+    class OwningHeightfield : public btHeightfieldTerrainShape
+    {
+    public:
+        OwningHeightfield(int resolution, float* pHeights,
+                          double minHeight, double maxHeight) :
+            btHeightfieldTerrainShape(resolution, resolution, pHeights,
+                                      1.0, minHeight, maxHeight,
+                                      1, PHY_FLOAT, false),
+            m_pHeights(pHeights)
+        {
+        }
+
+        virtual ~OwningHeightfield()
+        {
+            delete[] m_pHeights;
+        }
+
+    private:
+        float* const m_pHeights;
+    };
+} // namespace
+
+tgTiledTerrain::HeightfieldSource::HeightfieldSource(int resolution) :
+    m_resolution(resolution)
+{
+    if (resolution < 2)
+    {
+        throw std::invalid_argument("resolution is less than 2");
+    }
+}
+
+btCollisionShape*
+tgTiledTerrain::HeightfieldSource::createTile(int i, int j,
+                                              double tileSize,
+                                              btTransform& transform)
+{
+    const int n = m_resolution;
+    float* const pHeights = new float[n * n];
+    float minHeight = std::numeric_limits<float>::max();
+    float maxHeight = -std::numeric_limits<float>::max();
+    // Rows run along z and columns along x, as btHeightfieldTerrainShape
+    // expects with y up
+    for (int row = 0; row < n; row++)
+    {
+        // The last sample of a tile is at exactly the first of the next
+        const double z = (j + row / (n - 1.0)) * tileSize;
+        for (int col = 0; col < n; col++)
+        {
+            const double x = (i + col / (n - 1.0)) * tileSize;
+            const float h = height(x, z);
+            pHeights[row * n + col] = h;
+            minHeight = std::min(minHeight, h);
+            maxHeight = std::max(maxHeight, h);
+        }
+    }
+
+    btHeightfieldTerrainShape* const pShape =
+        new OwningHeightfield(n, pHeights, minHeight, maxHeight);
+    const double spacing = tileSize / (n - 1);
+    pShape->setLocalScaling(btVector3(spacing, 1.0, spacing));
+
+    // The shape is centered on the middle of its bounding box
+    transform.setIdentity();
+    transform.setOrigin(btVector3((i + 0.5) * tileSize,
+                                  (minHeight + maxHeight) / 2.0,
+                                  (j + 0.5) * tileSize));
+    return pShape;
+}
+
+tgTiledTerrain::HillySource::HillySource(double waveHeight,
+                                         double wavelength,
+                                         double offset,
+                                         int resolution) :
+    HeightfieldSource(resolution),
+    m_waveHeight(waveHeight),
+    m_wavelength(wavelength),
+    m_offset(offset)
+{
+    if (wavelength <= 0.0)
+    {
+        throw std::invalid_argument("wavelength is not positive");
+    }
+}
+
+double tgTiledTerrain::HillySource::height(double x, double z) const
+{
+    return m_waveHeight * std::sin(x / m_wavelength) *
+        std::cos(z / m_wavelength) + m_offset;
+}
+
+tgTiledTerrain::Config::Config(double tileSize,
+                               int activeRadius,
+                               int prefetchRadius,
+                               double friction,
+                               double restitution) :
+    tileSize(tileSize),
+    activeRadius(activeRadius),
+    prefetchRadius(prefetchRadius),
+    friction(friction),
+    restitution(restitution)
+{
+    if (tileSize <= 0.0)
+    {
+        throw std::invalid_argument("tileSize is not positive");
+    }
+    else if (activeRadius < 0)
+    {
+        throw std::invalid_argument("activeRadius is negative");
+    }
+    else if (prefetchRadius < activeRadius)
+    {
+        throw std::invalid_argument("prefetchRadius is less than activeRadius");
+    }
+}
+
+tgTiledTerrain::tgTiledTerrain(TileSource* pSource, const Config& config) :
+    tgModel(tgTags("terrain")),
+    m_pSource(pSource),
+    m_config(config),
+    m_pWorld(NULL),
+    m_center(0, 0),
+    m_centered(false),
+    m_building(0, 0),
+    m_isBuilding(false),
+    m_stop(false)
+{
+    if (pSource == NULL)
+    {
+        throw std::invalid_argument("pSource is NULL");
+    }
+
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_requested, NULL);
+    pthread_cond_init(&m_built, NULL);
+    if (pthread_create(&m_thread, NULL, loaderMain, this) != 0)
+    {
+        pthread_cond_destroy(&m_built);
+        pthread_cond_destroy(&m_requested);
+        pthread_mutex_destroy(&m_mutex);
+        delete pSource;
+        throw std::runtime_error("Can't start the tile loading thread");
+    }
+}
+
+tgTiledTerrain::~tgTiledTerrain()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_stop = true;
+    pthread_cond_signal(&m_requested);
+    pthread_mutex_unlock(&m_mutex);
+    pthread_join(m_thread, NULL);
+
+    pthread_cond_destroy(&m_built);
+    pthread_cond_destroy(&m_requested);
+    pthread_mutex_destroy(&m_mutex);
+
+    for (std::size_t k = 0; k < m_finished.size(); k++)
+    {
+        delete m_finished[k].pShape;
+    }
+    for (std::map<Key, Tile>::iterator it = m_tiles.begin();
+         it != m_tiles.end(); ++it)
+    {
+        // teardown() took the bodies out of the world
+        assert(it->second.pBody == NULL);
+        delete it->second.pShape;
+    }
+    delete m_pSource;
+}
+
+void tgTiledTerrain::track(tgModel* pModel)
+{
+    if (pModel == NULL)
+    {
+        throw std::invalid_argument("pModel is NULL");
+    }
+    m_tracked.push_back(pModel);
+}
+
+void tgTiledTerrain::untrack(tgModel* pModel)
+{
+    m_tracked.erase(std::remove(m_tracked.begin(), m_tracked.end(), pModel),
+                    m_tracked.end());
+}
+
+void tgTiledTerrain::setup(tgWorld& world)
+{
+    m_pWorld = &world;
+    m_centered = false;
+    // Shapes come from the loading thread, so they are on the heap and
+    // not in the world's arena; they outlive resets
+    update();
+    tgModel::setup(world);
+}
+
+void tgTiledTerrain::step(double dt)
+{
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("dt is not positive");
+    }
+    else
+    {
+        if (m_pWorld != NULL)
+        {
+            update();
+        }
+        tgModel::step(dt);
+    }
+}
+
+void tgTiledTerrain::teardown()
+{
+    for (std::map<Key, Tile>::iterator it = m_tiles.begin();
+         it != m_tiles.end(); ++it)
+    {
+        if (it->second.pBody != NULL)
+        {
+            removeBody(it->second);
+        }
+    }
+    m_pWorld = NULL;
+    m_centered = false;
+    tgModel::teardown();
+}
+
+btVector3 tgTiledTerrain::center() const
+{
+    btVector3 weighted(0.0, 0.0, 0.0);
+    btVector3 sum(0.0, 0.0, 0.0);
+    double totalMass = 0.0;
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < m_tracked.size(); i++)
+    {
+        const std::vector<tgBaseRigid*> rigids =
+            tgCast::filter<tgModel, tgBaseRigid>(m_tracked[i]->getDescendants());
+        for (std::size_t k = 0; k < rigids.size(); k++)
+        {
+            const btVector3 com = rigids[k]->centerOfMass();
+            const double mass = rigids[k]->mass();
+            weighted += com * mass;
+            totalMass += mass;
+            sum += com;
+            count++;
+        }
+    }
+    if (totalMass > 0.0)
+    {
+        return weighted / totalMass;
+    }
+    // Only static bodies, or none at all
+    return count > 0 ? sum / count : btVector3(0.0, 0.0, 0.0);
+}
+
+std::size_t tgTiledTerrain::loadedTileCount() const
+{
+    std::size_t n = 0;
+    for (std::map<Key, Tile>::const_iterator it = m_tiles.begin();
+         it != m_tiles.end(); ++it)
+    {
+        if (it->second.pShape != NULL)
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+std::size_t tgTiledTerrain::activeTileCount() const
+{
+    std::size_t n = 0;
+    for (std::map<Key, Tile>::const_iterator it = m_tiles.begin();
+         it != m_tiles.end(); ++it)
+    {
+        if (it->second.pBody != NULL)
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+tgTiledTerrain::Key tgTiledTerrain::keyOf(const btVector3& point) const
+{
+    // Keep a blown up simulation from overflowing the indices
+    const double limit = std::numeric_limits<int>::max() / 2;
+    const double i = std::floor(point.x() / m_config.tileSize);
+    const double j = std::floor(point.z() / m_config.tileSize);
+    return Key(static_cast<int>(std::max(-limit, std::min(limit, i))),
+               static_cast<int>(std::max(-limit, std::min(limit, j))));
+}
+
+int tgTiledTerrain::distance(const Key& a, const Key& b)
+{
+    return std::max(std::abs(a.first - b.first),
+                    std::abs(a.second - b.second));
+}
+
+void tgTiledTerrain::update()
+{
+    collectBuilt();
+
+    const btVector3 point = center();
+    // NaN fails every comparison; keep the tiles we have
+    if (!(point.x() == point.x() && point.z() == point.z()))
+    {
+        return;
+    }
+    const Key c = keyOf(point);
+    if (m_centered && c == m_center)
+    {
+        return;
+    }
+    m_center = c;
+    m_centered = true;
+
+    // Drop tiles that are too far away, and their bodies a little sooner
+    std::map<Key, Tile>::iterator it = m_tiles.begin();
+    while (it != m_tiles.end())
+    {
+        Tile& tile = it->second;
+        const int d = distance(it->first, c);
+        if (tile.pBody != NULL && d > m_config.activeRadius)
+        {
+            removeBody(tile);
+        }
+        if (d > m_config.prefetchRadius)
+        {
+            // A shape still being built is thrown away by collectBuilt()
+            delete tile.pShape;
+            m_tiles.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Ask for the missing tiles, ring by ring from the center
+    pthread_mutex_lock(&m_mutex);
+    m_requests.clear();
+    const int radius = m_config.prefetchRadius;
+    for (int r = 0; r <= radius; r++)
+    {
+        for (int di = -r; di <= r; di++)
+        {
+            for (int dj = -r; dj <= r; dj++)
+            {
+                if (std::max(std::abs(di), std::abs(dj)) != r)
+                {
+                    continue;
+                }
+                const Key key(c.first + di, c.second + dj);
+                // Inserts an empty tile if there isn't one
+                const Tile& tile = m_tiles[key];
+                if (tile.pShape == NULL &&
+                    !(m_isBuilding && m_building == key) &&
+                    !isFinished(key))
+                {
+                    m_requests.push_back(key);
+                }
+            }
+        }
+    }
+    if (!m_requests.empty())
+    {
+        pthread_cond_signal(&m_requested);
+    }
+    pthread_mutex_unlock(&m_mutex);
+
+    // The tiles under the models can't wait for the loading thread
+    const int active = m_config.activeRadius;
+    for (int di = -active; di <= active; di++)
+    {
+        for (int dj = -active; dj <= active; dj++)
+        {
+            Tile& tile = m_tiles[Key(c.first + di, c.second + dj)];
+            if (tile.pShape == NULL)
+            {
+                waitFor(Key(c.first + di, c.second + dj));
+                collectBuilt();
+            }
+            assert(tile.pShape != NULL);
+            if (tile.pBody == NULL)
+            {
+                addBody(tile);
+            }
+        }
+    }
+}
+
+void tgTiledTerrain::collectBuilt()
+{
+    std::vector<Built> built;
+    pthread_mutex_lock(&m_mutex);
+    built.swap(m_finished);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (std::size_t k = 0; k < built.size(); k++)
+    {
+        std::map<Key, Tile>::iterator it = m_tiles.find(built[k].key);
+        if (it != m_tiles.end() && it->second.pShape == NULL)
+        {
+            it->second.pShape = built[k].pShape;
+            it->second.transform = built[k].transform;
+        }
+        else
+        {
+            // Dropped while it was being built
+            delete built[k].pShape;
+        }
+    }
+}
+
+bool tgTiledTerrain::isFinished(const Key& key) const
+{
+    for (std::size_t k = 0; k < m_finished.size(); k++)
+    {
+        if (m_finished[k].key == key)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void tgTiledTerrain::waitFor(const Key& key)
+{
+    pthread_mutex_lock(&m_mutex);
+    if (!(m_isBuilding && m_building == key) && !isFinished(key))
+    {
+        m_requests.erase(std::remove(m_requests.begin(), m_requests.end(), key),
+                         m_requests.end());
+        m_requests.push_front(key);
+        pthread_cond_signal(&m_requested);
+    }
+    while (!isFinished(key))
+    {
+        pthread_cond_wait(&m_built, &m_mutex);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void tgTiledTerrain::addBody(Tile& tile)
+{
+    assert(m_pWorld != NULL);
+    assert(tile.pShape != NULL);
+    btDynamicsWorld& dynamicsWorld =
+        tgBulletUtil::worldToDynamicsWorld(*m_pWorld);
+    tile.pBody = tgBulletUtil::createRigidBody(&dynamicsWorld, 0.0,
+                                               tile.transform, tile.pShape);
+    tile.pBody->setFriction(m_config.friction);
+    tile.pBody->setRestitution(m_config.restitution);
+}
+
+void tgTiledTerrain::removeBody(Tile& tile)
+{
+    assert(m_pWorld != NULL);
+    assert(tile.pBody != NULL);
+    btDynamicsWorld& dynamicsWorld =
+        tgBulletUtil::worldToDynamicsWorld(*m_pWorld);
+    dynamicsWorld.removeRigidBody(tile.pBody);
+    delete tile.pBody->getMotionState();
+    delete tile.pBody;
+    tile.pBody = NULL;
+}
+
+void* tgTiledTerrain::loaderMain(void* pTerrain)
+{
+    static_cast<tgTiledTerrain*>(pTerrain)->load();
+    return NULL;
+}
+
+void tgTiledTerrain::load()
+{
+    pthread_mutex_lock(&m_mutex);
+    while (true)
+    {
+        while (m_requests.empty() && !m_stop)
+        {
+            pthread_cond_wait(&m_requested, &m_mutex);
+        }
+        if (m_stop)
+        {
+            break;
+        }
+        Built built;
+        built.key = m_requests.front();
+        m_requests.pop_front();
+        m_building = built.key;
+        m_isBuilding = true;
+
+        // Build without holding the lock, so the simulation runs on
+        pthread_mutex_unlock(&m_mutex);
+        built.pShape = m_pSource->createTile(built.key.first,
+                                             built.key.second,
+                                             m_config.tileSize,
+                                             built.transform);
+        pthread_mutex_lock(&m_mutex);
+
+        m_isBuilding = false;
+        m_finished.push_back(built);
+        pthread_cond_broadcast(&m_built);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
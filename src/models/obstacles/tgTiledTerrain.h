@@ -0,0 +1,315 @@
+/*
+ * Copyright © 2014, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#ifndef TG_TILED_TERRAIN_H
+#define TG_TILED_TERRAIN_H
+
+/**
+ * @file tgTiledTerrain.h
+ * @brief Contains the definition of class tgTiledTerrain.
+ * Unbounded terrain that is paged in around the models it tracks
+ * $Id$
+ */
+
+// This library
+#include "core/tgModel.h"
+// The Bullet Physics library
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+#include <pthread.h>
+
+// Forward declarations
+class btCollisionShape;
+class btRigidBody;
+class tgWorld;
+
+/**
+ * Terrain without bounds, divided into square tiles in the x-z plane.
+ * The tiles near the tracked models have static bodies in the world;
+ * a larger ring of tiles around them has its collision shapes built
+ * ahead of time by a background thread. Tiles farther away are
+ * dropped, so memory and the broadphase stay the same size however
+ * far the models go.
+ *
+ * Add it to the simulation with tgSimulation::addModel, after the
+ * models it tracks, so that it keeps its tiles across resets. Tiles
+ * follow the center of mass of the tracked models, or the origin if
+ * there are none.
+ */
+class tgTiledTerrain : public tgModel
+{
+public:
+
+    /**
+     * Builds the collision shape of a tile. It is called on the loading
+     * thread, so it must not touch the world or throw.
+     */
+    class TileSource
+    {
+    public:
+        virtual ~TileSource() { }
+
+        /**
+         * Build the shape of tile (i, j), which covers
+         * [i * tileSize, (i + 1) * tileSize] in x and the same with j in z.
+         * @param[in] i the index of the tile along x
+         * @param[in] j the index of the tile along z
+         * @param[in] tileSize the length of a side of the tile
+         * @param[out] transform where the shape goes in the world
+         * @return a new shape, owned by the caller, which must not need
+         * anything else to be deleted with it
+         */
+        virtual btCollisionShape* createTile(int i, int j,
+                                             double tileSize,
+                                             btTransform& transform) = 0;
+    };
+
+    /**
+     * Tiles of a height function sampled on a square grid. Samples on
+     * the edge of a tile are taken at the same points as those of its
+     * neighbor, so the tiles meet without seams.
+     */
+    class HeightfieldSource : public TileSource
+    {
+    public:
+        /**
+         * @param[in] resolution the number of samples along a side of a
+         * tile, at least 2
+         * @throw std::invalid_argument if resolution is less than 2
+         */
+        explicit HeightfieldSource(int resolution = 33);
+
+        /** The height of the terrain at (x, z) */
+        virtual double height(double x, double z) const = 0;
+
+        virtual btCollisionShape* createTile(int i, int j,
+                                             double tileSize,
+                                             btTransform& transform);
+
+    private:
+        const int m_resolution;
+    };
+
+    /**
+     * The terrain of tgHillyGround, waveHeight * sin(x / wavelength) *
+     * cos(z / wavelength) + offset, carried on forever.
+     */
+    class HillySource : public HeightfieldSource
+    {
+    public:
+        HillySource(double waveHeight = 5.0,
+                    double wavelength = 5.0,
+                    double offset = 0.5,
+                    int resolution = 33);
+
+        virtual double height(double x, double z) const;
+
+    private:
+        const double m_waveHeight;
+        const double m_wavelength;
+        const double m_offset;
+    };
+
+    struct Config
+    {
+        /**
+         * @param[in] tileSize the length of a side of a tile
+         * @param[in] activeRadius tiles within this many tiles of the
+         * center (in x and in z) have bodies in the world
+         * @param[in] prefetchRadius tiles within this many tiles of the
+         * center have their shapes built; at least activeRadius
+         * @param[in] friction the friction of the tiles
+         * @param[in] restitution the restitution of the tiles
+         * @throw std::invalid_argument if tileSize is not positive or
+         * prefetchRadius is less than activeRadius
+         */
+        Config(double tileSize = 100.0,
+               int activeRadius = 1,
+               int prefetchRadius = 2,
+               double friction = 1.0,
+               double restitution = 0.0);
+
+        double tileSize;
+        int activeRadius;
+        int prefetchRadius;
+        double friction;
+        double restitution;
+    };
+
+    /**
+     * Start the loading thread.
+     * @param[in] pSource builds the tiles; we take ownership
+     * @param[in] config the size and radii of the tiles
+     * @throw std::invalid_argument if pSource is NULL
+     * @throw std::runtime_error if the thread can't be started
+     */
+    tgTiledTerrain(TileSource* pSource, const Config& config = Config());
+
+    /** Stop the loading thread and delete the shapes and the source */
+    virtual ~tgTiledTerrain();
+
+    /**
+     * Follow a model. Its rigid bodies count toward the center that the
+     * tiles are loaded around.
+     * @param[in] pModel a model that outlives us, or whose tracking is
+     * ended with untrack()
+     * @throw std::invalid_argument if pModel is NULL
+     */
+    void track(tgModel* pModel);
+
+    /** Stop following a model */
+    void untrack(tgModel* pModel);
+
+    /**
+     * Add the bodies of the tiles around the tracked models, waiting for
+     * any that aren't built yet.
+     */
+    virtual void setup(tgWorld& world);
+
+    /**
+     * Take up the tiles the loading thread has built, and page tiles in
+     * and out if the center has moved into another tile.
+     * @param[in] dt the time step, which must be positive
+     * @throw std::invalid_argument if dt is not positive
+     */
+    virtual void step(double dt);
+
+    /**
+     * Remove the bodies of the tiles from the world. The built shapes
+     * are kept for the next setup.
+     */
+    virtual void teardown();
+
+    /** The center that tiles are loaded around */
+    btVector3 center() const;
+
+    /** The number of tiles whose shapes are built */
+    std::size_t loadedTileCount() const;
+
+    /** The number of tiles with bodies in the world */
+    std::size_t activeTileCount() const;
+
+private:
+
+    /** Not copyable: the loading thread holds a pointer to us */
+    tgTiledTerrain(const tgTiledTerrain&);
+    tgTiledTerrain& operator=(const tgTiledTerrain&);
+
+    /** The indices of a tile along x and z */
+    typedef std::pair<int, int> Key;
+
+    struct Tile
+    {
+        Tile() : pShape(NULL), pBody(NULL) { }
+
+        /** NULL until the loading thread has built it */
+        btCollisionShape* pShape;
+        btTransform transform;
+        /** NULL unless it is in the world */
+        btRigidBody* pBody;
+    };
+
+    /** A shape built by the loading thread, not yet taken up */
+    struct Built
+    {
+        Key key;
+        btCollisionShape* pShape;
+        btTransform transform;
+    };
+
+    /** The tile that a point is in */
+    Key keyOf(const btVector3& point) const;
+
+    /** The distance between tiles in tiles, along x or z, whichever is more */
+    static int distance(const Key& a, const Key& b);
+
+    /**
+     * Take up what the loading thread has built, page tiles in and out
+     * around the center, and make sure the active tiles have bodies.
+     */
+    void update();
+
+    /** Move what the loading thread has built into m_tiles */
+    void collectBuilt();
+
+    /** Whether a built shape for the tile waits in m_finished. Lock first. */
+    bool isFinished(const Key& key) const;
+
+    /** Put a tile at the front of the queue and wait until it's built */
+    void waitFor(const Key& key);
+
+    void addBody(Tile& tile);
+
+    void removeBody(Tile& tile);
+
+    /** The loading thread */
+    static void* loaderMain(void* pTerrain);
+
+    void load();
+
+    TileSource* const m_pSource;
+
+    const Config m_config;
+
+    /** The models whose rigid bodies we follow; not owned */
+    std::vector<tgModel*> m_tracked;
+
+    /** NULL between teardown and setup */
+    tgWorld* m_pWorld;
+
+    /** Every tile that is requested, built or in the world */
+    std::map<Key, Tile> m_tiles;
+
+    /** The tile of the center at the last update */
+    Key m_center;
+
+    /** Whether m_center has been set since the last setup */
+    bool m_centered;
+
+    /** The members below are shared with the loading thread */
+    pthread_mutex_t m_mutex;
+
+    /** Signalled when a request is made or the thread is to stop */
+    pthread_cond_t m_requested;
+
+    /** Signalled when a shape is built */
+    pthread_cond_t m_built;
+
+    pthread_t m_thread;
+
+    /** Tiles to build, nearest to the center first */
+    std::deque<Key> m_requests;
+
+    /** Shapes built but not yet taken up */
+    std::vector<Built> m_finished;
+
+    /** The tile the loading thread is building */
+    Key m_building;
+
+    bool m_isBuilding;
+
+    bool m_stop;
+};
+
+#endif // TG_TILED_TERRAIN_H
@@ -59,11 +59,12 @@ namespace
     };
 } // namespace
 
-Wall::Wall() : tgModel() {
+Wall::Wall() : tgModel(), m_batch(tgStaticBoxBatch::eSeparate) {
     origin = btVector3(0,0,0);
 }
 
-Wall::Wall(btVector3 center) : tgModel() {
+Wall::Wall(btVector3 center, tgStaticBoxBatch::Mode batch) :
+    tgModel(), m_batch(batch) {
     origin = btVector3(center.getX(), center.getY(), center.getZ());
 }
 
@@ -76,15 +77,23 @@ void Wall::setup(tgWorld& world) {
     tgStructure s;
     addNodes(s);
 
-    // Create the build spec that uses tags to turn the structure into a real model
-    tgBuildSpec spec;
-    spec.addBuilder("box", new tgBoxInfo(boxConfig));
+    if (m_batch == tgStaticBoxBatch::eSeparate)
+    {
+        // Create the build spec that uses tags to turn the structure into a real model
+        tgBuildSpec spec;
+        spec.addBuilder("box", new tgBoxInfo(boxConfig));
 
-    // Create your structureInfo
-    tgStructureInfo structureInfo(s, spec);
+        // Create your structureInfo
+        tgStructureInfo structureInfo(s, spec);
 
-    // Use the structureInfo to build ourselves
-    structureInfo.buildInto(*this, world);
+        // Use the structureInfo to build ourselves
+        structureInfo.buildInto(*this, world);
+    }
+    else
+    {
+        addChild(tgStaticBoxBatch::create(world, s.getPairs(), boxConfig,
+                                          m_batch, tgTags("box")));
+    }
 
     // call the onSetup methods of all observed things e.g. controllers
     notifySetup();
@@ -28,6 +28,7 @@
 // This library
 #include "core/tgModel.h"
 #include "core/tgSubject.h"
+#include "tgStaticBoxBatch.h"
 // The Bullet Physics Library
 #include "LinearMath/btVector3.h"
 // The C++ Standard Library
@@ -54,8 +55,11 @@ class Wall : public tgSubject<Wall>, public tgModel
         /**
          * Origin constructor. Sets center point to input param 'origin'.
          * @param[in] origin - the center point of the Wall object
+         * @param[in] batch - whether the boxes are separate rigid bodies,
+         * or one static body
          */
-        Wall(btVector3 origin);
+        Wall(btVector3 origin,
+             tgStaticBoxBatch::Mode batch = tgStaticBoxBatch::eSeparate);
 
         /**
          * Destructor. Deletes controllers, if any were added during setup.
@@ -108,6 +112,7 @@ class Wall : public tgSubject<Wall>, public tgModel
 
         std::vector <tgNode> nodes;
         btVector3 origin;
+        tgStaticBoxBatch::Mode m_batch;
 };
 
 #endif // TETRA_COLLISIONS_WALL
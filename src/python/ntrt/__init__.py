@@ -0,0 +1,63 @@
+"""
+NTRT simulations from Python.
+
+The state properties of Simulation are NumPy arrays that share memory
+with the simulation: they are refreshed in place by step() and cost
+nothing to read. Writing to actuator_targets drives the actuators when
+control_enabled is set; every other array is read only.
+
+An array keeps the simulation's layout frozen, so delete (or stop
+using) the arrays before calling add_yaml_model() again.
+
+step() releases the GIL, so other Python threads run meanwhile.
+Simulations in different threads step in parallel if PARALLEL_STEPPING
+is set, i.e. Bullet was built with BT_NO_PROFILE as setup.sh does;
+otherwise Bullet's global profiler makes them take turns. A simulation
+runs one call at a time: using it while another thread is in its step()
+or reset() raises RuntimeError. Each World can back only one Simulation.
+
+Example:
+
+    import ntrt
+    sim = ntrt.Simulation(ntrt.World(), step_size=0.001)
+    sim.add_yaml_model("src/dev/mcdaly/12BarTensegrity/12BarCube.yaml")
+    positions = sim.body_positions
+    sim.step(1000)
+    print(positions.mean(axis=0))
+"""
+
+import numpy
+
+from _ntrt import World, StateArray, PARALLEL_STEPPING
+from _ntrt import Simulation as _Simulation
+
+__all__ = ["World", "Simulation", "StateArray", "PARALLEL_STEPPING"]
+
+
+def _state_property(name, doc):
+    def get(self):
+        return numpy.asarray(self.state(name))
+    return property(get, doc=doc)
+
+
+class Simulation(_Simulation):
+    """Simulation(world, step_size=0.001): a headless tgSimulation."""
+
+    body_positions = _state_property(
+        "body_positions", "(num_bodies, 3) centers of mass")
+    body_orientations = _state_property(
+        "body_orientations", "(num_bodies, 4) quaternions, x y z w")
+    body_linear_velocities = _state_property(
+        "body_linear_velocities", "(num_bodies, 3)")
+    body_angular_velocities = _state_property(
+        "body_angular_velocities", "(num_bodies, 3)")
+    actuator_rest_lengths = _state_property(
+        "actuator_rest_lengths", "(num_actuators,)")
+    actuator_lengths = _state_property(
+        "actuator_lengths", "(num_actuators,)")
+    actuator_tensions = _state_property(
+        "actuator_tensions", "(num_actuators,)")
+    actuator_targets = _state_property(
+        "actuator_targets",
+        "(num_actuators,) writable rest length targets, used when "
+        "control_enabled is set")
@@ -0,0 +1,744 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file ntrtmodule.cpp
+ * @brief The _ntrt Python extension module: tgWorld, tgSimulation,
+ * YAML models and zero-copy state arrays
+ * $Id$
+ */
+
+// Python comes first, as its documentation asks
+#include <Python.h>
+// This module
+#include "tgStateBuffers.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgModel.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "yamlbuilder/TensegrityModel.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+// POSIX
+#include <pthread.h>
+
+#if PY_MAJOR_VERSION >= 3
+#define NTRT_BUFFER_FLAGS 0
+#else
+#define NTRT_BUFFER_FLAGS Py_TPFLAGS_HAVE_NEWBUFFER
+#endif
+
+namespace
+{
+
+#ifndef BT_NO_PROFILE
+    /**
+     * Bullet's profiler is one global call tree, so unless Bullet was
+     * built with BT_NO_PROFILE only one simulation may step at a time.
+     */
+    pthread_mutex_t gStepLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+    /**
+     * Held while calling into Bullet without the GIL. A no-op if
+     * simulations can step in parallel. Take it after releasing the GIL,
+     * or while holding it briefly: its holders never wait for the GIL.
+     */
+    class StepLock
+    {
+    public:
+        StepLock()
+        {
+#ifndef BT_NO_PROFILE
+            pthread_mutex_lock(&gStepLock);
+#endif
+        }
+
+        ~StepLock()
+        {
+#ifndef BT_NO_PROFILE
+            pthread_mutex_unlock(&gStepLock);
+#endif
+        }
+
+    private:
+        StepLock(const StepLock&);
+        StepLock& operator=(const StepLock&);
+    };
+
+    struct SimulationObject;
+
+    /** Python's ntrt.World: a tgWorld with a box ground */
+    struct WorldObject
+    {
+        PyObject_HEAD
+        tgWorld* pWorld;
+        /**
+         * The Simulation built on this world, if any. Not a reference:
+         * the simulation holds one on the world and clears this when it
+         * goes away.
+         */
+        SimulationObject* pOwner;
+    };
+
+    /** Python's ntrt.Simulation: a headless tgSimulation and its state */
+    struct SimulationObject
+    {
+        PyObject_HEAD
+        WorldObject* pWorld;
+        tgSimView* pView;
+        tgSimulation* pSimulation;
+        std::vector<tgModel*>* pModels;
+        tgStateBuffers* pState;
+        double stepSize;
+        /** Buffers handed out and not released; the layout is frozen */
+        Py_ssize_t exports;
+        bool controlEnabled;
+        /** Set while step() or reset() runs without the GIL */
+        bool busy;
+    };
+
+    /** The arrays a StateArray can view */
+    enum StateField
+    {
+        bodyPositions,
+        bodyOrientations,
+        bodyLinearVelocities,
+        bodyAngularVelocities,
+        actuatorRestLengths,
+        actuatorLengths,
+        actuatorTensions,
+        actuatorTargets,
+        stateFieldCount
+    };
+
+    const char* const stateFieldNames[stateFieldCount] =
+    {
+        "body_positions",
+        "body_orientations",
+        "body_linear_velocities",
+        "body_angular_velocities",
+        "actuator_rest_lengths",
+        "actuator_lengths",
+        "actuator_tensions",
+        "actuator_targets"
+    };
+
+    /**
+     * Exports one of a simulation's state buffers through the buffer
+     * protocol. The pointer is looked up when a view is taken, never
+     * stored, so a StateArray made before a model was added still works.
+     */
+    struct StateArrayObject
+    {
+        PyObject_HEAD
+        SimulationObject* pOwner;
+        StateField field;
+        Py_ssize_t shape[2];
+        Py_ssize_t strides[2];
+    };
+
+    PyTypeObject WorldType = { PyVarObject_HEAD_INIT(NULL, 0) };
+    PyTypeObject SimulationType = { PyVarObject_HEAD_INIT(NULL, 0) };
+    PyTypeObject StateArrayType = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+    /** Something to point empty buffers at */
+    double emptyBuffer[1];
+
+    /** Translate a C++ exception into a Python one; returns NULL */
+    PyObject* raise(const std::exception& e)
+    {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return NULL;
+    }
+
+    // World
+
+    int World_init(WorldObject* self, PyObject* args, PyObject* kwds)
+    {
+        static const char* keywords[] =
+            { "gravity", "world_size", "yaw", "pitch", "roll", NULL };
+        double gravity = 9.81;
+        double worldSize = 1000.0;
+        double yaw = 0.0;
+        double pitch = 0.0;
+        double roll = 0.0;
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ddddd",
+                                         const_cast<char**>(keywords),
+                                         &gravity, &worldSize,
+                                         &yaw, &pitch, &roll))
+        {
+            return -1;
+        }
+        if (self->pWorld != NULL)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "World is already initialized");
+            return -1;
+        }
+        try
+        {
+            const tgBoxGround::Config groundConfig(btVector3(yaw, pitch, roll));
+            // The world deletes the ground
+            self->pWorld = new tgWorld(tgWorld::Config(gravity, worldSize),
+                                       new tgBoxGround(groundConfig));
+        }
+        catch (const std::exception& e)
+        {
+            raise(e);
+            return -1;
+        }
+        return 0;
+    }
+
+    void World_dealloc(WorldObject* self)
+    {
+        delete self->pWorld;
+        Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+    }
+
+    // Simulation
+
+    bool isInitialized(SimulationObject* self)
+    {
+        if (self->pSimulation == NULL)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Simulation is not initialized");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Whether the simulation can be used now. busy is only read and
+     * written with the GIL held, so it needs no lock of its own.
+     */
+    bool isIdle(SimulationObject* self)
+    {
+        if (!isInitialized(self))
+        {
+            return false;
+        }
+        if (self->busy)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Simulation is in use by another thread");
+            return false;
+        }
+        return true;
+    }
+
+    /** Mark the simulation busy before releasing the GIL */
+    bool claim(SimulationObject* self)
+    {
+        if (!isIdle(self))
+        {
+            return false;
+        }
+        self->busy = true;
+        return true;
+    }
+
+    int Simulation_init(SimulationObject* self, PyObject* args, PyObject* kwds)
+    {
+        static const char* keywords[] = { "world", "step_size", NULL };
+        PyObject* world = NULL;
+        double stepSize = 1.0 / 1000.0;
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!|d",
+                                         const_cast<char**>(keywords),
+                                         &WorldType, &world, &stepSize))
+        {
+            return -1;
+        }
+        WorldObject* const pWorld = reinterpret_cast<WorldObject*>(world);
+        if (pWorld->pWorld == NULL || self->pSimulation != NULL)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "The world is not initialized, or the simulation already is");
+            return -1;
+        }
+        // Two simulations would step and reset the same Bullet world
+        if (pWorld->pOwner != NULL)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "The world already belongs to a simulation");
+            return -1;
+        }
+        try
+        {
+            self->pView = new tgSimView(*pWorld->pWorld, stepSize);
+            self->pSimulation = new tgSimulation(*self->pView);
+            self->pModels = new std::vector<tgModel*>();
+            self->pState = new tgStateBuffers();
+        }
+        catch (const std::exception& e)
+        {
+            raise(e);
+            return -1;
+        }
+        Py_INCREF(world);
+        self->pWorld = pWorld;
+        pWorld->pOwner = self;
+        self->stepSize = stepSize;
+        return 0;
+    }
+
+    void Simulation_dealloc(SimulationObject* self)
+    {
+        // The simulation deletes the models; the view outlives it
+        delete self->pSimulation;
+        delete self->pView;
+        delete self->pModels;
+        delete self->pState;
+        if (self->pWorld != NULL)
+        {
+            self->pWorld->pOwner = NULL;
+        }
+        Py_XDECREF(self->pWorld);
+        Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+    }
+
+    PyObject* Simulation_add_yaml_model(SimulationObject* self, PyObject* args)
+    {
+        const char* path = NULL;
+        if (!PyArg_ParseTuple(args, "s", &path) || !isIdle(self))
+        {
+            return NULL;
+        }
+        if (self->exports > 0)
+        {
+            PyErr_SetString(PyExc_BufferError,
+                            "Can't add a model while state arrays are in use");
+            return NULL;
+        }
+        try
+        {
+            const StepLock lock;
+            TensegrityModel* const pModel = new TensegrityModel(path);
+            self->pSimulation->addModel(pModel);
+            self->pModels->push_back(pModel);
+            self->pState->bind(*self->pModels);
+        }
+        catch (const std::exception& e)
+        {
+            return raise(e);
+        }
+        return Py_BuildValue("n", (Py_ssize_t) self->pModels->size() - 1);
+    }
+
+    PyObject* Simulation_step(SimulationObject* self, PyObject* args, PyObject* kwds)
+    {
+        static const char* keywords[] = { "steps", NULL };
+        Py_ssize_t steps = 1;
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n",
+                                         const_cast<char**>(keywords), &steps) ||
+            !claim(self))
+        {
+            return NULL;
+        }
+
+        std::string error;
+        tgSimulation& simulation = *self->pSimulation;
+        tgStateBuffers& state = *self->pState;
+        const double dt = self->stepSize;
+        const bool control = self->controlEnabled;
+        // Nothing below touches Python objects, so other Python threads
+        // (e.g. stepping other simulations) run meanwhile
+        Py_BEGIN_ALLOW_THREADS
+        try
+        {
+            const StepLock lock;
+            for (Py_ssize_t i = 0; i < steps; i++)
+            {
+                if (control)
+                {
+                    state.applyTargets(dt);
+                }
+                simulation.step(dt);
+            }
+            state.gather();
+        }
+        catch (const std::exception& e)
+        {
+            error = e.what();
+        }
+        Py_END_ALLOW_THREADS
+        self->busy = false;
+
+        if (!error.empty())
+        {
+            PyErr_SetString(PyExc_RuntimeError, error.c_str());
+            return NULL;
+        }
+        Py_RETURN_NONE;
+    }
+
+    PyObject* Simulation_reset(SimulationObject* self, PyObject*)
+    {
+        if (!claim(self))
+        {
+            return NULL;
+        }
+        std::string error;
+        bool moved = false;
+        Py_BEGIN_ALLOW_THREADS
+        try
+        {
+            const StepLock lock;
+            self->pSimulation->reset();
+            moved = self->pState->bind(*self->pModels);
+        }
+        catch (const std::exception& e)
+        {
+            error = e.what();
+        }
+        Py_END_ALLOW_THREADS
+        self->busy = false;
+
+        if (!error.empty())
+        {
+            PyErr_SetString(PyExc_RuntimeError, error.c_str());
+            return NULL;
+        }
+        // The same models rebuild the same bodies, so this is a bug
+        if (moved && self->exports > 0)
+        {
+            PyErr_SetString(PyExc_BufferError,
+                            "The state layout changed while arrays were in use");
+            return NULL;
+        }
+        Py_RETURN_NONE;
+    }
+
+    PyObject* Simulation_state(SimulationObject* self, PyObject* args)
+    {
+        const char* name = NULL;
+        if (!PyArg_ParseTuple(args, "s", &name) || !isInitialized(self))
+        {
+            return NULL;
+        }
+        int field = 0;
+        while (field < stateFieldCount &&
+               std::strcmp(name, stateFieldNames[field]) != 0)
+        {
+            field++;
+        }
+        if (field == stateFieldCount)
+        {
+            PyErr_Format(PyExc_KeyError, "No state array named %s", name);
+            return NULL;
+        }
+
+        StateArrayObject* const pArray =
+            PyObject_New(StateArrayObject, &StateArrayType);
+        if (pArray == NULL)
+        {
+            return NULL;
+        }
+        Py_INCREF(self);
+        pArray->pOwner = self;
+        pArray->field = static_cast<StateField>(field);
+        return reinterpret_cast<PyObject*>(pArray);
+    }
+
+    PyObject* Simulation_get_num_bodies(SimulationObject* self, void*)
+    {
+        return isIdle(self) ?
+            Py_BuildValue("n", (Py_ssize_t) self->pState->getNumBodies()) : NULL;
+    }
+
+    PyObject* Simulation_get_num_actuators(SimulationObject* self, void*)
+    {
+        return isIdle(self) ?
+            Py_BuildValue("n", (Py_ssize_t) self->pState->getNumActuators()) : NULL;
+    }
+
+    PyObject* Simulation_get_step_size(SimulationObject* self, void*)
+    {
+        return PyFloat_FromDouble(self->stepSize);
+    }
+
+    PyObject* Simulation_get_busy(SimulationObject* self, void*)
+    {
+        return PyBool_FromLong(self->busy);
+    }
+
+    PyObject* Simulation_get_control_enabled(SimulationObject* self, void*)
+    {
+        return PyBool_FromLong(self->controlEnabled);
+    }
+
+    int Simulation_set_control_enabled(SimulationObject* self, PyObject* value, void*)
+    {
+        const int enabled = value ? PyObject_IsTrue(value) : -1;
+        if (enabled < 0)
+        {
+            if (!PyErr_Occurred())
+            {
+                PyErr_SetString(PyExc_TypeError, "Can't delete control_enabled");
+            }
+            return -1;
+        }
+        self->controlEnabled = (enabled != 0);
+        return 0;
+    }
+
+    PyMethodDef Simulation_methods[] =
+    {
+        { "add_yaml_model", (PyCFunction) Simulation_add_yaml_model, METH_VARARGS,
+          "add_yaml_model(path) -> index\n"
+          "Build a TensegrityModel from a YAML structure file and add it." },
+        { "step", (PyCFunction) Simulation_step, METH_VARARGS | METH_KEYWORDS,
+          "step(steps=1)\n"
+          "Advance by steps physics steps without holding the GIL, then\n"
+          "refresh the state arrays. Other simulations step concurrently\n"
+          "only if PARALLEL_STEPPING is set." },
+        { "reset", (PyCFunction) Simulation_reset, METH_NOARGS,
+          "reset()\nRebuild the world and the models in their initial state." },
+        { "state", (PyCFunction) Simulation_state, METH_VARARGS,
+          "state(name) -> buffer\n"
+          "A buffer protocol view of one state array, e.g. for numpy.asarray.\n"
+          "Only actuator_targets is writable." },
+        { NULL, NULL, 0, NULL }
+    };
+
+    PyGetSetDef Simulation_getset[] =
+    {
+        { const_cast<char*>("num_bodies"), (getter) Simulation_get_num_bodies,
+          NULL, const_cast<char*>("The number of rigid bodies"), NULL },
+        { const_cast<char*>("num_actuators"), (getter) Simulation_get_num_actuators,
+          NULL, const_cast<char*>("The number of actuators"), NULL },
+        { const_cast<char*>("step_size"), (getter) Simulation_get_step_size,
+          NULL, const_cast<char*>("The physics step in seconds"), NULL },
+        { const_cast<char*>("busy"), (getter) Simulation_get_busy, NULL,
+          const_cast<char*>("Whether step() or reset() is running in another thread"), NULL },
+        { const_cast<char*>("control_enabled"),
+          (getter) Simulation_get_control_enabled,
+          (setter) Simulation_set_control_enabled,
+          const_cast<char*>("Whether actuators are driven to actuator_targets"), NULL },
+        { NULL, NULL, NULL, NULL, NULL }
+    };
+
+    // StateArray
+
+    void StateArray_dealloc(StateArrayObject* self)
+    {
+        Py_DECREF(self->pOwner);
+        PyObject_Del(self);
+    }
+
+    int StateArray_getbuffer(StateArrayObject* self, Py_buffer* view, int flags)
+    {
+        // reset() may move the buffers
+        if (self->pOwner->busy)
+        {
+            PyErr_SetString(PyExc_BufferError,
+                            "Simulation is in use by another thread");
+            view->obj = NULL;
+            return -1;
+        }
+        tgStateBuffers& state = *self->pOwner->pState;
+        const Py_ssize_t nb = state.getNumBodies();
+        const Py_ssize_t na = state.getNumActuators();
+
+        double* data = NULL;
+        int ndim = 2;
+        switch (self->field)
+        {
+        case bodyPositions:
+            data = state.bodyPositions();
+            self->shape[0] = nb;
+            self->shape[1] = 3;
+            break;
+        case bodyOrientations:
+            data = state.bodyOrientations();
+            self->shape[0] = nb;
+            self->shape[1] = 4;
+            break;
+        case bodyLinearVelocities:
+            data = state.bodyLinearVelocities();
+            self->shape[0] = nb;
+            self->shape[1] = 3;
+            break;
+        case bodyAngularVelocities:
+            data = state.bodyAngularVelocities();
+            self->shape[0] = nb;
+            self->shape[1] = 3;
+            break;
+        case actuatorRestLengths:
+            data = state.actuatorRestLengths();
+            ndim = 1;
+            break;
+        case actuatorLengths:
+            data = state.actuatorLengths();
+            ndim = 1;
+            break;
+        case actuatorTensions:
+            data = state.actuatorTensions();
+            ndim = 1;
+            break;
+        default:
+            data = state.actuatorTargets();
+            ndim = 1;
+            break;
+        }
+        if (ndim == 1)
+        {
+            self->shape[0] = na;
+        }
+        self->strides[0] = ndim == 1 ? sizeof(double) : self->shape[1] * sizeof(double);
+        self->strides[1] = sizeof(double);
+
+        const bool writable = (self->field == actuatorTargets);
+        if ((flags & PyBUF_WRITABLE) && !writable)
+        {
+            PyErr_SetString(PyExc_BufferError, "This state array is read only");
+            view->obj = NULL;
+            return -1;
+        }
+
+        view->buf = data ? data : emptyBuffer;
+        view->obj = reinterpret_cast<PyObject*>(self);
+        Py_INCREF(self);
+        view->itemsize = sizeof(double);
+        view->len = self->shape[0] * (ndim == 2 ? self->shape[1] : 1) * sizeof(double);
+        view->readonly = writable ? 0 : 1;
+        view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("d") : NULL;
+        view->ndim = ndim;
+        view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+        view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : NULL;
+        view->suboffsets = NULL;
+        view->internal = NULL;
+
+        self->pOwner->exports++;
+        return 0;
+    }
+
+    void StateArray_releasebuffer(StateArrayObject* self, Py_buffer*)
+    {
+        self->pOwner->exports--;
+    }
+
+    PyBufferProcs StateArray_buffer;
+
+    PyMethodDef module_methods[] =
+    {
+        { NULL, NULL, 0, NULL }
+    };
+
+    const char* const moduleDoc =
+        "NTRT simulations in process. Use the ntrt package, which wraps the\n"
+        "state buffers in NumPy arrays.";
+
+    /** Fill in the type objects; C++03 has no designated initializers */
+    bool readyTypes()
+    {
+        WorldType.tp_name = "_ntrt.World";
+        WorldType.tp_basicsize = sizeof(WorldObject);
+        WorldType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+        WorldType.tp_doc = "World(gravity=9.81, world_size=1000.0, yaw=0.0, pitch=0.0, roll=0.0)\n"
+                           "A tgWorld with a box ground tilted by the given angles.";
+        WorldType.tp_init = (initproc) World_init;
+        WorldType.tp_dealloc = (destructor) World_dealloc;
+        WorldType.tp_new = PyType_GenericNew;
+
+        SimulationType.tp_name = "_ntrt.Simulation";
+        SimulationType.tp_basicsize = sizeof(SimulationObject);
+        SimulationType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+        SimulationType.tp_doc = "Simulation(world, step_size=0.001)\n"
+                                "A tgSimulation without graphics.";
+        SimulationType.tp_init = (initproc) Simulation_init;
+        SimulationType.tp_dealloc = (destructor) Simulation_dealloc;
+        SimulationType.tp_new = PyType_GenericNew;
+        SimulationType.tp_methods = Simulation_methods;
+        SimulationType.tp_getset = Simulation_getset;
+
+        StateArray_buffer.bf_getbuffer = (getbufferproc) StateArray_getbuffer;
+        StateArray_buffer.bf_releasebuffer = (releasebufferproc) StateArray_releasebuffer;
+        StateArrayType.tp_name = "_ntrt.StateArray";
+        StateArrayType.tp_basicsize = sizeof(StateArrayObject);
+        StateArrayType.tp_flags = Py_TPFLAGS_DEFAULT | NTRT_BUFFER_FLAGS;
+        StateArrayType.tp_doc = "A view of one of a Simulation's state arrays.";
+        StateArrayType.tp_dealloc = (destructor) StateArray_dealloc;
+        StateArrayType.tp_as_buffer = &StateArray_buffer;
+
+        return PyType_Ready(&WorldType) >= 0 &&
+               PyType_Ready(&SimulationType) >= 0 &&
+               PyType_Ready(&StateArrayType) >= 0;
+    }
+
+    void addTypes(PyObject* module)
+    {
+        Py_INCREF(&WorldType);
+        PyModule_AddObject(module, "World", reinterpret_cast<PyObject*>(&WorldType));
+        Py_INCREF(&SimulationType);
+        PyModule_AddObject(module, "Simulation", reinterpret_cast<PyObject*>(&SimulationType));
+        Py_INCREF(&StateArrayType);
+        PyModule_AddObject(module, "StateArray", reinterpret_cast<PyObject*>(&StateArrayType));
+#ifdef BT_NO_PROFILE
+        PyModule_AddObject(module, "PARALLEL_STEPPING", PyBool_FromLong(1));
+#else
+        PyModule_AddObject(module, "PARALLEL_STEPPING", PyBool_FromLong(0));
+#endif
+    }
+
+#if PY_MAJOR_VERSION >= 3
+    PyModuleDef moduleDef =
+    {
+        PyModuleDef_HEAD_INIT, "_ntrt", moduleDoc, -1, module_methods,
+        NULL, NULL, NULL, NULL
+    };
+#endif
+
+} // namespace
+
+#if PY_MAJOR_VERSION >= 3
+PyMODINIT_FUNC PyInit__ntrt()
+{
+    if (!readyTypes())
+    {
+        return NULL;
+    }
+    PyObject* const module = PyModule_Create(&moduleDef);
+    if (module != NULL)
+    {
+        addTypes(module);
+    }
+    return module;
+}
+#else
+PyMODINIT_FUNC init_ntrt()
+{
+    if (!readyTypes())
+    {
+        return;
+    }
+    PyObject* const module = Py_InitModule3("_ntrt", module_methods, moduleDoc);
+    if (module != NULL)
+    {
+        addTypes(module);
+    }
+}
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+/**
+ * @file tgStateBuffers.cpp
+ * @brief Contains the definitions of members of class tgStateBuffers
+ * $Id$
+ */
+
+// This module
+#include "tgStateBuffers.h"
+// This library
+#include "core/tgBaseRigid.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgSpringCableActuator.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+
+tgStateBuffers::tgStateBuffers()
+{
+}
+
+bool tgStateBuffers::bind(const std::vector<tgModel*>& models)
+{
+    const std::size_t oldBodies = m_bodies.size();
+    const std::size_t oldActuators = m_actuators.size();
+
+    m_bodies.clear();
+    m_actuators.clear();
+    for (std::size_t i = 0; i < models.size(); i++)
+    {
+        std::vector<tgModel*> descendants = models[i]->getDescendants();
+        descendants.insert(descendants.begin(), models[i]);
+
+        const std::vector<tgBaseRigid*> bodies =
+            tgCast::filter<tgModel, tgBaseRigid>(descendants);
+        m_bodies.insert(m_bodies.end(), bodies.begin(), bodies.end());
+
+        const std::vector<tgSpringCableActuator*> actuators =
+            tgCast::filter<tgModel, tgSpringCableActuator>(descendants);
+        m_actuators.insert(m_actuators.end(), actuators.begin(), actuators.end());
+    }
+
+    const std::size_t nb = m_bodies.size();
+    const std::size_t na = m_actuators.size();
+    m_bodyPositions.resize(3 * nb);
+    m_bodyOrientations.resize(4 * nb);
+    m_bodyLinearVelocities.resize(3 * nb);
+    m_bodyAngularVelocities.resize(3 * nb);
+    m_actuatorRestLengths.resize(na);
+    m_actuatorLengths.resize(na);
+    m_actuatorTensions.resize(na);
+    m_actuatorTargets.resize(na);
+
+    gather();
+    for (std::size_t i = 0; i < na; i++)
+    {
+        m_actuatorTargets[i] = m_actuatorRestLengths[i];
+    }
+
+    return nb != oldBodies || na != oldActuators;
+}
+
+void tgStateBuffers::gather()
+{
+    for (std::size_t i = 0; i < m_bodies.size(); i++)
+    {
+        const btRigidBody* const pBody = m_bodies[i]->getPRigidBody();
+        assert(pBody != NULL);
+        const btVector3& p = pBody->getCenterOfMassPosition();
+        const btQuaternion q = pBody->getOrientation();
+        const btVector3& v = pBody->getLinearVelocity();
+        const btVector3& w = pBody->getAngularVelocity();
+
+        double* const position = &m_bodyPositions[3 * i];
+        position[0] = p.x();
+        position[1] = p.y();
+        position[2] = p.z();
+
+        double* const orientation = &m_bodyOrientations[4 * i];
+        orientation[0] = q.x();
+        orientation[1] = q.y();
+        orientation[2] = q.z();
+        orientation[3] = q.w();
+
+        double* const linear = &m_bodyLinearVelocities[3 * i];
+        linear[0] = v.x();
+        linear[1] = v.y();
+        linear[2] = v.z();
+
+        double* const angular = &m_bodyAngularVelocities[3 * i];
+        angular[0] = w.x();
+        angular[1] = w.y();
+        angular[2] = w.z();
+    }
+
+    for (std::size_t i = 0; i < m_actuators.size(); i++)
+    {
+        const tgSpringCableActuator* const pActuator = m_actuators[i];
+        m_actuatorRestLengths[i] = pActuator->getRestLength();
+        m_actuatorLengths[i] = pActuator->getCurrentLength();
+        m_actuatorTensions[i] = pActuator->getTension();
+    }
+}
+
+void tgStateBuffers::applyTargets(double dt)
+{
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("dt is not positive");
+    }
+    for (std::size_t i = 0; i < m_actuators.size(); i++)
+    {
+        m_actuators[i]->setControlInput(m_actuatorTargets[i], dt);
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+
+#ifndef TG_STATE_BUFFERS_H
+#define TG_STATE_BUFFERS_H
+
+/**
+ * @file tgStateBuffers.h
+ * @brief Contains the definition of class tgStateBuffers
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgBaseRigid;
+class tgModel;
+class tgSpringCableActuator;
+
+/**
+ * The state of every rigid body and actuator of a set of models, copied
+ * into contiguous arrays so it can be read (e.g. by Python, as NumPy
+ * views) without walking the model tree. Bodies and actuators are in
+ * model order, then tgModel::getDescendants() order.
+ *
+ * Buffers keep their addresses across bind() as long as the number of
+ * bodies and actuators does not change, so views stay valid across
+ * tgSimulation::reset().
+ */
+class tgStateBuffers
+{
+public:
+
+    tgStateBuffers();
+
+    /**
+     * Find the bodies and actuators of the models. Call after the models
+     * are set up, and again after every reset. Actuator targets are set
+     * to the rest lengths.
+     * @return true if the number of bodies or actuators changed, in
+     * which case the buffers may have moved
+     */
+    bool bind(const std::vector<tgModel*>& models);
+
+    /** Copy the current state into the buffers */
+    void gather();
+
+    /**
+     * Drive every actuator toward its target rest length, as a
+     * controller would on each step.
+     * @param[in] dt the step size; must be positive
+     */
+    void applyTargets(double dt);
+
+    std::size_t getNumBodies() const
+    {
+        return m_bodies.size();
+    }
+
+    std::size_t getNumActuators() const
+    {
+        return m_actuators.size();
+    }
+
+    /** getNumBodies() rows of x, y, z of the center of mass */
+    double* bodyPositions() { return data(m_bodyPositions); }
+    /** getNumBodies() rows of the x, y, z, w orientation quaternion */
+    double* bodyOrientations() { return data(m_bodyOrientations); }
+    /** getNumBodies() rows of x, y, z */
+    double* bodyLinearVelocities() { return data(m_bodyLinearVelocities); }
+    /** getNumBodies() rows of x, y, z */
+    double* bodyAngularVelocities() { return data(m_bodyAngularVelocities); }
+
+    /** One value per actuator */
+    double* actuatorRestLengths() { return data(m_actuatorRestLengths); }
+    double* actuatorLengths() { return data(m_actuatorLengths); }
+    double* actuatorTensions() { return data(m_actuatorTensions); }
+    /** Target rest lengths used by applyTargets; written by the caller */
+    double* actuatorTargets() { return data(m_actuatorTargets); }
+
+private:
+
+    static double* data(std::vector<double>& v)
+    {
+        return v.empty() ? NULL : &v[0];
+    }
+
+    std::vector<tgBaseRigid*> m_bodies;
+    std::vector<tgSpringCableActuator*> m_actuators;
+
+    std::vector<double> m_bodyPositions;
+    std::vector<double> m_bodyOrientations;
+    std::vector<double> m_bodyLinearVelocities;
+    std::vector<double> m_bodyAngularVelocities;
+
+    std::vector<double> m_actuatorRestLengths;
+    std::vector<double> m_actuatorLengths;
+    std::vector<double> m_actuatorTensions;
+    std::vector<double> m_actuatorTargets;
+};
+
+#endif  // TG_STATE_BUFFERS_H
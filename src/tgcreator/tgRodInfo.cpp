@@ -102,13 +102,12 @@ btCollisionShape* tgRodInfo::getCollisionShape(tgWorld& world) const
     {
         const double radius = m_config.radius;
         const double length = getLength();
-        m_collisionShape =
-            new btCylinderShape(btVector3(radius, length / 2.0, radius));
     
-        // Add the collision shape to the array so we can delete it later
+        // Rods of the same size share one shape, owned by the world
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
-        bulletWorld.addCollisionShape(m_collisionShape);
+        m_collisionShape =
+            bulletWorld.getCylinderShape(btVector3(radius, length / 2.0, radius));
     }
     return m_collisionShape;
 }
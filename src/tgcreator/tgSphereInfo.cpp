@@ -102,13 +102,11 @@ btCollisionShape* tgSphereInfo::getCollisionShape(tgWorld& world) const
     if (m_collisionShape == NULL) 
     {
         const double radius = m_config.radius;
-        m_collisionShape =
-            new btSphereShape(radius);
     
-        // Add the collision shape to the array so we can delete it later
+        // Spheres of the same size share one shape, owned by the world
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
-        bulletWorld.addCollisionShape(m_collisionShape);
+        m_collisionShape = bulletWorld.getSphereShape(radius);
     }
     return m_collisionShape;
 }
@@ -33,62 +33,139 @@
 #include <LinearMath/btQuaternion.h>
 #include <LinearMath/btVector3.h>
  
-tgStructure::tgStructure() : tgTaggable() 
+tgStructure::Transform::Transform() :
+    scale(1.0),
+    rotation(btQuaternion::getIdentity()),
+    translation(0.0, 0.0, 0.0)
+{
+}
+
+btVector3 tgStructure::Transform::apply(const btVector3& v) const
+{
+    return scale * quatRotate(rotation, v) + translation;
+}
+
+void tgStructure::Transform::append(const Transform& t)
+{
+    scale *= t.scale;
+    rotation = t.rotation * rotation;
+    // Keep repeated rotations from drifting off the unit sphere
+    rotation.normalize();
+    translation = t.apply(translation);
+}
+
+tgStructure::Body::Body(const Body& orig) :
+    nodes(orig.nodes),
+    pairs(orig.pairs),
+    children(orig.children.size())
+{
+    for (std::size_t i = 0; i < orig.children.size(); ++i) {
+        children[i] = new tgStructure(*orig.children[i]);
+    }
+}
+
+tgStructure::Body::~Body()
+{
+    for (std::size_t i = 0; i < children.size(); ++i)
+    {
+        delete children[i];
+    }
+}
+
+tgStructure::tgStructure() : tgTaggable(),
+        m_body(new Body()), m_transformed(false)
 {
 }
 
 
 /**
- * Copy constructor
+ * Copy constructor. Shares the body of the original, so it takes constant
+ * time whatever the size of the original.
  */
 tgStructure::tgStructure(const tgStructure& orig) : tgTaggable(orig.getTags()), 
-        m_children(orig.m_children.size()), m_nodes(orig.m_nodes), m_pairs(orig.m_pairs)
+        m_body(orig.m_body), m_transform(orig.m_transform),
+        m_transformed(orig.m_transformed)
 {
-    
-    // Copy children
-    for (std::size_t i = 0; i < orig.m_children.size(); ++i) {
-        m_children[i] = new tgStructure(*orig.m_children[i]);
-    }
 }
 
-tgStructure::tgStructure(const tgTags& tags) : tgTaggable(tags)
+tgStructure::tgStructure(const tgTags& tags) : tgTaggable(tags),
+        m_body(new Body()), m_transformed(false)
 {
 }
 
-tgStructure::tgStructure(const std::string& space_separated_tags) : tgTaggable(space_separated_tags)
+tgStructure::tgStructure(const std::string& space_separated_tags) : tgTaggable(space_separated_tags),
+        m_body(new Body()), m_transformed(false)
 {
 }
 
 tgStructure::~tgStructure()
 {
-    for (std::size_t i = 0; i < m_children.size(); ++i)
+}
+
+void tgStructure::materialize() const
+{
+    if (!m_body.unique())
+    {
+        m_body.reset(new Body(*m_body));
+    }
+    if (m_transformed)
     {
-        delete m_children[i];
+        std::vector<tgNode>& nodes = m_body->nodes.getNodes();
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            // Keep the node's tags
+            static_cast<btVector3&>(nodes[i]) = m_transform.apply(nodes[i]);
+        }
+        std::vector<tgPair>& pairs = m_body->pairs.getPairs();
+        for (std::size_t i = 0; i < pairs.size(); ++i)
+        {
+            pairs[i].setFrom(m_transform.apply(pairs[i].getFrom()));
+            pairs[i].setTo(m_transform.apply(pairs[i].getTo()));
+        }
+        // The children are ours now, so pass the transform down to them
+        for (std::size_t i = 0; i < m_body->children.size(); ++i)
+        {
+            tgStructure * const pStructure = m_body->children[i];
+            assert(pStructure != NULL);
+            pStructure->addTransform(m_transform);
+        }
+        m_transform = Transform();
+        m_transformed = false;
     }
 }
 
+void tgStructure::addTransform(const Transform& t)
+{
+    m_transform.append(t);
+    m_transformed = true;
+}
+
 void tgStructure::addNode(double x, double y, double z, std::string tags)
 {
-    m_nodes.addNode(x, y, z, tags);
+    materialize();
+    m_body->nodes.addNode(x, y, z, tags);
 }
 
 void tgStructure::addNode(tgNode& newNode)
 {
-    m_nodes.addNode(newNode);
+    materialize();
+    m_body->nodes.addNode(newNode);
 }
 
 void tgStructure::addPair(int fromNodeIdx, int toNodeIdx, std::string tags)
 {
-    addPair(m_nodes[fromNodeIdx], m_nodes[toNodeIdx], tags);
+    materialize();
+    addPair(m_body->nodes[fromNodeIdx], m_body->nodes[toNodeIdx], tags);
 }
 
 void tgStructure::addPair(const btVector3& from, const btVector3& to, std::string tags)
 {
+    materialize();
     // @todo: do we need to pass in tags here? might be able to save some proc time if not...
     tgPair p = tgPair(from, to);
-    if (!m_pairs.contains(p))
+    if (!m_body->pairs.contains(p))
     {
-        m_pairs.addPair(tgPair(from, to, tags));
+        m_body->pairs.addPair(tgPair(from, to, tags));
     }
     else
     {
@@ -99,22 +176,18 @@ void tgStructure::addPair(const btVector3& from, const btVector3& to, std::strin
 }
 
 void tgStructure::removePair(const tgPair& pair) {
-    m_pairs.removePair(pair);
-    for (unsigned int i = 0; i < m_children.size(); i++) {
-        m_children[i]->removePair(pair);
+    materialize();
+    m_body->pairs.removePair(pair);
+    for (unsigned int i = 0; i < m_body->children.size(); i++) {
+        m_body->children[i]->removePair(pair);
     }
 }
 
 void tgStructure::move(const btVector3& offset)
 {
-    m_nodes.move(offset);
-    m_pairs.move(offset);
-    for (size_t i = 0; i < m_children.size(); ++i)
-    {
-        tgStructure * const pStructure = m_children[i];
-    assert(pStructure != NULL);
-        pStructure->move(offset);
-    }
+    Transform t;
+    t.translation = offset;
+    addTransform(t);
 }
 
 void tgStructure::addRotation(const btVector3& fixedPoint,
@@ -137,15 +210,11 @@ void tgStructure::addRotation(const btVector3& fixedPoint,
 void tgStructure::addRotation(const btVector3& fixedPoint,
                  const btQuaternion& rotation)
 {
-    m_nodes.addRotation(fixedPoint, rotation);
-    m_pairs.addRotation(fixedPoint, rotation);
-
-    for (std::size_t i = 0; i < m_children.size(); ++i)
-    {
-        tgStructure * const pStructure = m_children[i];
-    assert(pStructure != NULL);
-        pStructure->addRotation(fixedPoint, rotation);
-    }
+    // Rotate about fixedPoint: v -> rotation(v - fixedPoint) + fixedPoint
+    Transform t;
+    t.rotation = rotation.normalized();
+    t.translation = fixedPoint - quatRotate(t.rotation, fixedPoint);
+    addTransform(t);
 }
 
 void tgStructure::scale(double scaleFactor) {
@@ -154,14 +223,11 @@ void tgStructure::scale(double scaleFactor) {
 }
 
 void tgStructure::scale(const btVector3& referencePoint, double scaleFactor) {
-    m_nodes.scale(referencePoint, scaleFactor);
-    m_pairs.scale(referencePoint, scaleFactor);
-
-    for (int i = 0; i < m_children.size(); i++) {
-        tgStructure* const childStructure = m_children[i];
-        assert(childStructure != NULL);
-        childStructure->scale(referencePoint, scaleFactor);
-    }
+    // v -> (v - referencePoint) * scaleFactor + referencePoint
+    Transform t;
+    t.scale = scaleFactor;
+    t.translation = referencePoint * (1.0 - scaleFactor);
+    addTransform(t);
 }
 
 void tgStructure::addChild(tgStructure* pChild)
@@ -172,74 +238,147 @@ void tgStructure::addChild(tgStructure* pChild)
     /// structure may build the pairs, while another may not depending on its tags.
     if (pChild != NULL)
     {
-        m_children.push_back(pChild);
+        // Our pending transform must not reach the new child
+        materialize();
+        m_body->children.push_back(pChild);
     }
 }
 
 void tgStructure::addChild(const tgStructure& child)
 {
-    m_children.push_back(new tgStructure(child));
-    
+    addChild(new tgStructure(child));
 }
 
 btVector3 tgStructure::getCentroid() const {
     btVector3 centroid = btVector3(0, 0, 0);
     int numNodes = 0;
-    std::queue< const tgStructure*> q;
+    sumNodes(Transform(), centroid, numNodes);
+    return centroid/numNodes;
+}
 
-    q.push(this);
+void tgStructure::sumNodes(const Transform& outer, btVector3& sum,
+                           int& count) const
+{
+    Transform t = m_transform;
+    t.append(outer);
+    const tgNodes& nodes = m_body->nodes;
+    for (int i = 0; i < nodes.size(); i++) {
+        sum += t.apply(nodes[i]);
+        count++;
+    }
+    for (std::size_t i = 0; i < m_body->children.size(); i++) {
+        m_body->children[i]->sumNodes(t, sum, count);
+    }
+}
 
-    while (!q.empty()) {
-        const tgStructure* structure = q.front();
-        q.pop();
-        for (int i = 0; i < structure->m_nodes.size(); i++) {
-            centroid += structure->m_nodes[i];
-            numNodes++;
-        }
-        for (int i = 0; i < structure->m_children.size(); i++) {
-            q.push(structure->m_children[i]);
+/**
+ * What materializing the path to the structure would do to its nodes and
+ * pairs: its own pending transform, followed by its ancestors' if any of
+ * them are transformed.
+ */
+struct tgStructure::SearchEntry
+{
+    const tgStructure* structure;
+    /** The parent's entry, or -1 for the root */
+    int parent;
+    /** The index among the parent's children */
+    std::size_t child;
+    Transform transform;
+    bool transformed;
+};
+
+void tgStructure::queueChildren(std::vector<SearchEntry>& entries, std::size_t i)
+{
+    const std::vector<tgStructure*>& children =
+        entries[i].structure->m_body->children;
+    for (std::size_t k = 0; k < children.size(); k++) {
+        SearchEntry entry;
+        entry.structure = children[k];
+        entry.parent = static_cast<int>(i);
+        entry.child = k;
+        entry.transform = children[k]->m_transform;
+        entry.transformed = children[k]->m_transformed;
+        // As materialize() hands a parent's transform down
+        if (entries[i].transformed) {
+            entry.transform.append(entries[i].transform);
+            entry.transformed = true;
         }
+        entries.push_back(entry);
     }
-    return centroid/numNodes;
 }
 
-tgNode& tgStructure::findNode(const std::string& tags) {
-    std::queue<tgStructure*> q;
-
-    q.push(this);
+tgStructure& tgStructure::materializePath(const std::vector<SearchEntry>& entries,
+                                          std::size_t i)
+{
+    std::vector<std::size_t> path;
+    for (int e = static_cast<int>(i); entries[e].parent >= 0; e = entries[e].parent) {
+        path.push_back(entries[e].child);
+    }
+    tgStructure* structure = const_cast<tgStructure*>(entries[0].structure);
+    for (std::size_t k = path.size(); k > 0; k--) {
+        structure->materialize();
+        structure = structure->m_body->children[path[k - 1]];
+    }
+    return *structure;
+}
 
-    while (!q.empty()) {
-        tgStructure* structure = q.front();
-        q.pop();
-        for (int i = 0; i < structure->m_nodes.size(); i++) {
-            if (structure->m_nodes[i].hasAllTags(tags)) {
-                return structure->m_nodes[i];
+tgNode& tgStructure::findNode(const std::string& tags) {
+    // Split and look up the search once, not for every node
+    std::vector<int> atoms;
+    if (!tgTags::atomsOf(tags, atoms)) {
+        // A tag no tgTags has held can't be on any node
+        throw std::invalid_argument("Node not found: " + tags);
+    }
+    std::vector<SearchEntry> entries(1);
+    entries[0].structure = this;
+    entries[0].parent = -1;
+    entries[0].child = 0;
+    entries[0].transformed = false;
+
+    // Tags don't depend on the transforms, so nothing is materialized
+    // until we know which structure holds the node
+    for (std::size_t e = 0; e < entries.size(); e++) {
+        const tgNodes& nodes = entries[e].structure->m_body->nodes;
+        for (int i = 0; i < nodes.size(); i++) {
+            if (nodes[i].getTags().containsAtoms(atoms)) {
+                // The caller may change what we return
+                tgStructure& structure = materializePath(entries, e);
+                structure.materialize();
+                return structure.m_body->nodes[i];
             }
         }
-        for (int i = 0; i < structure->m_children.size(); i++) {
-            q.push(structure->m_children[i]);
-        }
+        queueChildren(entries, e);
     }
     throw std::invalid_argument("Node not found: " + tags);
 }
 
 tgPair& tgStructure::findPair(const btVector3& from, const btVector3& to) {
-    std::queue<tgStructure*> q;
-
-    q.push(this);
-
-    while (!q.empty()) {
-        tgStructure* structure = q.front();
-        q.pop();
-        for (int i = 0; i < structure->m_pairs.size(); i++) {
-            if ((structure->m_pairs[i].getFrom() == from && structure->m_pairs[i].getTo() == to) ||
-                (structure->m_pairs[i].getFrom() == to && structure->m_pairs[i].getTo() == from)) {
-                return structure->m_pairs[i];
+    std::vector<SearchEntry> entries(1);
+    entries[0].structure = this;
+    entries[0].parent = -1;
+    entries[0].child = 0;
+    entries[0].transform = m_transform;
+    entries[0].transformed = m_transformed;
+
+    for (std::size_t e = 0; e < entries.size(); e++) {
+        const SearchEntry& entry = entries[e];
+        const tgPairs& pairs = entry.structure->m_body->pairs;
+        for (int i = 0; i < pairs.size(); i++) {
+            // Where the pair will be once materialized
+            btVector3 pairFrom = pairs[i].getFrom();
+            btVector3 pairTo = pairs[i].getTo();
+            if (entry.transformed) {
+                pairFrom = entry.transform.apply(pairFrom);
+                pairTo = entry.transform.apply(pairTo);
+            }
+            if ((pairFrom == from && pairTo == to) ||
+                (pairFrom == to && pairTo == from)) {
+                tgStructure& structure = materializePath(entries, e);
+                structure.materialize();
+                return structure.m_body->pairs[i];
             }
         }
-        for (int i = 0; i < structure->m_children.size(); i++) {
-            q.push(structure->m_children[i]);
-        }
+        queueChildren(entries, e);
     }
     std::ostringstream pairString;
     pairString << from << ", " << to;
@@ -247,21 +386,23 @@ tgPair& tgStructure::findPair(const btVector3& from, const btVector3& to) {
 }
 
 tgStructure& tgStructure::findChild(const std::string& tags) {
-    std::queue<tgStructure*> q;
-
-    for (int i = 0; i < m_children.size(); i++) {
-        q.push(m_children[i]);
+    std::vector<int> atoms;
+    if (!tgTags::atomsOf(tags, atoms)) {
+        throw std::invalid_argument("Child structure not found: " + tags);
     }
-
-    while (!q.empty()) {
-        tgStructure* structure = q.front();
-        q.pop();
-        if (structure->hasAllTags(tags)) {
-            return *structure;
-        }
-        for (int i = 0; i < structure->m_children.size(); i++) {
-            q.push(structure->m_children[i]);
+    std::vector<SearchEntry> entries(1);
+    entries[0].structure = this;
+    entries[0].parent = -1;
+    entries[0].child = 0;
+    entries[0].transformed = false;
+
+    for (std::size_t e = 0; e < entries.size(); e++) {
+        // We aren't our own child
+        if (e > 0 && entries[e].structure->getTags().containsAtoms(atoms)) {
+            // Only the path to what we return needs to be ours
+            return materializePath(entries, e);
         }
+        queueChildren(entries, e);
     }
     throw std::invalid_argument("Child structure not found: " + tags);
 }
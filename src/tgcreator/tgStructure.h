@@ -32,14 +32,16 @@
 #include "tgPairs.h"
 // The NTRT Core Library
 #include "core/tgTaggable.h"
+// The Bullet Physics library
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btVector3.h"
 // The C++ Standard Library
 #include <string>
 #include <vector>
 #include <queue>
+#include <tr1/memory>
 
 // Forward declarations
-class btQuaternion;
-class btVector3;
 class tgNode;
 class tgTags;
 
@@ -50,6 +52,14 @@ class tgTags;
  * create physical representations of the structures with rods, muscles, etc.
  * Note that tags can be anything you want -- you'll specify the tags that you 
  * want to use to build things like rods or muscles during the build phase.
+ *
+ * Copies are instances: a copy shares the nodes, pairs and children of the
+ * original, and move(), addRotation() and scale() only compose a pending
+ * transform. The shared parts are copied, and the transform applied, the
+ * first time a structure is changed or its nodes, pairs or children are
+ * read. So a spine of N copies of a segment holds one segment until it is
+ * built. References returned by the getters and finders stay valid until
+ * the structure is copied or changed.
  */
 class tgStructure : public tgTaggable
 {
@@ -123,11 +133,14 @@ public:
     void scale(const btVector3& referencePoint, double scaleFactor);
 
     /**
-     * Add a child structure. Note that this will be copied rather than
-     * being a reference or a pointer.
+     * Add a child structure, which we will own.
      */
     void addChild(tgStructure* child);    
 
+    /**
+     * Add a copy of a child structure. Copying is cheap, since the copy
+     * shares the child's nodes, pairs and children.
+     */
     void addChild(const tgStructure& child);
 
     /**
@@ -137,7 +150,8 @@ public:
      */
     const tgNodes& getNodes() const
     {
-        return m_nodes;
+        materialize();
+        return m_body->nodes;
     }
 
     /**
@@ -164,7 +178,8 @@ public:
      */
     const tgPairs& getPairs() const
     {
-        return m_pairs;
+        materialize();
+        return m_body->pairs;
     }
 
     /**
@@ -183,7 +198,8 @@ public:
      */
     const std::vector<tgStructure*>& getChildren() const
     {
-        return m_children;
+        materialize();
+        return m_body->children;
     }
 
     /**
@@ -198,12 +214,83 @@ public:
 
 private:
 
-    tgNodes m_nodes;
+    /** A similarity transform, v -> scale * rotation(v) + translation */
+    struct Transform
+    {
+        Transform();
+
+        btVector3 apply(const btVector3& v) const;
+
+        /** Follow this transform by t */
+        void append(const Transform& t);
+
+        double scale;
+        btQuaternion rotation;
+        btVector3 translation;
+    };
+
+    /** The nodes, pairs and children, which copies share until changed */
+    struct Body
+    {
+        Body() {}
+
+        /** Copies the children, which share their own bodies */
+        Body(const Body& orig);
+
+        ~Body();
+
+        tgNodes nodes;
+
+        tgPairs pairs;
+
+        // we own these
+        std::vector<tgStructure*> children;
+
+    private:
+        Body& operator=(const Body&);
+    };
+
+    /**
+     * Take a copy of the body if it is shared, then apply the pending
+     * transform to it. Logically const, since what the getters return
+     * doesn't change.
+     */
+    void materialize() const;
+
+    /** Follow the pending transform by t, without touching the body */
+    void addTransform(const Transform& t);
+
+    /** A structure reached by a search, and how the search got there */
+    struct SearchEntry;
+
+    /**
+     * Queue the children of entries[i] for a breadth first search,
+     * without materializing anything
+     */
+    static void queueChildren(std::vector<SearchEntry>& entries, std::size_t i);
+
+    /**
+     * Materialize the structures from the root of the search down to the
+     * parent of entries[i], so the structure found there is no longer
+     * shared with any copy of us. Structures off that path stay shared.
+     * @return the structure of entries[i], now reachable only through us
+     */
+    static tgStructure& materializePath(const std::vector<SearchEntry>& entries,
+                                        std::size_t i);
+
+    /**
+     * Add up our nodes and our children's, transformed by our pending
+     * transform followed by outer, without materializing
+     */
+    void sumNodes(const Transform& outer, btVector3& sum, int& count) const;
+
+    mutable std::tr1::shared_ptr<Body> m_body;
 
-    tgPairs m_pairs;
+    /** Not yet applied to m_body */
+    mutable Transform m_transform;
 
-    // we own these
-    std::vector<tgStructure*> m_children;
+    /** Whether m_transform may differ from the identity */
+    mutable bool m_transformed;
     
 };
 
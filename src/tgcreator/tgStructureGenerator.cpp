@@ -0,0 +1,299 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgStructureGenerator.cpp
+ * @brief Implementation of class tgStructureGenerator
+ * $Id$
+ */
+
+// This module
+#include "tgStructureGenerator.h"
+// This library
+#include "tgStructure.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    void checkSizes(int nx, int ny, int nz)
+    {
+        if (nx <= 0 || ny <= 0 || nz <= 0)
+        {
+            throw std::invalid_argument("lattice size is not positive");
+        }
+    }
+
+    /**
+     * Add a node to the module, keeping its position, since the module's
+     * copies are joined by where their nodes will be.
+     */
+    void addNode(tgStructure& module, std::vector<btVector3>& nodes,
+                 double x, double y, double z)
+    {
+        module.addNode(x, y, z);
+        nodes.push_back(btVector3(x, y, z));
+    }
+
+    /** Add a copy of the module at offset */
+    void addModule(tgStructure& structure, const tgStructure& module,
+                   const btVector3& offset)
+    {
+        tgStructure* const pCopy = new tgStructure(module);
+        pCopy->move(offset);
+        structure.addChild(pCopy);
+    }
+
+    /** Join node a of the module at offsetA to node b of the one at offsetB */
+    void join(tgStructure& structure, const std::vector<btVector3>& nodes,
+              const btVector3& offsetA, int a,
+              const btVector3& offsetB, int b,
+              const std::string& tags)
+    {
+        structure.addPair(nodes[a] + offsetA, nodes[b] + offsetB, tags);
+    }
+}
+
+tgStructureGenerator::Config::Config(double length,
+                                     double gap,
+                                     const std::string& rodTags,
+                                     const std::string& cableTags) :
+    length(length),
+    gap(gap),
+    rodTags(rodTags),
+    cableTags(cableTags)
+{
+    if (length <= 0.0)
+    {
+        throw std::invalid_argument("length is not positive");
+    }
+    else if (gap <= 0.0)
+    {
+        throw std::invalid_argument("gap is not positive");
+    }
+}
+
+void tgStructureGenerator::addPrismLattice(tgStructure& structure,
+                                           int nx, int ny, int nz,
+                                           const Config& config)
+{
+    checkSizes(nx, ny, nz);
+
+    // The same prism as PrismModel, sized so the rods are config.length
+    const double edge = config.length / std::sqrt(2.0);
+    const double height = edge;
+    const double width = edge * std::sqrt(3.0) / 2.0;
+
+    tgStructure prism;
+    std::vector<btVector3> nodes;
+    addNode(prism, nodes, -edge / 2.0, 0, 0);
+    addNode(prism, nodes,  edge / 2.0, 0, 0);
+    addNode(prism, nodes, 0, 0, width);
+    addNode(prism, nodes, -edge / 2.0, height, 0);
+    addNode(prism, nodes,  edge / 2.0, height, 0);
+    addNode(prism, nodes, 0, height, width);
+
+    prism.addPair(0, 4, config.rodTags);
+    prism.addPair(1, 5, config.rodTags);
+    prism.addPair(2, 3, config.rodTags);
+
+    prism.addPair(0, 1, config.cableTags);
+    prism.addPair(1, 2, config.cableTags);
+    prism.addPair(2, 0, config.cableTags);
+    prism.addPair(3, 4, config.cableTags);
+    prism.addPair(4, 5, config.cableTags);
+    prism.addPair(5, 3, config.cableTags);
+    prism.addPair(0, 3, config.cableTags);
+    prism.addPair(1, 4, config.cableTags);
+    prism.addPair(2, 5, config.cableTags);
+
+    const btVector3 stepX(edge + config.gap, 0, 0);
+    const btVector3 stepY(0, height + config.gap, 0);
+    const btVector3 stepZ(0, 0, width + config.gap);
+
+    const std::string& tags = config.cableTags;
+    for (int i = 0; i < nx; ++i)
+    {
+        for (int j = 0; j < ny; ++j)
+        {
+            for (int k = 0; k < nz; ++k)
+            {
+                const btVector3 offset = i * stepX + j * stepY + k * stepZ;
+                addModule(structure, prism, offset);
+
+                if (j + 1 < ny)
+                {
+                    // Top triangle to the bottom triangle above
+                    const btVector3 above = offset + stepY;
+                    join(structure, nodes, offset, 3, above, 0, tags);
+                    join(structure, nodes, offset, 4, above, 1, tags);
+                    join(structure, nodes, offset, 5, above, 2, tags);
+                }
+                if (i + 1 < nx)
+                {
+                    // The +x edge to the -x edge beside it
+                    const btVector3 beside = offset + stepX;
+                    join(structure, nodes, offset, 1, beside, 0, tags);
+                    join(structure, nodes, offset, 4, beside, 3, tags);
+                }
+                if (k + 1 < nz)
+                {
+                    // The apex of each triangle to the base of the next
+                    const btVector3 behind = offset + stepZ;
+                    join(structure, nodes, offset, 2, behind, 0, tags);
+                    join(structure, nodes, offset, 2, behind, 1, tags);
+                    join(structure, nodes, offset, 5, behind, 3, tags);
+                    join(structure, nodes, offset, 5, behind, 4, tags);
+                }
+            }
+        }
+    }
+}
+
+void tgStructureGenerator::addSpine(tgStructure& structure, int segments,
+                                    const Config& config)
+{
+    if (segments <= 0)
+    {
+        throw std::invalid_argument("segments is not positive");
+    }
+
+    // An equilateral base whose corners are config.length from the tip
+    const double radius = config.length / std::sqrt(2.0);
+    const double depth = config.length / std::sqrt(2.0);
+
+    tgStructure vertebra;
+    std::vector<btVector3> nodes;
+    for (int i = 0; i < 3; ++i)
+    {
+        const double angle = M_PI / 2.0 + i * 2.0 * M_PI / 3.0;
+        addNode(vertebra, nodes,
+                radius * std::cos(angle), radius * std::sin(angle), 0);
+    }
+    addNode(vertebra, nodes, 0, 0, depth);
+
+    vertebra.addPair(0, 3, config.rodTags);
+    vertebra.addPair(1, 3, config.rodTags);
+    vertebra.addPair(2, 3, config.rodTags);
+
+    const btVector3 step(0, 0, depth + config.gap);
+
+    const std::string& tags = config.cableTags;
+    for (int i = 0; i < segments; ++i)
+    {
+        const btVector3 offset = i * step;
+        addModule(structure, vertebra, offset);
+
+        if (i + 1 < segments)
+        {
+            const btVector3 next = offset + step;
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                // Saddle cables from the base, and the tip to the next base
+                join(structure, nodes, offset, corner, next, corner, tags);
+                join(structure, nodes, offset, 3, next, corner, tags);
+            }
+        }
+    }
+}
+
+void tgStructureGenerator::addIcosahedronLattice(tgStructure& structure,
+                                                 int nx, int ny, int nz,
+                                                 const Config& config)
+{
+    checkSizes(nx, ny, nz);
+
+    // The nodes, rods and cables of T6Model
+    const double half = config.length / 2.0;
+    const double space = config.length / 4.0;
+
+    tgStructure icosahedron;
+    std::vector<btVector3> nodes;
+    addNode(icosahedron, nodes, -space, -half, 0);      // 0
+    addNode(icosahedron, nodes, -space,  half, 0);      // 1
+    addNode(icosahedron, nodes,  space, -half, 0);      // 2
+    addNode(icosahedron, nodes,  space,  half, 0);      // 3
+    addNode(icosahedron, nodes, 0, -space, -half);      // 4
+    addNode(icosahedron, nodes, 0, -space,  half);      // 5
+    addNode(icosahedron, nodes, 0,  space, -half);      // 6
+    addNode(icosahedron, nodes, 0,  space,  half);      // 7
+    addNode(icosahedron, nodes, -half, 0,  space);      // 8
+    addNode(icosahedron, nodes,  half, 0,  space);      // 9
+    addNode(icosahedron, nodes, -half, 0, -space);      // 10
+    addNode(icosahedron, nodes,  half, 0, -space);      // 11
+
+    for (int i = 0; i < 12; i += 2)
+    {
+        icosahedron.addPair(i, i + 1, config.rodTags);
+    }
+
+    static const int cables[24][2] = {
+        {0, 4}, {0, 5}, {0, 8}, {0, 10},
+        {1, 6}, {1, 7}, {1, 8}, {1, 10},
+        {2, 4}, {2, 5}, {2, 9}, {2, 11},
+        {3, 7}, {3, 6}, {3, 9}, {3, 11},
+        {4, 10}, {4, 11}, {5, 8}, {5, 9},
+        {6, 10}, {6, 11}, {7, 8}, {7, 9}
+    };
+    for (int i = 0; i < 24; ++i)
+    {
+        icosahedron.addPair(cables[i][0], cables[i][1], config.cableTags);
+    }
+
+    // Start at the origin rather than centered on it
+    const btVector3 corner(half, half, half);
+    const double pitch = config.length + config.gap;
+    const btVector3 stepX(pitch, 0, 0);
+    const btVector3 stepY(0, pitch, 0);
+    const btVector3 stepZ(0, 0, pitch);
+
+    const std::string& tags = config.cableTags;
+    for (int i = 0; i < nx; ++i)
+    {
+        for (int j = 0; j < ny; ++j)
+        {
+            for (int k = 0; k < nz; ++k)
+            {
+                const btVector3 offset =
+                    corner + i * stepX + j * stepY + k * stepZ;
+                addModule(structure, icosahedron, offset);
+
+                // The rod ends at +half to those at -half of the neighbor
+                if (i + 1 < nx)
+                {
+                    join(structure, nodes, offset, 9, offset + stepX, 8, tags);
+                    join(structure, nodes, offset, 11, offset + stepX, 10, tags);
+                }
+                if (j + 1 < ny)
+                {
+                    join(structure, nodes, offset, 1, offset + stepY, 0, tags);
+                    join(structure, nodes, offset, 3, offset + stepY, 2, tags);
+                }
+                if (k + 1 < nz)
+                {
+                    join(structure, nodes, offset, 5, offset + stepZ, 4, tags);
+                    join(structure, nodes, offset, 7, offset + stepZ, 6, tags);
+                }
+            }
+        }
+    }
+}
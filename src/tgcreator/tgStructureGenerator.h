@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_STRUCTURE_GENERATOR_H
+#define TG_STRUCTURE_GENERATOR_H
+
+/**
+ * @file tgStructureGenerator.h
+ * @brief Definition of class tgStructureGenerator
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <string>
+
+// Forward declarations
+class tgStructure;
+
+/**
+ * Generates large, regular tensegrity structures out of many copies of
+ * one module: lattices of 3-prisms, long tetrahedral spines and lattices
+ * of 6-bar icosahedra. They are meant for benchmarks that grow a model
+ * until the simulator stops scaling, but they are ordinary structures
+ * and can be built with any tgBuildSpec.
+ *
+ * Each module is a child of the structure, a copy of a single template,
+ * so a large structure takes little memory until it is built. Cables
+ * that join neighboring modules are pairs of the structure itself. Pairs
+ * are tagged with Config::rodTags or Config::cableTags. The structure
+ * starts at the origin and grows along +x, +y and +z.
+ */
+class tgStructureGenerator
+{
+public:
+
+    struct Config
+    {
+        /**
+         * @param[in] length the length of a rod, which sets the size of a
+         * module
+         * @param[in] gap the distance between neighboring modules, which
+         * is the rest length of most of the cables that join them
+         * @param[in] rodTags the tags of the rods
+         * @param[in] cableTags the tags of the cables
+         * @throw std::invalid_argument if length or gap is not positive
+         */
+        Config(double length = 10.0,
+               double gap = 2.0,
+               const std::string& rodTags = "rod",
+               const std::string& cableTags = "cable");
+
+        double length;
+        double gap;
+        std::string rodTags;
+        std::string cableTags;
+    };
+
+    /**
+     * Add a lattice of 3-prisms: nx by nz columns of ny prisms stacked in
+     * y. Each prism has 3 rods and 9 cables. The top of a prism is joined
+     * to the bottom of the one above by 3 cables, and its sides to the
+     * prisms beside it by 2 cables in x and 4 in z.
+     * @throw std::invalid_argument if any size is not positive
+     */
+    static void addPrismLattice(tgStructure& structure,
+                                int nx, int ny, int nz,
+                                const Config& config = Config());
+
+    /**
+     * Add a spine of tetrahedral vertebrae along z. Each vertebra is a
+     * tripod of 3 rods from its tip to a base triangle; the tip of each
+     * is joined to the base of the next by 6 cables.
+     * @throw std::invalid_argument if segments is not positive
+     */
+    static void addSpine(tgStructure& structure, int segments,
+                         const Config& config = Config());
+
+    /**
+     * Add a lattice of nx by ny by nz 6-bar icosahedra, each like
+     * SUPERball with 6 rods and 24 cables. Neighbors are joined by the 2
+     * pairs of rod ends that face each other.
+     * @throw std::invalid_argument if any size is not positive
+     */
+    static void addIcosahedronLattice(tgStructure& structure,
+                                      int nx, int ny, int nz,
+                                      const Config& config = Config());
+};
+
+#endif // TG_STRUCTURE_GENERATOR_H
@@ -0,0 +1,285 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgControllerBank_test.cpp
+* @brief Contains a test of tgControllerBank against the scalar controllers
+* $Id$
+*/
+
+// This application
+#include "controllers/tgControllerBank.h"
+#include "controllers/tgImpedanceController.h"
+#include "controllers/tgPIDController.h"
+#include "controllers/tgTensionController.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgKinematicActuator.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgKinematicActuatorInfo.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+	const double dt = 1.0 / 1000.0;
+	const int ticks = 200;
+
+	/**
+	 * Two parallel rods joined by three tgBasicActuators and one
+	 * tgKinematicActuator, floating without gravity
+	 */
+	class RodPairModel : public tgModel {
+	public:
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(0, 5, 0);
+			s.addNode(0, 5, 10);
+			s.addNode(10, 5, 0);
+			s.addNode(10, 5, 10);
+			s.addPair(0, 1, "rod");
+			s.addPair(2, 3, "rod");
+			s.addPair(0, 2, "basic");
+			s.addPair(1, 3, "basic");
+			s.addPair(0, 3, "basic");
+			s.addPair(1, 2, "kinematic");
+
+			const tgRod::Config rodConfig;
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+			const tgBasicActuator::Config basicConfig(1000, 10);
+			spec.addBuilder("basic", new tgBasicActuatorInfo(basicConfig));
+			const tgKinematicActuator::Config kinematicConfig(1000, 10);
+			spec.addBuilder("kinematic", new tgKinematicActuatorInfo(kinematicConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+
+			basic = find<tgBasicActuator>("basic");
+			kinematic = find<tgKinematicActuator>("kinematic")[0];
+		}
+
+		std::vector<tgBasicActuator*> basic;
+		tgKinematicActuator* kinematic;
+	};
+
+	/** A simulation of its own RodPairModel */
+	struct Rig {
+		Rig() :
+			world(tgWorld::Config(0.0)),
+			view(world, dt, 1.0 / 60.0),
+			simulation(view),
+			model(new RodPairModel()) {
+			simulation.addModel(model);
+		}
+
+		/** Every actuator, in the order of the bank's channels */
+		std::vector<tgSpringCableActuator*> actuators() const {
+			std::vector<tgSpringCableActuator*> result(model->basic.begin(),
+													   model->basic.end());
+			result.push_back(model->kinematic);
+			return result;
+		}
+
+		tgWorld world;
+		tgSimView view;
+		tgSimulation simulation;
+		RodPairModel* model;
+	};
+
+	/** tgImpedanceController::control is not const */
+	tgImpedanceController impedance(10, 50, 5);
+	const tgPIDController::Config pidConfig(0.01, 0.001, 0.0001, true);
+
+	/** A bank over every actuator of rig, with the same gains for all */
+	void fillBank(tgControllerBank& bank, const Rig& rig) {
+		const std::vector<tgSpringCableActuator*> actuators = rig.actuators();
+		for (std::size_t i = 0; i < actuators.size(); i++) {
+			EXPECT_EQ(i, bank.addActuator(actuators[i], pidConfig, impedance));
+		}
+	}
+
+	/** The rest lengths of the two rigs' actuators are the same */
+	void expectSameRestLengths(const Rig& scalar, const Rig& batched) {
+		const std::vector<tgSpringCableActuator*> a = scalar.actuators();
+		const std::vector<tgSpringCableActuator*> b = batched.actuators();
+		ASSERT_EQ(a.size(), b.size());
+		for (std::size_t i = 0; i < a.size(); i++) {
+			EXPECT_DOUBLE_EQ(a[i]->getRestLength(), b[i]->getRestLength());
+			EXPECT_DOUBLE_EQ(a[i]->getTension(), b[i]->getTension());
+		}
+	}
+
+	TEST(tgControllerBankTest, testImpedanceMatchesScalar) {
+		Rig scalar;
+		Rig batched;
+		tgControllerBank bank;
+		fillBank(bank, batched);
+		ASSERT_EQ(4u, bank.size());
+
+		tgPIDController pid(scalar.model->kinematic, pidConfig);
+		std::vector<double> positions(bank.size());
+		std::vector<double> offsetVels(bank.size());
+
+		for (int t = 0; t < ticks; t++) {
+			// Shorter than the actuators, so the tension goes up
+			const std::vector<tgSpringCableActuator*> actuators = scalar.actuators();
+			for (std::size_t i = 0; i < bank.size(); i++) {
+				positions[i] = 0.9 * actuators[i]->getCurrentLength();
+				offsetVels[i] = std::sin(0.05 * t + i);
+			}
+
+			std::vector<double> setTensions;
+			for (std::size_t i = 0; i < scalar.model->basic.size(); i++) {
+				setTensions.push_back(impedance.control(*scalar.model->basic[i],
+					dt, positions[i], offsetVels[i]));
+			}
+			setTensions.push_back(impedance.control(pid, dt,
+				positions.back(), offsetVels.back()));
+
+			bank.controlImpedance(dt, &positions[0], NULL, &offsetVels[0]);
+
+			ASSERT_EQ(setTensions.size(), bank.getSetTensions().size());
+			for (std::size_t i = 0; i < setTensions.size(); i++) {
+				EXPECT_DOUBLE_EQ(setTensions[i], bank.getSetTensions()[i]);
+			}
+			expectSameRestLengths(scalar, batched);
+
+			scalar.simulation.run(1);
+			batched.simulation.run(1);
+		}
+		expectSameRestLengths(scalar, batched);
+	}
+
+	TEST(tgControllerBankTest, testTensionMatchesScalar) {
+		Rig scalar;
+		Rig batched;
+		tgControllerBank bank;
+		fillBank(bank, batched);
+
+		tgPIDController pid(scalar.model->kinematic, pidConfig);
+		std::vector<double> setTensions(bank.size());
+
+		for (int t = 0; t < ticks; t++) {
+			for (std::size_t i = 0; i < bank.size(); i++) {
+				setTensions[i] = 50.0 + 40.0 * std::sin(0.05 * t + i);
+			}
+
+			for (std::size_t i = 0; i < scalar.model->basic.size(); i++) {
+				tgTensionController::control(*scalar.model->basic[i], dt,
+											 setTensions[i]);
+			}
+			pid.control(dt, setTensions.back(),
+						scalar.model->kinematic->getTension());
+
+			bank.controlTension(dt, &setTensions[0]);
+			EXPECT_EQ(setTensions, bank.getSetTensions());
+			expectSameRestLengths(scalar, batched);
+
+			scalar.simulation.run(1);
+			batched.simulation.run(1);
+		}
+
+		// After a reset the integrators start over, as in a new controller
+		bank.resetState();
+		tgPIDController fresh(scalar.model->kinematic, pidConfig);
+		for (int t = 0; t < 10; t++) {
+			for (std::size_t i = 0; i < scalar.model->basic.size(); i++) {
+				tgTensionController::control(*scalar.model->basic[i], dt,
+											 setTensions[i]);
+			}
+			fresh.control(dt, setTensions.back(),
+						  scalar.model->kinematic->getTension());
+			bank.controlTension(dt, &setTensions[0]);
+
+			scalar.simulation.run(1);
+			batched.simulation.run(1);
+			expectSameRestLengths(scalar, batched);
+		}
+	}
+
+	TEST(tgControllerBankTest, testMinimumRestLength) {
+		Rig scalar;
+		Rig batched;
+		tgControllerBank bank;
+		fillBank(bank, batched);
+
+		// Far more tension than the springs can give: the rest length law
+		// asks for a negative length, which is clamped
+		tgImpedanceController pull(1.0e6, 0, 0);
+		for (std::size_t i = 0; i < bank.size(); i++) {
+			bank.setImpedance(i, pull);
+		}
+		tgPIDController pid(scalar.model->kinematic, pidConfig);
+		std::vector<double> positions(bank.size(), 0.0);
+
+		for (int t = 0; t < 10; t++) {
+			for (std::size_t i = 0; i < scalar.model->basic.size(); i++) {
+				pull.control(*scalar.model->basic[i], dt, positions[i]);
+			}
+			pull.control(pid, dt, positions.back());
+			bank.controlImpedance(dt, &positions[0]);
+
+			for (std::size_t i = 0; i < batched.model->basic.size(); i++) {
+				EXPECT_DOUBLE_EQ(1.0e6, bank.getSetTensions()[i]);
+				EXPECT_DOUBLE_EQ(0.1, bank.getCommands()[i]);
+			}
+			for (std::size_t i = 0; i < scalar.model->basic.size(); i++) {
+				EXPECT_DOUBLE_EQ(scalar.model->basic[i]->getRestLength(),
+								 batched.model->basic[i]->getRestLength());
+			}
+
+			scalar.simulation.run(1);
+			batched.simulation.run(1);
+		}
+	}
+
+	TEST(tgControllerBankTest, testErrors) {
+		Rig rig;
+		tgControllerBank bank;
+		EXPECT_THROW(bank.addActuator(NULL, pidConfig, impedance),
+					 std::invalid_argument);
+		fillBank(bank, rig);
+		EXPECT_THROW(bank.setImpedance(bank.size(), impedance), std::out_of_range);
+
+		std::vector<double> values(bank.size(), 1.0);
+		EXPECT_THROW(bank.controlImpedance(0.0, &values[0]), std::runtime_error);
+		EXPECT_THROW(bank.controlTension(-dt, &values[0]), std::runtime_error);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
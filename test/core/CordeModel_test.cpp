@@ -0,0 +1,191 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file CordeModel_test.cpp
+* @brief Checks CordeModel against the vector-of-elements implementation
+* it replaced
+* $Id$
+*/
+
+// This application
+#include "core/CordeModel.h"
+// The Bullet Physics library
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <stdexcept>
+
+namespace {
+
+	/**
+	 * The state after 200 steps, recorded from the previous implementation
+	 * (one heap-allocated element per mass point and centerline), with its
+	 * forces reset every step. The rope lies in the xz plane but its
+	 * centerlines point along z, so the alignment constraint sets it
+	 * moving.
+	 */
+	struct VectorSample {
+		std::size_t i;
+		btVector3 expected;
+	};
+
+	struct QuaternionSample {
+		std::size_t i;
+		btQuaternion expected;
+	};
+
+	const VectorSample shortPositions[] = {
+		{0, btVector3(-1.0791034738153674e-21, -6.821886086774132e-34, -1.4388046317535286e-21)},
+		{5, btVector3(3.333333333333333, 3.7290866469532042e-18, 4.4444444444444446)},
+		{9, btVector3(6, 8.47214731349531e-33, 8.0000000000000018)}
+	};
+
+	const VectorSample shortVelocities[] = {
+		{0, btVector3(-6.3997469038540898e-18, -7.6717837753162935e-30, -8.5329958718021045e-18)},
+		{5, btVector3(0, 7.2152595555366799e-15, -8.1077721307658341e-15)},
+		{9, btVector3(-1.0435468821794361e-18, 2.201694508684764e-28, -1.3913958431964485e-18)}
+	};
+
+	const VectorSample shortForces[] = {
+		{0, btVector3(-1.6086958259706805e-14, -3.7676340442178124e-26, -2.1449277679592544e-14)},
+		{5, btVector3(0, 0, 3.092281986027956e-11)},
+		{9, btVector3(-2.54376725980019e-14, 4.9645410363597825e-25, -3.3916896797981487e-14)}
+	};
+
+	const QuaternionSample shortQuaternions[] = {
+		{0, btQuaternion(0.028986323304985226, -0.71063539614227844, -0.086822196890709996, 0.69758084329920989)},
+		{5, btQuaternion(0.028986323190182399, -0.71063539614720928, -0.086822196627284173, 0.69758084333174331)},
+		{8, btQuaternion(0.028986323179668653, -0.71063539617731764, -0.086822196619764438, 0.6975808433024443)}
+	};
+
+	/** Long enough to be split into chunks for OpenMP */
+	const VectorSample longPositions[] = {
+		{0, btVector3(3.4848836541045151e-48, -4.6142094990627764e-68, 4.6465115388060183e-48)},
+		{300, btVector3(3.0050083472453992, -4.1457047213264179e-20, 4.0066777963271987)},
+		{599, btVector3(5.9999999999999787, -5.931559478527966e-33, 7.9999999999999707)}
+	};
+
+	const VectorSample longVelocities[] = {
+		{0, btVector3(1.1853635011588181e-43, -2.1674909350699307e-63, 1.5804846682117568e-43)},
+		{300, btVector3(-4.3411490980943145e-11, -4.5204762171656819e-16, -6.7671983507018972e-11)},
+		{599, btVector3(7.5317324655906128e-16, -2.9460728570244985e-28, 1.0042309954123088e-15)}
+	};
+
+	const VectorSample longForces[] = {
+		{0, btVector3(2.3447801875108065e-41, -6.3844484132922548e-61, 3.1263735833477426e-41)},
+		{300, btVector3(-1.4842953532934189e-09, -2.1316282072803006e-14, -2.306478563696146e-09)},
+		{599, btVector3(1.4445353692198286e-13, -9.7225317482815164e-26, 1.9260471589621624e-13)}
+	};
+
+	const QuaternionSample longQuaternions[] = {
+		{0, btQuaternion(3.5290109202630908e-14, -9.8599846760037341e-05, -1.069493615390073e-09, 0.99999999513903515)},
+		{300, btQuaternion(3.5290109202337767e-14, -9.8599846760037341e-05, -1.0694936153847238e-09, 0.99999999513903515)},
+		{598, btQuaternion(3.5290108840475071e-14, -9.8599846120589224e-05, -1.069493609162412e-09, 0.99999999513903515)}
+	};
+
+	/**
+	 * The kernels sum in a different order, so allow rounding relative
+	 * to the size of the vector rather than of each component.
+	 */
+	double tolerance(double magnitude) {
+		const double eps = (sizeof(btScalar) == sizeof(double)) ? 1e-9 : 1e-3;
+		return eps * (1.0 + magnitude);
+	}
+
+	/**
+	 * Short links need a shorter step to stay stable; otherwise rounding
+	 * differences grow until no two implementations agree.
+	 */
+	CordeModel makeRope(std::size_t resolution, double dt) {
+		// Values for rope from Spillman's paper, as in AppCordeTest
+		const CordeModel::Config config(resolution, 0.01, 1300, 0.5, 0.5,
+										20.0, 100e3, 10e-6, 1e-6);
+		const btQuaternion alongZ(0, 0, 0, 1);
+		CordeModel rope(btVector3(0, 0, 0), btVector3(6, 0, 8),
+						alongZ, alongZ, config);
+		for (int i = 0; i < 200; i++) {
+			rope.step(dt);
+		}
+		return rope;
+	}
+
+	void expectVectors(const VectorSample* samples,
+					   btVector3 (CordeModel::*get)(std::size_t) const,
+					   const CordeModel& rope) {
+		for (std::size_t k = 0; k < 3; k++) {
+			const btVector3& expected = samples[k].expected;
+			const btVector3 actual = (rope.*get)(samples[k].i);
+			EXPECT_LE((actual - expected).length(),
+					  tolerance(expected.length())) << "element " << samples[k].i;
+		}
+	}
+
+	void expectQuaternions(const QuaternionSample* samples,
+						   const CordeModel& rope) {
+		for (std::size_t k = 0; k < 3; k++) {
+			const btQuaternion actual = rope.getQuaternion(samples[k].i);
+			for (int j = 0; j < 4; j++) {
+				EXPECT_NEAR(samples[k].expected[j], actual[j], tolerance(1.0))
+					<< "centerline " << samples[k].i;
+			}
+		}
+	}
+
+	TEST(CordeModelTest, testMatchesElementImplementation) {
+		const CordeModel rope = makeRope(10, 1e-5);
+		ASSERT_EQ(10u, rope.getNumMassPoints());
+		ASSERT_EQ(9u, rope.getNumCenterlines());
+		expectVectors(shortPositions, &CordeModel::getPosition, rope);
+		expectVectors(shortVelocities, &CordeModel::getVelocity, rope);
+		expectVectors(shortForces, &CordeModel::getForce, rope);
+		expectQuaternions(shortQuaternions, rope);
+	}
+
+	TEST(CordeModelTest, testMatchesElementImplementationChunked) {
+		const CordeModel rope = makeRope(600, 1e-6);
+		expectVectors(longPositions, &CordeModel::getPosition, rope);
+		expectVectors(longVelocities, &CordeModel::getVelocity, rope);
+		expectVectors(longForces, &CordeModel::getForce, rope);
+		expectQuaternions(longQuaternions, rope);
+	}
+
+	TEST(CordeModelTest, testInvalid) {
+		const CordeModel::Config config(1, 0.01, 1300, 0.5, 0.5,
+										20.0, 100e3, 10e-6, 1e-6);
+		const btQuaternion q(0, 0, 0, 1);
+		EXPECT_THROW(CordeModel(btVector3(0, 0, 0), btVector3(1, 0, 0),
+								q, q, config),
+					 std::invalid_argument);
+		EXPECT_THROW(CordeModel::Config(10, -0.01, 1300, 0.5, 0.5,
+										20.0, 100e3, 10e-6, 1e-6),
+					 std::invalid_argument);
+		CordeModel rope = makeRope(10, 1e-5);
+		EXPECT_THROW(rope.step(0.0), std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
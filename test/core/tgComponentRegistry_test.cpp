@@ -0,0 +1,168 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgComponentRegistry_test.cpp
+* @brief Contains a test of tgComponentRegistry: models join it on setup,
+* leave it on teardown, and its actuators are stepped once per step
+* $Id$
+*/
+
+// This application
+#include "core/tgBaseRigid.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgComponentRegistry.h"
+#include "core/tgModel.h"
+#include "core/tgObserver.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// Google Test
+#include "gtest/gtest.h"
+
+namespace {
+
+	/** Two rods joined by a cable, or just the rods */
+	class RodsModel : public tgModel {
+	public:
+		RodsModel(bool withCable) : stepCount(0), m_withCable(withCable) { }
+
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(0, 2, 0);
+			s.addNode(0, 2, 10);
+			s.addNode(5, 2, 0);
+			s.addNode(5, 2, 10);
+			s.addPair(0, 1, "rod");
+			s.addPair(2, 3, "rod");
+			if (m_withCable) {
+				s.addPair(1, 3, "cable");
+			}
+
+			const tgRod::Config rodConfig;
+			const tgSpringCableActuator::Config cableConfig;
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+			spec.addBuilder("cable", new tgBasicActuatorInfo(cableConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+		virtual void step(double dt) {
+			stepCount++;
+			tgModel::step(dt);
+		}
+
+		int stepCount;
+
+	private:
+		const bool m_withCable;
+	};
+
+	class CountingObserver : public tgObserver<tgSpringCableActuator> {
+	public:
+		CountingObserver() : stepCount(0) { }
+
+		virtual void onStep(tgSpringCableActuator& subject, double dt) {
+			stepCount++;
+		}
+
+		int stepCount;
+	};
+
+	TEST(tgComponentRegistryTest, testSetupAndReset) {
+		CountingObserver observer;
+		tgWorld world;
+		tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+		tgSimulation simulation(view);
+
+		RodsModel* const pModel = new RodsModel(true);
+		simulation.addModel(pModel);
+
+		const tgComponentRegistry& registry = world.components();
+		EXPECT_EQ(3, registry.size());
+		ASSERT_EQ(1, registry.getActuators().size());
+		EXPECT_EQ(2, registry.getRigids().size());
+		EXPECT_TRUE(registry.getCompressionSprings().empty());
+		EXPECT_EQ(pModel->find<tgSpringCableActuator>("cable")[0],
+				  registry.getActuators()[0]);
+
+		// The model is stepped by the simulation, the actuator by the registry,
+		// once each
+		registry.getActuators()[0]->attach(&observer);
+		simulation.run(10);
+		EXPECT_EQ(10, pModel->stepCount);
+		EXPECT_EQ(10, observer.stepCount);
+
+		// The old components leave and the new ones join
+		simulation.reset();
+		EXPECT_EQ(3, registry.size());
+		ASSERT_EQ(1, registry.getActuators().size());
+		EXPECT_EQ(pModel->find<tgSpringCableActuator>("cable")[0],
+				  registry.getActuators()[0]);
+	}
+
+	TEST(tgComponentRegistryTest, testTeardownAndDelete) {
+		tgWorld world;
+		const tgComponentRegistry& registry = world.components();
+
+		RodsModel first(false);
+		first.setup(world);
+		RodsModel* const pSecond = new RodsModel(false);
+		pSecond->setup(world);
+		EXPECT_EQ(4, registry.getRigids().size());
+
+		// The gap is closed, keeping the order
+		const tgBaseRigid* const pLast = registry.getRigids()[3];
+		first.teardown();
+		ASSERT_EQ(2, registry.getRigids().size());
+		EXPECT_EQ(pLast, registry.getRigids()[1]);
+
+		// Deleting a model without a teardown leaves nothing behind
+		delete pSecond;
+		EXPECT_EQ(0, registry.size());
+		EXPECT_TRUE(registry.getRigids().empty());
+	}
+
+	TEST(tgComponentRegistryTest, testInvalid) {
+		tgComponentRegistry registry;
+		EXPECT_THROW(registry.add(NULL), std::invalid_argument);
+		EXPECT_THROW(registry.step(0.0), std::invalid_argument);
+
+		// A model of no listed type isn't added
+		tgModel model;
+		registry.add(&model);
+		EXPECT_EQ(0, registry.size());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
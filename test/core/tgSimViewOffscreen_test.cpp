@@ -0,0 +1,63 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgSimViewOffscreen_test.cpp
+* @brief Contains a test of tgSimViewOffscreen's configuration
+* $Id$
+*/
+
+// This application
+#include "core/tgSimViewOffscreen.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+namespace {
+
+	typedef tgSimViewOffscreen::Config Config;
+
+	TEST(tgSimViewOffscreenTest, testFramePatterns) {
+		EXPECT_NO_THROW(Config("frame%05d.ppm"));
+		EXPECT_NO_THROW(Config("frames/%d.ppm"));
+		EXPECT_NO_THROW(Config("frame%-8.3i.ppm"));
+		// No '%' at all: a single stream
+		EXPECT_NO_THROW(Config("video.ppm"));
+
+		// The output is the format string, so only one int may be read
+		EXPECT_THROW(Config("frame%s.ppm"), std::invalid_argument);
+		EXPECT_THROW(Config("frame%05d_%d.ppm"), std::invalid_argument);
+		EXPECT_THROW(Config("100%%_frame%d.ppm"), std::invalid_argument);
+		EXPECT_THROW(Config("frame%ld.ppm"), std::invalid_argument);
+		EXPECT_THROW(Config("frame%n.ppm"), std::invalid_argument);
+		EXPECT_THROW(Config("frame%"), std::invalid_argument);
+		EXPECT_THROW(Config("frame%05"), std::invalid_argument);
+	}
+
+	TEST(tgSimViewOffscreenTest, testInvalid) {
+		EXPECT_THROW(Config("frame%05d.ppm", 0.0), std::invalid_argument);
+		EXPECT_THROW(Config("frame%05d.ppm", 30.0, 0, 480), std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,129 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgSoftwareRasterizer_test.cpp
+* @brief Contains a test of tgSoftwareRasterizer
+* $Id$
+*/
+
+// This application
+#include "core/tgSoftwareRasterizer.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+	/** The red byte of a pixel */
+	int red(const tgSoftwareRasterizer& r, int x, int y) {
+		return r.getPixels()[3 * (y * r.width() + x)];
+	}
+
+	/** A camera on the z axis looking at the origin */
+	tgSoftwareRasterizer makeRasterizer() {
+		tgSoftwareRasterizer r(64, 48);
+		r.setCamera(btVector3(0, 0, 10), btVector3(0, 0, 0));
+		r.setLight(btVector3(0, 0, 1));
+		r.clear(btVector3(0, 0, 0));
+		return r;
+	}
+
+	TEST(tgSoftwareRasterizerTest, testTriangle) {
+		tgSoftwareRasterizer r = makeRasterizer();
+		// Facing the camera and the light, so fully lit
+		r.drawTriangle(btVector3(-1, -1, 0), btVector3(1, -1, 0),
+					   btVector3(0, 1, 0), btVector3(1, 0, 0));
+		EXPECT_EQ(255, red(r, 32, 24));
+		EXPECT_EQ(0, red(r, 0, 0));
+		EXPECT_EQ(0, red(r, 63, 47));
+	}
+
+	TEST(tgSoftwareRasterizerTest, testDepth) {
+		tgSoftwareRasterizer r = makeRasterizer();
+		const btVector3 a(-1, -1, 0), b(1, -1, 0), c(0, 1, 0);
+		const btVector3 closer(0, 0, 1);
+		// The nearer one wins whichever is drawn first
+		r.drawTriangle(a + closer, b + closer, c + closer, btVector3(1, 0, 0));
+		r.drawTriangle(a, b, c, btVector3(0.5, 0, 0));
+		EXPECT_EQ(255, red(r, 32, 24));
+		r.clear(btVector3(0, 0, 0));
+		r.drawTriangle(a, b, c, btVector3(0.5, 0, 0));
+		r.drawTriangle(a + closer, b + closer, c + closer, btVector3(1, 0, 0));
+		EXPECT_EQ(255, red(r, 32, 24));
+	}
+
+	TEST(tgSoftwareRasterizerTest, testNearPlane) {
+		tgSoftwareRasterizer r = makeRasterizer();
+		// Reaches behind the camera; only the part in front is drawn
+		r.drawTriangle(btVector3(-1, -1, 0), btVector3(1, -1, 0),
+					   btVector3(0, 3, 20), btVector3(1, 0, 0));
+		EXPECT_LT(0, red(r, 32, 2));
+		EXPECT_LT(0, red(r, 32, 28));
+		EXPECT_EQ(0, red(r, 32, 40));
+		// Entirely behind the camera
+		r.clear(btVector3(0, 0, 0));
+		r.drawTriangle(btVector3(-1, -1, 20), btVector3(1, -1, 20),
+					   btVector3(0, 1, 20), btVector3(1, 0, 0));
+		r.drawLine(btVector3(-1, 0, 20), btVector3(1, 0, 20),
+				   btVector3(1, 0, 0));
+		for (std::size_t i = 0; i < r.getPixels().size(); i++) {
+			ASSERT_EQ(0, r.getPixels()[i]);
+		}
+	}
+
+	TEST(tgSoftwareRasterizerTest, testLine) {
+		tgSoftwareRasterizer r = makeRasterizer();
+		r.drawTriangle(btVector3(-1, -1, 0), btVector3(1, -1, 0),
+					   btVector3(0, 1, 0), btVector3(0.5, 0, 0));
+		// A line on a surface is drawn over it
+		r.drawLine(btVector3(-2, 0, 0), btVector3(2, 0, 0),
+				   btVector3(1, 0, 0));
+		EXPECT_EQ(255, red(r, 32, 24));
+		EXPECT_EQ(255, red(r, 20, 24));
+		EXPECT_EQ(0, red(r, 10, 24));
+	}
+
+	TEST(tgSoftwareRasterizerTest, testPPM) {
+		tgSoftwareRasterizer r(4, 2);
+		std::ostringstream os;
+		r.writePPM(os);
+		EXPECT_EQ(std::string("P6\n4 2\n255\n").size() + 4 * 2 * 3,
+				  os.str().size());
+		EXPECT_EQ(0u, os.str().find("P6\n4 2\n255\n"));
+	}
+
+	TEST(tgSoftwareRasterizerTest, testInvalid) {
+		EXPECT_THROW(tgSoftwareRasterizer(0, 10), std::invalid_argument);
+		tgSoftwareRasterizer r(10, 10);
+		EXPECT_THROW(r.setCamera(btVector3(1, 2, 3), btVector3(1, 2, 3)),
+					 std::invalid_argument);
+		EXPECT_THROW(r.setCamera(btVector3(0, 10, 0), btVector3(0, 0, 0)),
+					 std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
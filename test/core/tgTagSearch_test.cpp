@@ -0,0 +1,165 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgTagSearch_test.cpp
+* @brief Contains a test of tgTags and the 'and', 'or' and 'not' searches
+* of tgTagSearch
+* $Id$
+*/
+
+// This application
+#include "core/tgTagAtoms.h"
+#include "core/tgTags.h"
+#include "core/tgTagSearch.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+// POSIX
+#include <pthread.h>
+
+namespace {
+
+	TEST(tgTagSearchTest, testTags) {
+		tgTags tags("b a c a");
+		EXPECT_EQ(3, tags.size());
+		EXPECT_EQ("b", tags[0]);
+		EXPECT_TRUE(tags.contains("a  c"));
+		EXPECT_TRUE(tags.contains(""));
+		EXPECT_FALSE(tags.contains("a d"));
+		EXPECT_TRUE(tags.containsAny("d c"));
+		EXPECT_FALSE(tags.containsAny("d e"));
+		EXPECT_TRUE(tags == tgTags("c b a"));
+
+		tags.remove("a");
+		EXPECT_FALSE(tags.contains("a"));
+		tags.prepend("a");
+		EXPECT_EQ("a", tags[0]);
+		EXPECT_TRUE(tags.contains("a b c"));
+
+		tags += tgTags("c d");
+		EXPECT_EQ(4, tags.size());
+
+		EXPECT_THROW(tgTags("rod 12"), tgTagException);
+	}
+
+	TEST(tgTagSearchTest, testAnd) {
+		EXPECT_TRUE(tgTagSearch("a b").matches(tgTags("a b c")));
+		EXPECT_FALSE(tgTagSearch("a b").matches(tgTags("a c")));
+		EXPECT_TRUE(tgTagSearch("").matches(tgTags("a")));
+		EXPECT_TRUE(tgTagSearch().matches(tgTags()));
+	}
+
+	TEST(tgTagSearchTest, testNot) {
+		const tgTagSearch search("a -b");
+		EXPECT_TRUE(search.matches(tgTags("a c")));
+		EXPECT_FALSE(search.matches(tgTags("a b")));
+		EXPECT_FALSE(search.matches(tgTags("c")));
+	}
+
+	TEST(tgTagSearchTest, testOr) {
+		const tgTagSearch search("a b|c");
+		EXPECT_TRUE(search.matches(tgTags("a b")));
+		EXPECT_TRUE(search.matches(tgTags("a c")));
+		EXPECT_FALSE(search.matches(tgTags("a d")));
+
+		const tgTagSearch either("b|-c");
+		EXPECT_TRUE(either.matches(tgTags("a")));
+		EXPECT_TRUE(either.matches(tgTags("b c")));
+		EXPECT_FALSE(either.matches(tgTags("c")));
+	}
+
+	TEST(tgTagSearchTest, testRemove) {
+		// A child inherits its parent's tags
+		tgTagSearch search("parent rod -hidden");
+		search.remove(tgTags("parent"));
+		EXPECT_TRUE(search.matches(tgTags("rod")));
+		EXPECT_FALSE(search.matches(tgTags("rod hidden")));
+
+		tgTagSearch alternatives("a|b c");
+		alternatives.remove(tgTags("b"));
+		EXPECT_TRUE(alternatives.matches(tgTags("c")));
+
+		tgTagSearch excluded("rod -hidden");
+		excluded.remove(tgTags("hidden"));
+		EXPECT_FALSE(excluded.matches(tgTags("rod")));
+	}
+
+	TEST(tgTagSearchTest, testUnknownTags) {
+		tgTags tags("a b");
+		const std::size_t atoms = tgTagAtoms::size();
+		EXPECT_EQ(-1, tgTagAtoms::lookup("neverAddedTag"));
+
+		// Queries don't add the tags they ask about
+		EXPECT_FALSE(tags.contains("a neverAddedTag"));
+		EXPECT_TRUE(tags.containsAny("neverAddedTag b"));
+		EXPECT_FALSE(tags.containsAny("neverAddedTag"));
+		tags.remove("neverAddedTag");
+		EXPECT_EQ(2, tags.size());
+		EXPECT_EQ(atoms, tgTagAtoms::size());
+		EXPECT_EQ(-1, tgTagAtoms::lookup("neverAddedTag"));
+
+		EXPECT_EQ(tgTagAtoms::intern("a"), tgTagAtoms::lookup("a"));
+		EXPECT_EQ("a", tgTagAtoms::name(tgTagAtoms::lookup("a")));
+	}
+
+	void* internTags(void* result) {
+		std::vector<int>& atoms = *static_cast<std::vector<int>*>(result);
+		for (int i = 0; i < 200; i++) {
+			std::stringstream ss;
+			ss << "threaded" << i;
+			atoms.push_back(tgTagAtoms::intern(ss.str()));
+			tgTags(ss.str() + " shared").contains("shared");
+		}
+		return NULL;
+	}
+
+	TEST(tgTagSearchTest, testAtomsFromThreads) {
+		const int numThreads = 4;
+		pthread_t threads[numThreads];
+		std::vector<int> atoms[numThreads];
+		for (int t = 0; t < numThreads; t++) {
+			ASSERT_EQ(0, pthread_create(&threads[t], NULL, internTags, &atoms[t]));
+		}
+		for (int t = 0; t < numThreads; t++) {
+			pthread_join(threads[t], NULL);
+		}
+		// Every thread got the same atom for each tag
+		for (int t = 1; t < numThreads; t++) {
+			EXPECT_EQ(atoms[0], atoms[t]);
+		}
+		EXPECT_EQ("threaded7", tgTagAtoms::name(atoms[0][7]));
+	}
+
+	TEST(tgTagSearchTest, testInvalid) {
+		EXPECT_THROW(tgTagSearch("a 5"), tgTagException);
+		EXPECT_THROW(tgTagSearch("a|"), tgTagException);
+		EXPECT_THROW(tgTagSearch("a||b"), tgTagException);
+		EXPECT_THROW(tgTagSearch("-"), tgTagException);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
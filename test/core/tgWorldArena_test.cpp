@@ -0,0 +1,117 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgWorldArena_test.cpp
+* @brief Contains a test of tgWorldArena: setup fills it, stepping doesn't
+* $Id$
+*/
+
+// This application
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "core/tgWorldArena.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// Google Test
+#include "gtest/gtest.h"
+
+namespace {
+
+	/** Two crossed rods dropped onto the ground, so there are contacts */
+	class RodsModel : public tgModel {
+	public:
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(0, 2, 0);
+			s.addNode(0, 3, 10);
+			s.addNode(-5, 4, 5);
+			s.addNode(5, 4, 5);
+			s.addPair(0, 1, "rod");
+			s.addPair(2, 3, "rod");
+
+			const tgRod::Config rodConfig;
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+	};
+
+	TEST(tgWorldArenaTest, testStepDoesNotGrow) {
+		tgWorld world;
+		tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+		tgSimulation simulation(view);
+		simulation.addModel(new RodsModel());
+
+		const tgWorldArena& arena = world.arena();
+		const std::size_t built = arena.bytesInUse();
+		EXPECT_LT(0u, built);
+
+		// Long enough for the rods to land and roll
+		simulation.run(3000);
+		EXPECT_EQ(built, arena.bytesInUse());
+
+		// The world and model are rebuilt into the same memory
+		simulation.reset();
+		EXPECT_EQ(built, arena.bytesInUse());
+		simulation.run(3000);
+		EXPECT_EQ(built, arena.bytesInUse());
+	}
+
+	TEST(tgWorldArenaTest, testScopes) {
+		tgWorldArena arena;
+		EXPECT_TRUE(tgWorldArena::current() == NULL);
+		EXPECT_FALSE(tgWorldArena::allocating());
+		{
+			tgWorldArena::Scope scope(arena);
+			EXPECT_EQ(&arena, tgWorldArena::current());
+			EXPECT_TRUE(tgWorldArena::allocating());
+			{
+				// As while stepping: the arena is current but not used
+				tgWorldArena::Scope stepping(arena, false);
+				EXPECT_EQ(&arena, tgWorldArena::current());
+				EXPECT_FALSE(tgWorldArena::allocating());
+			}
+			EXPECT_TRUE(tgWorldArena::allocating());
+		}
+		EXPECT_TRUE(tgWorldArena::current() == NULL);
+		EXPECT_FALSE(tgWorldArena::allocating());
+
+		void* const p = arena.allocate(100);
+		EXPECT_TRUE(arena.contains(p));
+		EXPECT_FALSE(arena.contains(&arena));
+		EXPECT_EQ(112u, arena.bytesInUse());
+		arena.release();
+		EXPECT_EQ(0u, arena.bytesInUse());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgWorldBulletPhysicsImpl_test.cpp
+* @brief Contains a test of the collision shapes shared between rods
+* $Id$
+*/
+
+// This application
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "core/tgWorldBulletPhysicsImpl.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <vector>
+
+namespace {
+
+	/** Three rods of length 10 and one of length 5, none touching */
+	class RodsModel : public tgModel {
+	public:
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(0, 2, 0);
+			s.addNode(0, 2, 10);
+			s.addNode(5, 2, 0);
+			s.addNode(5, 2, 10);
+			s.addNode(10, 2, 0);
+			s.addNode(10, 2, 10);
+			s.addNode(15, 2, 0);
+			s.addNode(15, 2, 5);
+			s.addPair(0, 1, "rod");
+			s.addPair(2, 3, "rod");
+			s.addPair(4, 5, "rod");
+			s.addPair(6, 7, "rod");
+
+			const tgRod::Config rodConfig;
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+		std::vector<btCollisionShape*> shapes() {
+			const std::vector<tgRod*> rods = find<tgRod>("rod");
+			std::vector<btCollisionShape*> result;
+			for (std::size_t i = 0; i < rods.size(); i++) {
+				result.push_back(rods[i]->getPRigidBody()->getCollisionShape());
+			}
+			return result;
+		}
+	};
+
+	/** A box that counts its deletions */
+	class CountedBox : public btBoxShape {
+	public:
+		CountedBox(int& deleted) :
+			btBoxShape(btVector3(1.0, 1.0, 1.0)), m_deleted(deleted) { }
+
+		virtual ~CountedBox() {
+			m_deleted++;
+		}
+
+	private:
+		int& m_deleted;
+	};
+
+	/** A compound shape that counts its deletions */
+	class CountedCompound : public btCompoundShape {
+	public:
+		CountedCompound(int& deleted) : m_deleted(deleted) { }
+
+		virtual ~CountedCompound() {
+			m_deleted++;
+		}
+
+	private:
+		int& m_deleted;
+	};
+
+	tgWorldBulletPhysicsImpl& bulletWorld(const tgWorld& world) {
+		return static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+	}
+
+	/** The first three rods share a shape that the fourth doesn't */
+	void expectShared(RodsModel& model, const tgWorld& world) {
+		const std::vector<btCollisionShape*> shapes = model.shapes();
+		ASSERT_EQ(4u, shapes.size());
+		EXPECT_EQ(shapes[0], shapes[1]);
+		EXPECT_EQ(shapes[0], shapes[2]);
+		EXPECT_NE(shapes[0], shapes[3]);
+		EXPECT_TRUE(bulletWorld(world).isSharedShape(shapes[0]));
+		EXPECT_TRUE(bulletWorld(world).isSharedShape(shapes[3]));
+		EXPECT_EQ(2u, bulletWorld(world).sharedShapeCount());
+	}
+
+	TEST(tgWorldBulletPhysicsImplTest, testIdenticalRodsShareShape) {
+		tgWorld world;
+		tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+		tgSimulation simulation(view);
+		RodsModel* const model = new RodsModel();
+		simulation.addModel(model);
+
+		expectShared(*model, world);
+
+		// The rebuilt world has a registry of its own
+		simulation.reset();
+		expectShared(*model, world);
+		simulation.run(100);
+	}
+
+	TEST(tgWorldBulletPhysicsImplTest, testSharedShapeIsDeletedOnce) {
+		tgWorld world;
+		tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+		tgSimulation simulation(view);
+		RodsModel* const model = new RodsModel();
+		simulation.addModel(model);
+		tgWorldBulletPhysicsImpl& impl = bulletWorld(world);
+		btCollisionShape* const shared = model->shapes()[0];
+
+		// Deleting a shared shape leaves it to the world
+		impl.deleteCollisionShape(shared);
+		impl.deleteCollisionShape(shared);
+		EXPECT_TRUE(impl.isSharedShape(shared));
+		EXPECT_EQ(2u, impl.sharedShapeCount());
+		EXPECT_EQ(shared, impl.getCylinderShape(btVector3(0.5, 5.0, 0.5)));
+
+		// A compound is deleted with its own children, but not shared ones
+		int compoundsDeleted = 0;
+		int boxesDeleted = 0;
+		CountedCompound* const compound = new CountedCompound(compoundsDeleted);
+		CountedBox* const box = new CountedBox(boxesDeleted);
+		btTransform transform;
+		transform.setIdentity();
+		compound->addChildShape(transform, shared);
+		compound->addChildShape(transform, box);
+		impl.addCollisionShape(box);
+		impl.addCollisionShape(compound);
+		EXPECT_FALSE(impl.isSharedShape(compound));
+		EXPECT_FALSE(impl.isSharedShape(box));
+
+		impl.deleteCollisionShape(compound);
+		EXPECT_EQ(1, compoundsDeleted);
+		EXPECT_EQ(1, boxesDeleted);
+		EXPECT_TRUE(impl.isSharedShape(shared));
+
+		// The rods still use the shape; the world frees it when it goes
+		simulation.run(100);
+		simulation.reset();
+		expectShared(*model, world);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
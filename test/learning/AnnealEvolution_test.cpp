@@ -0,0 +1,178 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file AnnealEvolution_test.cpp
+* @brief Contains a test of AnnealEvolution resuming from a checkpoint
+* $Id$
+*/
+
+// This application
+#include "learning/AnnealEvolution/AnnealEvolution.h"
+#include "learning/Checkpoint/EvoCheckpoint.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// POSIX
+#include <sys/stat.h>
+
+namespace {
+
+	const char* const configFile = "AnnealEvolution_test.ini";
+	const char* const checkpointFile = "logs/checkpoint-Resume.bin";
+
+	/** Higher the closer every parameter is to 0.3 */
+	std::vector<double> score(const std::vector<AnnealEvoMember*>& controllers) {
+		double sum = 0.0;
+		for (std::size_t i = 0; i < controllers.size(); i++) {
+			const std::vector<double>& p = controllers[i]->statelessParameters;
+			for (std::size_t j = 0; j < p.size(); j++) {
+				sum -= (p[j] - 0.3) * (p[j] - 0.3);
+			}
+		}
+		std::vector<double> scores;
+		scores.push_back(sum);
+		scores.push_back(0.0);
+		return scores;
+	}
+
+	/** The parameters of the selected controllers, one row each */
+	std::vector<std::vector<double> > parameters(
+		const std::vector<AnnealEvoMember*>& controllers) {
+		std::vector<std::vector<double> > rows;
+		for (std::size_t i = 0; i < controllers.size(); i++) {
+			rows.push_back(controllers[i]->statelessParameters);
+		}
+		return rows;
+	}
+
+	std::string readFile(const std::string& filename) {
+		std::ifstream in(filename.c_str(), std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(in),
+						   std::istreambuf_iterator<char>());
+	}
+
+	class AnnealEvolutionTest : public ::testing::Test {
+	protected:
+		virtual void SetUp() {
+			// Learning runs log to logs/ under the resource path
+			mkdir("logs", 0755);
+			writeConfig(false);
+		}
+
+		virtual void TearDown() {
+			std::remove(configFile);
+			std::remove(checkpointFile);
+			std::remove("logs/original.bin");
+			std::remove("logs/resumed.bin");
+			std::remove("logs/evolutionResume.csv");
+			std::remove("logs/scores.csv");
+			std::remove("logs/bestParameters-Resume-0.nnw");
+			std::remove("logs/bestParameters-Resume-1.nnw");
+		}
+
+		void writeConfig(bool resume, int populationSize = 10) {
+			std::ofstream config(configFile);
+			config << "numberOfActions = 3\n"
+				   << "numberOfControllers = 2\n"
+				   << "populationSize = " << populationSize << "\n"
+				   << "numberOfElementsToMutate = 5\n"
+				   << "numberOfTestsBetweenGenerations = 10\n"
+				   << "numberOfSubtests = 1\n"
+				   << "leniencyCoef = 0.2\n"
+				   << "coevolution = 0\n"
+				   << "MonteCarlo = 0\n"
+				   << "deviation = 0.1\n"
+				   << "compareAverageScores = 0\n"
+				   << "clearScoresBetweenGenerations = 0\n"
+				   << "startSeed = 0\n"
+				   << "learning = 1\n"
+				   << "checkpointInterval = 1\n"
+				   << "resumeFromCheckpoint = " << (resume ? 1 : 0) << "\n";
+		}
+	};
+
+	TEST_F(AnnealEvolutionTest, testResumeFromCheckpoint) {
+		AnnealEvolution original("Resume", configFile);
+
+		// Stop right after the checkpoint of generation 3; the trial it
+		// selected next has not been scored yet
+		std::vector<AnnealEvoMember*> selected;
+		while (original.getGeneration() < 3) {
+			if (!selected.empty()) {
+				original.updateScores(score(selected));
+			}
+			selected = original.nextSetOfControllers();
+		}
+
+		writeConfig(true);
+		AnnealEvolution resumed("Resume", configFile);
+		EXPECT_EQ(3, resumed.getGeneration());
+
+		// Same populations, counters and random engine: both runs carry
+		// on with the same trials through several more generations
+		std::vector<AnnealEvoMember*> resumedSelected = resumed.nextSetOfControllers();
+		while (original.getGeneration() < 6) {
+			ASSERT_EQ(parameters(selected), parameters(resumedSelected));
+			original.updateScores(score(selected));
+			resumed.updateScores(score(resumedSelected));
+			selected = original.nextSetOfControllers();
+			resumedSelected = resumed.nextSetOfControllers();
+			ASSERT_EQ(original.getGeneration(), resumed.getGeneration());
+		}
+
+		// Nothing else differs either
+		original.saveCheckpoint("logs/original.bin");
+		resumed.saveCheckpoint("logs/resumed.bin");
+		const std::string originalState = readFile("logs/original.bin");
+		EXPECT_FALSE(originalState.empty());
+		EXPECT_EQ(originalState, readFile("logs/resumed.bin"));
+	}
+
+	TEST_F(AnnealEvolutionTest, testBadCheckpoints) {
+		{
+			std::ofstream truncated(checkpointFile);
+			truncated << "NTR";
+		}
+		EXPECT_THROW(EvoCheckpointReader(checkpointFile, "AnnealEvolution"),
+					 std::runtime_error);
+
+		{
+			AnnealEvolution evolution("Resume", configFile);
+			evolution.saveCheckpoint(checkpointFile);
+		}
+		EXPECT_THROW(EvoCheckpointReader(checkpointFile, "NeuroEvolution"),
+					 std::runtime_error);
+
+		writeConfig(true, 12);
+		EXPECT_THROW(AnnealEvolution("Resume", configFile), std::runtime_error);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
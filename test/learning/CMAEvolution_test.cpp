@@ -0,0 +1,154 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file CMAEvolution_test.cpp
+* @brief Contains a test of CMAEvolution on a rotated ellipsoid
+* $Id$
+*/
+
+// This application
+#include "learning/CMAEvolution/CMAEvolution.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+// POSIX
+#include <sys/stat.h>
+
+namespace {
+
+	const char* const configFile = "CMAEvolution_test.ini";
+	const std::size_t n = 10;
+
+	/**
+	 * f(x) = sum_i 10^(6 i / (n - 1)) y_i^2 with y = R (x - 0.4), where R
+	 * chains a Givens rotation through every pair of neighbouring axes,
+	 * so no axis is separable. The optimum is inside the [0, 1] box, away
+	 * from the initial mean of 0.5. Scores are -f, since higher is better.
+	 */
+	class RotatedEllipsoid : public CMAEvolution::Evaluator {
+	public:
+		virtual void evaluate(const std::vector<std::vector<double> >& candidates,
+							  std::vector<double>& scores) {
+			for (std::size_t k = 0; k < candidates.size(); k++) {
+				scores[k] = -value(candidates[k]);
+			}
+		}
+
+		static double value(const std::vector<double>& x) {
+			std::vector<double> y(x.size());
+			for (std::size_t i = 0; i < x.size(); i++) {
+				y[i] = x[i] - 0.4;
+			}
+			const double c = std::cos(0.7);
+			const double s = std::sin(0.7);
+			for (std::size_t i = 0; i + 1 < y.size(); i++) {
+				const double a = y[i];
+				const double b = y[i + 1];
+				y[i] = c * a - s * b;
+				y[i + 1] = s * a + c * b;
+			}
+			double f = 0.0;
+			for (std::size_t i = 0; i < y.size(); i++) {
+				f += std::pow(10.0, 6.0 * i / (y.size() - 1.0)) * y[i] * y[i];
+			}
+			return f;
+		}
+	};
+
+	class CMAEvolutionTest : public ::testing::Test {
+	protected:
+		virtual void SetUp() {
+			// Learning runs log to logs/ under the resource path
+			mkdir("logs", 0755);
+			std::ofstream config(configFile);
+			config << "numberOfActions = 5\n"
+				   << "numberOfControllers = 2\n"
+				   << "populationSize = 0\n"
+				   << "learning = 1\n"
+				   << "startSeed = 0\n"
+				   << "seed = 1\n";
+		}
+
+		virtual void TearDown() {
+			std::remove(configFile);
+			std::remove("logs/evolutionEllipsoid.csv");
+			std::remove("logs/bestParameters-Ellipsoid-0.nnw");
+			std::remove("logs/bestParameters-Ellipsoid-1.nnw");
+		}
+	};
+
+	TEST_F(CMAEvolutionTest, testRotatedEllipsoid) {
+		CMAEvolution evolution("Ellipsoid", configFile);
+		ASSERT_EQ(n, evolution.getNumberOfParameters());
+		ASSERT_EQ(10u, evolution.getPopulationSize());
+
+		RotatedEllipsoid ellipsoid;
+		while (evolution.getGeneration() < 1000 &&
+			   -evolution.getBestScore() > 1e-10) {
+			evolution.runGeneration(ellipsoid);
+		}
+
+		// Condition number 1e6 needs the full covariance to be learned;
+		// this stalls if the eigensystem falls behind C
+		EXPECT_GT(1e-10, -evolution.getBestScore());
+		EXPECT_GT(8000, evolution.getGeneration() * (int) evolution.getPopulationSize());
+		EXPECT_GT(1e-8, RotatedEllipsoid::value(evolution.getMean()));
+
+		// The controllers are the best candidate split into rows
+		const std::vector<std::vector<double> >& rows = evolution.getBestControllers();
+		ASSERT_EQ(2u, rows.size());
+		for (std::size_t i = 0; i < rows.size(); i++) {
+			ASSERT_EQ(5u, rows[i].size());
+			for (std::size_t j = 0; j < rows[i].size(); j++) {
+				EXPECT_NEAR(0.4, rows[i][j], 1e-3);
+			}
+		}
+	}
+
+	TEST_F(CMAEvolutionTest, testAskTell) {
+		CMAEvolution evolution("Ellipsoid", configFile);
+		EXPECT_THROW(evolution.tell(std::vector<double>(10, 0.0)), std::logic_error);
+
+		const std::vector<std::vector<double> >& first = evolution.ask();
+		const std::vector<std::vector<double> > copy = first;
+		EXPECT_EQ(copy, evolution.ask());
+		for (std::size_t k = 0; k < copy.size(); k++) {
+			for (std::size_t i = 0; i < n; i++) {
+				EXPECT_LE(0.0, copy[k][i]);
+				EXPECT_GE(1.0, copy[k][i]);
+			}
+		}
+
+		EXPECT_THROW(evolution.tell(std::vector<double>(9, 0.0)), std::invalid_argument);
+		evolution.tell(std::vector<double>(10, 0.0));
+		EXPECT_EQ(1, evolution.getGeneration());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
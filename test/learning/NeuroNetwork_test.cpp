@@ -0,0 +1,80 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file NeuroNetwork_test.cpp
+* @brief Contains a test of NeuroNetwork's weight files
+* $Id$
+*/
+
+// This application
+#include "learning/NeuroEvolution/NeuroNetwork.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+	const char* const weightFile = "NeuroNetwork_test.nnw";
+
+	TEST(NeuroNetworkTest, testSaveLoadRoundTrip) {
+		srand(1);
+		NeuroNetwork saved(4, 6, 3);
+		// Values that 6 significant digits would round
+		saved.getWeights()[0] = 1.0 / 3.0;
+		saved.getWeights()[1] = -2.0 / 7.0 * 1e-5;
+		saved.getWeights()[2] = 123456.789012345;
+		ASSERT_TRUE(saved.saveWeights(weightFile));
+
+		NeuroNetwork loaded(4, 6, 3);
+		ASSERT_TRUE(loaded.loadWeights(weightFile));
+		std::remove(weightFile);
+
+		ASSERT_EQ(saved.getNumWeights(), loaded.getNumWeights());
+		for (std::size_t i = 0; i < saved.getNumWeights(); i++) {
+			EXPECT_EQ(saved.getWeights()[i], loaded.getWeights()[i]) << i;
+		}
+
+		// So the replayed policy is the one that was evaluated
+		const double pattern[4] = {0.1, -0.7, 0.35, 1.0};
+		std::vector<double> expected(3), actual(3);
+		saved.feedForward(pattern, &expected[0]);
+		loaded.feedForward(pattern, &actual[0]);
+		for (std::size_t i = 0; i < expected.size(); i++) {
+			EXPECT_EQ(expected[i], actual[i]);
+		}
+	}
+
+	TEST(NeuroNetworkTest, testLoadWrongShape) {
+		srand(1);
+		NeuroNetwork saved(4, 6, 3);
+		ASSERT_TRUE(saved.saveWeights(weightFile));
+		NeuroNetwork other(4, 5, 3);
+		EXPECT_FALSE(other.loadWeights(weightFile));
+		std::remove(weightFile);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
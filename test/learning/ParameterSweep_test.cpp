@@ -0,0 +1,147 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file ParameterSweep_test.cpp
+* @brief Contains a test of ParameterSweep running samples on several threads
+* $Id$
+*/
+
+// This application
+#include "learning/ParameterSweep/ParameterSweep.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+	/** One rod dropped onto the ground */
+	class RodModel : public tgModel {
+	public:
+		RodModel(const tgRod::Config& config) : m_config(config) { }
+
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(0, 3, 0);
+			s.addNode(0, 4, 10);
+			s.addPair(0, 1, "rod");
+
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(m_config));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+	private:
+		const tgRod::Config m_config;
+	};
+
+	class RodTrial : public ParameterSweep::Trial {
+	public:
+		RodTrial(const ParameterSweep::Sample& sample) : m_rod(sample.rod) { }
+
+		virtual tgModel* createModel() {
+			return new RodModel(m_rod);
+		}
+
+		virtual void measure(tgModel& model, double* metrics) {
+			const tgRod& rod = *model.find<tgRod>("rod")[0];
+			metrics[0] = rod.centerOfMass().y();
+			metrics[1] = rod.mass();
+		}
+
+	private:
+		const tgRod::Config m_rod;
+	};
+
+	class RodFactory : public ParameterSweep::Factory {
+	public:
+		virtual std::vector<std::string> getMetricNames() const {
+			std::vector<std::string> names;
+			names.push_back("height");
+			names.push_back("mass");
+			return names;
+		}
+
+		virtual ParameterSweep::Trial* create(const ParameterSweep::Sample& sample) {
+			return new RodTrial(sample);
+		}
+	};
+
+	ParameterSweep::Config makeConfig(int numThreads) {
+		return ParameterSweep::Config(tgRod::Config(), tgBasicActuator::Config(),
+									  tgWorld::Config(), ParameterSweep::grid,
+									  0, 500, 1.0 / 1000.0, numThreads);
+	}
+
+	std::vector<ParameterSweep::Result> run(int numThreads) {
+		ParameterSweep sweep(makeConfig(numThreads));
+		sweep.addRange(ParameterSweep::Range("world.gravity", 1.0, 20.0, 4));
+		sweep.addRange(ParameterSweep::Range("rod.density", 0.5, 1.0, 2));
+		RodFactory factory;
+		return sweep.run(factory);
+	}
+
+#ifdef BT_NO_PROFILE
+
+	TEST(ParameterSweepTest, testThreadsMatchSerial) {
+		const std::vector<ParameterSweep::Result> serial = run(1);
+		const std::vector<ParameterSweep::Result> parallel = run(2);
+
+		ASSERT_EQ(8u, serial.size());
+		ASSERT_EQ(serial.size(), parallel.size());
+		for (std::size_t i = 0; i < serial.size(); i++) {
+			EXPECT_EQ("", serial[i].error);
+			EXPECT_EQ("", parallel[i].error);
+			EXPECT_EQ(serial[i].values, parallel[i].values);
+			ASSERT_EQ(2u, parallel[i].metrics.size());
+			EXPECT_DOUBLE_EQ(serial[i].metrics[0], parallel[i].metrics[0]);
+			EXPECT_DOUBLE_EQ(serial[i].metrics[1], parallel[i].metrics[1]);
+		}
+
+		// Each sample got its own configs: the heavier rods weigh more
+		EXPECT_LT(serial[0].metrics[1], serial[1].metrics[1]);
+	}
+
+#elif defined(_OPENMP)
+
+	TEST(ParameterSweepTest, testThreadsNeedNoProfile) {
+		EXPECT_THROW(ParameterSweep sweep(makeConfig(2)), std::invalid_argument);
+	}
+
+#endif
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
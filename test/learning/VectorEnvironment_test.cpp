@@ -0,0 +1,224 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file VectorEnvironment_test.cpp
+* @brief Contains a test of VectorEnvironment stepping on several threads
+* $Id$
+*/
+
+// This application
+#include "learning/VectorEnvironment/VectorEnvironment.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimulation.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <set>
+#include <stdexcept>
+#include <vector>
+// POSIX
+#include <pthread.h>
+
+namespace {
+
+	const std::size_t n = 8;
+	const int ticks = 120;
+
+	/** The threads that have stepped an environment, if recorded */
+	std::set<pthread_t> gThreads;
+	pthread_mutex_t gThreadsLock = PTHREAD_MUTEX_INITIALIZER;
+
+	/** One rod, dropped from a height that depends on its index */
+	class RodModel : public tgModel {
+	public:
+		RodModel(double height) : m_height(height) { }
+
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(0, m_height, 0);
+			s.addNode(0, m_height + 1, 10);
+			s.addPair(0, 1, "rod");
+
+			const tgRod::Config rodConfig;
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+		tgRod& rod() {
+			return *find<tgRod>("rod")[0];
+		}
+
+	private:
+		const double m_height;
+	};
+
+	/**
+	 * The action is a vertical impulse on the rod, the observation its
+	 * centre of mass, the reward its height.
+	 */
+	class RodEnvironment : public VectorEnvironment::Environment {
+	public:
+		RodEnvironment(double height, bool recordThreads) :
+			m_height(height),
+			m_recordThreads(recordThreads),
+			m_pModel(NULL) { }
+
+		virtual std::size_t getNumObservations() const { return 3; }
+
+		virtual std::size_t getNumActions() const { return 1; }
+
+		virtual void populate(tgSimulation& simulation) {
+			m_pModel = new RodModel(m_height);
+			simulation.addModel(m_pModel);
+		}
+
+		virtual void applyActions(const double* actions, double dt) {
+			if (m_recordThreads) {
+				pthread_mutex_lock(&gThreadsLock);
+				gThreads.insert(pthread_self());
+				pthread_mutex_unlock(&gThreadsLock);
+			}
+			m_pModel->rod().getPRigidBody()->activate(true);
+			m_pModel->rod().getPRigidBody()->applyCentralImpulse(
+				btVector3(0, actions[0], 0));
+		}
+
+		virtual void observe(double* observations) {
+			const btVector3 center = m_pModel->rod().centerOfMass();
+			observations[0] = center.x();
+			observations[1] = center.y();
+			observations[2] = center.z();
+		}
+
+		virtual double reward(bool& done) {
+			return m_pModel->rod().centerOfMass().y();
+		}
+
+	private:
+		const double m_height;
+		const bool m_recordThreads;
+		RodModel* m_pModel;
+	};
+
+	class RodFactory : public VectorEnvironment::Factory {
+	public:
+		RodFactory(bool recordThreads) : m_recordThreads(recordThreads) { }
+
+		virtual VectorEnvironment::Environment* create(std::size_t index) {
+			return new RodEnvironment(2.0 + index, m_recordThreads);
+		}
+
+	private:
+		const bool m_recordThreads;
+	};
+
+	/** The observations, rewards and dones of every tick, in order */
+	struct Trace {
+		std::vector<double> observations;
+		std::vector<double> rewards;
+		std::vector<unsigned char> dones;
+	};
+
+	Trace run(int numThreads) {
+		RodFactory factory(numThreads > 1);
+		// maxTicks ends episodes, so resets happen in the parallel loop too
+		VectorEnvironment environments(factory,
+			VectorEnvironment::Config(n, 1.0 / 1000.0, 10, 50, numThreads));
+
+		Trace trace;
+		std::vector<double> actions(n);
+		for (int t = 0; t < ticks; t++) {
+			for (std::size_t i = 0; i < n; i++) {
+				actions[i] = (t % 20 == 5) ? 0.5 * i : 0.0;
+			}
+			environments.step(&actions[0]);
+			const std::vector<double>& observations = environments.getObservations();
+			trace.observations.insert(trace.observations.end(),
+				observations.begin(), observations.end());
+			const std::vector<double>& rewards = environments.getRewards();
+			trace.rewards.insert(trace.rewards.end(), rewards.begin(), rewards.end());
+			const std::vector<unsigned char>& dones = environments.getDones();
+			trace.dones.insert(trace.dones.end(), dones.begin(), dones.end());
+		}
+		return trace;
+	}
+
+#ifdef BT_NO_PROFILE
+
+	TEST(VectorEnvironmentTest, testThreadsMatchSerial) {
+		const Trace serial = run(1);
+		const Trace parallel = run(2);
+
+		// Each world is stepped by one thread at a time, so the threads
+		// change nothing but the wall clock
+		ASSERT_EQ(serial.observations.size(), parallel.observations.size());
+		for (std::size_t k = 0; k < serial.observations.size(); k++) {
+			EXPECT_DOUBLE_EQ(serial.observations[k], parallel.observations[k]);
+		}
+		ASSERT_EQ(serial.rewards.size(), parallel.rewards.size());
+		for (std::size_t k = 0; k < serial.rewards.size(); k++) {
+			EXPECT_DOUBLE_EQ(serial.rewards[k], parallel.rewards[k]);
+		}
+		EXPECT_EQ(serial.dones, parallel.dones);
+		EXPECT_EQ(1, serial.dones[49 * n]);
+
+#ifdef _OPENMP
+		EXPECT_LT(1u, gThreads.size());
+#endif
+	}
+
+#elif defined(_OPENMP)
+
+	TEST(VectorEnvironmentTest, testThreadsNeedNoProfile) {
+		RodFactory factory(false);
+		EXPECT_THROW(VectorEnvironment(factory,
+			VectorEnvironment::Config(n, 1.0 / 1000.0, 10, 0, 2)),
+			std::invalid_argument);
+	}
+
+#endif
+
+	TEST(VectorEnvironmentTest, testConfigErrors) {
+		RodFactory factory(false);
+		EXPECT_THROW(VectorEnvironment(factory, VectorEnvironment::Config(0)),
+			std::invalid_argument);
+		EXPECT_THROW(VectorEnvironment(factory,
+			VectorEnvironment::Config(n, 1.0 / 1000.0, 0)),
+			std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,164 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgStaticBoxBatch_test.cpp
+* @brief Contains a test of block fields built as one tgStaticBoxBatch
+* $Id$
+*/
+
+// This application
+#include "models/obstacles/tgBlockField.h"
+#include "models/obstacles/tgStaticBoxBatch.h"
+#include "core/tgBox.h"
+#include "core/tgBulletUtil.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+	const std::size_t nBlocks = 12;
+
+	/**
+	 * Blocks with their centers on the ground, scattered along x. Every
+	 * field is seeded the same way, so all modes place the same blocks.
+	 */
+	tgBlockField::Config fieldConfig(tgStaticBoxBatch::Mode mode) {
+		return tgBlockField::Config(btVector3(0.0, 0.0, 0.0), 0.5, 0.0,
+									btVector3(-20.0, 0.0, 0.0),
+									btVector3(20.0, 0.0, 0.0),
+									nBlocks, 5.0, 5.0, 5.0, mode);
+	}
+
+	/** A long rod across the blocks, dropped from above them */
+	class RodModel : public tgModel {
+	public:
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(-30, 10, 2.5);
+			s.addNode(30, 10, 2.5);
+			s.addPair(0, 1, "rod");
+
+			const tgRod::Config rodConfig;
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+		double height() {
+			return find<tgRod>("rod")[0]->centerOfMass().y();
+		}
+	};
+
+	/** The height at which the rod comes to rest on a field */
+	double restingHeight(tgStaticBoxBatch::Mode mode) {
+		tgWorld world;
+		tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+		tgSimulation simulation(view);
+		tgBlockField::Config config = fieldConfig(mode);
+		simulation.addObstacle(new tgBlockField(config));
+		RodModel* const rod = new RodModel();
+		simulation.addModel(rod);
+
+		simulation.run(3000);
+		return rod->height();
+	}
+
+	void expectOneBody(tgStaticBoxBatch::Mode mode) {
+		tgWorld world;
+		tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+		tgSimulation simulation(view);
+		const btDynamicsWorld& dynamicsWorld =
+			tgBulletUtil::worldToDynamicsWorld(world);
+		const int before = dynamicsWorld.getNumCollisionObjects();
+
+		tgBlockField::Config config = fieldConfig(mode);
+		tgBlockField* const field = new tgBlockField(config);
+		simulation.addObstacle(field);
+
+		// All the boxes went into one static body
+		EXPECT_EQ(before + 1, dynamicsWorld.getNumCollisionObjects());
+		EXPECT_TRUE(field->find<tgBox>("box").empty());
+		const std::vector<tgStaticBoxBatch*> batches =
+			field->find<tgStaticBoxBatch>("box");
+		ASSERT_EQ(1u, batches.size());
+		EXPECT_EQ(nBlocks, batches[0]->size());
+		ASSERT_TRUE(batches[0]->getPRigidBody() != NULL);
+		EXPECT_TRUE(batches[0]->getPRigidBody()->isStaticObject());
+	}
+
+	TEST(tgStaticBoxBatchTest, testCompoundIsOneBody) {
+		expectOneBody(tgStaticBoxBatch::eCompound);
+	}
+
+	TEST(tgStaticBoxBatchTest, testTriangleMeshIsOneBody) {
+		expectOneBody(tgStaticBoxBatch::eTriangleMesh);
+	}
+
+	TEST(tgStaticBoxBatchTest, testSeparateBoxes) {
+		tgWorld world;
+		tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+		tgSimulation simulation(view);
+		const int before =
+			tgBulletUtil::worldToDynamicsWorld(world).getNumCollisionObjects();
+
+		tgBlockField::Config config = fieldConfig(tgStaticBoxBatch::eSeparate);
+		tgBlockField* const field = new tgBlockField(config);
+		simulation.addObstacle(field);
+
+		EXPECT_EQ(before + (int) nBlocks,
+				  tgBulletUtil::worldToDynamicsWorld(world).getNumCollisionObjects());
+		EXPECT_EQ(nBlocks, field->find<tgBox>("box").size());
+		EXPECT_TRUE(field->find<tgStaticBoxBatch>("box").empty());
+	}
+
+	TEST(tgStaticBoxBatchTest, testContactHeight) {
+		const double separate = restingHeight(tgStaticBoxBatch::eSeparate);
+
+		// The rod rests on the blocks, not on the ground
+		EXPECT_LT(2.5, separate);
+
+		EXPECT_NEAR(separate, restingHeight(tgStaticBoxBatch::eCompound), 1e-2);
+		EXPECT_NEAR(separate, restingHeight(tgStaticBoxBatch::eTriangleMesh), 1e-2);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,254 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgTiledTerrain_test.cpp
+* @brief Contains a test of tgTiledTerrain paging tiles around a moving model
+* $Id$
+*/
+
+// This application
+#include "models/obstacles/tgTiledTerrain.h"
+#include "core/tgBulletUtil.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <pthread.h>
+
+namespace {
+
+	const double tileSize = 10.0;
+	const int activeRadius = 1;
+	const int prefetchRadius = 2;
+	const std::size_t activeTiles = (2 * activeRadius + 1) * (2 * activeRadius + 1);
+	const std::size_t prefetchTiles = (2 * prefetchRadius + 1) * (2 * prefetchRadius + 1);
+
+	/**
+	 * The tiles built and not yet deleted. Tiles are built on the loading
+	 * thread and deleted on this one.
+	 */
+	class TileCounts {
+	public:
+		TileCounts() : m_created(0), m_live(0) {
+			pthread_mutex_init(&m_mutex, NULL);
+		}
+
+		~TileCounts() {
+			pthread_mutex_destroy(&m_mutex);
+		}
+
+		void add(int delta) {
+			pthread_mutex_lock(&m_mutex);
+			if (delta > 0) {
+				m_created += delta;
+			}
+			m_live += delta;
+			pthread_mutex_unlock(&m_mutex);
+		}
+
+		int created() {
+			pthread_mutex_lock(&m_mutex);
+			const int n = m_created;
+			pthread_mutex_unlock(&m_mutex);
+			return n;
+		}
+
+		int live() {
+			pthread_mutex_lock(&m_mutex);
+			const int n = m_live;
+			pthread_mutex_unlock(&m_mutex);
+			return n;
+		}
+
+	private:
+		pthread_mutex_t m_mutex;
+		int m_created;
+		int m_live;
+	};
+
+	/** A flat slab that counts itself */
+	class CountedBox : public btBoxShape {
+	public:
+		CountedBox(TileCounts& counts) :
+			btBoxShape(btVector3(tileSize / 2.0, 0.5, tileSize / 2.0)),
+			m_counts(counts) {
+			m_counts.add(1);
+		}
+
+		virtual ~CountedBox() {
+			m_counts.add(-1);
+		}
+
+	private:
+		TileCounts& m_counts;
+	};
+
+	class CountingSource : public tgTiledTerrain::TileSource {
+	public:
+		CountingSource(TileCounts& counts) : m_counts(counts) { }
+
+		virtual btCollisionShape* createTile(int i, int j,
+											 double size,
+											 btTransform& transform) {
+			transform.setIdentity();
+			transform.setOrigin(btVector3((i + 0.5) * size, -0.5,
+										  (j + 0.5) * size));
+			return new CountedBox(m_counts);
+		}
+
+	private:
+		TileCounts& m_counts;
+	};
+
+	/** One rod above the ground, sent along x without gravity */
+	class RodModel : public tgModel {
+	public:
+		virtual void setup(tgWorld& world) {
+			tgStructure s;
+			s.addNode(1, 5, 1);
+			s.addNode(1, 5, 5);
+			s.addPair(0, 1, "rod");
+
+			const tgRod::Config rodConfig;
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+
+			find<tgRod>("rod")[0]->getPRigidBody()->setLinearVelocity(
+				btVector3(20.0, 0.0, 0.0));
+		}
+	};
+
+	int collisionObjects(const tgWorld& world) {
+		return tgBulletUtil::worldToDynamicsWorld(world).getNumCollisionObjects();
+	}
+
+	TEST(tgTiledTerrainTest, testPagingAroundTrackedModel) {
+		TileCounts counts;
+		{
+			tgWorld world(tgWorld::Config(0.0));
+			tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+			tgSimulation simulation(view);
+			const int before = collisionObjects(world);
+
+			RodModel* const rod = new RodModel();
+			simulation.addModel(rod);
+			tgTiledTerrain* const terrain = new tgTiledTerrain(
+				new CountingSource(counts),
+				tgTiledTerrain::Config(tileSize, activeRadius, prefetchRadius));
+			terrain->track(rod);
+			simulation.addModel(terrain);
+
+			EXPECT_EQ(activeTiles, terrain->activeTileCount());
+			EXPECT_EQ(before + 1 + (int) activeTiles, collisionObjects(world));
+
+			// 40 units along x: across four tile boundaries
+			int crossings = 0;
+			int lastTile = (int) std::floor(terrain->center().x() / tileSize);
+			for (int t = 0; t < 2000; t++) {
+				simulation.run(1);
+				const int tile = (int) std::floor(terrain->center().x() / tileSize);
+				if (tile != lastTile) {
+					crossings++;
+					lastTile = tile;
+				}
+				ASSERT_EQ(activeTiles, terrain->activeTileCount());
+				ASSERT_GE(prefetchTiles, terrain->loadedTileCount());
+				ASSERT_EQ(before + 1 + (int) activeTiles, collisionObjects(world));
+			}
+			EXPECT_LE(4, crossings);
+
+			// Each crossing builds one new column of the prefetch ring; the
+			// tiles that stay in the ring aren't built again
+			EXPECT_GE((int) (prefetchTiles + crossings * (2 * prefetchRadius + 1)),
+					  counts.created());
+
+			// Teardown takes every tile body out, and is safe to repeat
+			terrain->teardown();
+			EXPECT_EQ(0u, terrain->activeTileCount());
+			EXPECT_EQ(before + 1, collisionObjects(world));
+			terrain->teardown();
+			EXPECT_EQ(0u, terrain->activeTileCount());
+
+			// A reset puts the rod back at the start, and the tiles with it
+			simulation.reset();
+			EXPECT_EQ(activeTiles, terrain->activeTileCount());
+			EXPECT_GE(prefetchTiles, terrain->loadedTileCount());
+			EXPECT_EQ(before + 1 + (int) activeTiles, collisionObjects(world));
+			EXPECT_EQ(0, (int) std::floor(terrain->center().x() / tileSize));
+		}
+		// The simulation tore the terrain down and deleted it with its tiles
+		EXPECT_EQ(0, counts.live());
+	}
+
+	TEST(tgTiledTerrainTest, testUntrackedTerrainStaysAtOrigin) {
+		TileCounts counts;
+		{
+			tgWorld world(tgWorld::Config(0.0));
+			tgSimView view(world, 1.0 / 1000.0, 1.0 / 60.0);
+			tgSimulation simulation(view);
+			tgTiledTerrain* const terrain = new tgTiledTerrain(
+				new CountingSource(counts),
+				tgTiledTerrain::Config(tileSize, activeRadius, prefetchRadius));
+			simulation.addModel(terrain);
+
+			simulation.run(100);
+			EXPECT_EQ(activeTiles, terrain->activeTileCount());
+			EXPECT_GE(prefetchTiles, terrain->loadedTileCount());
+			EXPECT_GE((int) prefetchTiles, counts.created());
+		}
+		EXPECT_EQ(0, counts.live());
+	}
+
+	TEST(tgTiledTerrainTest, testErrors) {
+		EXPECT_THROW(tgTiledTerrain::Config(0.0), std::invalid_argument);
+		EXPECT_THROW(tgTiledTerrain::Config(tileSize, -1), std::invalid_argument);
+		EXPECT_THROW(tgTiledTerrain::Config(tileSize, 2, 1), std::invalid_argument);
+		EXPECT_THROW(tgTiledTerrain(NULL), std::invalid_argument);
+
+		TileCounts counts;
+		tgTiledTerrain terrain(new CountingSource(counts));
+		EXPECT_THROW(terrain.track(NULL), std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,119 @@
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+"""
+Tests of the ntrt Python bindings. Run with the built module on the path:
+
+    PYTHONPATH=build/python python -m unittest discover test/python
+"""
+
+import gc
+import threading
+import time
+import unittest
+
+import ntrt
+
+
+class TestSimulationThreads(unittest.TestCase):
+
+    # Long enough that the other thread is still stepping when checked
+    STEPS = 1000000
+
+    def setUp(self):
+        self.sim = ntrt.Simulation(ntrt.World())
+        self.errors = []
+
+    def stepInBackground(self):
+        def run():
+            try:
+                self.sim.step(self.STEPS)
+            except RuntimeError as e:
+                self.errors.append(e)
+        thread = threading.Thread(target=run)
+        thread.start()
+        deadline = time.time() + 10.0
+        while not self.sim.busy and thread.is_alive() and time.time() < deadline:
+            time.sleep(0)
+        return thread
+
+    def testConcurrentCallsRaise(self):
+        thread = self.stepInBackground()
+        try:
+            self.assertTrue(self.sim.busy, "step() finished before it was checked")
+            self.assertRaises(RuntimeError, self.sim.step)
+            self.assertRaises(RuntimeError, self.sim.reset)
+            self.assertRaises(RuntimeError, self.sim.add_yaml_model, "unused.yaml")
+            self.assertRaises(RuntimeError, getattr, self.sim, "num_bodies")
+        finally:
+            thread.join()
+        # The stepping thread itself was not disturbed
+        self.assertEqual([], self.errors)
+        self.assertFalse(self.sim.busy)
+        self.sim.step()
+        self.sim.reset()
+
+    @unittest.skipUnless(ntrt.PARALLEL_STEPPING,
+                         "Bullet was built with its profiler")
+    def testSimulationsStepInParallel(self):
+        other = ntrt.Simulation(ntrt.World())
+        thread = self.stepInBackground()
+        try:
+            other.step(10)
+            # Done without waiting for the other simulation's turn
+            self.assertTrue(self.sim.busy)
+        finally:
+            thread.join()
+        self.assertEqual([], self.errors)
+
+    @unittest.skipIf(ntrt.PARALLEL_STEPPING, "simulations step in parallel")
+    def testSimulationsTakeTurns(self):
+        other = ntrt.Simulation(ntrt.World())
+        thread = self.stepInBackground()
+        try:
+            other.step(10)
+            # It waited for the background step() to finish with Bullet,
+            # so that thread is only handing back the GIL
+            thread.join(1.0)
+            self.assertFalse(thread.is_alive())
+        finally:
+            thread.join()
+        self.assertEqual([], self.errors)
+
+
+class TestWorldOwnership(unittest.TestCase):
+
+    def testSecondSimulationRaises(self):
+        world = ntrt.World()
+        first = ntrt.Simulation(world)
+        self.assertRaises(RuntimeError, ntrt.Simulation, world)
+        first.step()
+
+    def testWorldIsFreedForReuse(self):
+        world = ntrt.World()
+        first = ntrt.Simulation(world)
+        del first
+        gc.collect()
+        second = ntrt.Simulation(world)
+        second.step()
+
+    def testReinitializeRaises(self):
+        sim = ntrt.Simulation(ntrt.World())
+        self.assertRaises(RuntimeError, sim.__init__, ntrt.World())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,141 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgStructureGenerator_test.cpp
+* @brief Contains a test of the sizes and shapes of the structures made by
+* tgStructureGenerator
+* $Id$
+*/
+
+// This application
+#include "tgcreator/tgStructureGenerator.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgPair.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+	const tgStructureGenerator::Config config(10.0, 2.0);
+
+	int countPairs(const tgStructure& s, const std::string& tags) {
+		int count = 0;
+		const tgPairs& pairs = s.getPairs();
+		for (std::size_t i = 0; i < pairs.size(); i++) {
+			if (pairs[i].getTags().contains(tags)) {
+				count++;
+			}
+		}
+		const std::vector<tgStructure*>& children = s.getChildren();
+		for (std::size_t i = 0; i < children.size(); i++) {
+			count += countPairs(*children[i], tags);
+		}
+		return count;
+	}
+
+	/** Every rod of every module is config.length long */
+	void expectRodLengths(const tgStructure& s) {
+		const std::vector<tgStructure*>& children = s.getChildren();
+		for (std::size_t i = 0; i < children.size(); i++) {
+			const tgPairs& pairs = children[i]->getPairs();
+			for (std::size_t j = 0; j < pairs.size(); j++) {
+				if (pairs[j].getTags().contains("rod")) {
+					const btVector3 rod = pairs[j].getTo() - pairs[j].getFrom();
+					EXPECT_NEAR(config.length, rod.length(), 1.0e-9);
+				}
+			}
+		}
+	}
+
+	TEST(tgStructureGeneratorTest, testPrismLattice) {
+		tgStructure s;
+		tgStructureGenerator::addPrismLattice(s, 2, 3, 4, config);
+
+		EXPECT_EQ(24, s.getChildren().size());
+		EXPECT_EQ(72, countPairs(s, "rod"));
+		// 9 per prism, 3 per vertical, 2 per x and 4 per z neighbor
+		const int joins = 3 * (2 * 2 * 4) + 2 * (1 * 3 * 4) + 4 * (2 * 3 * 3);
+		EXPECT_EQ(9 * 24 + joins, countPairs(s, "cable"));
+		EXPECT_EQ(joins, s.getPairs().size());
+		expectRodLengths(s);
+
+		// Vertical and x joins are as long as the gap
+		const btVector3 vertical = s.getPairs()[0].getTo() - s.getPairs()[0].getFrom();
+		EXPECT_NEAR(config.gap, vertical.length(), 1.0e-9);
+	}
+
+	TEST(tgStructureGeneratorTest, testSpine) {
+		tgStructure s;
+		tgStructureGenerator::addSpine(s, 5, config);
+
+		EXPECT_EQ(5, s.getChildren().size());
+		EXPECT_EQ(15, countPairs(s, "rod"));
+		EXPECT_EQ(6 * 4, countPairs(s, "cable"));
+		expectRodLengths(s);
+	}
+
+	TEST(tgStructureGeneratorTest, testIcosahedronLattice) {
+		tgStructure s;
+		tgStructureGenerator::addIcosahedronLattice(s, 3, 2, 2, config);
+
+		EXPECT_EQ(12, s.getChildren().size());
+		EXPECT_EQ(72, countPairs(s, "rod"));
+		const int joins = 2 * (2 * 2 * 2 + 3 * 1 * 2 + 3 * 2 * 1);
+		EXPECT_EQ(24 * 12 + joins, countPairs(s, "cable"));
+		expectRodLengths(s);
+
+		// Every join is as long as the gap
+		const tgPairs& pairs = s.getPairs();
+		for (std::size_t i = 0; i < pairs.size(); i++) {
+			const btVector3 join = pairs[i].getTo() - pairs[i].getFrom();
+			EXPECT_NEAR(config.gap, join.length(), 1.0e-9);
+		}
+
+		// It grows from the origin
+		EXPECT_GE(s.getChildren()[0]->getCentroid().x(), 0.0);
+	}
+
+	TEST(tgStructureGeneratorTest, testTags) {
+		tgStructure s;
+		tgStructureGenerator::addSpine(s, 2,
+			tgStructureGenerator::Config(1.0, 1.0, "strut", "tendon spine"));
+		EXPECT_EQ(6, countPairs(s, "strut"));
+		EXPECT_EQ(6, countPairs(s, "tendon spine"));
+		EXPECT_EQ(0, countPairs(s, "rod"));
+	}
+
+	TEST(tgStructureGeneratorTest, testInvalid) {
+		tgStructure s;
+		EXPECT_THROW(tgStructureGenerator::Config(0.0, 1.0), std::invalid_argument);
+		EXPECT_THROW(tgStructureGenerator::Config(1.0, 0.0), std::invalid_argument);
+		EXPECT_THROW(tgStructureGenerator::addPrismLattice(s, 1, 0, 1), std::invalid_argument);
+		EXPECT_THROW(tgStructureGenerator::addSpine(s, 0), std::invalid_argument);
+		EXPECT_THROW(tgStructureGenerator::addIcosahedronLattice(s, 1, 1, -1), std::invalid_argument);
+		EXPECT_TRUE(s.getChildren().empty());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
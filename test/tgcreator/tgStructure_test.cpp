@@ -0,0 +1,207 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgStructure_test.cpp
+* @brief Contains a test of copies of tgStructure, which share nodes, pairs
+* and children until they are changed
+* $Id$
+*/
+
+// This application
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgNode.h"
+#include "tgcreator/tgPair.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btQuaternion.h"
+// Google Test
+#include "gtest/gtest.h"
+// The C++ Standard Library
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+	void expectNear(const btVector3& expected, const btVector3& actual) {
+		EXPECT_NEAR(expected.x(), actual.x(), 1.0e-9);
+		EXPECT_NEAR(expected.y(), actual.y(), 1.0e-9);
+		EXPECT_NEAR(expected.z(), actual.z(), 1.0e-9);
+	}
+
+	void makeSegment(tgStructure& s) {
+		s.addNode(0, 0, 0, "base");
+		s.addNode(1, 0, 0);
+		s.addNode(0, 2, 0, "top");
+		s.addPair(0, 1, "rod");
+		s.addPair(1, 2, "string");
+	}
+
+	TEST(tgStructureTest, testCopyIsIndependent) {
+		tgStructure segment;
+		makeSegment(segment);
+
+		tgStructure copy(segment);
+		copy.move(btVector3(0, 0, 5));
+		copy.addNode(3, 3, 3);
+
+		// The original is untouched
+		ASSERT_EQ(3, segment.getNodes().size());
+		expectNear(btVector3(1, 0, 0), segment.getNodes()[1]);
+		expectNear(btVector3(1, 0, 0), segment.getPairs()[0].getTo());
+
+		// The copy was moved before the new node was added
+		ASSERT_EQ(4, copy.getNodes().size());
+		expectNear(btVector3(1, 0, 5), copy.getNodes()[1]);
+		expectNear(btVector3(3, 3, 3), copy.getNodes()[3]);
+		expectNear(btVector3(0, 2, 5), copy.getPairs()[1].getTo());
+		EXPECT_TRUE(copy.getNodes()[2].hasTag("top"));
+		EXPECT_TRUE(copy.getPairs()[0].hasTag("rod"));
+
+		// Changing the original doesn't reach the copy either
+		segment.move(btVector3(1, 0, 0));
+		expectNear(btVector3(2, 0, 0), segment.getNodes()[1]);
+		expectNear(btVector3(1, 0, 5), copy.getNodes()[1]);
+	}
+
+	TEST(tgStructureTest, testComposedTransforms) {
+		tgStructure s;
+		makeSegment(s);
+		tgStructure t(s);
+
+		// Applied one at a time to the nodes, as they are built
+		s.move(btVector3(1, 2, 3));
+		s.getNodes();
+		s.addRotation(btVector3(1, 0, 0), btVector3(0, 0, 1), M_PI / 2);
+		s.getNodes();
+		s.scale(btVector3(0, 1, 0), 2.0);
+
+		// Composed, then applied once
+		t.move(btVector3(1, 2, 3));
+		t.addRotation(btVector3(1, 0, 0), btVector3(0, 0, 1), M_PI / 2);
+		t.scale(btVector3(0, 1, 0), 2.0);
+
+		for (int i = 0; i < 3; i++) {
+			expectNear(s.getNodes()[i], t.getNodes()[i]);
+		}
+		for (int i = 0; i < 2; i++) {
+			expectNear(s.getPairs()[i].getFrom(), t.getPairs()[i].getFrom());
+			expectNear(s.getPairs()[i].getTo(), t.getPairs()[i].getTo());
+		}
+		expectNear(s.getCentroid(), t.getCentroid());
+	}
+
+	TEST(tgStructureTest, testInstancedChildren) {
+		tgStructure segment;
+		makeSegment(segment);
+
+		tgStructure spine;
+		for (int i = 0; i < 10; i++) {
+			tgStructure* const p = new tgStructure(segment);
+			p->addTags("segment");
+			p->move(btVector3(0, 0, i));
+			spine.addChild(p);
+		}
+		// The children get our transform after theirs
+		spine.move(btVector3(10, 0, 0));
+		expectNear(btVector3(10 + 1.0 / 3, 2.0 / 3, 4.5), spine.getCentroid());
+
+		// A copy of the spine, children and all, is independent too
+		tgStructure other(spine);
+		other.findNode("top").setY(7);
+		expectNear(btVector3(10, 7, 0), other.getChildren()[0]->getNodes()[2]);
+		expectNear(btVector3(10, 2, 0), spine.getChildren()[0]->getNodes()[2]);
+		expectNear(btVector3(11, 0, 9), spine.getChildren()[9]->getNodes()[1]);
+		expectNear(btVector3(0, 2, 0), segment.getNodes()[2]);
+
+		// A child we add isn't moved by what was done before
+		spine.addChild(segment);
+		expectNear(btVector3(1, 0, 0), spine.getChildren()[10]->getNodes()[1]);
+
+		spine.removePair(tgPair(btVector3(10, 0, 3), btVector3(11, 0, 3)));
+		EXPECT_EQ(1, spine.getChildren()[3]->getPairs().size());
+		EXPECT_EQ(2, spine.getChildren()[4]->getPairs().size());
+		EXPECT_EQ(2, segment.getPairs().size());
+	}
+
+	TEST(tgStructureTest, testFindUnknownTag) {
+		tgStructure segment;
+		makeSegment(segment);
+		tgStructure parent;
+		parent.addChild(segment);
+		parent.getChildren()[0]->addTags("segment");
+
+		// The known tags alone would match, but nothing has the unknown one
+		EXPECT_THROW(parent.findNode("top neverSeenNodeTag"), std::invalid_argument);
+		EXPECT_THROW(parent.findChild("segment neverSeenChildTag"), std::invalid_argument);
+		EXPECT_THROW(parent.findNode("neverSeenNodeTag"), std::invalid_argument);
+
+		expectNear(btVector3(0, 2, 0), parent.findNode("top"));
+		EXPECT_TRUE(parent.findChild("segment").hasTag("segment"));
+	}
+
+	TEST(tgStructureTest, testFindInTransformedCopies) {
+		tgStructure segment;
+		makeSegment(segment);
+
+		tgStructure spine;
+		for (int i = 0; i < 4; i++) {
+			tgStructure* const p = new tgStructure(segment);
+			p->addTags(i == 2 ? "segment middle" : "segment");
+			p->move(btVector3(0, 0, i));
+			spine.addChild(p);
+		}
+		spine.addRotation(btVector3(0, 0, 0), btVector3(0, 0, 1), M_PI / 2);
+		tgStructure other(spine);
+
+		// Pairs are found where they will be once the transforms apply
+		const btVector3 from = other.getChildren()[3]->getPairs()[1].getFrom();
+		const btVector3 to = other.getChildren()[3]->getPairs()[1].getTo();
+		tgStructure copy(spine);
+		tgPair& pair = copy.findPair(to, from);
+		EXPECT_TRUE(pair.getFrom() == from);
+		pair.addTags("found");
+		EXPECT_TRUE(copy.getChildren()[3]->getPairs()[1].hasTag("found"));
+		EXPECT_FALSE(spine.getChildren()[3]->getPairs()[1].hasTag("found"));
+
+		// What a search returns is ours alone
+		copy.findChild("middle").addNode(5, 5, 5);
+		EXPECT_EQ(4, copy.getChildren()[2]->getNodes().size());
+		EXPECT_EQ(3, spine.getChildren()[2]->getNodes().size());
+		EXPECT_EQ(3, segment.getNodes().size());
+
+		EXPECT_THROW(copy.findPair(from, from), std::invalid_argument);
+	}
+
+	TEST(tgStructureTest, testAssignment) {
+		tgStructure a;
+		makeSegment(a);
+		a.addChild(a);
+		tgStructure b;
+		b = a;
+		b.move(btVector3(0, 1, 0));
+		expectNear(btVector3(0, 1, 0), b.getChildren()[0]->getNodes()[0]);
+		expectNear(btVector3(0, 0, 0), a.getChildren()[0]->getNodes()[0]);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,225 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file PerformanceBenchmark.cpp
+* @brief Runs one of a fixed set of canonical models headless for a
+* number of steps, reporting build time, speed, reset time and peak
+* memory, so that performance regressions can be caught.
+* @see checkPerformance.py
+* $Id$
+*/
+
+// The canonical models
+#include "examples/3_prism/PrismModel.h"
+#include "examples/SUPERball/T6Model.h"
+#include "examples/contactCables/ContactCableDemo.h"
+#include "examples/contactCables/TetraSpineCollisions.h"
+#include "examples/contactCables/colSpineSine.h"
+#include "yamlbuilder/TensegrityModel.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/terrain/tgEmptyGround.h"
+#include "core/terrain/tgHillyGround.h"
+#include "core/tgModel.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics library
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+// POSIX
+#include <sys/resource.h>
+
+namespace
+{
+    /**
+     * Every run starts from the same seed, so controllers and models that
+     * draw random numbers do the same work from run to run.
+     */
+    const unsigned int seed = 1;
+
+    /** Where the YAML scenarios' structures are, set by CMakeLists.txt */
+    const std::string yamlPath(YAML_STRUCTURE_PATH);
+
+    tgGround* createGround(const std::string& scenario)
+    {
+        if (scenario == "tetraspine")
+        {
+            // Same terrain as TetraSpineHills_test
+            const btVector3 eulerAngles(M_PI/4.0, 0.0, 0.0);
+            const btScalar friction = 0.5;
+            const btScalar restitution = 0.1;
+            const btVector3 size(500.0, 1.5, 500.0);
+            const btVector3 origin(0.0, 0.0, 0.0);
+            const size_t nx = 100;
+            const size_t ny = 100;
+            const double triangleSize = 2.0;
+            const double waveHeight = 2.0;
+            const double offset = 0.0;
+            const double margin = 1.0;
+            const tgHillyGround::Config groundConfig(eulerAngles, friction,
+                                                     restitution, size, origin,
+                                                     nx, ny, margin,
+                                                     triangleSize, waveHeight,
+                                                     offset);
+            return new tgHillyGround(groundConfig);
+        }
+        else if (scenario == "contactcable")
+        {
+            // Same as AppContactCables, which checks conservation of energy
+            return new tgEmptyGround();
+        }
+        return new tgBoxGround();
+    }
+
+    /** @return NULL if the scenario is unknown */
+    tgModel* createModel(const std::string& scenario)
+    {
+        if (scenario == "prism")
+        {
+            return new PrismModel();
+        }
+        else if (scenario == "superball")
+        {
+            return new T6Model();
+        }
+        else if (scenario == "tetraspine")
+        {
+            const int segments = 6;
+            const double scale = 100;
+            TetraSpineCollisions* const myModel =
+                new TetraSpineCollisions(segments, scale / 2.0);
+            colSpineSine* const myControl =
+                new colSpineSine("controlVars.json", "tetraTerrain/");
+            myModel->attach(myControl);
+            return myModel;
+        }
+        else if (scenario == "contactcable")
+        {
+            return new ContactCableDemo();
+        }
+        else if (scenario == "yamlsixbar")
+        {
+            return new TensegrityModel(yamlPath + "/BaseStructures/SuperBall.yaml",
+                                       false);
+        }
+        else if (scenario == "bigpuppy")
+        {
+            return new TensegrityModel(yamlPath + "/BigPuppy.yaml", false);
+        }
+        return NULL;
+    }
+
+    double secondsSince(std::clock_t start)
+    {
+        return (double) (std::clock() - start) / CLOCKS_PER_SEC;
+    }
+
+    /** The most resident memory this process has used, in kilobytes */
+    long peakResidentKB()
+    {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+        return usage.ru_maxrss;
+    }
+
+    void usage(const char* name)
+    {
+        std::cerr << "usage: " << name
+                  << " <prism|superball|tetraspine|contactcable|yamlsixbar|bigpuppy>"
+                  << " <steps>" << std::endl;
+    }
+}
+
+/**
+ * Runs one scenario and prints a single machine readable result line:
+ * precision,scenario,steps,buildSeconds,seconds,stepsPerSecond,
+ * resetSeconds,peakRssKB
+ * Build time covers constructing the model and its first setup; reset
+ * time is that of one tgSimulation::reset after the run.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const std::string scenario(argv[1]);
+    const int steps = atoi(argv[2]);
+    if (steps <= 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::srand(seed);
+
+    const double gravity = (scenario == "contactcable") ? 0.0 : 981.0;
+    const tgWorld::Config config(gravity); // gravity, cm/sec^2
+    tgWorld world(config, createGround(scenario));
+
+    const double stepSize = 1.0/1000.0; // Seconds
+    const double renderRate = 1.0/60.0; // Seconds
+    tgSimView view(world, stepSize, renderRate);
+
+    tgSimulation simulation(view);
+
+    const std::clock_t buildStart = std::clock();
+    tgModel* const myModel = createModel(scenario);
+    if (myModel == NULL)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    simulation.addModel(myModel);
+    const double buildSeconds = secondsSince(buildStart);
+
+    const std::clock_t runStart = std::clock();
+    simulation.run(steps);
+    const double elapsed = secondsSince(runStart);
+
+    const std::clock_t resetStart = std::clock();
+    simulation.reset();
+    const double resetSeconds = secondsSince(resetStart);
+
+#ifdef BT_USE_DOUBLE_PRECISION
+    const std::string precision("double");
+#else
+    const std::string precision("single");
+#endif
+
+    std::cout << precision << "," << scenario << "," << steps << ","
+              << buildSeconds << "," << elapsed << ","
+              << (elapsed > 0.0 ? steps / elapsed : 0.0) << ","
+              << resetSeconds << "," << peakResidentKB()
+              << std::endl;
+
+    return 0;
+}
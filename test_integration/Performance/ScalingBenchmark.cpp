@@ -0,0 +1,200 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file ScalingBenchmark.cpp
+* @brief Builds a structure from tgStructureGenerator at a given size and
+* runs it headless, reporting build time, speed and peak memory, so the
+* cost per rod and cable can be followed as models grow.
+* @see checkScaling.py
+* $Id$
+*/
+
+// This library
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureGenerator.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+// POSIX
+#include <sys/resource.h>
+
+namespace
+{
+    /** Same materials as PrismModel */
+    const double density = 0.2;
+    const double radius = 0.31;
+    const double stiffness = 1000.0;
+    const double damping = 10.0;
+    const double pretension = 500.0;
+
+    /**
+     * A structure from tgStructureGenerator: a size^3 lattice of prisms or
+     * icosahedra, or a spine of size vertebrae.
+     */
+    class GeneratedModel : public tgModel
+    {
+    public:
+        GeneratedModel(const std::string& shape, int size) :
+            m_shape(shape),
+            m_size(size)
+        {
+        }
+
+        virtual void setup(tgWorld& world)
+        {
+            const tgStructureGenerator::Config config;
+
+            tgStructure s;
+            if (m_shape == "prisms")
+            {
+                tgStructureGenerator::addPrismLattice(s, m_size, m_size,
+                                                      m_size, config);
+            }
+            else if (m_shape == "spine")
+            {
+                tgStructureGenerator::addSpine(s, m_size, config);
+            }
+            else
+            {
+                tgStructureGenerator::addIcosahedronLattice(s, m_size, m_size,
+                                                            m_size, config);
+            }
+            // Clear of the ground
+            s.move(btVector3(0, config.length, 0));
+
+            const tgRod::Config rodConfig(radius, density);
+            const tgSpringCableActuator::Config cableConfig(stiffness, damping,
+                                                            pretension);
+            tgBuildSpec spec;
+            spec.addBuilder(config.rodTags, new tgRodInfo(rodConfig));
+            spec.addBuilder(config.cableTags, new tgBasicActuatorInfo(cableConfig));
+
+            tgStructureInfo structureInfo(s, spec);
+            structureInfo.buildInto(*this, world);
+
+            tgModel::setup(world);
+        }
+
+    private:
+        const std::string m_shape;
+        const int m_size;
+    };
+
+    double secondsSince(std::clock_t start)
+    {
+        return (double) (std::clock() - start) / CLOCKS_PER_SEC;
+    }
+
+    /** The most resident memory this process has used, in kilobytes */
+    long peakResidentKB()
+    {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+        return usage.ru_maxrss;
+    }
+
+    void usage(const char* name)
+    {
+        std::cerr << "usage: " << name
+                  << " <prisms|spine|icosahedra> <size> <steps>" << std::endl;
+    }
+}
+
+/**
+ * Builds and runs one structure and prints a single machine readable
+ * result line:
+ * precision,shape,size,rods,cables,buildSeconds,steps,seconds,
+ * stepsPerSecond,peakRssKB
+ * Peak memory only grows within a process, so run one size per process.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const std::string shape(argv[1]);
+    const int size = atoi(argv[2]);
+    const int steps = atoi(argv[3]);
+    if ((shape != "prisms" && shape != "spine" && shape != "icosahedra") ||
+        size <= 0 || steps <= 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const tgWorld::Config config(981); // gravity, cm/sec^2
+    tgWorld world(config);
+
+    const double stepSize = 1.0/1000.0; // Seconds
+    const double renderRate = 1.0/60.0; // Seconds
+    tgSimView view(world, stepSize, renderRate);
+
+    tgSimulation simulation(view);
+
+    const std::clock_t buildStart = std::clock();
+    GeneratedModel* const myModel = new GeneratedModel(shape, size);
+    simulation.addModel(myModel);
+    const double buildSeconds = secondsSince(buildStart);
+
+    const std::vector<tgModel*>& descendants = myModel->getDescendants();
+    const std::size_t rods =
+        tgCast::filter<tgModel, tgRod>(descendants).size();
+    const std::size_t cables =
+        tgCast::filter<tgModel, tgBasicActuator>(descendants).size();
+
+    const std::clock_t runStart = std::clock();
+    simulation.run(steps);
+    const double elapsed = secondsSince(runStart);
+
+#ifdef BT_USE_DOUBLE_PRECISION
+    const std::string precision("double");
+#else
+    const std::string precision("single");
+#endif
+
+    std::cout << precision << "," << shape << "," << size << ","
+              << rods << "," << cables << "," << buildSeconds << ","
+              << steps << "," << elapsed << ","
+              << (elapsed > 0.0 ? steps / elapsed : 0.0) << ","
+              << peakResidentKB() << std::endl;
+
+    return 0;
+}
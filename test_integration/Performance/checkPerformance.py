@@ -0,0 +1,170 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+# Purpose: Run PerformanceBenchmark on the canonical models and compare
+#          steps per second, build time, reset time and peak memory with
+#          a baseline. Exits with 1 if any of them regressed past its
+#          threshold.
+# Usage:   bin/build.sh -i, then from the repository root:
+#          checkPerformance.py --write-baseline perf.json   (on a known good tree)
+#          checkPerformance.py --baseline perf.json         (on the change)
+#          Baselines only mean something on the machine they were made on.
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+
+SCENARIOS = {
+    "prism": 20000,
+    "superball": 20000,
+    "tetraspine": 15000,
+    "contactcable": 4000,
+    "yamlsixbar": 20000,
+    "bigpuppy": 10000,
+}
+
+FIELDS = ["stepsPerSecond", "buildSeconds", "resetSeconds", "peakRssKB"]
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+    if len(ordered) % 2 == 1:
+        return ordered[middle]
+    return (ordered[middle - 1] + ordered[middle]) / 2.0
+
+
+def runBenchmark(executable, scenario, steps):
+    """ Returns the measurements of one run as a dict of FIELDS. """
+    output = subprocess.check_output([executable, scenario, str(steps)])
+    lastLine = output.decode().strip().splitlines()[-1]
+    values = lastLine.split(",")
+    # precision,scenario,steps,buildSeconds,seconds,stepsPerSecond,resetSeconds,peakRssKB
+    return {
+        "stepsPerSecond": float(values[5]),
+        "buildSeconds": float(values[3]),
+        "resetSeconds": float(values[6]),
+        "peakRssKB": float(values[7]),
+    }
+
+
+def measure(executable, scenario, steps, repeat):
+    """ The median of each field over repeat runs. """
+    runs = [runBenchmark(executable, scenario, steps) for _ in range(repeat)]
+    result = dict((field, median([run[field] for run in runs])) for field in FIELDS)
+    result["steps"] = steps
+    return result
+
+
+def regressions(scenario, result, baseline, args):
+    """ Descriptions of every measurement that is worse than the thresholds allow. """
+    found = []
+    if scenario not in baseline:
+        return found
+    base = baseline[scenario]
+
+    if base["stepsPerSecond"] > 0:
+        drop = 1.0 - result["stepsPerSecond"] / base["stepsPerSecond"]
+        if drop > args.max_slowdown:
+            found.append("%s: %.1f steps/s is %.0f%% below the baseline %.1f"
+                         % (scenario, result["stepsPerSecond"], 100 * drop,
+                            base["stepsPerSecond"]))
+
+    # Build and reset take a few milliseconds for the small models, so
+    # ignore changes smaller than the clock can tell apart
+    for field in ("buildSeconds", "resetSeconds"):
+        increase = result[field] - base[field]
+        if increase > args.min_time and increase > args.max_time_increase * base[field]:
+            found.append("%s: %s %.3f is above the baseline %.3f"
+                         % (scenario, field, result[field], base[field]))
+
+    if base["peakRssKB"] > 0:
+        growth = result["peakRssKB"] / base["peakRssKB"] - 1.0
+        if growth > args.max_memory_increase:
+            found.append("%s: peak RSS %d KB is %.0f%% above the baseline %d KB"
+                         % (scenario, result["peakRssKB"], 100 * growth,
+                            base["peakRssKB"]))
+    return found
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Check PerformanceBenchmark results against a baseline.")
+    parser.add_argument("--build", default="build_test_integration/Performance")
+    parser.add_argument("--scenario", action="append", choices=sorted(SCENARIOS.keys()),
+                        help="Scenario to run, may be repeated. Defaults to all.")
+    parser.add_argument("--steps", type=int, help="Override the number of steps per scenario.")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Runs per scenario; the median of each measurement is used.")
+    parser.add_argument("--baseline", help="JSON file of results to compare against.")
+    parser.add_argument("--write-baseline", help="Write the results to this JSON file.")
+    parser.add_argument("--max-slowdown", type=float, default=0.2,
+                        help="Fraction steps/s may drop below the baseline.")
+    parser.add_argument("--max-time-increase", type=float, default=0.5,
+                        help="Fraction build and reset time may rise above the baseline.")
+    parser.add_argument("--min-time", type=float, default=0.05,
+                        help="Seconds of build or reset time increase to ignore.")
+    parser.add_argument("--max-memory-increase", type=float, default=0.2,
+                        help="Fraction peak RSS may rise above the baseline.")
+    args = parser.parse_args()
+
+    executable = os.path.join(args.build, "PerformanceBenchmark")
+    if not os.access(executable, os.X_OK):
+        sys.stderr.write("Could not find %s. Has it been built?\n" % executable)
+        return 1
+    if args.repeat < 1:
+        sys.stderr.write("--repeat must be at least 1\n")
+        return 1
+
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["scenario", "steps", "stepsPerSecond", "buildSeconds",
+                     "resetSeconds", "peakRssKB", "baselineStepsPerSecond", "ratio"])
+
+    results = {}
+    found = []
+    for scenario in (args.scenario or sorted(SCENARIOS.keys())):
+        steps = args.steps or SCENARIOS[scenario]
+        result = measure(executable, scenario, steps, args.repeat)
+        results[scenario] = result
+
+        baseSpeed = baseline.get(scenario, {}).get("stepsPerSecond", 0.0)
+        ratio = result["stepsPerSecond"] / baseSpeed if baseSpeed > 0 else 0.0
+        writer.writerow([scenario, steps, "%.1f" % result["stepsPerSecond"],
+                         "%.4f" % result["buildSeconds"], "%.4f" % result["resetSeconds"],
+                         "%d" % result["peakRssKB"], "%.1f" % baseSpeed, "%.3f" % ratio])
+        found.extend(regressions(scenario, result, baseline, args))
+
+    if args.write_baseline:
+        with open(args.write_baseline, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    for message in found:
+        sys.stderr.write("Regression: %s\n" % message)
+    return 1 if found else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+# Purpose: Run ScalingBenchmark on growing generated structures and report
+#          build time, step time and memory per element (rod or cable).
+#          A cost per element that keeps rising with size marks where a
+#          subsystem stops scaling linearly.
+# Usage:   bin/build.sh -i, then from the repository root:
+#          checkScaling.py --shape icosahedra --sizes 1 2 4 8
+
+import argparse
+import csv
+import os
+import subprocess
+import sys
+
+SIZES = {
+    "prisms": [1, 2, 4, 8],
+    "spine": [8, 32, 128, 512],
+    "icosahedra": [1, 2, 4, 8],
+}
+
+
+def runBenchmark(executable, shape, size, steps):
+    """ Returns (rods, cables, buildSeconds, stepsPerSecond, peakRssKB). """
+    output = subprocess.check_output([executable, shape, str(size), str(steps)])
+    lastLine = output.decode().strip().splitlines()[-1]
+    # precision,shape,size,rods,cables,buildSeconds,steps,seconds,stepsPerSecond,peakRssKB
+    values = lastLine.split(",")
+    return (int(values[3]), int(values[4]), float(values[5]),
+            float(values[8]), float(values[9]))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure how build time, step time and memory grow with structure size.")
+    parser.add_argument("--build", default="build_test_integration/Performance")
+    parser.add_argument("--shape", action="append", choices=sorted(SIZES.keys()),
+                        help="Structure to grow, may be repeated. Defaults to all.")
+    parser.add_argument("--sizes", type=int, nargs="+",
+                        help="Sizes to run, overriding the defaults of each shape.")
+    parser.add_argument("--steps", type=int, default=1000)
+    args = parser.parse_args()
+
+    executable = os.path.join(args.build, "ScalingBenchmark")
+    if not os.access(executable, os.X_OK):
+        sys.stderr.write("Could not find %s. Has it been built?\n" % executable)
+        return 1
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["shape", "size", "rods", "cables", "buildSeconds", "stepsPerSecond",
+                     "peakRssKB", "buildMsPerElement", "stepUsPerElement", "kbPerElement"])
+
+    for shape in (args.shape or sorted(SIZES.keys())):
+        for size in (args.sizes or SIZES[shape]):
+            rods, cables, build, speed, rss = runBenchmark(executable, shape, size, args.steps)
+            elements = max(rods + cables, 1)
+            stepUs = 1.0e6 / speed / elements if speed > 0 else 0.0
+            writer.writerow([shape, size, rods, cables, "%.4f" % build, "%.1f" % speed,
+                             "%d" % rss, "%.4f" % (1000.0 * build / elements),
+                             "%.4f" % stepUs, "%.3f" % (rss / elements)])
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
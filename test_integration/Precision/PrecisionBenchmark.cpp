@@ -0,0 +1,212 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file PrecisionBenchmark.cpp
+* @brief Runs the scenarios of the TimestepIndependence, SpineTests and
+* ICRA2015 fixtures headless, reporting speed and recording rigid body
+* trajectories so single and double precision builds can be compared.
+* @see comparePrecision.py
+* $Id$
+*/
+
+// The fixtures' models and controllers
+#include "examples/motorModel/tsTestRig.h"
+#include "examples/learningSpines/TetrahedralComplex/FlemonsSpineModelLearning.h"
+#include "examples/learningSpines/BaseSpineCPGControl.h"
+#include "examples/learningSpines/KinematicSpineCPGControl.h"
+#include "examples/IROS_2015/TetraSpineStatic/TetraSpineStaticModel_hf.h"
+#include "examples/IROS_2015/TetraSpineStatic/SerializedSpineControl.h"
+// This library
+#include "core/tgBaseRigid.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics library
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /** Steps between trajectory samples */
+    const int sampleInterval = 100;
+
+    tgModel* addTimestepScenario(tgSimulation& simulation)
+    {
+        tsTestRig* const myModel = new tsTestRig(true);
+        simulation.addModel(myModel);
+        return myModel;
+    }
+
+    tgModel* addSpineScenario(tgSimulation& simulation)
+    {
+        const int segments = 12;
+        FlemonsSpineModelLearning* myModel =
+          new FlemonsSpineModelLearning(segments);
+
+        const std::string suffix("default");
+
+        // Same configuration as WorldConf_Spines_test
+        BaseSpineCPGControl::Config control_config(3, 8, 8, 2, 6, .01,
+                                                   -30.0, 30.0,
+                                                   -1 * M_PI, M_PI,
+                                                   0.0, 1000.0, 210.0,
+                                                   true, 10.0, -30.0, 30.0);
+
+        KinematicSpineCPGControl* const myControl =
+          new KinematicSpineCPGControl(control_config, suffix,
+                                       "learningSpines/TetrahedralComplex/");
+        myModel->attach(myControl);
+
+        simulation.addModel(myModel);
+        return myModel;
+    }
+
+    tgModel* addICRA2015Scenario(tgSimulation& simulation)
+    {
+        const int segments = 3;
+        TetraSpineStaticModel_hf* myModel =
+          new TetraSpineStaticModel_hf(segments);
+
+        const std::string suffix("controlVars.json");
+        SerializedSpineControl* const myControl =
+          new SerializedSpineControl(suffix);
+        myModel->attach(myControl);
+
+        simulation.addModel(myModel);
+        return myModel;
+    }
+
+    void writeSample(std::ofstream& out, int step,
+                     const std::vector<tgBaseRigid*>& rigids)
+    {
+        out << step;
+        for (std::size_t i = 0; i < rigids.size(); i++)
+        {
+            const btVector3 com = rigids[i]->centerOfMass();
+            out << "," << com.getX() << "," << com.getY() << "," << com.getZ();
+        }
+        out << std::endl;
+    }
+
+    void usage(const char* name)
+    {
+        std::cerr << "usage: " << name
+                  << " <timestep|spine|icra2015> <steps> <trajectory.csv>"
+                  << std::endl;
+    }
+}
+
+/**
+ * Runs one scenario and prints a single machine readable result line:
+ * precision,scenario,steps,seconds,stepsPerSecond
+ * The trajectory file contains the center of mass of every rigid body
+ * in the model every sampleInterval steps.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const std::string scenario(argv[1]);
+    const int steps = atoi(argv[2]);
+    if (steps <= 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream trajectory(argv[3]);
+    if (!trajectory.is_open())
+    {
+        std::cerr << "Could not open " << argv[3] << std::endl;
+        return 1;
+    }
+    trajectory.precision(12);
+
+    const tgWorld::Config config(981); // gravity, cm/sec^2
+    tgWorld world(config);
+
+    const double stepSize = 1.0/1000.0; // Seconds
+    const double renderRate = 1.0/60.0; // Seconds
+    tgSimView view(world, stepSize, renderRate);
+
+    tgSimulation simulation(view);
+
+    tgModel* myModel = NULL;
+    if (scenario == "timestep")
+    {
+        myModel = addTimestepScenario(simulation);
+    }
+    else if (scenario == "spine")
+    {
+        myModel = addSpineScenario(simulation);
+    }
+    else if (scenario == "icra2015")
+    {
+        myModel = addICRA2015Scenario(simulation);
+    }
+    else
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const std::vector<tgBaseRigid*> rigids =
+        tgCast::filter<tgModel, tgBaseRigid>(myModel->getDescendants());
+
+    writeSample(trajectory, 0, rigids);
+
+    double elapsed = 0.0;
+    for (int step = 0; step < steps; step += sampleInterval)
+    {
+        const int chunk = std::min(sampleInterval, steps - step);
+
+        const std::clock_t start = std::clock();
+        simulation.run(chunk);
+        elapsed += (double) (std::clock() - start) / CLOCKS_PER_SEC;
+
+        writeSample(trajectory, step + chunk, rigids);
+    }
+
+#ifdef BT_USE_DOUBLE_PRECISION
+    const std::string precision("double");
+#else
+    const std::string precision("single");
+#endif
+
+    std::cout << precision << "," << scenario << "," << steps << ","
+              << elapsed << "," << (elapsed > 0.0 ? steps / elapsed : 0.0)
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+# Purpose: Run PrecisionBenchmark from the double and single precision
+#          integration test builds and report speed and trajectory divergence.
+# Usage:   bin/build.sh -i && bin/build.sh -f -i, then run this script from
+#          the repository root.
+
+import argparse
+import csv
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+SCENARIOS = {
+    "timestep": 1000,
+    "spine": 15000,
+    "icra2015": 60000,
+}
+
+
+def runBenchmark(executable, scenario, steps):
+    """ Returns (stepsPerSecond, trajectory rows) for one run. """
+    handle, trajectoryFile = tempfile.mkstemp(suffix=".csv")
+    os.close(handle)
+    try:
+        output = subprocess.check_output([executable, scenario, str(steps), trajectoryFile])
+        lastLine = output.decode().strip().splitlines()[-1]
+        stepsPerSecond = float(lastLine.split(",")[4])
+        with open(trajectoryFile) as f:
+            rows = [[float(v) for v in row] for row in csv.reader(f)]
+    finally:
+        os.remove(trajectoryFile)
+    return stepsPerSecond, rows
+
+
+def divergence(doubleRows, singleRows):
+    """ Max, RMS and final distance between matching body positions. """
+    maxDist = 0.0
+    sumSq = 0.0
+    count = 0
+    finalDist = 0.0
+    for a, b in zip(doubleRows, singleRows):
+        rowMax = 0.0
+        # Column 0 is the step number, then x,y,z per body
+        for i in range(1, min(len(a), len(b)), 3):
+            d = math.sqrt(sum((a[i + k] - b[i + k]) ** 2 for k in range(3)))
+            rowMax = max(rowMax, d)
+            sumSq += d * d
+            count += 1
+        maxDist = max(maxDist, rowMax)
+        finalDist = rowMax
+    rms = math.sqrt(sumSq / count) if count > 0 else 0.0
+    return maxDist, rms, finalDist
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare PrecisionBenchmark results between double and single precision builds.")
+    parser.add_argument("--double-build", default="build_test_integration/Precision")
+    parser.add_argument("--single-build", default="build_test_integration_float/Precision")
+    parser.add_argument("--scenario", action="append", choices=sorted(SCENARIOS.keys()),
+                        help="Scenario to run, may be repeated. Defaults to all.")
+    parser.add_argument("--steps", type=int, help="Override the number of steps per scenario.")
+    args = parser.parse_args()
+
+    doubleExe = os.path.join(args.double_build, "PrecisionBenchmark")
+    singleExe = os.path.join(args.single_build, "PrecisionBenchmark")
+    for exe in (doubleExe, singleExe):
+        if not os.access(exe, os.X_OK):
+            sys.stderr.write("Could not find %s. Has it been built?\n" % exe)
+            return 1
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["scenario", "steps", "doubleStepsPerSecond", "singleStepsPerSecond",
+                     "speedup", "maxDivergence", "rmsDivergence", "finalDivergence"])
+
+    for scenario in (args.scenario or sorted(SCENARIOS.keys())):
+        steps = args.steps or SCENARIOS[scenario]
+        doubleSpeed, doubleRows = runBenchmark(doubleExe, scenario, steps)
+        singleSpeed, singleRows = runBenchmark(singleExe, scenario, steps)
+        maxDist, rms, finalDist = divergence(doubleRows, singleRows)
+        speedup = singleSpeed / doubleSpeed if doubleSpeed > 0 else 0.0
+        writer.writerow([scenario, steps, "%.1f" % doubleSpeed, "%.1f" % singleSpeed,
+                         "%.3f" % speedup, "%.6g" % maxDist, "%.6g" % rms, "%.6g" % finalDist])
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())